@@ -72,9 +72,11 @@ void Distribution_1D::precompute_1D_pdf_cdf(float const* data, uint32_t len) {
 
     float const ii = 1.f / integral;
 
+    // Accumulated rounding errors of long distributions could otherwise exceed 1,
+    // and be mapped beyond the end of the LUT
     cdf_[0] = 0.f;
     for (uint32_t i = 1; i < len; ++i) {
-        cdf_[i] = std::fma(data[i - 1], ii, cdf_[i - 1]);
+        cdf_[i] = std::min(std::fma(data[i - 1], ii, cdf_[i - 1]), 1.f);
     }
     cdf_[len] = 1.f;
 
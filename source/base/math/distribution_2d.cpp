@@ -1,12 +1,15 @@
 #include "distribution_2d.hpp"
 #include "distribution_1d.inl"
+#include "distribution_alias_1d.inl"
 #include "math/vector2.inl"
 
 namespace math {
 
-Distribution_2D::Distribution_2D() : conditional_size_(0), conditional_(nullptr) {}
+template <typename T>
+Distribution_t_2D<T>::Distribution_t_2D() : conditional_size_(0), conditional_(nullptr) {}
 
-Distribution_2D::Distribution_2D(Distribution_2D&& other)
+template <typename T>
+Distribution_t_2D<T>::Distribution_t_2D(Distribution_t_2D&& other)
     : marginal_(std::move(other.marginal_)),
       conditional_size_(other.conditional_size_),
       conditional_sizef_(other.conditional_sizef_),
@@ -14,30 +17,35 @@ Distribution_2D::Distribution_2D(Distribution_2D&& other)
     other.conditional_ = nullptr;
 }
 
-Distribution_2D::~Distribution_2D() {
+template <typename T>
+Distribution_t_2D<T>::~Distribution_t_2D() {
     delete[] conditional_;
 }
 
-Distribution_1D* Distribution_2D::allocate(uint32_t num) {
+template <typename T>
+T* Distribution_t_2D<T>::allocate(uint32_t num) {
     if (conditional_size_ != num) {
         delete[] conditional_;
 
         conditional_size_ = num;
-        conditional_      = new Distribution_1D[num];
+        conditional_      = new T[num];
     }
 
     return conditional_;
 }
 
-Distribution_1D* Distribution_2D::conditional() {
+template <typename T>
+T* Distribution_t_2D<T>::conditional() {
     return conditional_;
 }
 
-bool Distribution_2D::empty() const {
+template <typename T>
+bool Distribution_t_2D<T>::empty() const {
     return 0 == conditional_size_;
 }
 
-void Distribution_2D::init() {
+template <typename T>
+void Distribution_t_2D<T>::init() {
     uint32_t const num_conditional = conditional_size_;
 
     float* integrals = new float[num_conditional];
@@ -53,11 +61,14 @@ void Distribution_2D::init() {
     delete[] integrals;
 }
 
-float Distribution_2D::integral() const {
+template <typename T>
+float Distribution_t_2D<T>::integral() const {
     return marginal_.integral();
 }
 
-typename Distribution_2D::Continuous Distribution_2D::sample_continuous(float2 r2) const {
+template <typename T>
+typename Distribution_t_2D<T>::Continuous Distribution_t_2D<T>::sample_continuous(
+    float2 r2) const {
     auto const v = marginal_.sample_continuous(r2[1]);
 
     uint32_t const i = uint32_t(v.offset * conditional_sizef_);
@@ -68,7 +79,8 @@ typename Distribution_2D::Continuous Distribution_2D::sample_continuous(float2 r
     return {float2(u.offset, v.offset), u.pdf * v.pdf};
 }
 
-float Distribution_2D::pdf(float2 uv) const {
+template <typename T>
+float Distribution_t_2D<T>::pdf(float2 uv) const {
     float const v_pdf = marginal_.pdf(uv[1]);
 
     uint32_t const i = uint32_t(uv[1] * conditional_sizef_);
@@ -79,4 +91,7 @@ float Distribution_2D::pdf(float2 uv) const {
     return u_pdf * v_pdf;
 }
 
+template class Distribution_t_2D<Distribution_1D>;
+template class Distribution_t_2D<Distribution_alias_1D>;
+
 }  // namespace math
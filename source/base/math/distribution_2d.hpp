@@ -2,21 +2,25 @@
 #define SU_BASE_MATH_DISTRIBUTION_DISTRIBUTION_2D_HPP
 
 #include "distribution_1d.hpp"
+#include "distribution_alias_1d.hpp"
 #include "math/vector2.hpp"
 
 namespace math {
 
-class Distribution_2D {
+template <typename T>
+class Distribution_t_2D {
   public:
-    Distribution_2D();
+    using Distribution_impl = T;
 
-    Distribution_2D(Distribution_2D&& other);
+    Distribution_t_2D();
 
-    ~Distribution_2D();
+    Distribution_t_2D(Distribution_t_2D&& other);
 
-    Distribution_1D* allocate(uint32_t num);
+    ~Distribution_t_2D();
 
-    Distribution_1D* conditional();
+    T* allocate(uint32_t num);
+
+    T* conditional();
 
     bool empty() const;
 
@@ -33,15 +37,21 @@ class Distribution_2D {
     float pdf(float2 uv) const;
 
   private:
-    Distribution_1D marginal_;
+    T marginal_;
 
     uint32_t conditional_size_;
 
     float conditional_sizef_;
 
-    Distribution_1D* conditional_;
+    T* conditional_;
 };
 
+using Distribution_2D       = Distribution_t_2D<Distribution_1D>;
+using Distribution_alias_2D = Distribution_t_2D<Distribution_alias_1D>;
+
+extern template class Distribution_t_2D<Distribution_1D>;
+extern template class Distribution_t_2D<Distribution_alias_1D>;
+
 }  // namespace math
 
 #endif
@@ -1,27 +1,32 @@
 #include "distribution_3d.hpp"
 #include "distribution_1d.inl"
+#include "distribution_alias_1d.inl"
 #include "math/vector4.inl"
 
 namespace math {
 
-Distribution_3D::Distribution_3D() : conditional_size_(0), conditional_(nullptr) {}
+template <typename T>
+Distribution_t_3D<T>::Distribution_t_3D() : conditional_size_(0), conditional_(nullptr) {}
 
-Distribution_3D::~Distribution_3D() {
+template <typename T>
+Distribution_t_3D<T>::~Distribution_t_3D() {
     delete[] conditional_;
 }
 
-Distribution_2D* Distribution_3D::allocate(uint32_t num) {
+template <typename T>
+Distribution_t_2D<T>* Distribution_t_3D<T>::allocate(uint32_t num) {
     if (conditional_size_ != num) {
         delete[] conditional_;
 
         conditional_size_ = num;
-        conditional_      = new Distribution_2D[num];
+        conditional_      = new Distribution_t_2D<T>[num];
     }
 
     return conditional_;
 }
 
-void Distribution_3D::init() {
+template <typename T>
+void Distribution_t_3D<T>::init() {
     uint32_t const num_conditional = conditional_size_;
 
     float* integrals = new float[num_conditional];
@@ -37,11 +42,13 @@ void Distribution_3D::init() {
     delete[] integrals;
 }
 
-float Distribution_3D::integral() const {
+template <typename T>
+float Distribution_t_3D<T>::integral() const {
     return marginal_.integral();
 }
 
-float4 Distribution_3D::sample_continuous(float3_p r3) const {
+template <typename T>
+float4 Distribution_t_3D<T>::sample_continuous(float3_p r3) const {
     auto const w = marginal_.sample_continuous(r3[2]);
 
     uint32_t const i = uint32_t(w.offset * conditional_sizef_);
@@ -52,7 +59,8 @@ float4 Distribution_3D::sample_continuous(float3_p r3) const {
     return float4(uv.uv, w.offset, uv.pdf * w.pdf);
 }
 
-float Distribution_3D::pdf(float3_p uvw) const {
+template <typename T>
+float Distribution_t_3D<T>::pdf(float3_p uvw) const {
     float const w_pdf = marginal_.pdf(uvw[2]);
 
     uint32_t const i = uint32_t(uvw[2] * conditional_sizef_);
@@ -63,4 +71,7 @@ float Distribution_3D::pdf(float3_p uvw) const {
     return uv_pdf * w_pdf;
 }
 
+template class Distribution_t_3D<Distribution_1D>;
+template class Distribution_t_3D<Distribution_alias_1D>;
+
 }  // namespace math
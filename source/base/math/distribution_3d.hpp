@@ -6,13 +6,16 @@
 
 namespace math {
 
-class Distribution_3D {
+template <typename T>
+class Distribution_t_3D {
   public:
-    Distribution_3D();
+    using Distribution_impl = T;
 
-    ~Distribution_3D();
+    Distribution_t_3D();
 
-    Distribution_2D* allocate(uint32_t num);
+    ~Distribution_t_3D();
+
+    Distribution_t_2D<T>* allocate(uint32_t num);
 
     void init();
 
@@ -23,14 +26,20 @@ class Distribution_3D {
     float pdf(float3_p uvw) const;
 
   private:
-    Distribution_1D marginal_;
+    T marginal_;
 
     uint32_t conditional_size_;
     float    conditional_sizef_;
 
-    Distribution_2D* conditional_;
+    Distribution_t_2D<T>* conditional_;
 };
 
+using Distribution_3D       = Distribution_t_3D<Distribution_1D>;
+using Distribution_alias_3D = Distribution_t_3D<Distribution_alias_1D>;
+
+extern template class Distribution_t_3D<Distribution_1D>;
+extern template class Distribution_t_3D<Distribution_alias_1D>;
+
 }  // namespace math
 
 #endif
@@ -0,0 +1,117 @@
+#include "distribution_alias_1d.inl"
+
+#include <vector>
+
+namespace math {
+
+Distribution_alias_1D::Distribution_alias_1D()
+    : size_(0), sizef_(0.f), integral_(-1.f), entries_(nullptr) {}
+
+Distribution_alias_1D::Distribution_alias_1D(Distribution_alias_1D&& other)
+    : size_(other.size_),
+      sizef_(other.sizef_),
+      integral_(other.integral_),
+      entries_(other.entries_) {
+    other.entries_ = nullptr;
+}
+
+Distribution_alias_1D::~Distribution_alias_1D() {
+    delete[] entries_;
+}
+
+void Distribution_alias_1D::init(float const* data, uint32_t len, uint32_t /*lut_bucket_size*/) {
+    double integral = 0.;
+    for (uint32_t i = 0; i < len; ++i) {
+        integral += double(data[i]);
+    }
+
+    if (0. == integral) {
+        if (0.f != integral_) {
+            delete[] entries_;
+
+            size_    = 1;
+            sizef_   = 1.f;
+            entries_ = new Entry[1];
+
+            entries_[0] = {1.f, 0, 0.f, 0.f};
+
+            integral_ = 0.f;
+        }
+
+        return;
+    }
+
+    if (size_ != len) {
+        delete[] entries_;
+
+        size_    = len;
+        sizef_   = float(len);
+        entries_ = new Entry[len];
+    }
+
+    // Vose's algorithm, with the probabilities scaled by the size,
+    // so that 1 is the share of every entry.
+    // Underfull entries are kept at the front of the work list, overfull ones at the back.
+
+    double const scale = double(len) / integral;
+
+    std::vector<double>   scaled(len);
+    std::vector<uint32_t> work(len);
+
+    uint32_t num_small = 0;
+    uint32_t large     = len;
+
+    for (uint32_t i = 0; i < len; ++i) {
+        double const p = double(data[i]) * scale;
+
+        scaled[i] = p;
+
+        if (p < 1.) {
+            work[num_small++] = i;
+        } else {
+            work[--large] = i;
+        }
+
+        entries_[i].pdf = float(double(data[i]) / integral);
+    }
+
+    // Both sections together never hold more than len - 1 indices after a small one was taken,
+    // so a large entry that became small can always be appended to the small section.
+    while (num_small > 0 && large < len) {
+        uint32_t const s = work[--num_small];
+        uint32_t const l = work[large];
+
+        entries_[s].threshold = float(scaled[s]);
+        entries_[s].alias     = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.;
+
+        if (scaled[l] < 1.) {
+            ++large;
+            work[num_small++] = l;
+        }
+    }
+
+    // Whatever remains is full up to rounding errors
+    for (uint32_t i = 0; i < num_small; ++i) {
+        uint32_t const s = work[i];
+
+        entries_[s].threshold = 1.f;
+        entries_[s].alias     = s;
+    }
+
+    for (uint32_t i = large; i < len; ++i) {
+        uint32_t const l = work[i];
+
+        entries_[l].threshold = 1.f;
+        entries_[l].alias     = l;
+    }
+
+    for (uint32_t i = 0; i < len; ++i) {
+        entries_[i].alias_pdf = entries_[entries_[i].alias].pdf;
+    }
+
+    integral_ = float(integral);
+}
+
+}  // namespace math
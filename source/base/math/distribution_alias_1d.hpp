@@ -0,0 +1,56 @@
+#ifndef SU_BASE_MATH_DISTRIBUTION_DISTRIBUTION_ALIAS_1D_HPP
+#define SU_BASE_MATH_DISTRIBUTION_DISTRIBUTION_ALIAS_1D_HPP
+
+#include "distribution_1d.hpp"
+
+namespace math {
+
+// Alias method: every sample looks at exactly one entry, independent of the size.
+// Unlike Distribution_1D, the mapping from r to the sampled offset is not monotonic,
+// so stratification of r does not carry over to the samples.
+// https://www.keithschwarz.com/darts-dice-coins/
+
+class Distribution_alias_1D {
+  public:
+    using Discrete   = Distribution_1D::Discrete;
+    using Continuous = Distribution_1D::Continuous;
+
+    Distribution_alias_1D();
+
+    Distribution_alias_1D(Distribution_alias_1D&& other);
+
+    ~Distribution_alias_1D();
+
+    void init(float const* data, uint32_t len, uint32_t lut_bucket_size = 0);
+
+    float integral() const;
+
+    uint32_t sample(float r) const;
+
+    Discrete sample_discrete(float r) const;
+
+    Continuous sample_continuous(float r) const;
+
+    float pdf(uint32_t index) const;
+    float pdf(float u) const;
+
+  private:
+    struct alignas(16) Entry {
+        float    threshold;
+        uint32_t alias;
+        float    pdf;
+        float    alias_pdf;
+    };
+
+    uint32_t size_;
+
+    float sizef_;
+
+    float integral_;
+
+    Entry* entries_;
+};
+
+}  // namespace math
+
+#endif
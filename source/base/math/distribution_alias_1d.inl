@@ -0,0 +1,79 @@
+#ifndef SU_BASE_MATH_DISTRIBUTION_DISTRIBUTION_ALIAS_1D_INL
+#define SU_BASE_MATH_DISTRIBUTION_DISTRIBUTION_ALIAS_1D_INL
+
+#include "distribution_alias_1d.hpp"
+
+#include <algorithm>
+
+#include "debug/assert.hpp"
+
+namespace math {
+
+inline float Distribution_alias_1D::integral() const {
+    return integral_;
+}
+
+inline uint32_t Distribution_alias_1D::sample(float r) const {
+    return sample_discrete(r).offset;
+}
+
+inline Distribution_alias_1D::Discrete Distribution_alias_1D::sample_discrete(float r) const {
+    float const    s = r * sizef_;
+    uint32_t const i = std::min(uint32_t(s), size_ - 1);
+
+    Entry const& e = entries_[i];
+
+    if (s - float(i) < e.threshold) {
+        return {i, e.pdf};
+    }
+
+    return {e.alias, e.alias_pdf};
+}
+
+inline Distribution_alias_1D::Continuous Distribution_alias_1D::sample_continuous(float r) const {
+    float const    s = r * sizef_;
+    uint32_t const i = std::min(uint32_t(s), size_ - 1);
+
+    // Stay below 1, in case r was exactly 1
+    float const f = std::min(s - float(i), 0x1.fffffep-1f);
+
+    Entry const& e = entries_[i];
+
+    uint32_t offset;
+    float    pdf;
+    float    t;
+
+    if (f < e.threshold) {
+        offset = i;
+        pdf    = e.pdf;
+        t      = f / e.threshold;
+    } else {
+        offset = e.alias;
+        pdf    = e.alias_pdf;
+        t      = (f - e.threshold) / (1.f - e.threshold);
+    }
+
+    if (0.f == pdf) {
+        return {0.f, 0.f};
+    }
+
+    float const result = (float(offset) + t) / sizef_;
+
+    return {result, pdf};
+}
+
+inline float Distribution_alias_1D::pdf(uint32_t index) const {
+    SOFT_ASSERT(index < size_);
+
+    return entries_[index].pdf;
+}
+
+inline float Distribution_alias_1D::pdf(float u) const {
+    uint32_t const offset = std::min(uint32_t(u * sizef_), size_ - 1);
+
+    return entries_[offset].pdf;
+}
+
+}  // namespace math
+
+#endif
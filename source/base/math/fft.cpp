@@ -0,0 +1,168 @@
+#include "fft.hpp"
+#include "debug/assert.hpp"
+#include "vector2.inl"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace math {
+
+static inline float2 mul(float2 a, float2 b) {
+    return float2(a[0] * b[0] - a[1] * b[1], a[0] * b[1] + a[1] * b[0]);
+}
+
+static inline float2 conj(float2 a) {
+    return float2(a[0], -a[1]);
+}
+
+FFT::FFT() : n_(0), twiddles_(nullptr), real_twiddles_(nullptr) {}
+
+FFT::~FFT() {
+    delete[] real_twiddles_;
+    delete[] twiddles_;
+}
+
+void FFT::init(uint32_t n) {
+    SOFT_ASSERT(std::has_single_bit(n));
+
+    if (n == n_) {
+        return;
+    }
+
+    delete[] real_twiddles_;
+    delete[] twiddles_;
+
+    n_ = n;
+
+    twiddles_      = new float2[std::max(n / 2, 1u)];
+    real_twiddles_ = new float2[n + 1];
+
+    // Computed in double precision, so that the error doesn't grow with the size
+    double const pi = 3.14159265358979323846;
+
+    for (uint32_t k = 0; k < n / 2; ++k) {
+        double const a = -2. * pi * double(k) / double(n);
+        twiddles_[k]   = float2(float(std::cos(a)), float(std::sin(a)));
+    }
+
+    for (uint32_t k = 0; k <= n; ++k) {
+        double const a    = -pi * double(k) / double(n);
+        real_twiddles_[k] = float2(float(std::cos(a)), float(std::sin(a)));
+    }
+}
+
+uint32_t FFT::size() const {
+    return n_;
+}
+
+void FFT::forward(float2* data) const {
+    transform(data, false);
+}
+
+void FFT::inverse(float2* data) const {
+    transform(data, true);
+}
+
+void FFT::forward_real(float const* source, float2* destination) const {
+    uint32_t const n = n_;
+
+    // The even values become the real parts and the odd values the imaginary parts
+    std::memcpy(static_cast<void*>(destination), source, 2 * n * sizeof(float));
+
+    transform(destination, false);
+
+    // Untangle the spectra of the even and odd values, and combine them.
+    // Done for k and n - k at once, because they depend on each other.
+    float2 const z0 = destination[0];
+
+    destination[0] = float2(z0[0] + z0[1], 0.f);
+    destination[n] = float2(z0[0] - z0[1], 0.f);
+
+    for (uint32_t k = 1, len = n / 2; k <= len; ++k) {
+        uint32_t const l = n - k;
+
+        float2 const zk = destination[k];
+        float2 const zl = destination[l];
+
+        float2 const ek = 0.5f * (zk + conj(zl));
+        float2 const dk = zk - conj(zl);
+        float2 const ok = 0.5f * float2(dk[1], -dk[0]);
+
+        float2 const el = 0.5f * (zl + conj(zk));
+        float2 const dl = zl - conj(zk);
+        float2 const ol = 0.5f * float2(dl[1], -dl[0]);
+
+        destination[k] = ek + mul(real_twiddles_[k], ok);
+        destination[l] = el + mul(real_twiddles_[l], ol);
+    }
+}
+
+void FFT::inverse_real(float2 const* source, float* destination) const {
+    uint32_t const n = n_;
+
+    float2* z = reinterpret_cast<float2*>(destination);
+
+    for (uint32_t k = 0; k < n; ++k) {
+        float2 const xk = source[k];
+        float2 const xl = conj(source[n - k]);
+
+        float2 const e = 0.5f * (xk + xl);
+        float2 const o = 0.5f * mul(xk - xl, conj(real_twiddles_[k]));
+
+        z[k] = e + float2(-o[1], o[0]);
+    }
+
+    transform(z, true);
+}
+
+void FFT::transform(float2* data, bool inverse) const {
+    uint32_t const n = n_;
+
+    for (uint32_t i = 1, j = 0; i < n; ++i) {
+        uint32_t bit = n >> 1;
+
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        uint32_t const half = len >> 1;
+        uint32_t const step = n / len;
+
+        for (uint32_t i = 0; i < n; i += len) {
+            float2* a = data + i;
+            float2* b = a + half;
+
+            for (uint32_t j = 0; j < half; ++j) {
+                float2 const t = twiddles_[j * step];
+                float2 const w = inverse ? conj(t) : t;
+
+                float2 const u = a[j];
+                float2 const v = mul(b[j], w);
+
+                a[j] = u + v;
+                b[j] = u - v;
+            }
+        }
+    }
+
+    if (inverse) {
+        float const s = 1.f / float(n);
+
+        for (uint32_t i = 0; i < n; ++i) {
+            data[i] *= s;
+        }
+    }
+}
+
+}  // namespace math
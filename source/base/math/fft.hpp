@@ -0,0 +1,47 @@
+#ifndef SU_BASE_MATH_FFT_HPP
+#define SU_BASE_MATH_FFT_HPP
+
+#include "vector2.hpp"
+
+namespace math {
+
+// Iterative radix-2 Cooley-Tukey transforms of power of two sizes.
+// Complex numbers are stored as float2(real, imaginary).
+// The forward transforms are not scaled, the inverse ones by 1/size.
+class FFT {
+  public:
+    FFT();
+
+    ~FFT();
+
+    // n must be a power of two
+    void init(uint32_t n);
+
+    uint32_t size() const;
+
+    void forward(float2* data) const;
+
+    void inverse(float2* data) const;
+
+    // Transforms 2n real values into the n + 1 non-redundant values of their spectrum,
+    // by means of a complex transform of size n
+    void forward_real(float const* source, float2* destination) const;
+
+    // source holds n + 1 spectrum values, destination receives 2n real values
+    void inverse_real(float2 const* source, float* destination) const;
+
+  private:
+    void transform(float2* data, bool inverse) const;
+
+    uint32_t n_;
+
+    // exp(-2 pi i k / n) for k in [0, n / 2)
+    float2* twiddles_;
+
+    // exp(-2 pi i k / 2n) for k in [0, n]
+    float2* real_twiddles_;
+};
+
+}  // namespace math
+
+#endif
@@ -1,47 +1,69 @@
 #include "thread_pool.hpp"
 
-#ifdef GRANULAR_TASKS
-#include "task_queue.inl"
-#endif
-
 #include <algorithm>
-#include <cmath>
 
 namespace thread {
 
+// Number of times an idle thread looks for work before it parks
+static uint32_t constexpr Spin_count = 64;
+
+// Default number of chunks per thread for run_range()
+static int32_t constexpr Chunks_per_thread = 8;
+
+static thread_local Pool const* Current_pool = nullptr;
+
+static thread_local uint32_t Current_id = 0;
+
+static thread_local uint32_t Parallel_depth = 0;
+
+struct Pool::Job {
+    Parallel_program const* parallel = nullptr;
+
+    Range_program const* range = nullptr;
+
+    Async_program async;
+
+    int32_t begin = 0;
+    int32_t end   = 0;
+
+    int32_t item_size = 1;
+
+    int32_t num_ids = 1;
+
+    std::atomic<uint32_t> pending = 0;
+
+    std::condition_variable done_signal;
+
+    std::mutex mutex;
+
+    bool done = false;
+};
+
 Pool::Pool(uint32_t num_threads)
     : num_threads_(num_threads),
-      uniques_(new Unique[num_threads]),
-      threads_(new std::thread[num_threads])
-#ifdef GRANULAR_TASKS
-      ,
-      tasks_(num_threads * 64)
-#endif
-{
+      queues_(new Queue[num_threads]),
+      threads_(new std::thread[num_threads]) {
     for (uint32_t i = 0; i < num_threads; ++i) {
         threads_[i] = std::thread(&Pool::loop, this, i);
     }
-
-    async_thread_ = std::thread(async_loop, std::ref(async_));
 }
 
 Pool::~Pool() {
+    wait_async();
+
     quit_ = true;
 
-    wake_all(num_threads_);
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_signal_.notify_all();
+    }
 
     for (uint32_t i = 0, len = num_threads_; i < len; ++i) {
         threads_[i].join();
     }
 
-    async_.quit = true;
-
-    wake_async();
-
-    async_thread_.join();
-
     delete[] threads_;
-    delete[] uniques_;
+    delete[] queues_;
 }
 
 uint32_t Pool::num_threads() const {
@@ -49,43 +71,69 @@ uint32_t Pool::num_threads() const {
 }
 
 bool Pool::is_running_parallel() const {
-    return running_parallel_;
+    return Current_pool == this && Parallel_depth > 0;
 }
 
 void Pool::run_parallel(Parallel_program&& program, uint32_t num_tasks_hint) {
-    parallel_program_ = program;
-
-    range_program_ = nullptr;
-
     uint32_t const num_tasks = num_tasks_hint ? std::min(num_tasks_hint, num_threads_)
                                               : num_threads_;
 
-    wake_all(num_tasks);
+    Job job;
+    job.parallel = &program;
+    job.pending  = num_tasks;
 
-    wait_all(num_tasks);
+    submit(job, int32_t(num_tasks));
+
+    wait(job);
 }
 
-void Pool::run_range(Range_program&& program, int32_t begin, int32_t end) {
-    range_program_ = program;
+void Pool::run_range(Range_program&& program, int32_t begin, int32_t end,
+                     int32_t item_size_hint) {
+    if (begin >= end) {
+        return;
+    }
+
+    int32_t const num_chunks_hint = int32_t(num_threads_) * Chunks_per_thread;
+
+    int32_t const item_size = item_size_hint > 0
+                                  ? item_size_hint
+                                  : std::max((end - begin + num_chunks_hint - 1) / num_chunks_hint,
+                                             1);
+
+    int32_t const num_chunks = (end - begin + item_size - 1) / item_size;
 
-    parallel_program_ = nullptr;
+    int32_t const num_ids = std::min(int32_t(num_threads_), num_chunks);
 
-    wake_all(begin, end);
+    Job job;
+    job.range     = &program;
+    job.begin     = begin;
+    job.end       = end;
+    job.item_size = item_size;
+    job.num_ids   = num_ids;
+    job.pending   = uint32_t(num_ids);
 
-    wait_all(num_threads_);
+    submit(job, num_ids);
+
+    wait(job);
 }
 
 void Pool::run_async(Async_program&& program) {
-    wait_async();
+    Job* job = new Job;
 
-    async_.program = std::move(program);
+    job->async   = std::move(program);
+    job->pending = 1;
 
-    wake_async();
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        ++num_async_;
+    }
+
+    submit(*job, 1);
 }
 
 void Pool::wait_async() {
-    std::unique_lock<std::mutex> lock(async_.mutex);
-    async_.done_signal.wait(lock, [this]() { return !async_.wake; });
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    async_signal_.wait(lock, [this]() { return 0 == num_async_; });
 }
 
 uint32_t Pool::num_threads(int32_t request) {
@@ -100,121 +148,195 @@ uint32_t Pool::num_threads(int32_t request) {
     return std::min(available_threads, uint32_t(std::max(request, 1)));
 }
 
-void Pool::wake_all(uint32_t num_tasks) {
-    running_parallel_ = true;
-
-    for (uint32_t i = 0; i < num_tasks; ++i) {
-        auto& u = uniques_[i];
+void Pool::submit(Job& job, int32_t num_tasks) {
+    Queue& queue = Current_pool == this ? queues_[Current_id] : shared_;
 
-        std::unique_lock<std::mutex> lock(u.mutex);
-        u.wake = true;
-        lock.unlock();
-        u.wake_signal.notify_one();
+    for (int32_t i = 0; i < num_tasks; ++i) {
+        push(queue, {&job, i, i + 1});
     }
+
+    wake(uint32_t(num_tasks));
 }
 
-void Pool::wake_all(int32_t begin, int32_t end) {
-    running_parallel_ = true;
+void Pool::push(Queue& queue, Task const& task) {
+    // Count first, so that the counter never drops below the number of queued tasks
+    num_queued_.fetch_add(1);
 
-#ifdef GRANULAR_TASKS
-    float const range     = float(end - begin);
-    float const num_tasks = float(tasks_.size());
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(task);
+}
 
-    int32_t const step = int32_t(std::ceil(range / num_tasks));
+bool Pool::pop(uint32_t id, Job const* filter, Task& task) {
+    if (0 == num_queued_.load(std::memory_order_relaxed)) {
+        return false;
+    }
 
-    tasks_.clear();
+    if (pop_back(queues_[id], filter, task) || pop_front(shared_, filter, task)) {
+        num_queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
 
-    for (int32_t i = begin; i < end; i += step) {
-        tasks_.push({i, std::min(i + step, end)});
+    for (uint32_t i = 1, len = num_threads_; i < len; ++i) {
+        uint32_t const victim = (id + i) % len;
+
+        if (pop_front(queues_[victim], filter, task)) {
+            num_queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
     }
 
-    wake_all();
-#else
-    float const range       = float(end - begin);
-    float const num_threads = float(num_threads_);
+    return false;
+}
 
-    int32_t const step = int32_t(std::ceil(range / num_threads));
+bool Pool::pop_back(Queue& queue, Job const* filter, Task& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
 
-    int32_t b = 0;
-    int32_t e = begin;
+    for (auto i = queue.tasks.rbegin(), end = queue.tasks.rend(); i != end; ++i) {
+        if (!filter || filter == i->job) {
+            task = *i;
+            queue.tasks.erase(std::next(i).base());
+            return true;
+        }
+    }
 
-    for (uint32_t i = 0, len = num_threads_; i < len; ++i) {
-        auto& u = uniques_[i];
+    return false;
+}
 
-        b = e;
-        e += step;
+bool Pool::pop_front(Queue& queue, Job const* filter, Task& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
 
-        std::unique_lock<std::mutex> lock(u.mutex);
-        u.begin = b;
-        u.end   = std::min(e, end);
-        u.wake  = true;
-        lock.unlock();
-        u.wake_signal.notify_one();
+    for (auto i = queue.tasks.begin(), end = queue.tasks.end(); i != end; ++i) {
+        if (!filter || filter == i->job) {
+            task = *i;
+            queue.tasks.erase(i);
+            return true;
+        }
     }
-#endif
-}
 
-void Pool::wake_async() {
-    std::unique_lock<std::mutex> lock(async_.mutex);
-    async_.wake = true;
-    lock.unlock();
-    async_.wake_signal.notify_one();
+    return false;
 }
 
-void Pool::wait_all(uint32_t num_tasks) {
-    for (uint32_t i = 0; i < num_tasks; ++i) {
-        auto& u = uniques_[i];
+void Pool::execute(Task const& task) {
+    Job& job = *task.job;
+
+    if (job.range) {
+        // The task stands for one id, which runs the chunks id, id + num_ids, ...
+        uint32_t const id = uint32_t(task.begin);
 
-        std::unique_lock<std::mutex> lock(u.mutex);
-        u.done_signal.wait(lock, [&u]() { return !u.wake; });
+        int64_t const stride = int64_t(job.num_ids) * int64_t(job.item_size);
+
+        ++Parallel_depth;
+
+        for (int64_t b = int64_t(job.begin) + int64_t(id) * job.item_size; b < job.end;
+             b += stride) {
+            (*job.range)(id, int32_t(b), int32_t(std::min(b + job.item_size, int64_t(job.end))));
+        }
+
+        --Parallel_depth;
+    } else if (job.parallel) {
+        ++Parallel_depth;
+        (*job.parallel)(uint32_t(task.begin));
+        --Parallel_depth;
+    } else {
+        job.async();
     }
 
-    running_parallel_ = false;
+    finish(job);
 }
 
-void Pool::loop(uint32_t id) {
-    Unique& unique = uniques_[id];
+void Pool::finish(Job& job) {
+    if (!job.range && !job.parallel) {
+        delete &job;
 
-    for (;;) {
-        std::unique_lock<std::mutex> lock(unique.mutex);
-        unique.wake_signal.wait(lock, [&unique]() { return unique.wake; });
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        --num_async_;
+        async_signal_.notify_all();
+        return;
+    }
 
-        if (quit_) {
-            break;
-        }
+    if (1 == job.pending.fetch_sub(1, std::memory_order_acq_rel)) {
+        // Notify while holding the lock, because the waiter destroys the job as soon as it sees
+        // that it is done
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.done = true;
+        job.done_signal.notify_all();
+    }
+}
 
-        if (range_program_) {
-#ifdef GRANULAR_TASKS
-            for (Task task; tasks_.pop(task);) {
-                range_program_(id, task.begin, task.end);
+void Pool::wait(Job& job) {
+    if (Current_pool == this) {
+        // Help with the job instead of blocking the calling worker right away.
+        // Only tasks of this job are considered, which keeps the per-id state of the
+        // program that is waiting on the stack safe.
+        uint32_t const id = Current_id;
+
+        for (uint32_t spin = 0;
+             job.pending.load(std::memory_order_acquire) > 0 && spin < Spin_count;) {
+            if (Task task; pop(id, &job, task)) {
+                execute(task);
+                spin = 0;
+            } else {
+                std::this_thread::yield();
+                ++spin;
             }
-#else
-            range_program_(id, unique.begin, unique.end);
-#endif
-        } else if (parallel_program_) {
-            parallel_program_(id);
         }
+    }
+
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.done_signal.wait(lock, [&job]() { return job.done; });
+}
+
+bool Pool::park() {
+    std::unique_lock<std::mutex> lock(park_mutex_);
+
+    num_parked_.fetch_add(1);
+
+    park_signal_.wait(lock, [this]() { return quit_ || num_queued_.load() > 0; });
+
+    num_parked_.fetch_sub(1);
+
+    return !quit_;
+}
 
-        unique.wake = false;
-        lock.unlock();
-        unique.done_signal.notify_one();
+void Pool::wake(uint32_t num_tasks) {
+    if (0 == num_parked_.load()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(park_mutex_);
+
+    if (1 == num_tasks) {
+        park_signal_.notify_one();
+    } else {
+        park_signal_.notify_all();
     }
 }
 
-void Pool::async_loop(Async& async) {
-    for (;;) {
-        std::unique_lock<std::mutex> lock(async.mutex);
-        async.wake_signal.wait(lock, [&async]() { return async.wake; });
+void Pool::loop(uint32_t id) {
+    Current_pool = this;
+    Current_id   = id;
+
+    for (uint32_t spin = 0;;) {
+        if (Task task; pop(id, nullptr, task)) {
+            execute(task);
+            spin = 0;
+            continue;
+        }
 
-        if (async.quit) {
-            break;
+        if (quit_) {
+            return;
+        }
+
+        if (++spin < Spin_count) {
+            std::this_thread::yield();
+            continue;
         }
 
-        async.program();
+        spin = 0;
 
-        async.wake = false;
-        lock.unlock();
-        async.done_signal.notify_one();
+        if (!park()) {
+            return;
+        }
     }
 }
 
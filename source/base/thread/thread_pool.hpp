@@ -1,18 +1,19 @@
 #ifndef SU_BASE_THREAD_POOL_HPP
 #define SU_BASE_THREAD_POOL_HPP
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <thread>
 
-// #define GRANULAR_TASKS
-
-#ifdef GRANULAR_TASKS
-#include "task_queue.hpp"
-#endif
-
 namespace thread {
 
+// Work-stealing pool: every worker owns a deque it pushes to and pops from at the back, while
+// idle workers steal from the front of the other deques. Programs submitted from a worker
+// (nested fork-join) are pushed to its own deque, and the worker helps with them while waiting.
+// Programs submitted from an outside thread go through a shared queue and the caller blocks.
 class Pool {
   public:
     using Parallel_program = std::function<void(uint32_t)>;
@@ -25,12 +26,21 @@ class Pool {
 
     uint32_t num_threads() const;
 
+    // True if called from inside a run_parallel() or run_range() program of this pool.
     bool is_running_parallel() const;
 
+    // The program is called num_tasks times, with unique ids in [0, num_tasks).
     void run_parallel(Parallel_program&& program, uint32_t num_tasks_hint = 0);
 
-    void run_range(Range_program&& program, int32_t begin, int32_t end);
+    // [begin, end) is split into chunks of at most item_size_hint elements, or several chunks
+    // per thread if no hint is given. The chunks are dealt out in turn to at most num_threads()
+    // ids, and each id runs its chunks one after the other in ascending order, on whichever
+    // thread picks it up. Per-id results must be accumulated, and they only depend on the range
+    // and the number of threads, never on timing.
+    void run_range(Range_program&& program, int32_t begin, int32_t end,
+                   int32_t item_size_hint = 0);
 
+    // Async programs run concurrently with each other and with everything else in the pool.
     void run_async(Async_program&& program);
 
     void wait_async();
@@ -38,67 +48,62 @@ class Pool {
     static uint32_t num_threads(int32_t request);
 
   private:
-    void wake_all(uint32_t num_tasks);
-    void wake_all(int32_t begin, int32_t end);
+    struct Job;
 
-    void wake_async();
-
-    void wait_all(uint32_t num_tasks);
-
-    struct Unique {
-        int32_t begin = 0;
-        int32_t end   = 0;
+    struct Task {
+        Job* job;
 
-        std::condition_variable wake_signal;
-        std::condition_variable done_signal;
+        int32_t begin;
+        int32_t end;
+    };
 
+    struct alignas(64) Queue {
         std::mutex mutex;
 
-        bool wake = false;
+        std::deque<Task> tasks;
     };
 
-    struct Async {
-        Async_program program;
+    void submit(Job& job, int32_t num_tasks);
 
-        std::condition_variable wake_signal;
-        std::condition_variable done_signal;
+    void push(Queue& queue, Task const& task);
 
-        std::mutex mutex;
+    bool pop(uint32_t id, Job const* filter, Task& task);
 
-        bool wake = false;
-        bool quit = false;
-    };
+    static bool pop_back(Queue& queue, Job const* filter, Task& task);
+    static bool pop_front(Queue& queue, Job const* filter, Task& task);
 
-    uint32_t num_threads_;
+    void execute(Task const& task);
 
-    bool quit_ = false;
+    void finish(Job& job);
 
-    bool running_parallel_ = false;
+    void wait(Job& job);
 
-    Parallel_program parallel_program_;
+    bool park();
 
-    Range_program range_program_;
+    void wake(uint32_t num_tasks);
 
-    Unique* uniques_;
+    void loop(uint32_t id);
 
-    std::thread* threads_;
+    uint32_t num_threads_;
 
-    struct Task {
-        int32_t begin;
-        int32_t end;
-    };
+    std::atomic<bool> quit_ = false;
 
-#ifdef GRANULAR_TASKS
-    Task_queue<Task> tasks_;
-#endif
+    std::atomic<uint32_t> num_queued_ = 0;
+    std::atomic<uint32_t> num_parked_ = 0;
 
-    Async async_;
+    std::mutex              park_mutex_;
+    std::condition_variable park_signal_;
 
-    std::thread async_thread_;
+    uint32_t num_async_ = 0;
 
-    void loop(uint32_t id);
+    std::mutex              async_mutex_;
+    std::condition_variable async_signal_;
 
-    static void async_loop(Async& async);
+    Queue shared_;
+
+    Queue* queues_;
+
+    std::thread* threads_;
 };
 
 }  // namespace thread
@@ -575,6 +575,7 @@ int32_t su_render() {
 
     engine->driver.render(0);
     engine->driver.export_frame(0, engine->take.exporters);
+    engine->driver.wait_export();
 
     return 0;
 }
@@ -599,6 +600,7 @@ int32_t su_export_frame(uint32_t frame) {
     ASSERT_ENGINE(-1)
 
     engine->driver.export_frame(frame, engine->take.exporters);
+    engine->driver.wait_export();
 
     return 0;
 }
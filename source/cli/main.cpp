@@ -10,6 +10,7 @@
 #include "core/image/image_provider.hpp"
 #include "core/image/texture/texture.hpp"
 #include "core/image/texture/texture_provider.hpp"
+#include "core/image/tiled_image.hpp"
 #include "core/logging/log_std_out.hpp"
 #include "core/logging/logging.hpp"
 #include "core/progress/progress_sink_std_out.hpp"
@@ -33,12 +34,17 @@
 #include "core/scene/material/material_sample_cache.hpp"
 #endif
 
+#include <cmath>
+#include <csignal>
+
 //#include "core/scene/material/substitute/substitute_test.hpp"
 //#include "core/scene/material/glass/glass_test.hpp"
+//#include "core/testing/testing_bvh.hpp"
 //#include "core/testing/testing_cdf.hpp"
 //#include "core/testing/testing_simd.hpp"
 //#include "core/testing/testing_size.hpp"
 //#include "core/testing/testing_spectrum.hpp"
+//#include "core/testing/testing_threads.hpp"
 //#include "core/testing/testing_vector.hpp"
 //#include "core/sampler/sampler_test.hpp"
 //#include "core/scene/material/ggx/ggx_integrate.hpp"
@@ -46,9 +52,20 @@
 
 using namespace scene;
 
+static volatile std::sig_atomic_t Interrupted = 0;
+
+static void interrupt(int /*signal*/) {
+    Interrupted = 1;
+}
+
 static bool load_take_and_scene(std::string const& take_string, scene::Loader& scene_loader,
-                                resource::Manager& resources, uint32_t frame, take::Take& take,
-                                Scene& scene);
+                                resource::Manager& resources, uint32_t frame, bool progressive,
+                                take::Take& take, Scene& scene);
+
+static bool render_progressive(rendering::Driver& driver, take::Take& take, uint32_t frame,
+                               options::Options const& args);
+
+static void log_texture_cache();
 
 static bool reload_frame_dependant(scene::Loader& scene_loader, resource::Manager& resources,
                                    uint32_t frame, take::Take& take, Scene& scene);
@@ -67,8 +84,13 @@ int main(int argc, char* argv[]) {
     //	testing::simd::unions();
     //	testing::simd::basis();
     //	testing::spectrum();
+    //  testing::threads::dispatch();
+    //  testing::threads::scaling();
     //  testing::vector();
     //	testing::cdf::test_1D();
+    //  testing::cdf::test_2D();
+    //  testing::bvh::traversal();
+    //  testing::bvh::spatial_splits();
     //  sampler::testing::test();
 
     //  scene::material::ggx::integrate();
@@ -105,12 +127,17 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    image::Tiled_image::set_cache_budget(uint64_t(args.tex_cache) << 20);
+
     image::Provider image_provider;
     auto const&     image_resources = resources.register_provider(image_provider);
 
     shape::triangle::Provider mesh_provider;
     auto const&               shape_resources = resources.register_provider(mesh_provider);
 
+    mesh_provider.set_bvh_cache(args.bvh_cache);
+    mesh_provider.set_spatial_split_budget(args.spatial_splits);
+
     material::Provider material_provider(args.no_tex, args.no_tex_dwim, args.debug_material);
     auto const&        material_resources = resources.register_provider(material_provider);
 
@@ -130,6 +157,19 @@ int main(int argc, char* argv[]) {
     progress::Std_out progressor;
     rendering::Driver driver(threads, progressor);
 
+    bool const progressive = args.time_budget > 0.f || args.iterations > 0;
+
+    if (args.num_splits > 1 && (!progressive || args.checkpoint.empty())) {
+        logging::error("Splitting a frame requires progressive rendering and a checkpoint.");
+        return 1;
+    }
+
+    if (progressive) {
+        // Stop cleanly, e.g. when the job is preempted
+        std::signal(SIGINT, interrupt);
+        std::signal(SIGTERM, interrupt);
+    }
+
     for (;;) {
         take.clear();
         scene.clear();
@@ -138,14 +178,20 @@ int main(int argc, char* argv[]) {
 
         auto const loading_start = std::chrono::high_resolution_clock::now();
 
-        if (load_take_and_scene(args.take, scene_loader, resources, args.start_frame, take,
-                                scene)) {
+        if (load_take_and_scene(args.take, scene_loader, resources, args.start_frame,
+                                progressive, take, scene)) {
             logging::info("Loading time %f s", chrono::seconds_since(loading_start));
             logging::info("Rendering...");
 
             auto const rendering_start = std::chrono::high_resolution_clock::now();
 
-            driver.init(take.view, scene, false);
+            driver.init(take.view, scene, progressive);
+
+            driver.set_split(args.split_index, args.num_splits);
+
+            if (args.iterations > 0) {
+                take.view.camera->set_sample_spacing(1.f / std::sqrt(float(args.iterations)));
+            }
 
             for (uint32_t f = args.start_frame, end = args.start_frame + args.num_frames; f < end;
                  ++f) {
@@ -153,15 +199,25 @@ int main(int argc, char* argv[]) {
                     continue;
                 }
 
-                driver.render(f);
-                driver.export_frame(f, take.exporters);
+                if (progressive) {
+                    if (!render_progressive(driver, take, f, args)) {
+                        break;
+                    }
+                } else {
+                    driver.render(f);
+                    driver.export_frame(f, take.exporters);
+                }
             }
 
+            driver.wait_export();
+
             logging::info("Total render time %f s", chrono::seconds_since(rendering_start));
             logging::info("Total elapsed time %f s", chrono::seconds_since(loading_start));
+
+            log_texture_cache();
         }
 
-        if (args.quit) {
+        if (args.quit || Interrupted) {
             break;
         }
 
@@ -185,8 +241,8 @@ int main(int argc, char* argv[]) {
 }
 
 static bool load_take_and_scene(std::string const& take_string, scene::Loader& scene_loader,
-                                resource::Manager& resources, uint32_t frame, take::Take& take,
-                                Scene& scene) {
+                                resource::Manager& resources, uint32_t frame, bool progressive,
+                                take::Take& take, Scene& scene) {
     file::System& filesystem = resources.filesystem();
 
     filesystem.set_frame(frame);
@@ -196,7 +252,7 @@ static bool load_take_and_scene(std::string const& take_string, scene::Loader& s
     auto stream = is_json ? filesystem.string_stream(take_string)
                           : filesystem.read_stream(take_string, take.resolved_name);
 
-    if (!stream || !take::Loader::load(take, *stream, false, scene, resources)) {
+    if (!stream || !take::Loader::load(take, *stream, progressive, scene, resources)) {
         logging::error("Loading take %S: ", take_string);
         return false;
     }
@@ -242,3 +298,110 @@ static bool reload_frame_dependant(scene::Loader& scene_loader, resource::Manage
 
     return true;
 }
+
+static bool render_progressive(rendering::Driver& driver, take::Take& take, uint32_t frame,
+                               options::Options const& args) {
+    logging::info("Frame " + string::to_string(frame));
+
+    driver.start_frame(frame);
+
+    bool const split = args.num_splits > 1;
+
+    std::string checkpoint;
+
+    if (!args.checkpoint.empty()) {
+        checkpoint = args.checkpoint + "_" + string::to_string(frame, 6);
+
+        if (split) {
+            checkpoint += '_';
+            checkpoint += string::to_string(args.split_index);
+        }
+    }
+
+    // The share of this process of the iterations split_index, split_index + num_splits, ...
+    uint32_t num_iterations = args.iterations;
+
+    if (split && num_iterations > 0) {
+        num_iterations = args.split_index < num_iterations
+                             ? (num_iterations - args.split_index + args.num_splits - 1) /
+                                   args.num_splits
+                             : 0;
+
+        if (0 == num_iterations) {
+            logging::info("Nothing to render for split " + string::to_string(args.split_index));
+        }
+    }
+
+    uint32_t iteration = 0;
+    float    previous  = 0.f;
+
+    if (!checkpoint.empty() && driver.read_checkpoint(checkpoint, frame, iteration, previous)) {
+        logging::info("Resuming from " + checkpoint + " after " + string::to_string(iteration) +
+                      " iterations");
+    }
+
+    auto const start = std::chrono::high_resolution_clock::now();
+
+    auto last_checkpoint = start;
+
+    for (;;) {
+        float const seconds = previous + chrono::seconds_since(start);
+
+        if (Interrupted || (args.iterations > 0 && iteration >= num_iterations) ||
+            (args.time_budget > 0.f && seconds >= args.time_budget)) {
+            break;
+        }
+
+        driver.render(frame, iteration);
+
+        ++iteration;
+
+        if (!checkpoint.empty() &&
+            chrono::seconds_since(last_checkpoint) >= args.checkpoint_interval) {
+            driver.write_checkpoint(checkpoint, frame, iteration,
+                                    previous + chrono::seconds_since(start));
+
+            last_checkpoint = std::chrono::high_resolution_clock::now();
+        }
+    }
+
+    if (!checkpoint.empty()) {
+        driver.write_checkpoint(checkpoint, frame, iteration,
+                                previous + chrono::seconds_since(start));
+    }
+
+    logging::info(string::to_string(iteration) + " iterations in " +
+                  string::to_string(previous + chrono::seconds_since(start)) + " s");
+
+    if (Interrupted) {
+        logging::info("Interrupted");
+    }
+
+    if (split) {
+        // All parts would be exported to the same file, so leave that to "it --merge"
+        logging::info("Stored split " + string::to_string(args.split_index) + " in " +
+                      checkpoint);
+    } else {
+        driver.postprocess();
+        driver.export_frame(frame, take.exporters);
+    }
+
+    return !Interrupted;
+}
+
+static void log_texture_cache() {
+    auto const s = image::Tiled_image::cache_statistics();
+
+    if (0 == s.num_lookups) {
+        return;
+    }
+
+    float const hit_rate = 100.f * float(s.num_lookups - s.num_misses) / float(s.num_lookups);
+
+    logging::info("Texture cache: " + string::to_string(s.num_lookups) + " lookups, " +
+                  string::to_string(s.num_misses) + " misses (" + string::to_string(hit_rate) +
+                  " % hits), " + string::to_string(s.num_evictions) + " evictions");
+
+    logging::info("Texture cache: " + string::print_bytes(s.num_bytes) + " resident, " +
+                  string::print_bytes(s.max_bytes) + " peak");
+}
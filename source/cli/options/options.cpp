@@ -74,6 +74,37 @@ bool handle(std::string const& command, std::string const& parameter, Options& r
         std::from_chars(parameter.data(), parameter.data() + parameter.size(), result.threads);
     } else if ("quit" == command || "q" == command) {
         result.quit = true;
+    } else if ("bvh-cache" == command) {
+        result.bvh_cache = parameter;
+    } else if ("spatial-splits" == command) {
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(),
+                        result.spatial_splits);
+    } else if ("time" == command) {
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(), result.time_budget);
+    } else if ("iterations" == command) {
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(), result.iterations);
+    } else if ("checkpoint" == command) {
+        result.checkpoint = parameter;
+    } else if ("checkpoint-interval" == command) {
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(),
+                        result.checkpoint_interval);
+    } else if ("split" == command) {
+        char const* const end = parameter.data() + parameter.size();
+
+        auto const [index_end, error] = std::from_chars(parameter.data(), end, result.split_index);
+
+        if (std::errc() == error && index_end < end && '/' == *index_end) {
+            std::from_chars(index_end + 1, end, result.num_splits);
+        }
+
+        if (0 == result.num_splits || result.split_index >= result.num_splits) {
+            logging::warning("Split %S is invalid.", parameter);
+
+            result.split_index = 0;
+            result.num_splits  = 1;
+        }
+    } else if ("tex-cache" == command) {
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(), result.tex_cache);
     } else if ("no-tex" == command) {
         result.no_tex = true;
     } else if ("no-tex-dwim" == command) {
@@ -128,6 +159,36 @@ Usage:
                                  logical CPUs minus x.
                                  The default value is 0.
   -q, --quit                     Automatically quit sprout after rendering.
+      --time        float        Render each frame progressively,
+                                 for the given number of seconds.
+      --iterations  int          Render each frame progressively,
+                                 with the given number of samples per pixel.
+      --checkpoint  path         Periodically store the progress of the frames,
+                                 as path_<frame>, and resume from there if the
+                                 file already exists.
+                                 Only used for progressive rendering.
+      --checkpoint-interval float
+                                 Seconds between checkpoints.
+                                 The default value is 600.
+      --split       int/int      Only render the part index/count of the
+                                 iterations of each frame, e.g. 0/4 renders
+                                 iterations 0, 4, 8...
+                                 The raw result is stored as the checkpoint
+                                 path_<frame>_<index> instead of being exported,
+                                 so that "it --merge" can combine the parts.
+                                 Requires --checkpoint.
+      --bvh-cache   path         Directory for storing and reusing the BVHs
+                                 of binary meshes.
+      --spatial-splits float     Lets the mesh BVH builder clip triangles at
+                                 spatial splits, which helps with long thin
+                                 triangles. The value limits the added
+                                 references to this fraction of the number
+                                 of triangles, e.g. 0.3.
+                                 0 disables it, which is the default.
+      --tex-cache   int          Memory budget in MiB for the tiles of images
+                                 that are loaded on demand.
+                                 0 means no limit.
+                                 The default value is 2048.
       --no-tex                   Disables loading of all textures.
       --no-tex-dwim              Disables loading of most textures.)";
 
@@ -12,8 +12,28 @@ struct Options {
 
     std::vector<std::string> mounts;
 
+    std::string bvh_cache;
+
+    // Fraction of the number of triangles that spatial splits may add as references
+    float spatial_splits = 0.f;
+
     int32_t threads = 0;
 
+    // MiB
+    uint32_t tex_cache = 2048;
+
+    // Either budget renders the frames progressively, until the first one of them is reached
+    float    time_budget = 0.f;
+    uint32_t iterations  = 0;
+
+    std::string checkpoint;
+
+    float checkpoint_interval = 600.f;
+
+    // Only render every num_splits-th iteration, starting at split_index
+    uint32_t split_index = 0;
+    uint32_t num_splits  = 1;
+
     uint32_t start_frame = 0;
     uint32_t num_frames  = 1;
 
@@ -0,0 +1,145 @@
+#include "file_mapping.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace file {
+
+#ifdef _WIN32
+Mapping::Mapping() : data_(nullptr), size_(0), file_(nullptr), mapping_(nullptr) {}
+
+Mapping::Mapping(Mapping&& other) noexcept
+    : data_(other.data_), size_(other.size_), file_(other.file_), mapping_(other.mapping_) {
+    other.data_    = nullptr;
+    other.size_    = 0;
+    other.file_    = nullptr;
+    other.mapping_ = nullptr;
+}
+#else
+Mapping::Mapping() : data_(nullptr), size_(0) {}
+
+Mapping::Mapping(Mapping&& other) noexcept : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+#endif
+
+Mapping::~Mapping() {
+    close();
+}
+
+void Mapping::operator=(Mapping&& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+
+#ifdef _WIN32
+    std::swap(file_, other.file_);
+    std::swap(mapping_, other.mapping_);
+#endif
+}
+
+bool Mapping::open(std::string const& name) {
+    close();
+
+#ifdef _WIN32
+    HANDLE const file = CreateFileA(name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || 0 == size.QuadPart) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* const data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    data_    = static_cast<char*>(data);
+    size_    = uint64_t(size.QuadPart);
+    file_    = file;
+    mapping_ = mapping;
+#else
+    int const file = ::open(name.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) < 0 || 0 == info.st_size) {
+        ::close(file);
+        return false;
+    }
+
+    size_t const size = size_t(info.st_size);
+
+    void* const data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(file);
+
+    if (MAP_FAILED == data) {
+        return false;
+    }
+
+    data_ = static_cast<char*>(data);
+    size_ = uint64_t(size);
+#endif
+
+    return true;
+}
+
+void Mapping::close() {
+    if (!data_) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+
+    file_    = nullptr;
+    mapping_ = nullptr;
+#else
+    munmap(data_, size_);
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool Mapping::is_open() const {
+    return nullptr != data_;
+}
+
+char* Mapping::data() const {
+    return data_;
+}
+
+uint64_t Mapping::size() const {
+    return size_;
+}
+
+}  // namespace file
@@ -0,0 +1,44 @@
+#ifndef SU_CORE_FILE_MAPPING_HPP
+#define SU_CORE_FILE_MAPPING_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace file {
+
+// Private (copy-on-write) memory mapping of a whole file.
+// Writes through data() never reach the file.
+class Mapping {
+  public:
+    Mapping();
+
+    Mapping(Mapping&& other) noexcept;
+
+    ~Mapping();
+
+    void operator=(Mapping&& other) noexcept;
+
+    bool open(std::string const& name);
+
+    void close();
+
+    bool is_open() const;
+
+    char* data() const;
+
+    uint64_t size() const;
+
+  private:
+    char* data_;
+
+    uint64_t size_;
+
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#endif
+};
+
+}  // namespace file
+
+#endif
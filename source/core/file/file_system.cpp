@@ -6,11 +6,13 @@
 
 namespace file {
 
-System::Stream_ptr::Stream_ptr(System& system, Type type) : system_(system), type_(type) {}
+System::Stream_ptr::Stream_ptr(System& system, Stream* stream, Type type)
+    : system_(system), stream_(stream), type_(type) {}
 
 System::Stream_ptr::Stream_ptr(Stream_ptr&& other) noexcept
-    : system_(other.system_), type_(other.type_) {
-    other.type_ = Type::Invalid;
+    : system_(other.system_), stream_(other.stream_), type_(other.type_) {
+    other.stream_ = nullptr;
+    other.type_   = Type::Invalid;
 }
 
 System::Stream_ptr::~Stream_ptr() {
@@ -29,18 +31,46 @@ std::istream& System::Stream_ptr::operator*() const {
     return system_.stream(*this);
 }
 
+System::Stream_ptr::Type System::Stream_ptr::type() const {
+    return type_;
+}
+
 void System::Stream_ptr::close() {
     if (Type::Invalid != type_) {
         system_.close(*this);
     }
 }
 
-System::System()
-    : read_buffer_size_(0), buffer_size_(0), read_buffer_(nullptr), buffer_(nullptr), frame_(0) {}
+System::Stream::Stream()
+    : read_buffer_size(0), buffer_size(0), read_buffer(nullptr), buffer(nullptr) {}
+
+System::Stream::~Stream() {
+    delete[] read_buffer;
+    delete[] buffer;
+}
+
+void System::Stream::allocate_buffers(uint32_t read_size, uint32_t size) {
+    if (read_size > read_buffer_size) {
+        delete[] read_buffer;
+
+        read_buffer_size = read_size;
+        read_buffer      = new char[read_size];
+    }
+
+    if (size > buffer_size) {
+        delete[] buffer;
+
+        buffer_size = size;
+        buffer      = new char[size];
+    }
+}
+
+System::System() : frame_(0) {}
 
 System::~System() {
-    delete[] read_buffer_;
-    delete[] buffer_;
+    for (auto s : streams_) {
+        delete s;
+    }
 }
 
 System::Stream_ptr System::read_stream(std::string_view name) {
@@ -49,65 +79,78 @@ System::Stream_ptr System::read_stream(std::string_view name) {
 }
 
 System::Stream_ptr System::read_stream(std::string_view name, std::string& resolved_name) {
-    auto& stream = open_read_stream(name, resolved_name);
+    Stream* s = acquire_stream();
+
+    auto& stream = open_read_stream(*s, name, resolved_name);
     if (!stream) {
+        release_stream(s);
+
         logging::push_error("Stream %S could not be opened.", std::string(name));
-        return Stream_ptr(*this, Stream_ptr::Type::Invalid);
+        return Stream_ptr(*this, nullptr, Stream_ptr::Type::Invalid);
     }
 
     const Type type = query_type(stream);
 
     if (Type::GZIP == type) {
-        allocate_buffers(gzip::Filebuffer::read_buffer_size(),
-                         gzip::Filebuffer::write_buffer_size());
+        s->allocate_buffers(gzip::Filebuffer::read_buffer_size(),
+                            gzip::Filebuffer::write_buffer_size());
 
-        gzip_stream_.clear();
-        gzip_stream_.open(&stream, read_buffer_size_, read_buffer_, buffer_size_, buffer_);
+        s->gzip_stream.clear();
+        s->gzip_stream.open(&stream, s->read_buffer_size, s->read_buffer, s->buffer_size,
+                            s->buffer);
 
-        return Stream_ptr(*this, Stream_ptr::Type::GZIP);
+        return Stream_ptr(*this, s, Stream_ptr::Type::GZIP);
     }
 
     if (Type::ZSTD == type) {
 #ifdef SU_ZSTD
-        allocate_buffers(zstd::Filebuffer::read_buffer_size(),
-                         zstd::Filebuffer::write_buffer_size());
+        s->allocate_buffers(zstd::Filebuffer::read_buffer_size(),
+                            zstd::Filebuffer::write_buffer_size());
 
-        zstd_stream_.clear();
-        zstd_stream_.open(&stream, read_buffer_size_, read_buffer_, buffer_size_, buffer_);
+        s->zstd_stream.clear();
+        s->zstd_stream.open(&stream, s->read_buffer_size, s->read_buffer, s->buffer_size,
+                            s->buffer);
 
-        return Stream_ptr(*this, Stream_ptr::Type::ZSTD);
+        return Stream_ptr(*this, s, Stream_ptr::Type::ZSTD);
 #else
+        s->file_stream.close();
+        release_stream(s);
+
         logging::push_error("ZSTD compression is not supported.");
-        return Stream_ptr(*this, Stream_ptr::Type::Invalid);
+        return Stream_ptr(*this, nullptr, Stream_ptr::Type::Invalid);
 #endif
     }
 
-    return Stream_ptr(*this, Stream_ptr::Type::Uncompressed);
+    return Stream_ptr(*this, s, Stream_ptr::Type::Uncompressed);
 }
 
 System::Stream_ptr System::string_stream(std::string const& string) {
-    str_stream_.clear();
-    str_stream_.str(string);
+    Stream* s = acquire_stream();
+
+    s->str_stream.clear();
+    s->str_stream.str(string);
 
-    return Stream_ptr(*this, Stream_ptr::Type::String);
+    return Stream_ptr(*this, s, Stream_ptr::Type::String);
 }
 
 std::istream& System::stream(Stream_ptr const& ptr) {
+    Stream& s = *ptr.stream_;
+
     if (Stream_ptr::Type::GZIP == ptr.type_) {
-        return gzip_stream_;
+        return s.gzip_stream;
     }
 
 #ifdef SU_ZSTD
     if (Stream_ptr::Type::ZSTD == ptr.type_) {
-        return zstd_stream_;
+        return s.zstd_stream;
     }
 #endif
 
     if (Stream_ptr::Type::String == ptr.type_) {
-        return str_stream_;
+        return s.str_stream;
     }
 
-    return stream_;
+    return s.file_stream;
 }
 
 void System::close(Stream_ptr& stream) {
@@ -115,21 +158,26 @@ void System::close(Stream_ptr& stream) {
         return;
     }
 
+    Stream& s = *stream.stream_;
+
     if (Stream_ptr::Type::Uncompressed == stream.type_) {
-        stream_.close();
+        s.file_stream.close();
     } else if (Stream_ptr::Type::GZIP == stream.type_) {
-        gzip_stream_.close();
-        stream_.close();
+        s.gzip_stream.close();
+        s.file_stream.close();
     } else if (Stream_ptr::Type::ZSTD == stream.type_) {
 #ifdef SU_ZSTD
-        zstd_stream_.close();
-        stream_.close();
+        s.zstd_stream.close();
+        s.file_stream.close();
 #endif
     } else if (Stream_ptr::Type::String == stream.type_) {
-        str_stream_.str(std::string());
+        s.str_stream.str(std::string());
     }
 
-    stream.type_ = Stream_ptr::Type::Invalid;
+    release_stream(stream.stream_);
+
+    stream.stream_ = nullptr;
+    stream.type_   = Stream_ptr::Type::Invalid;
 }
 
 void System::push_mount(std::string_view folder) {
@@ -164,55 +212,66 @@ bool System::frame_dependant_name(std::string_view name) {
     return name.find(FRAME_MARKER) != std::string::npos;
 }
 
-std::istream& System::open_read_stream(std::string_view name, std::string& resolved_name) {
+System::Stream* System::acquire_stream() {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+
+    if (free_streams_.empty()) {
+        Stream* s = new Stream;
+
+        streams_.push_back(s);
+
+        return s;
+    }
+
+    Stream* s = free_streams_.back();
+
+    free_streams_.pop_back();
+
+    return s;
+}
+
+void System::release_stream(Stream* stream) {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+
+    free_streams_.push_back(stream);
+}
+
+std::istream& System::open_read_stream(Stream& s, std::string_view name,
+                                       std::string& resolved_name) const {
     std::string modified_name = std::string(name);
 
     if (size_t const pos = modified_name.find(FRAME_MARKER); std::string::npos != pos) {
         modified_name.replace(pos, 7, frame_string_);
     }
 
+    auto& stream = s.file_stream;
+
     for (auto const& f : mount_folders_) {
         // Ignore empty folders, because this is handled explicitely
         if (f.empty()) {
             continue;
         }
 
-        stream_.close();
-        stream_.clear();
+        stream.close();
+        stream.clear();
 
         resolved_name = f + modified_name;
-        stream_.open(resolved_name, std::ios::binary);
-        if (stream_) {
-            return stream_;
+        stream.open(resolved_name, std::ios::binary);
+        if (stream) {
+            return stream;
         }
     }
 
-    stream_.close();
-    stream_.clear();
+    stream.close();
+    stream.clear();
 
-    stream_.open(modified_name, std::ios::binary);
-    if (stream_) {
+    stream.open(modified_name, std::ios::binary);
+    if (stream) {
         resolved_name = modified_name;
-        return stream_;
-    }
-
-    return stream_;
-}
-
-void System::allocate_buffers(uint32_t read_size, uint32_t size) {
-    if (read_size > read_buffer_size_) {
-        delete[] read_buffer_;
-
-        read_buffer_size_ = read_size;
-        read_buffer_      = new char[read_size];
+        return stream;
     }
 
-    if (size > buffer_size_) {
-        delete[] buffer_;
-
-        buffer_size_ = size;
-        buffer_      = new char[size];
-    }
+    return stream;
 }
 
 }  // namespace file
@@ -9,13 +9,19 @@
 #endif
 
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <vector>
 
 namespace file {
 
+// Streams come from a pool, so that several threads can read files at the same time.
+// The mount folders and the frame must not change while other threads are reading.
 class System {
+  private:
+    struct Stream;
+
   public:
     class Stream_ptr {
       public:
@@ -23,7 +29,7 @@ class System {
 
         enum class Type { Uncompressed, GZIP, ZSTD, String, Invalid };
 
-        Stream_ptr(System& system, Type type);
+        Stream_ptr(System& system, Stream* stream, Type type);
 
         Stream_ptr(Stream_ptr&& other) noexcept;
 
@@ -35,11 +41,15 @@ class System {
 
         std::istream& operator*() const;
 
+        Type type() const;
+
         void close();
 
       private:
         System& system_;
 
+        Stream* stream_;
+
         Type type_;
     };
 
@@ -68,25 +78,42 @@ class System {
     static bool frame_dependant_name(std::string_view name);
 
   private:
-    std::istream& open_read_stream(std::string_view name, std::string& resolved_name);
+    struct Stream {
+        Stream();
+
+        ~Stream();
 
-    void allocate_buffers(uint32_t read_size, uint32_t size);
+        void allocate_buffers(uint32_t read_size, uint32_t size);
 
-    std::ifstream stream_;
+        std::ifstream file_stream;
 
-    Read_stream<gzip::Filebuffer> gzip_stream_;
+        Read_stream<gzip::Filebuffer> gzip_stream;
 
 #ifdef SU_ZSTD
-    Read_stream<zstd::Filebuffer> zstd_stream_;
+        Read_stream<zstd::Filebuffer> zstd_stream;
 #endif
 
-    std::istringstream str_stream_;
+        std::istringstream str_stream;
+
+        uint32_t read_buffer_size;
+        uint32_t buffer_size;
+
+        char* read_buffer;
+        char* buffer;
+    };
+
+    Stream* acquire_stream();
+
+    void release_stream(Stream* stream);
+
+    std::istream& open_read_stream(Stream& stream, std::string_view name,
+                                   std::string& resolved_name) const;
 
-    uint32_t read_buffer_size_;
-    uint32_t buffer_size_;
+    std::mutex streams_mutex_;
 
-    char* read_buffer_;
-    char* buffer_;
+    // All streams ever created, and the ones currently not in use
+    std::vector<Stream*> streams_;
+    std::vector<Stream*> free_streams_;
 
     std::vector<std::string> mount_folders_;
 
@@ -0,0 +1,566 @@
+#include "exr_piz.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Based on
+// https://github.com/AcademySoftwareFoundation/openexr/blob/main/src/lib/OpenEXR/ImfPizCompressor.cpp
+// https://github.com/AcademySoftwareFoundation/openexr/blob/main/src/lib/OpenEXR/ImfHuf.cpp
+// https://github.com/AcademySoftwareFoundation/openexr/blob/main/src/lib/OpenEXR/ImfWav.cpp
+
+namespace image::encoding::exr {
+
+static uint32_t constexpr Ushort_range = 1 << 16;
+static uint32_t constexpr Bitmap_size  = Ushort_range >> 3;
+
+static uint32_t constexpr Encoding_bits = 16;
+static uint32_t constexpr Encoding_size = (1 << Encoding_bits) + 1;
+
+static uint32_t constexpr Decoder_bits = 14;
+static uint32_t constexpr Decoder_size = 1 << Decoder_bits;
+static uint32_t constexpr Decoder_mask = Decoder_size - 1;
+
+static uint32_t constexpr Short_zero_run    = 59;
+static uint32_t constexpr Long_zero_run     = 63;
+static uint32_t constexpr Shortest_long_run = 2 + Long_zero_run - Short_zero_run;
+
+static uint16_t reverse_lut(uint8_t const* bitmap, uint16_t* lut);
+
+static void wav2_decode(uint16_t* in, int32_t nx, int32_t ox, int32_t ny, int32_t oy,
+                        uint16_t mx);
+
+static inline uint32_t read_uint(uint8_t const* source) {
+    uint32_t v;
+    std::memcpy(&v, source, sizeof(uint32_t));
+    return v;
+}
+
+static inline uint16_t read_ushort(uint8_t const* source) {
+    uint16_t v;
+    std::memcpy(&v, source, sizeof(uint16_t));
+    return v;
+}
+
+Piz::Piz()
+    : codes_(new uint64_t[Encoding_size]),
+      decoders_(new Decoder[Decoder_size]),
+      long_symbols_(new uint32_t[Encoding_size]),
+      lut_(new uint16_t[Ushort_range]) {}
+
+Piz::~Piz() {
+    delete[] buffer_;
+    delete[] lut_;
+    delete[] long_symbols_;
+    delete[] decoders_;
+    delete[] codes_;
+}
+
+bool Piz::decompress(uint8_t const* source, uint32_t source_size, int32_t width, int32_t num_rows,
+                     int32_t num_channels, int32_t scalar_size, uint8_t* destination) {
+    // Wider scalars are coded as several independent 16 bit values
+    int32_t const num_parts = scalar_size / 2;
+
+    int32_t const row_values   = width * num_parts;
+    int32_t const plane_values = row_values * num_rows;
+
+    uint32_t const num_values = uint32_t(plane_values * num_channels);
+
+    if (buffer_size_ < num_values) {
+        delete[] buffer_;
+
+        buffer_ = new uint16_t[num_values];
+
+        buffer_size_ = num_values;
+    }
+
+    uint8_t const* const end = source + source_size;
+
+    if (source_size < 4) {
+        return false;
+    }
+
+    uint16_t const min_non_zero = read_ushort(source);
+    uint16_t const max_non_zero = read_ushort(source + 2);
+
+    source += 4;
+
+    if (max_non_zero >= Bitmap_size) {
+        return false;
+    }
+
+    uint8_t bitmap[Bitmap_size];
+    std::memset(bitmap, 0, Bitmap_size);
+
+    if (min_non_zero <= max_non_zero) {
+        uint32_t const num_bytes = uint32_t(max_non_zero - min_non_zero) + 1;
+
+        if (uint32_t(end - source) < num_bytes) {
+            return false;
+        }
+
+        std::memcpy(bitmap + min_non_zero, source, num_bytes);
+
+        source += num_bytes;
+    }
+
+    uint16_t const max_value = reverse_lut(bitmap, lut_);
+
+    if (end - source < 4) {
+        return false;
+    }
+
+    uint32_t const length = read_uint(source);
+
+    source += 4;
+
+    if (length > uint32_t(end - source)) {
+        return false;
+    }
+
+    if (!huffman_decompress(source, length, buffer_, num_values)) {
+        return false;
+    }
+
+    for (int32_t c = 0; c < num_channels; ++c) {
+        uint16_t* const plane = buffer_ + c * plane_values;
+
+        for (int32_t p = 0; p < num_parts; ++p) {
+            wav2_decode(plane + p, width, num_parts, num_rows, row_values, max_value);
+        }
+    }
+
+    for (uint32_t i = 0; i < num_values; ++i) {
+        buffer_[i] = lut_[buffer_[i]];
+    }
+
+    // The planes hold the channels of all rows, while the scanlines alternate between channels
+    uint32_t const row_bytes = uint32_t(row_values) * sizeof(uint16_t);
+
+    for (int32_t y = 0; y < num_rows; ++y) {
+        for (int32_t c = 0; c < num_channels; ++c, destination += row_bytes) {
+            std::memcpy(destination, buffer_ + c * plane_values + y * row_values, row_bytes);
+        }
+    }
+
+    return true;
+}
+
+bool Piz::huffman_decompress(uint8_t const* source, uint32_t source_size, uint16_t* destination,
+                             uint32_t num_values) {
+    if (0 == source_size) {
+        return 0 == num_values;
+    }
+
+    if (source_size < 20) {
+        return false;
+    }
+
+    uint32_t const min      = read_uint(source);
+    uint32_t const max      = read_uint(source + 4);
+    uint32_t const num_bits = read_uint(source + 12);
+
+    if (min >= Encoding_size || max >= Encoding_size) {
+        return false;
+    }
+
+    uint8_t const* const end = source + source_size;
+
+    source += 20;
+
+    if (!unpack_codes(source, end, min, max)) {
+        return false;
+    }
+
+    if (uint64_t(num_bits) > 8 * uint64_t(end - source)) {
+        return false;
+    }
+
+    if (!build_decoders(min, max)) {
+        return false;
+    }
+
+    return decode(source, num_bits, max, destination, num_values);
+}
+
+bool Piz::unpack_codes(uint8_t const*& source, uint8_t const* end, uint32_t min, uint32_t max) {
+    std::fill(codes_ + min, codes_ + std::max(min, max + 1), 0);
+
+    uint64_t c  = 0;
+    int32_t  lc = 0;
+
+    auto bits = [&c, &lc, &source, end](int32_t n, uint64_t& value) {
+        while (lc < n) {
+            if (source >= end) {
+                return false;
+            }
+
+            c = (c << 8) | uint64_t(*source++);
+            lc += 8;
+        }
+
+        lc -= n;
+
+        value = (c >> lc) & ((uint64_t(1) << n) - 1);
+
+        return true;
+    };
+
+    for (uint32_t i = min; i <= max; ++i) {
+        uint64_t l;
+        if (!bits(6, l)) {
+            return false;
+        }
+
+        codes_[i] = l;
+
+        if (l >= Short_zero_run) {
+            uint32_t run = uint32_t(l) - Short_zero_run + 2;
+
+            if (Long_zero_run == l) {
+                uint64_t r;
+                if (!bits(8, r)) {
+                    return false;
+                }
+
+                run = uint32_t(r) + Shortest_long_run;
+            }
+
+            if (i + run > max + 1) {
+                return false;
+            }
+
+            std::fill_n(codes_ + i, run, 0);
+
+            i += run - 1;
+        }
+    }
+
+    // Canonical codes from the lengths
+    uint64_t n[59];
+    std::fill_n(n, 59, 0);
+
+    for (uint32_t i = min; i <= max; ++i) {
+        n[codes_[i]] += 1;
+    }
+
+    uint64_t code = 0;
+    for (int32_t i = 58; i > 0; --i) {
+        uint64_t const next = (code + n[i]) >> 1;
+
+        n[i] = code;
+        code = next;
+    }
+
+    for (uint32_t i = min; i <= max; ++i) {
+        uint64_t const l = codes_[i];
+
+        if (l > 0) {
+            codes_[i] = l | (n[l]++ << 6);
+        }
+    }
+
+    return true;
+}
+
+bool Piz::build_decoders(uint32_t min, uint32_t max) {
+    std::fill_n(decoders_, Decoder_size, Decoder{0, 0, 0});
+
+    // Short codes fill all entries they are a prefix of, long codes are counted per prefix
+    for (uint32_t i = min; i <= max; ++i) {
+        uint64_t const c = codes_[i] >> 6;
+        uint32_t const l = uint32_t(codes_[i] & 63);
+
+        if (c >> l) {
+            return false;
+        }
+
+        if (l > Decoder_bits) {
+            Decoder& d = decoders_[c >> (l - Decoder_bits)];
+
+            if (d.length) {
+                return false;
+            }
+
+            ++d.literal;
+        } else if (l) {
+            Decoder* d = decoders_ + (c << (Decoder_bits - l));
+
+            for (uint32_t j = 1 << (Decoder_bits - l); j > 0; --j, ++d) {
+                if (d->length || d->literal) {
+                    return false;
+                }
+
+                d->length  = l;
+                d->literal = i;
+            }
+        }
+    }
+
+    uint32_t begin = 0;
+
+    for (uint32_t i = 0; i < Decoder_size; ++i) {
+        Decoder& d = decoders_[i];
+
+        if (0 == d.length) {
+            d.begin = begin;
+            begin += d.literal;
+            d.literal = 0;
+        }
+    }
+
+    for (uint32_t i = min; i <= max; ++i) {
+        uint32_t const l = uint32_t(codes_[i] & 63);
+
+        if (l > Decoder_bits) {
+            Decoder& d = decoders_[(codes_[i] >> 6) >> (l - Decoder_bits)];
+
+            long_symbols_[d.begin + d.literal++] = i;
+        }
+    }
+
+    return true;
+}
+
+bool Piz::decode(uint8_t const* source, uint32_t num_bits, uint32_t run_symbol,
+                 uint16_t* destination, uint32_t num_values) const {
+    uint64_t c  = 0;
+    int32_t  lc = 0;
+
+    uint8_t const* const end = source + (num_bits + 7) / 8;
+
+    uint16_t*       out     = destination;
+    uint16_t* const out_end = destination + num_values;
+
+    auto output = [&c, &lc, &source, end, run_symbol, destination, &out, out_end](
+                      uint32_t symbol) {
+        if (run_symbol == symbol) {
+            if (lc < 8) {
+                if (source >= end) {
+                    return false;
+                }
+
+                c = (c << 8) | uint64_t(*source++);
+                lc += 8;
+            }
+
+            lc -= 8;
+
+            uint32_t const run = uint32_t(uint8_t(c >> lc));
+
+            if (out + run > out_end || out == destination) {
+                return false;
+            }
+
+            std::fill_n(out, run, out[-1]);
+
+            out += run;
+        } else {
+            if (out >= out_end) {
+                return false;
+            }
+
+            *out++ = uint16_t(symbol);
+        }
+
+        return true;
+    };
+
+    while (source < end) {
+        c = (c << 8) | uint64_t(*source++);
+        lc += 8;
+
+        while (lc >= int32_t(Decoder_bits)) {
+            Decoder const& d = decoders_[(c >> (lc - int32_t(Decoder_bits))) & Decoder_mask];
+
+            if (d.length) {
+                lc -= int32_t(d.length);
+
+                if (!output(d.literal)) {
+                    return false;
+                }
+            } else {
+                uint32_t j = 0;
+
+                for (; j < d.literal; ++j) {
+                    uint32_t const symbol = long_symbols_[d.begin + j];
+
+                    uint64_t const code = codes_[symbol];
+
+                    int32_t const l = int32_t(code & 63);
+
+                    while (lc < l && source < end) {
+                        c = (c << 8) | uint64_t(*source++);
+                        lc += 8;
+                    }
+
+                    if (lc >= l && (code >> 6) == ((c >> (lc - l)) & ((uint64_t(1) << l) - 1))) {
+                        lc -= l;
+
+                        if (!output(symbol)) {
+                            return false;
+                        }
+
+                        break;
+                    }
+                }
+
+                if (j == d.literal) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // The remaining short codes, without the padding of the last byte
+    int32_t const padding = int32_t(8 - num_bits) & 7;
+
+    c >>= padding;
+    lc -= padding;
+
+    while (lc > 0) {
+        Decoder const& d = decoders_[(c << (int32_t(Decoder_bits) - lc)) & Decoder_mask];
+
+        if (0 == d.length) {
+            return false;
+        }
+
+        lc -= int32_t(d.length);
+
+        if (!output(d.literal)) {
+            return false;
+        }
+    }
+
+    return out_end == out;
+}
+
+uint16_t reverse_lut(uint8_t const* bitmap, uint16_t* lut) {
+    uint32_t k = 0;
+
+    for (uint32_t i = 0; i < Ushort_range; ++i) {
+        if (0 == i || (bitmap[i >> 3] & (1 << (i & 7)))) {
+            lut[k++] = uint16_t(i);
+        }
+    }
+
+    uint32_t const n = k - 1;
+
+    std::fill(lut + k, lut + Ushort_range, 0);
+
+    return uint16_t(n);
+}
+
+static inline void wdec14(uint16_t l, uint16_t h, uint16_t& a, uint16_t& b) {
+    int16_t const ls = int16_t(l);
+    int16_t const hs = int16_t(h);
+
+    int32_t const hi = hs;
+    int32_t const ai = ls + (hi & 1) + (hi >> 1);
+
+    int16_t const as = int16_t(ai);
+    int16_t const bs = int16_t(ai - hi);
+
+    a = uint16_t(as);
+    b = uint16_t(bs);
+}
+
+static inline void wdec16(uint16_t l, uint16_t h, uint16_t& a, uint16_t& b) {
+    static int32_t constexpr A_offset = 1 << 15;
+    static int32_t constexpr Mod_mask = (1 << 16) - 1;
+
+    int32_t const m = l;
+    int32_t const d = h;
+
+    int32_t const bb = (m - (d >> 1)) & Mod_mask;
+    int32_t const aa = (d + bb - A_offset) & Mod_mask;
+
+    b = uint16_t(bb);
+    a = uint16_t(aa);
+}
+
+static inline void wdec(bool w14, uint16_t l, uint16_t h, uint16_t& a, uint16_t& b) {
+    if (w14) {
+        wdec14(l, h, a, b);
+    } else {
+        wdec16(l, h, a, b);
+    }
+}
+
+void wav2_decode(uint16_t* in, int32_t nx, int32_t ox, int32_t ny, int32_t oy, uint16_t mx) {
+    bool const w14 = mx < (1 << 14);
+
+    int32_t const n = std::min(nx, ny);
+
+    // Search max level
+    int32_t p = 1;
+
+    while (p <= n) {
+        p <<= 1;
+    }
+
+    p >>= 1;
+
+    int32_t p2 = p;
+
+    p >>= 1;
+
+    // Hierarchical loop on smaller dimension n
+    while (p >= 1) {
+        uint16_t* py = in;
+        uint16_t* ey = in + oy * (ny - p2);
+
+        int32_t const oy1 = oy * p;
+        int32_t const oy2 = oy * p2;
+        int32_t const ox1 = ox * p;
+        int32_t const ox2 = ox * p2;
+
+        uint16_t i00;
+        uint16_t i01;
+        uint16_t i10;
+        uint16_t i11;
+
+        for (; py <= ey; py += oy2) {
+            uint16_t* px = py;
+            uint16_t* ex = py + ox * (nx - p2);
+
+            for (; px <= ex; px += ox2) {
+                uint16_t* p01 = px + ox1;
+                uint16_t* p10 = px + oy1;
+                uint16_t* p11 = p10 + ox1;
+
+                wdec(w14, *px, *p10, i00, i10);
+                wdec(w14, *p01, *p11, i01, i11);
+                wdec(w14, i00, i01, *px, *p01);
+                wdec(w14, i10, i11, *p10, *p11);
+            }
+
+            // Odd column
+            if (nx & p) {
+                uint16_t* p10 = px + oy1;
+
+                wdec(w14, *px, *p10, i00, *p10);
+
+                *px = i00;
+            }
+        }
+
+        // Odd line
+        if (ny & p) {
+            uint16_t* px = py;
+            uint16_t* ex = py + ox * (nx - p2);
+
+            for (; px <= ex; px += ox2) {
+                uint16_t* p01 = px + ox1;
+
+                wdec(w14, *px, *p01, i00, *p01);
+
+                *px = i00;
+            }
+        }
+
+        p2 = p;
+        p >>= 1;
+    }
+}
+
+}  // namespace image::encoding::exr
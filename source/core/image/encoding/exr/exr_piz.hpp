@@ -0,0 +1,59 @@
+#ifndef SU_CORE_IMAGE_ENCODING_EXR_PIZ_HPP
+#define SU_CORE_IMAGE_ENCODING_EXR_PIZ_HPP
+
+#include <cstdint>
+
+namespace image::encoding::exr {
+
+// Decoder for PIZ compressed blocks: Huffman coded wavelet coefficients of the scanlines.
+// The tables are kept between blocks, so every thread should use its own instance.
+class Piz {
+  public:
+    Piz();
+
+    ~Piz();
+
+    // Channels of the same type, with scalar_size in bytes.
+    // The destination receives the scanlines in the layout of an uncompressed block.
+    bool decompress(uint8_t const* source, uint32_t source_size, int32_t width, int32_t num_rows,
+                    int32_t num_channels, int32_t scalar_size, uint8_t* destination);
+
+  private:
+    struct Decoder {
+        // Length of a short code, or 0 if the entry is the prefix of long codes
+        uint32_t length;
+
+        // Symbol of a short code, or the number of long codes
+        uint32_t literal;
+
+        // First long code in long_symbols_
+        uint32_t begin;
+    };
+
+    bool huffman_decompress(uint8_t const* source, uint32_t source_size, uint16_t* destination,
+                            uint32_t num_values);
+
+    bool unpack_codes(uint8_t const*& source, uint8_t const* end, uint32_t min, uint32_t max);
+
+    bool build_decoders(uint32_t min, uint32_t max);
+
+    bool decode(uint8_t const* source, uint32_t num_bits, uint32_t run_symbol,
+                uint16_t* destination, uint32_t num_values) const;
+
+    // Code and length of every symbol, as code << 6 | length
+    uint64_t* codes_;
+
+    Decoder* decoders_;
+
+    uint32_t* long_symbols_;
+
+    uint16_t* lut_;
+
+    uint32_t buffer_size_ = 0;
+
+    uint16_t* buffer_ = nullptr;
+};
+
+}  // namespace image::encoding::exr
+
+#endif
@@ -1,13 +1,18 @@
 #include "exr_reader.hpp"
 #include "base/math/half.inl"
 #include "base/math/vector4.inl"
+#include "base/memory/array.inl"
 #include "base/memory/buffer.hpp"
 #include "base/spectrum/aces.hpp"
+#include "base/thread/thread_pool.hpp"
 #include "exr.hpp"
+#include "exr_piz.hpp"
 #include "image/image.hpp"
 #include "logging/logging.hpp"
 #include "miniz/miniz.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
@@ -48,9 +53,11 @@ static void channel_list(std::istream& stream, Channels& channels);
 
 static Compression compression(std::istream& stream);
 
-static Image* read_zip(std::istream& stream, int2 dimensions, Channels const& channels, bool color);
+static Image* read_blocks(std::istream& stream, int2 dimensions, int32_t first_row,
+                          Channels const& channels, Compression compression, bool color,
+                          Threads& threads);
 
-Image* Reader::read(std::istream& stream, bool color) {
+Image* Reader::read(std::istream& stream, bool color, Threads& threads) {
     uint8_t header[Signature_size];
 
     // Check signature
@@ -135,11 +142,19 @@ Image* Reader::read(std::istream& stream, bool color) {
         return nullptr;
     }
 
-    if (Compression::ZIP == compression) {
-        return read_zip(stream, data_window.zw() + 1, channels, color);
+    switch (compression) {
+        case Compression::No:
+        case Compression::RLE:
+        case Compression::ZIPS:
+        case Compression::ZIP:
+        case Compression::PIZ:
+            return read_blocks(stream, data_window.zw() - data_window.xy() + 1, data_window[1],
+                               channels, compression, color, threads);
+        default:
+            break;
     }
 
-    logging::push_error("only ZIP compression is supported");
+    logging::push_error("only uncompressed, RLE, ZIPS, ZIP and PIZ compression are supported");
 
     return nullptr;
 }
@@ -288,109 +303,253 @@ static void interleave_sse2(uint8_t const* source, int32_t len, uint8_t* out) {
     }
 }
 
-static Image* read_zip(std::istream& stream, int2 dimensions, Channels const& channels,
-                       bool color) {
-    int32_t const rows_per_block = exr::num_scanlines_per_block(Compression::ZIP);
-    int32_t const row_blocks     = exr::num_scanline_blocks(dimensions[1], Compression::ZIP);
-
-    int32_t const bytes_per_pixel = channels.bytes_per_pixel();
-    int32_t const bytes_per_row   = dimensions[0] * bytes_per_pixel;
+static bool rle_uncompress(uint8_t const* source, uint32_t size, uint8_t* destination,
+                           uint32_t num_bytes) {
+    uint8_t const* const end = source + size;
 
-    int32_t const bytes_per_row_block = bytes_per_row * rows_per_block;
+    uint8_t* const out_end = destination + num_bytes;
 
-    for (int32_t i = 0; i < row_blocks; ++i) {
-        int64_t v;
-        stream.read(reinterpret_cast<char*>(&v), sizeof(int64_t));
-    }
+    while (source < end) {
+        int32_t const count = int32_t(int8_t(*source++));
 
-    memory::Buffer<uint8_t> buffer(static_cast<uint64_t>(bytes_per_row_block));
+        if (count < 0) {
+            uint32_t const run = uint32_t(-count);
 
-    memory::Buffer<uint8_t> uncompressed(static_cast<uint64_t>(bytes_per_row_block));
+            if (uint32_t(end - source) < run || uint32_t(out_end - destination) < run) {
+                return false;
+            }
 
-    Image* image = nullptr;
+            std::memcpy(destination, source, run);
 
-    if (Channel::Type::Half == channels.channels[0].type) {
-        image = new Image(Short3(Description(dimensions)));
-    } else {
-        image = new Image(Float3(Description(dimensions)));
-    }
+            source += run;
+            destination += run;
+        } else {
+            uint32_t const run = uint32_t(count) + 1;
 
-    for (int32_t i = 0, p = 0; i < row_blocks; ++i) {
-        int32_t row;
-        stream.read(reinterpret_cast<char*>(&row), sizeof(int32_t));
+            if (source >= end || uint32_t(out_end - destination) < run) {
+                return false;
+            }
 
-        int32_t size;
-        stream.read(reinterpret_cast<char*>(&size), sizeof(int32_t));
+            std::memset(destination, *source++, run);
 
-        stream.read(reinterpret_cast<char*>(buffer.data()), size);
+            destination += run;
+        }
+    }
 
-        int32_t const num_rows_here = std::min(dimensions[1] - row, rows_per_block);
+    return out_end == destination;
+}
 
-        int32_t const num_pixels_here = num_rows_here * dimensions[0];
+// Returns the pixels of the block in the layout of the file, either pointing into the source or
+// into one of the buffers, or nullptr if the block is corrupt
+static uint8_t const* uncompress_block(uint8_t const* source, uint32_t size, uint32_t num_bytes,
+                                       int32_t width, int32_t num_rows, Channels const& channels,
+                                       Compression compression, uint8_t* buffer_a,
+                                       uint8_t* buffer_b, Piz* piz) {
+    // Blocks that would not get smaller are stored as they are
+    if (size == num_bytes) {
+        return source;
+    }
 
-        if (size < bytes_per_row_block) {
-            unsigned long uncompressed_size = uint32_t(bytes_per_row_block);
-            if (MZ_OK != mz_uncompress(uncompressed, &uncompressed_size, buffer, uint32_t(size))) {
-                delete image;
+    switch (compression) {
+        case Compression::RLE:
+            if (!rle_uncompress(source, size, buffer_a, num_bytes)) {
+                return nullptr;
+            }
+            break;
+        case Compression::ZIPS:
+        case Compression::ZIP: {
+            unsigned long uncompressed_size = num_bytes;
+            if (MZ_OK != mz_uncompress(buffer_a, &uncompressed_size, source, size) ||
+                num_bytes != uncompressed_size) {
                 return nullptr;
             }
+        } break;
+        case Compression::PIZ:
+            if (!piz->decompress(source, size, width, num_rows, int32_t(channels.channels.size()),
+                                channels.channels[0].byte_size(), buffer_b)) {
+                return nullptr;
+            }
+
+            return buffer_b;
+        default:
+            return nullptr;
+    }
 
-            reconstruct_scalar(uncompressed, num_pixels_here * bytes_per_pixel);
+    reconstruct_scalar(buffer_a, int32_t(num_bytes));
 
-            interleave_sse2(uncompressed, num_pixels_here * bytes_per_pixel, buffer.data());
-        }
+    interleave_sse2(buffer_a, int32_t(num_bytes), buffer_b);
 
-        if (Channel::Type::Half == channels.channels[0].type) {
-            uint16_t* const shorts = reinterpret_cast<uint16_t* const>(buffer.data());
+    return buffer_b;
+}
 
-            auto& image_s3 = image->short3();
+static void store_block(uint8_t const* pixels, int32_t row, int32_t num_rows, bool color,
+                        Image& image) {
+    int32_t const width = image.description().dimensions()[0];
 
-            for (int32_t y = 0; y < num_rows_here; ++y) {
-                int32_t const o = 3 * y * dimensions[0];
-                for (int32_t x = 0; x < dimensions[0]; ++x, ++p) {
-                    uint16_t const r = shorts[o + 2 * dimensions[0] + x];
-                    uint16_t const g = shorts[o + 1 * dimensions[0] + x];
-                    uint16_t const b = shorts[o + 0 * dimensions[0] + x];
+    int32_t p = row * width;
 
-                    if (color) {
+    if (Image::Type::Short3 == image.type()) {
+        uint16_t const* const shorts = reinterpret_cast<uint16_t const*>(pixels);
+
+        auto& image_s3 = image.short3();
+
+        for (int32_t y = 0; y < num_rows; ++y) {
+            int32_t const o = 3 * y * width;
+            for (int32_t x = 0; x < width; ++x, ++p) {
+                uint16_t const r = shorts[o + 2 * width + x];
+                uint16_t const g = shorts[o + 1 * width + x];
+                uint16_t const b = shorts[o + 0 * width + x];
+
+                if (color) {
 #ifdef SU_ACESCG
-                        float3 const  rgbf(half_to_float(ushort3(r, g, b)));
-                        ushort3 const rgb(float_to_half(spectrum::sRGB_to_AP1(rgbf)));
+                    float3 const  rgbf(half_to_float(ushort3(r, g, b)));
+                    ushort3 const rgb(float_to_half(spectrum::sRGB_to_AP1(rgbf)));
 #else
-                        ushort3 const       rgb(r, g, b);
+                    ushort3 const rgb(r, g, b);
 #endif
-                        image_s3.store(p, rgb);
-                    } else {
-                        image_s3.store(p, ushort3(r, g, b));
-                    }
+                    image_s3.store(p, rgb);
+                } else {
+                    image_s3.store(p, ushort3(r, g, b));
                 }
             }
-        } else {
-            float* const floats = reinterpret_cast<float* const>(buffer.data());
+        }
+    } else {
+        float const* const floats = reinterpret_cast<float const*>(pixels);
 
-            auto& image_f3 = image->float3();
+        auto& image_f3 = image.float3();
 
-            for (int32_t y = 0; y < num_rows_here; ++y) {
-                int32_t const o = 3 * y * dimensions[0];
-                for (int32_t x = 0; x < dimensions[0]; ++x, ++p) {
-                    float const r = floats[o + 2 * dimensions[0] + x];
-                    float const g = floats[o + 1 * dimensions[0] + x];
-                    float const b = floats[o + 0 * dimensions[0] + x];
+        for (int32_t y = 0; y < num_rows; ++y) {
+            int32_t const o = 3 * y * width;
+            for (int32_t x = 0; x < width; ++x, ++p) {
+                float const r = floats[o + 2 * width + x];
+                float const g = floats[o + 1 * width + x];
+                float const b = floats[o + 0 * width + x];
 
-                    if (color) {
+                if (color) {
 #ifdef SU_ACESCG
-                        packed_float3 const rgb(spectrum::sRGB_to_AP1(float3(r, g, b)));
+                    packed_float3 const rgb(spectrum::sRGB_to_AP1(float3(r, g, b)));
 #else
-                        packed_float3 const rgb(r, g, b);
+                    packed_float3 const rgb(r, g, b);
 #endif
-                        image_f3.store(p, rgb);
-                    } else {
-                        image_f3.store(p, packed_float3(r, g, b));
-                    }
+                    image_f3.store(p, rgb);
+                } else {
+                    image_f3.store(p, packed_float3(r, g, b));
                 }
             }
         }
     }
+}
+
+static Image* read_blocks(std::istream& stream, int2 dimensions, int32_t first_row,
+                          Channels const& channels, Compression compression, bool color,
+                          Threads& threads) {
+    int32_t const rows_per_block = exr::num_scanlines_per_block(compression);
+    int32_t const row_blocks     = exr::num_scanline_blocks(dimensions[1], compression);
+
+    int32_t const bytes_per_pixel = channels.bytes_per_pixel();
+    int32_t const bytes_per_row   = dimensions[0] * bytes_per_pixel;
+
+    uint32_t const bytes_per_row_block = uint32_t(bytes_per_row * rows_per_block);
+
+    memory::Buffer<int64_t> offsets(static_cast<uint32_t>(row_blocks));
+
+    stream.read(reinterpret_cast<char*>(offsets.data()), row_blocks * int64_t(sizeof(int64_t)));
+
+    if (!stream) {
+        logging::push_error("incomplete EXR offset table");
+        return nullptr;
+    }
+
+    // The offset table tells where each block starts, so that the blocks can be decoded
+    // independently of each other, after reading the remainder of the stream in one go.
+    // The first block directly follows the table.
+    int64_t const start = *std::min_element(offsets.data(), offsets.data() + row_blocks);
+
+    std::vector<uint8_t> data;
+
+    for (size_t chunk = 1 << 20;; chunk *= 2) {
+        size_t const size = data.size();
+
+        data.resize(size + chunk);
+
+        stream.read(reinterpret_cast<char*>(data.data() + size), std::streamsize(chunk));
+
+        data.resize(size + size_t(stream.gcount()));
+
+        if (!stream) {
+            break;
+        }
+    }
+
+    Image* image = nullptr;
+
+    if (Channel::Type::Half == channels.channels[0].type) {
+        image = new Image(Short3(Description(dimensions)));
+    } else {
+        image = new Image(Float3(Description(dimensions)));
+    }
+
+    uint32_t const num_threads = threads.num_threads();
+
+    memory::Buffer<uint8_t> buffers(2 * bytes_per_row_block * num_threads);
+
+    memory::Array<Piz> pizs(Compression::PIZ == compression ? num_threads : 0);
+
+    std::atomic<bool> valid = true;
+
+    threads.run_range(
+        [&](uint32_t id, int32_t begin, int32_t end) noexcept {
+            uint8_t* buffer_a = buffers.data() + 2 * bytes_per_row_block * id;
+            uint8_t* buffer_b = buffer_a + bytes_per_row_block;
+
+            for (int32_t i = begin; i < end; ++i) {
+                int64_t const offset = offsets[i] - start;
+
+                if (offset < 0 || offset + 8 > int64_t(data.size())) {
+                    valid = false;
+                    continue;
+                }
+
+                uint8_t const* block = data.data() + offset;
+
+                int32_t y;
+                std::memcpy(&y, block, sizeof(int32_t));
+
+                uint32_t size;
+                std::memcpy(&size, block + 4, sizeof(uint32_t));
+
+                int32_t const row = y - first_row;
+
+                if (row < 0 || row >= dimensions[1] || 0 != row % rows_per_block ||
+                    uint64_t(offset + 8) + size > data.size()) {
+                    valid = false;
+                    continue;
+                }
+
+                int32_t const num_rows_here = std::min(dimensions[1] - row, rows_per_block);
+
+                uint32_t const num_bytes = uint32_t(num_rows_here * bytes_per_row);
+
+                uint8_t const* pixels = uncompress_block(
+                    block + 8, size, num_bytes, dimensions[0], num_rows_here, channels,
+                    compression, buffer_a, buffer_b, pizs.empty() ? nullptr : &pizs[id]);
+
+                if (!pixels) {
+                    valid = false;
+                    continue;
+                }
+
+                store_block(pixels, row, num_rows_here, color, *image);
+            }
+        },
+        0, row_blocks);
+
+    if (!valid) {
+        logging::push_error("corrupt EXR block");
+
+        delete image;
+        return nullptr;
+    }
 
     return image;
 }
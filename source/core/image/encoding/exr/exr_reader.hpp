@@ -3,6 +3,12 @@
 
 #include <iosfwd>
 
+namespace thread {
+class Pool;
+}
+
+using Threads = thread::Pool;
+
 namespace image {
 
 class Image;
@@ -11,7 +17,7 @@ namespace encoding::exr {
 
 class Reader {
   public:
-    static Image* read(std::istream& stream, bool color);
+    static Image* read(std::istream& stream, bool color, Threads& threads);
 };
 
 }  // namespace encoding::exr
@@ -347,7 +347,8 @@ bool Writer::zip_compression(std::ostream& stream, Float4 const& image, Compress
                 return;
             }
 
-            int32_t const width = args.image.description().dimensions()[0];
+            int32_t const width  = args.image.description().dimensions()[0];
+            int32_t const height = args.image.description().dimensions()[1];
 
             uint32_t const offset = id * args.bytes_per_block;
 
@@ -355,7 +356,7 @@ bool Writer::zip_compression(std::ostream& stream, Float4 const& image, Compress
             uint8_t* block_buffer = args.block_buffer + offset;
 
             for (int32_t y = begin; y < end; ++y) {
-                int32_t const num_rows_here = std::min(width - (y * args.rows_per_block),
+                int32_t const num_rows_here = std::min(height - (y * args.rows_per_block),
                                                        args.rows_per_block);
 
                 int32_t const pixel = y * args.rows_per_block * width;
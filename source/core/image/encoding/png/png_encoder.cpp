@@ -0,0 +1,400 @@
+#include "png_encoder.hpp"
+#include "base/math/simd.hpp"
+#include "base/math/vector2.inl"
+#include "base/memory/align.hpp"
+#include "base/thread/thread_pool.hpp"
+#include "miniz/miniz.h"
+
+#include <cstring>
+#include <ostream>
+
+namespace image::encoding::png {
+
+enum class Filter : uint8_t { None, Sub, Up, Average, Paeth };
+
+// Bands are compressed without the dictionary of their predecessor, so they shouldn't be too small
+static uint32_t constexpr Band_size = 1 << 18;
+
+static uint32_t constexpr Num_filters = 5;
+
+// Filtered rows give the compressor a lot more matches to consider than the raw bytes did,
+// which makes the default level about four times slower for only a few percent smaller files
+static int32_t constexpr Compression_level = 3;
+
+static void filter_row(Filter filter, uint8_t const* row, uint8_t const* prior, uint8_t* target,
+                       uint32_t row_size, uint32_t bytes_per_pixel);
+
+static uint32_t filter_cost(uint8_t const* row, uint32_t row_size);
+
+static uint32_t adler32_combine(uint32_t adler0, uint32_t adler1, uint32_t num_bytes1);
+
+static void write_chunk(std::ostream& stream, char const* type, uint8_t const* data,
+                        uint32_t length);
+
+static void store_big_endian(uint8_t* destination, uint32_t v);
+
+static int put_buffer(void const* buffer, int length, void* user);
+
+Encoder::Encoder() = default;
+
+Encoder::~Encoder() {
+    release();
+
+    memory::free_aligned(zero_row_);
+}
+
+bool Encoder::write(std::ostream& stream, uint8_t const* image, int2 dimensions,
+                    uint32_t num_channels, Threads& threads) {
+    uint32_t const width    = uint32_t(dimensions[0]);
+    uint32_t const height   = uint32_t(dimensions[1]);
+    uint32_t const row_size = width * num_channels;
+
+    if (num_channels < 1 || num_channels > 4 || 0 == row_size || 0 == height) {
+        return false;
+    }
+
+    uint32_t const rows_per_band = std::max(Band_size / (row_size + 1), 1u);
+    uint32_t const num_bands     = (height + rows_per_band - 1) / rows_per_band;
+
+    allocate(threads.num_threads(), row_size);
+
+    bands_.resize(num_bands);
+
+    threads.run_range(
+        [this, image, dimensions, num_channels, rows_per_band, num_bands](
+            uint32_t id, int32_t begin, int32_t end) noexcept {
+            for (int32_t b = begin; b < end; ++b) {
+                compress_band(uint32_t(b), workers_[id], image, dimensions, num_channels,
+                              rows_per_band, num_bands);
+            }
+        },
+        0, int32_t(num_bands), 1);
+
+    uint32_t adler = 1;
+
+    for (auto const& b : bands_) {
+        if (!b.valid) {
+            return false;
+        }
+
+        adler = adler32_combine(adler, b.adler, b.num_bytes);
+    }
+
+    static uint8_t constexpr Signature[] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    stream.write(reinterpret_cast<char const*>(Signature), sizeof(Signature));
+
+    static uint8_t constexpr Color_types[] = {0, 0, 4, 2, 6};
+
+    uint8_t header[13];
+    store_big_endian(header, width);
+    store_big_endian(header + 4, height);
+    header[8]  = 8;
+    header[9]  = Color_types[num_channels];
+    header[10] = 0;
+    header[11] = 0;
+    header[12] = 0;
+
+    write_chunk(stream, "IHDR", header, sizeof(header));
+
+    for (auto const& b : bands_) {
+        stream.write(reinterpret_cast<char const*>(b.chunk.data()),
+                     std::streamsize(b.chunk.size()));
+    }
+
+    // The zlib stream ends with the checksum of all the bands
+    uint8_t trailer[4];
+    store_big_endian(trailer, adler);
+
+    write_chunk(stream, "IDAT", trailer, sizeof(trailer));
+
+    write_chunk(stream, "IEND", nullptr, 0);
+
+    return bool(stream);
+}
+
+void Encoder::compress_band(uint32_t band, Worker& worker, uint8_t const* image,
+                            int2 dimensions, uint32_t num_channels, uint32_t rows_per_band,
+                            uint32_t num_bands) {
+    Band& b = bands_[band];
+
+    uint32_t const row_size = uint32_t(dimensions[0]) * num_channels;
+
+    uint32_t const row_begin = band * rows_per_band;
+    uint32_t const row_end   = std::min(row_begin + rows_per_band, uint32_t(dimensions[1]));
+
+    b.chunk.clear();
+    b.chunk.reserve(((row_end - row_begin) * (row_size + 1)) / 2);
+
+    // Room for length and type
+    b.chunk.resize(8);
+
+    if (0 == band) {
+        // zlib header: deflate with 32K window and fast compression
+        b.chunk.push_back(0x78);
+        b.chunk.push_back(0x5E);
+    }
+
+    auto* compressor = static_cast<tdefl_compressor*>(worker.compressor);
+
+    // Negative window bits for raw deflate, because write() takes care of
+    // the zlib header and checksum
+    mz_uint const flags = tdefl_create_comp_flags_from_zip_params(
+        Compression_level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+
+    tdefl_init(compressor, put_buffer, &b.chunk, int(flags));
+
+    uint32_t adler = 1;
+
+    for (uint32_t y = row_begin; y < row_end; ++y) {
+        uint8_t const* row   = image + y * row_size;
+        uint8_t const* prior = 0 == y ? zero_row_ : row - row_size;
+
+        // Each filtered row is prefixed by its filter type
+        uint32_t const stride = row_size + 1;
+
+        uint32_t best      = uint32_t(Filter::None);
+        uint32_t best_cost = filter_cost(row, row_size);
+
+        for (uint32_t f = uint32_t(Filter::Sub); f < Num_filters; ++f) {
+            uint8_t* target = worker.rows + f * stride;
+
+            filter_row(Filter(f), row, prior, target + 1, row_size, num_channels);
+
+            if (uint32_t const cost = filter_cost(target + 1, row_size); cost < best_cost) {
+                best      = f;
+                best_cost = cost;
+            }
+        }
+
+        uint8_t* filtered = worker.rows + best * stride;
+
+        if (uint32_t(Filter::None) == best) {
+            std::memcpy(filtered + 1, row, row_size);
+        }
+
+        filtered[0] = uint8_t(best);
+
+        tdefl_compress_buffer(compressor, filtered, stride, TDEFL_NO_FLUSH);
+
+        adler = uint32_t(mz_adler32(adler, filtered, stride));
+    }
+
+    // Every band but the last ends on a byte boundary without the final block,
+    // so that the next one can simply be appended
+    bool const last = band == num_bands - 1;
+
+    tdefl_status const status = tdefl_compress_buffer(compressor, nullptr, 0,
+                                                      last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+
+    b.valid = last ? TDEFL_STATUS_DONE == status : TDEFL_STATUS_OKAY == status;
+
+    uint32_t const length = uint32_t(b.chunk.size()) - 8;
+
+    store_big_endian(b.chunk.data(), length);
+    std::memcpy(b.chunk.data() + 4, "IDAT", 4);
+
+    uint32_t const crc = uint32_t(mz_crc32(MZ_CRC32_INIT, b.chunk.data() + 4, length + 4));
+
+    b.chunk.resize(b.chunk.size() + 4);
+    store_big_endian(b.chunk.data() + 8 + length, crc);
+
+    b.num_bytes = (row_end - row_begin) * (row_size + 1);
+    b.adler     = adler;
+}
+
+void Encoder::allocate(uint32_t num_threads, uint32_t row_size) {
+    if (workers_.size() != num_threads) {
+        release();
+
+        workers_.resize(num_threads);
+
+        for (auto& w : workers_) {
+            w.compressor = tdefl_compressor_alloc();
+            w.rows       = nullptr;
+        }
+
+        row_size_ = 0;
+    }
+
+    if (row_size_ >= row_size) {
+        return;
+    }
+
+    row_size_ = row_size;
+
+    for (auto& w : workers_) {
+        memory::free_aligned(w.rows);
+        w.rows = memory::allocate_aligned<uint8_t>(Num_filters * (row_size + 1));
+    }
+
+    memory::free_aligned(zero_row_);
+    zero_row_ = memory::allocate_aligned<uint8_t>(row_size);
+    std::memset(zero_row_, 0, row_size);
+}
+
+void Encoder::release() {
+    for (auto& w : workers_) {
+        tdefl_compressor_free(static_cast<tdefl_compressor*>(w.compressor));
+        memory::free_aligned(w.rows);
+    }
+
+    workers_.clear();
+}
+
+static uint8_t average(uint8_t a, uint8_t b) {
+    return uint8_t((uint32_t(a) + uint32_t(b)) >> 1);
+}
+
+// Without branches, so that the loop below can be vectorized
+static uint8_t paeth_predictor(uint8_t a, uint8_t b, uint8_t c) {
+    int32_t const A = int32_t(a);
+    int32_t const B = int32_t(b);
+    int32_t const C = int32_t(c);
+
+    int32_t const pa = std::abs(B - C);
+    int32_t const pb = std::abs(A - C);
+    int32_t const pc = std::abs(A + B - 2 * C);
+
+    uint8_t const bc = pb <= pc ? b : c;
+
+    return pa <= pb && pa <= pc ? a : bc;
+}
+
+// In contrast to decoding, all predictors only depend on the unfiltered rows
+void filter_row(Filter filter, uint8_t const* row, uint8_t const* prior, uint8_t* target,
+                uint32_t row_size, uint32_t bytes_per_pixel) {
+    uint32_t const bpp = bytes_per_pixel;
+
+    switch (filter) {
+        case Filter::None:
+            std::memcpy(target, row, row_size);
+            break;
+        case Filter::Sub:
+            for (uint32_t i = 0; i < bpp; ++i) {
+                target[i] = row[i];
+            }
+
+            for (uint32_t i = bpp; i < row_size; ++i) {
+                target[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case Filter::Up:
+            for (uint32_t i = 0; i < row_size; ++i) {
+                target[i] = row[i] - prior[i];
+            }
+            break;
+        case Filter::Average:
+            for (uint32_t i = 0; i < bpp; ++i) {
+                target[i] = row[i] - (prior[i] >> 1);
+            }
+
+            for (uint32_t i = bpp; i < row_size; ++i) {
+                target[i] = row[i] - average(row[i - bpp], prior[i]);
+            }
+            break;
+        case Filter::Paeth:
+            for (uint32_t i = 0; i < bpp; ++i) {
+                target[i] = row[i] - prior[i];
+            }
+
+            for (uint32_t i = bpp; i < row_size; ++i) {
+                target[i] = row[i] - paeth_predictor(row[i - bpp], prior[i], prior[i - bpp]);
+            }
+            break;
+    }
+}
+
+// Sum of the filtered bytes taken as signed magnitudes, the heuristic suggested by the PNG spec
+uint32_t filter_cost(uint8_t const* row, uint32_t row_size) {
+    __m128i const zero = _mm_setzero_si128();
+
+    __m128i sum = zero;
+
+    uint32_t i = 0;
+
+    for (; i + 16 <= row_size; i += 16) {
+        __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(row + i));
+
+        // abs(-128) stays 0x80, which is correct when read unsigned
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_abs_epi8(v), zero));
+    }
+
+    uint32_t cost = uint32_t(_mm_cvtsi128_si32(_mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum))));
+
+    for (; i < row_size; ++i) {
+        cost += uint32_t(std::abs(int32_t(int8_t(row[i]))));
+    }
+
+    return cost;
+}
+
+// Same as adler32_combine() of zlib
+uint32_t adler32_combine(uint32_t adler0, uint32_t adler1, uint32_t num_bytes1) {
+    static uint32_t constexpr Base = 65521;
+
+    uint32_t const rem = num_bytes1 % Base;
+
+    uint32_t sum1 = adler0 & 0xFFFF;
+    uint32_t sum2 = (rem * sum1) % Base;
+
+    sum1 += (adler1 & 0xFFFF) + Base - 1;
+    sum2 += (adler0 >> 16) + (adler1 >> 16) + Base - rem;
+
+    if (sum1 >= Base) {
+        sum1 -= Base;
+    }
+
+    if (sum1 >= Base) {
+        sum1 -= Base;
+    }
+
+    if (sum2 >= Base << 1) {
+        sum2 -= Base << 1;
+    }
+
+    if (sum2 >= Base) {
+        sum2 -= Base;
+    }
+
+    return sum1 | (sum2 << 16);
+}
+
+void write_chunk(std::ostream& stream, char const* type, uint8_t const* data, uint32_t length) {
+    uint8_t buffer[8];
+    store_big_endian(buffer, length);
+    std::memcpy(buffer + 4, type, 4);
+
+    stream.write(reinterpret_cast<char const*>(buffer), 8);
+
+    uint32_t crc = uint32_t(mz_crc32(MZ_CRC32_INIT, buffer + 4, 4));
+
+    if (length > 0) {
+        stream.write(reinterpret_cast<char const*>(data), length);
+
+        crc = uint32_t(mz_crc32(crc, data, length));
+    }
+
+    store_big_endian(buffer, crc);
+
+    stream.write(reinterpret_cast<char const*>(buffer), 4);
+}
+
+void store_big_endian(uint8_t* destination, uint32_t v) {
+    destination[0] = uint8_t(v >> 24);
+    destination[1] = uint8_t(v >> 16);
+    destination[2] = uint8_t(v >> 8);
+    destination[3] = uint8_t(v);
+}
+
+int put_buffer(void const* buffer, int length, void* user) {
+    auto& chunk = *static_cast<std::vector<uint8_t>*>(user);
+
+    auto const* bytes = static_cast<uint8_t const*>(buffer);
+
+    chunk.insert(chunk.end(), bytes, bytes + length);
+
+    return 1;
+}
+
+}  // namespace image::encoding::png
@@ -0,0 +1,68 @@
+#ifndef SU_CORE_IMAGE_ENCODING_PNG_ENCODER_HPP
+#define SU_CORE_IMAGE_ENCODING_PNG_ENCODER_HPP
+
+#include "base/math/vector2.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace thread {
+class Pool;
+}
+
+using Threads = thread::Pool;
+
+namespace image::encoding::png {
+
+// Filters and compresses bands of rows in parallel, similar to pigz.
+// Every band is an independent deflate stream that ends with a sync flush (the last one with the
+// final block), and is stored in its own IDAT chunk. Together they form a single zlib stream.
+class Encoder {
+  public:
+    Encoder();
+
+    ~Encoder();
+
+    // 8 bit per channel, with 1 to 4 interleaved channels
+    bool write(std::ostream& stream, uint8_t const* image, int2 dimensions, uint32_t num_channels,
+               Threads& threads);
+
+  private:
+    struct Band {
+        // The complete IDAT chunk, including length, type and CRC
+        std::vector<uint8_t> chunk;
+
+        uint32_t num_bytes;
+        uint32_t adler;
+
+        bool valid;
+    };
+
+    struct Worker {
+        // tdefl_compressor
+        void* compressor;
+
+        // One filtered row for each filter type
+        uint8_t* rows;
+    };
+
+    void compress_band(uint32_t band, Worker& worker, uint8_t const* image, int2 dimensions,
+                       uint32_t num_channels, uint32_t rows_per_band, uint32_t num_bands);
+
+    void allocate(uint32_t num_threads, uint32_t row_size);
+
+    void release();
+
+    std::vector<Band> bands_;
+
+    std::vector<Worker> workers_;
+
+    uint8_t* zero_row_ = nullptr;
+
+    uint32_t row_size_ = 0;
+};
+
+}  // namespace image::encoding::png
+
+#endif
@@ -3,12 +3,13 @@
 #include "base/memory/align.hpp"
 #include "base/spectrum/rgb.hpp"
 #include "base/string/string.hpp"
+#include "base/thread/thread_pool.hpp"
 #include "image/image.hpp"
-#include "image/tiled_image.inl"
 #include "logging/logging.hpp"
 
 #include <cstring>
 #include <istream>
+#include <vector>
 
 // based on
 // https://github.com/jansol/LuPng
@@ -51,9 +52,10 @@ Reader::Info::~Info() {
 }
 
 bool Reader::Info::allocate() {
-    uint32_t const row_size    = uint32_t(width * num_channels);
-    uint32_t const buffer_size = row_size * uint32_t(height);
-    uint32_t const num_bytes   = buffer_size + 2 * row_size;
+    uint32_t const row_size      = uint32_t(width * num_channels);
+    uint32_t const buffer_size   = row_size * uint32_t(height);
+    uint32_t const filtered_size = (row_size + 1) * uint32_t(height);
+    uint32_t const num_bytes     = buffer_size + filtered_size + row_size;
 
     if (capacity < num_bytes) {
         memory::free_aligned(buffer);
@@ -63,8 +65,12 @@ bool Reader::Info::allocate() {
         capacity = num_bytes;
     }
 
-    current_row_data  = buffer + buffer_size;
-    previous_row_data = current_row_data + row_size;
+    filtered = buffer + buffer_size;
+    zero_row = filtered + filtered_size;
+
+    std::memset(zero_row, 0, row_size);
+
+    num_filtered = 0;
 
     if (!stream.zalloc) {
         if (MZ_OK != mz_inflateInit(&stream)) {
@@ -93,11 +99,10 @@ static bool parse_header(Chunk const& chunk, Info& info);
 
 static bool parse_data(Chunk const& chunk, Info& info);
 
-static uint8_t filter(uint8_t byte, Filter filter, Info const& info);
-
-static uint8_t raw(int column, Info const& info);
+static bool defilter(Info& info, Threads& threads);
 
-static uint8_t prior(int column, Info const& info);
+static void defilter_row(Filter filter, uint8_t const* source, uint8_t const* prior, uint8_t* row,
+                         int32_t row_size, int32_t bytes_per_pixel);
 
 static uint8_t average(uint8_t a, uint8_t b);
 
@@ -110,7 +115,7 @@ static uint32_t constexpr Signature_size = 8;
 static uint8_t constexpr Signature[Signature_size] = {0x89, 0x50, 0x4E, 0x47,
                                                       0x0D, 0x0A, 0x1A, 0x0A};
 
-Image* Reader::read(std::istream& stream, Swizzle swizzle, bool invert) {
+Image* Reader::read(std::istream& stream, Swizzle swizzle, bool invert, Threads& threads) {
     uint8_t signature[Signature_size];
 
     stream.read(reinterpret_cast<char*>(signature), Signature_size);
@@ -123,6 +128,10 @@ Image* Reader::read(std::istream& stream, Swizzle swizzle, bool invert) {
     for (; handle_chunk(stream, chunk_, info_);) {
     }
 
+    if (!defilter(info_, threads)) {
+        return nullptr;
+    }
+
     return create_image(info_, swizzle, invert);
 }
 
@@ -388,11 +397,6 @@ bool parse_header(Chunk const& chunk, Info& info) {
         return header_error("Interlaced PNG image not supported.", info);
     }
 
-    info.current_filter     = Filter::None;
-    info.filter_byte        = true;
-    info.current_byte       = 0;
-    info.current_byte_total = 0;
-
     if (!info.allocate()) {
         return header_error("Could not deflate PNG buffers.", info);
     }
@@ -401,17 +405,19 @@ bool parse_header(Chunk const& chunk, Info& info) {
 }
 
 bool parse_data(Chunk const& chunk, Info& info) {
-    static uint32_t constexpr Buffer_size = 8192;
-    uint8_t buffer[Buffer_size];
+    if (0 == info.num_channels) {
+        return false;
+    }
+
+    uint32_t const filtered_size = uint32_t(info.width * info.num_channels + 1) *
+                                   uint32_t(info.height);
 
     info.stream.next_in  = chunk.data;
     info.stream.avail_in = chunk.length;
 
-    int32_t const row_size = info.width * info.num_channels;
-
-    do {
-        info.stream.next_out  = buffer;
-        info.stream.avail_out = Buffer_size;
+    while (info.stream.avail_in > 0 && info.num_filtered < filtered_size) {
+        info.stream.next_out  = info.filtered + info.num_filtered;
+        info.stream.avail_out = filtered_size - info.num_filtered;
 
         int const status = mz_inflate(&info.stream, MZ_NO_FLUSH);
         if (status != MZ_OK && status != MZ_STREAM_END && status != MZ_BUF_ERROR &&
@@ -419,63 +425,110 @@ bool parse_data(Chunk const& chunk, Info& info) {
             return false;
         }
 
-        uint32_t const decompressed = Buffer_size - info.stream.avail_out;
+        info.num_filtered = filtered_size - info.stream.avail_out;
 
-        for (uint32_t i = 0; i < decompressed; ++i) {
-            if (info.filter_byte) {
-                info.current_filter = Filter(buffer[i]);
-                info.filter_byte    = false;
-            } else {
-                uint8_t const raw = filter(buffer[i], info.current_filter, info);
-                info.current_row_data[info.current_byte++] = raw;
-                info.buffer[info.current_byte_total++]     = raw;
-
-                if (row_size == info.current_byte) {
-                    info.current_byte = 0;
-                    std::swap(info.current_row_data, info.previous_row_data);
-                    info.filter_byte = true;
+        if (MZ_STREAM_END == status || MZ_BUF_ERROR == status) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Rows filtered with None or Sub don't depend on the previous row, so each of them starts a
+// sequence of rows that can be reconstructed independently of the others
+bool defilter(Info& info, Threads& threads) {
+    if (0 == info.num_channels) {
+        return false;
+    }
+
+    int32_t const row_size = info.width * info.num_channels;
+
+    uint32_t const filtered_size = uint32_t(row_size + 1) * uint32_t(info.height);
+
+    if (info.num_filtered != filtered_size) {
+        logging::push_error("Incomplete PNG image data.");
+        return false;
+    }
+
+    std::vector<int32_t> starts;
+
+    for (int32_t y = 0; y < info.height; ++y) {
+        uint8_t const filter = info.filtered[y * (row_size + 1)];
+
+        if (filter > uint8_t(Filter::Paeth)) {
+            logging::push_error("Unknown PNG filter type.");
+            return false;
+        }
+
+        if (0 == y || Filter(filter) == Filter::None || Filter(filter) == Filter::Sub) {
+            starts.push_back(y);
+        }
+    }
+
+    starts.push_back(info.height);
+
+    threads.run_range(
+        [&info, &starts, row_size](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+            for (int32_t s = begin; s < end; ++s) {
+                for (int32_t y = starts[s], len = starts[s + 1]; y < len; ++y) {
+                    uint8_t const* source = info.filtered + y * (row_size + 1);
+
+                    uint8_t* row = info.buffer + y * row_size;
+
+                    uint8_t const* prior = 0 == y ? info.zero_row : row - row_size;
+
+                    defilter_row(Filter(source[0]), source + 1, prior, row, row_size,
+                                 info.bytes_per_pixel);
                 }
             }
-        }
-    } while (info.stream.avail_in > 0 || 0 == info.stream.avail_out);
+        },
+        0, int32_t(starts.size()) - 1);
 
     return true;
 }
 
-uint8_t filter(uint8_t byte, Filter filter, Info const& info) {
+void defilter_row(Filter filter, uint8_t const* source, uint8_t const* prior, uint8_t* row,
+                  int32_t row_size, int32_t bytes_per_pixel) {
+    int32_t const bpp = bytes_per_pixel;
+
     switch (filter) {
         case Filter::None:
-            return byte;
+            std::memcpy(row, source, uint32_t(row_size));
+            break;
         case Filter::Sub:
-            return byte + raw(info.current_byte - info.bytes_per_pixel, info);
+            for (int32_t i = 0; i < bpp; ++i) {
+                row[i] = source[i];
+            }
+
+            for (int32_t i = bpp; i < row_size; ++i) {
+                row[i] = source[i] + row[i - bpp];
+            }
+            break;
         case Filter::Up:
-            return byte + prior(info.current_byte, info);
+            for (int32_t i = 0; i < row_size; ++i) {
+                row[i] = source[i] + prior[i];
+            }
+            break;
         case Filter::Average:
-            return byte + average(raw(info.current_byte - info.bytes_per_pixel, info),
-                                  prior(info.current_byte, info));
-        case Filter::Paeth:
-            return byte + paeth_predictor(raw(info.current_byte - info.bytes_per_pixel, info),
-                                          prior(info.current_byte, info),
-                                          prior(info.current_byte - info.bytes_per_pixel, info));
-        default:
-            return 0;
-    }
-}
-
-uint8_t raw(int column, Info const& info) {
-    if (column < 0) {
-        return 0;
-    }
+            for (int32_t i = 0; i < bpp; ++i) {
+                row[i] = source[i] + (prior[i] >> 1);
+            }
 
-    return info.current_row_data[column];
-}
+            for (int32_t i = bpp; i < row_size; ++i) {
+                row[i] = source[i] + average(row[i - bpp], prior[i]);
+            }
+            break;
+        case Filter::Paeth:
+            for (int32_t i = 0; i < bpp; ++i) {
+                row[i] = source[i] + prior[i];
+            }
 
-uint8_t prior(int column, Info const& info) {
-    if (column < 0) {
-        return 0;
+            for (int32_t i = bpp; i < row_size; ++i) {
+                row[i] = source[i] + paeth_predictor(row[i - bpp], prior[i], prior[i - bpp]);
+            }
+            break;
     }
-
-    return info.previous_row_data[column];
 }
 
 uint8_t average(uint8_t a, uint8_t b) {
@@ -7,6 +7,12 @@
 #include <cstdint>
 #include <iosfwd>
 
+namespace thread {
+class Pool;
+}
+
+using Threads = thread::Pool;
+
 namespace image {
 
 class Image;
@@ -15,7 +21,7 @@ namespace encoding::png {
 
 class Reader {
   public:
-    Image* read(std::istream& stream, Swizzle swizzle, bool invert);
+    Image* read(std::istream& stream, Swizzle swizzle, bool invert, Threads& threads);
 
     Image* create_from_buffer(Swizzle swizzle, bool invert) const;
 
@@ -47,16 +53,17 @@ class Reader {
         int32_t bytes_per_pixel = 0;
 
         // parsing state
-        Filter  current_filter;
-        bool    filter_byte;
-        int32_t current_byte;
-        int32_t current_byte_total;
+        uint32_t num_filtered;
 
         uint32_t capacity = 0;
 
-        uint8_t* buffer            = nullptr;
-        uint8_t* current_row_data  = nullptr;
-        uint8_t* previous_row_data = nullptr;
+        uint8_t* buffer = nullptr;
+
+        // The inflated rows, each preceded by its filter byte
+        uint8_t* filtered = nullptr;
+
+        // Prior of the first row
+        uint8_t* zero_row = nullptr;
 
         // miniz
         mz_stream stream;
@@ -32,20 +32,10 @@ bool Writer::write(std::ostream& stream, Float4 const& image, Threads& threads)
                                      int32_t end) noexcept { to_sRGB(image, begin, end); },
                       0, d[1]);
 
-    int32_t const num_channels = alpha() ? 4 : 3;
+    uint32_t const num_channels = alpha() ? 4 : 3;
 
-    size_t buffer_len = 0;
-    void*  png_buffer = tdefl_write_image_to_png_file_in_memory(buffer_, d[0], d[1], num_channels,
-                                                               &buffer_len);
-    if (!png_buffer) {
-        return false;
-    }
-
-    stream.write(static_cast<char*>(png_buffer), buffer_len);
-
-    mz_free(png_buffer);
-
-    return true;
+    return encoder_.write(stream, reinterpret_cast<uint8_t const*>(buffer_), d.xy(), num_channels,
+                          threads);
 }
 
 bool Writer::write(std::ostream& stream, Float4 const& image, Layout layout, Threads& threads) {
@@ -86,18 +76,8 @@ bool Writer::write(std::ostream& stream, Float4 const& image, Layout layout, Thr
         to_depth(image);
     }
 
-    size_t buffer_len = 0;
-    void*  png_buffer = tdefl_write_image_to_png_file_in_memory(buffer_, d[0], d[1],
-                                                               layout.num_channels, &buffer_len);
-    if (!png_buffer) {
-        return false;
-    }
-
-    stream.write(static_cast<char*>(png_buffer), buffer_len);
-
-    mz_free(png_buffer);
-
-    return true;
+    return encoder_.write(stream, reinterpret_cast<uint8_t const*>(buffer_), d.xy(),
+                          layout.num_channels, threads);
 }
 
 bool Writer::write(std::string_view name, Byte3 const& image) {
@@ -181,21 +161,13 @@ bool Writer::write_heatmap(std::string_view name, float const* data, int2 dimens
         },
         0, dimensions[0] * dimensions[1]);
 
-    size_t buffer_len = 0;
-    void*  png_buffer = tdefl_write_image_to_png_file_in_memory(bytes, dimensions[0], dimensions[1],
-                                                               3, &buffer_len);
+    Encoder encoder;
+    bool const result = encoder.write(stream, reinterpret_cast<uint8_t const*>(bytes), dimensions,
+                                      3, threads);
 
     memory::free_aligned(bytes);
 
-    if (!png_buffer) {
-        return false;
-    }
-
-    stream.write(static_cast<char*>(png_buffer), buffer_len);
-
-    mz_free(png_buffer);
-
-    return true;
+    return result;
 }
 
 void Writer::to_depth(Float4 const& image) {
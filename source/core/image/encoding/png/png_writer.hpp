@@ -3,6 +3,7 @@
 
 #include "image/encoding/encoding_srgb.hpp"
 #include "image/image_writer.hpp"
+#include "png_encoder.hpp"
 
 namespace image::encoding::png {
 
@@ -28,6 +29,8 @@ class Writer : public image::Writer, Srgb {
 
   private:
     void to_depth(Float4 const& image);
+
+    Encoder encoder_;
 };
 
 }  // namespace image::encoding::png
@@ -1,13 +1,17 @@
 #include "sub_image_reader.hpp"
+#include "sub_image_sparse.hpp"
 #include "base/math/vector3.inl"
 #include "base/memory/array.inl"
 #include "base/memory/bitfield.inl"
 #include "base/string/string.hpp"
+#include "file/file_mapping.hpp"
 #include "image/image.hpp"
+#include "image/tiled_image.hpp"
 #include "image/typed_image.hpp"
 #include "json/json.hpp"
 #include "logging/logging.hpp"
 
+#include <bit>
 #include <fstream>
 
 namespace image::encoding::sub {
@@ -19,6 +23,26 @@ static bool read_image_type(json::Value const& value, Image::Type& type) {
             return true;
         }
 
+        if ("Byte2" == node->value) {
+            type = Image::Type::Byte2;
+            return true;
+        }
+
+        if ("Byte3" == node->value) {
+            type = Image::Type::Byte3;
+            return true;
+        }
+
+        if ("Byte4" == node->value) {
+            type = Image::Type::Byte4;
+            return true;
+        }
+
+        if ("Short3" == node->value) {
+            type = Image::Type::Short3;
+            return true;
+        }
+
         if ("Float1" == node->value) {
             type = Image::Type::Float1;
             return true;
@@ -28,12 +52,243 @@ static bool read_image_type(json::Value const& value, Image::Type& type) {
             type = Image::Type::Float2;
             return true;
         }
+
+        if ("Float3" == node->value) {
+            type = Image::Type::Float3;
+            return true;
+        }
+
+        if ("Float4" == node->value) {
+            type = Image::Type::Float4;
+            return true;
+        }
     }
 
     return false;
 }
 
-Image* Reader::read(std::istream& stream) {
+static bool map(std::string const& name, uint64_t offset, uint64_t num_bytes,
+                file::Mapping& mapping) {
+    if (name.empty() || !mapping.open(name)) {
+        return false;
+    }
+
+    return mapping.size() >= offset + num_bytes;
+}
+
+template <typename T>
+static bool map(std::string const& name, Description const& description, uint64_t offset,
+                file::Mapping& mapping) {
+    if (0 != offset % alignof(T)) {
+        return false;
+    }
+
+    return map(name, offset, description.num_pixels() * sizeof(T), mapping);
+}
+
+static bool read_binary(json::Value const& value, uint64_t& offset, uint64_t& size) {
+    auto const binary_node = value.FindMember("binary");
+    if (value.MemberEnd() == binary_node) {
+        return false;
+    }
+
+    offset = json::read_uint64(binary_node->value, "offset");
+    size   = json::read_uint64(binary_node->value, "size");
+
+    return true;
+}
+
+static Image* read_sparse(std::istream& stream, std::string const& mapped_name,
+                          Description const& description, json::Value const& value,
+                          uint64_t binary_start, uint64_t pixels_offset, uint64_t pixels_size) {
+    using Sparse = Float1_sparse;
+
+    if (Sparse::Cell_dim != int32_t(json::read_uint(value, "cell_size")) ||
+        Sparse::Tile_dim != int32_t(json::read_uint(value, "tile_size"))) {
+        logging::push_error("Unsupported sparse layout.");
+        return nullptr;
+    }
+
+    uint64_t tiles_offset = 0;
+    uint64_t tiles_size   = 0;
+
+    uint64_t cells_offset = 0;
+    uint64_t cells_size   = 0;
+
+    auto const tiles_node = value.FindMember("tiles");
+    auto const cells_node = value.FindMember("cells");
+
+    if (value.MemberEnd() == tiles_node || value.MemberEnd() == cells_node ||
+        !read_binary(tiles_node->value, tiles_offset, tiles_size) ||
+        !read_binary(cells_node->value, cells_offset, cells_size)) {
+        logging::push_error("Incomplete sparse layout.");
+        return nullptr;
+    }
+
+    uint64_t const pixels_start = binary_start + pixels_offset;
+
+    uint64_t constexpr Cell_bytes = Sparse::Cell_len * sizeof(float);
+
+    // The voxels of the active cells can be used in place
+    file::Mapping mapping;
+
+    bool const mapped = 0 == pixels_start % alignof(float) &&
+                        map(mapped_name, pixels_start, pixels_size, mapping);
+
+    char* const mapped_pixels = mapped ? mapping.data() + pixels_start : nullptr;
+
+    auto image = mapped ? new Image(Sparse(description, std::move(mapping)))
+                        : new Image(Sparse(description));
+
+    Sparse& sparse = image->float1_sparse();
+
+    int3 const nt = sparse.num_tiles();
+
+    uint32_t const num_tiles = uint32_t(nt[0] * nt[1] * nt[2]);
+
+    if (uint64_t(num_tiles) * sizeof(Sparse_tile) != tiles_size) {
+        logging::push_error("Number of tiles does not match the dimensions.");
+        delete image;
+        return nullptr;
+    }
+
+    memory::Array<Sparse_tile> tiles(num_tiles);
+
+    stream.seekg(std::streamoff(binary_start + tiles_offset));
+    stream.read(reinterpret_cast<char*>(tiles.data()), std::streamsize(tiles_size));
+
+    uint32_t const num_cells = uint32_t(cells_size / sizeof(float2));
+
+    memory::Array<float2> cells(num_cells);
+
+    stream.seekg(std::streamoff(binary_start + cells_offset));
+    stream.read(reinterpret_cast<char*>(cells.data()), std::streamsize(cells_size));
+
+    uint64_t const num_blocks = pixels_size / Cell_bytes;
+
+    uint64_t block = 0;
+
+    stream.seekg(std::streamoff(pixels_start));
+
+    for (uint32_t t = 0; t < num_tiles; ++t) {
+        Sparse_tile const& st = tiles[t];
+
+        sparse.set_tile(int32_t(t), st.value);
+
+        if (0xFFFFFFFF == st.cells) {
+            continue;
+        }
+
+        if (uint64_t(st.cells) + Sparse::Tile_len > num_cells ||
+            block + uint64_t(std::popcount(st.active)) > num_blocks) {
+            logging::push_error("Sparse layout is out of bounds.");
+            delete image;
+            return nullptr;
+        }
+
+        for (int32_t c = 0; c < Sparse::Tile_len; ++c) {
+            float2 const range = cells[st.cells + uint32_t(c)];
+
+            if (0 == (st.active & (uint64_t(1) << uint32_t(c)))) {
+                sparse.set_cell(int32_t(t), c, nullptr, range[0], range[1]);
+                continue;
+            }
+
+            float* data;
+
+            if (mapped) {
+                data = reinterpret_cast<float*>(mapped_pixels + block * Cell_bytes);
+            } else {
+                data = new float[Sparse::Cell_len];
+
+                stream.read(reinterpret_cast<char*>(data), std::streamsize(Cell_bytes));
+            }
+
+            ++block;
+
+            sparse.set_cell(int32_t(t), c, data, range[0], range[1]);
+        }
+    }
+
+    return image;
+}
+
+template <typename T>
+static Image* read_tiled(std::istream& stream, std::string const& mapped_name,
+                         Description const& description, uint32_t log_tile_size,
+                         uint64_t offset) {
+    uint32_t const pixel_size = uint32_t(sizeof(T));
+
+    uint64_t const num_bytes = Tiled_image::num_bytes(description, pixel_size, log_tile_size);
+
+    if (file::Mapping mapping; map(mapped_name, offset, num_bytes, mapping)) {
+        auto tiled = new Tiled_image(description, pixel_size, log_tile_size, std::move(mapping),
+                                     offset);
+
+        return new Image(Typed_tiled_image<T>(description, tiled));
+    }
+
+    // Without a mapping the tiles can't be loaded on demand, so rearrange them into a dense image
+
+    Typed_image<T> image(description);
+
+    int2 const d = description.dimensions().xy();
+
+    int32_t const tile_size = 1 << log_tile_size;
+
+    memory::Array<T> tile(uint32_t(tile_size * tile_size));
+
+    stream.seekg(std::streamoff(offset));
+
+    for (int32_t ty = 0; ty < d[1]; ty += tile_size) {
+        int32_t const height = std::min(tile_size, d[1] - ty);
+
+        for (int32_t tx = 0; tx < d[0]; tx += tile_size) {
+            int32_t const width = std::min(tile_size, d[0] - tx);
+
+            stream.read(reinterpret_cast<char*>(tile.data()),
+                        std::streamsize(tile.size() * sizeof(T)));
+
+            for (int32_t y = 0; y < height; ++y) {
+                T const* row = tile.data() + y * tile_size;
+
+                std::copy(row, row + width, image.data() + int64_t(ty + y) * d[0] + tx);
+            }
+        }
+    }
+
+    return new Image(std::move(image));
+}
+
+static Image* read_tiled(std::istream& stream, std::string const& mapped_name,
+                         Description const& description, Image::Type type,
+                         uint32_t log_tile_size, uint64_t offset) {
+    switch (type) {
+        case Image::Type::Byte1:
+            return read_tiled<uint8_t>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Byte2:
+            return read_tiled<byte2>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Byte3:
+            return read_tiled<byte3>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Byte4:
+            return read_tiled<byte4>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Short3:
+            return read_tiled<ushort3>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Float1:
+            return read_tiled<float>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Float2:
+            return read_tiled<float2>(stream, mapped_name, description, log_tile_size, offset);
+        case Image::Type::Float3:
+            return read_tiled<packed_float3>(stream, mapped_name, description, log_tile_size,
+                                             offset);
+        case Image::Type::Float4:
+            return read_tiled<float4>(stream, mapped_name, description, log_tile_size, offset);
+        default:
+            return nullptr;
+    }
+}
+
+Image* Reader::read(std::istream& stream, std::string const& mapped_name) {
     stream.seekg(4);
 
     uint64_t json_size = 0;
@@ -89,6 +344,8 @@ Image* Reader::read(std::istream& stream) {
     uint64_t pixels_offset = 0;
     uint64_t pixels_size   = 0;
 
+    uint32_t log_tile_size = 0;
+
     for (auto const& pn : pixels_node->value.GetObject()) {
         if ("binary" == pn.name) {
             pixels_offset = json::read_uint64(pn.value, "offset");
@@ -99,6 +356,15 @@ Image* Reader::read(std::istream& stream) {
             //            } else {
             //                index_bytes = 4;
             //            }
+        } else if ("tile_size" == pn.name) {
+            uint32_t const tile_size = json::read_uint(pn.value);
+
+            if (tile_size < 8 || !std::has_single_bit(tile_size)) {
+                logging::push_error("Tile size must be a power of two of at least 8.");
+                return nullptr;
+            }
+
+            log_tile_size = uint32_t(std::countr_zero(tile_size));
         }
     }
 
@@ -106,6 +372,27 @@ Image* Reader::read(std::istream& stream) {
 
     Description const description(dimensions, offset);
 
+    if (auto const sparse_node = image_node->value.FindMember("sparse");
+        image_node->value.MemberEnd() != sparse_node) {
+        if (Image::Type::Float1 != type) {
+            logging::push_error("Only Float1 images can be sparse.");
+            return nullptr;
+        }
+
+        return read_sparse(stream, mapped_name, description, sparse_node->value, binary_start,
+                           pixels_offset, pixels_size);
+    }
+
+    if (log_tile_size > 0) {
+        if (dimensions[2] > 1) {
+            logging::push_error("Only 2D images can be tiled.");
+            return nullptr;
+        }
+
+        return read_tiled(stream, mapped_name, description, type, log_tile_size,
+                          binary_start + pixels_offset);
+    }
+
     if (topology_node->value.MemberEnd() != topology_node) {
         uint64_t topology_offset = 0;
         uint64_t topology_size   = 0;
@@ -163,6 +450,8 @@ Image* Reader::read(std::istream& stream) {
                     }
                 }
 
+                image->float1_sparse().optimize();
+
                 return image;
             }
 
@@ -202,7 +491,19 @@ Image* Reader::read(std::istream& stream) {
         }
     }
 
-    stream.seekg(std::streamoff(binary_start + pixels_offset));
+    uint64_t const pixels_start = binary_start + pixels_offset;
+
+    if (Image::Type::Byte1 == type) {
+        if (file::Mapping mapping; map<uint8_t>(mapped_name, description, pixels_start, mapping)) {
+            return new Image(Byte1(description, std::move(mapping), pixels_start));
+        }
+    } else {
+        if (file::Mapping mapping; map<float>(mapped_name, description, pixels_start, mapping)) {
+            return new Image(Float1(description, std::move(mapping), pixels_start));
+        }
+    }
+
+    stream.seekg(std::streamoff(pixels_start));
 
     if (Image::Type::Byte1 == type) {
         auto image = new Image(Byte1(description));
@@ -2,6 +2,7 @@
 #define SU_CORE_IMAGE_ENCODING_SUB_WRITER_HPP
 
 #include <iosfwd>
+#include <string>
 
 namespace image {
 
@@ -11,7 +12,9 @@ namespace encoding::sub {
 
 class Reader {
   public:
-    static Image* read(std::istream& stream);
+    // If mapped_name is given, it must name the uncompressed file behind the stream.
+    // Dense pixels are then used straight from a mapping of that file instead of being copied.
+    static Image* read(std::istream& stream, std::string const& mapped_name = "");
 };
 
 }  // namespace encoding::sub
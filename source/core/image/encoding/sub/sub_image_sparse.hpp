@@ -0,0 +1,20 @@
+#ifndef SU_CORE_IMAGE_ENCODING_SUB_SPARSE_HPP
+#define SU_CORE_IMAGE_ENCODING_SUB_SPARSE_HPP
+
+#include <cstdint>
+
+namespace image::encoding::sub {
+
+// Record of the "tiles" section, see Writer::write_sparse()
+struct Sparse_tile {
+    uint64_t active;
+    float    value;
+    uint32_t cells;
+};
+
+// Read and written as a whole, so it must not contain padding
+static_assert(sizeof(Sparse_tile) == 16);
+
+}  // namespace image::encoding::sub
+
+#endif
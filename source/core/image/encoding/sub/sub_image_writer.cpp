@@ -1,11 +1,16 @@
 #include "sub_image_writer.hpp"
+#include "sub_image_sparse.hpp"
 #include "base/math/vector3.inl"
 #include "base/memory/bitfield.inl"
 #include "base/string/string.hpp"
 #include "image/image.hpp"
+#include "image/typed_image.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 namespace image::encoding::sub {
 
@@ -25,8 +30,22 @@ static std::string image_type_string(Image::Type type) {
     switch (type) {
         case Image::Type::Byte1:
             return "Byte1";
+        case Image::Type::Byte2:
+            return "Byte2";
+        case Image::Type::Byte3:
+            return "Byte3";
+        case Image::Type::Byte4:
+            return "Byte4";
+        case Image::Type::Short3:
+            return "Short3";
         case Image::Type::Float1:
             return "Float1";
+        case Image::Type::Float2:
+            return "Float2";
+        case Image::Type::Float3:
+            return "Float3";
+        case Image::Type::Float4:
+            return "Float4";
         default:
             return "Undefined";
     }
@@ -35,8 +54,16 @@ static std::string image_type_string(Image::Type type) {
 static std::string image_type_encoding(Image::Type type) {
     switch (type) {
         case Image::Type::Byte1:
+        case Image::Type::Byte2:
+        case Image::Type::Byte3:
+        case Image::Type::Byte4:
             return "UInt8";
+        case Image::Type::Short3:
+            return "Float16";
         case Image::Type::Float1:
+        case Image::Type::Float2:
+        case Image::Type::Float3:
+        case Image::Type::Float4:
             return "Float32";
         default:
             return "Undefined";
@@ -47,8 +74,22 @@ static uint32_t image_type_bytes_per_pixel(Image::Type type) {
     switch (type) {
         case Image::Type::Byte1:
             return 1;
+        case Image::Type::Byte2:
+            return 2;
+        case Image::Type::Byte3:
+            return 3;
+        case Image::Type::Byte4:
+            return 4;
+        case Image::Type::Short3:
+            return 6;
         case Image::Type::Float1:
             return 4;
+        case Image::Type::Float2:
+            return 8;
+        case Image::Type::Float3:
+            return 12;
+        case Image::Type::Float4:
+            return 16;
         default:
             return 0;
     }
@@ -241,4 +282,305 @@ void Writer::write(std::string const& filename, Image const& image) {
     }
 }
 
+void Writer::write_tiled(std::string const& filename, Image const& image, uint32_t tile_size) {
+    std::string const out_name = string::extract_filename(filename) + ".sub";
+
+    std::cout << "Export " << out_name << std::endl;
+
+    std::ofstream stream(out_name, std::ios::binary);
+
+    if (!stream) {
+        return;
+    }
+
+    const char header[] = "SUB\000";
+    stream.write(header, sizeof(char) * 4);
+
+    auto const& description = image.description();
+
+    int2 const d = description.dimensions().xy();
+
+    uint32_t const pixel_size = image_type_bytes_per_pixel(image.type());
+
+    int32_t const ts = int32_t(tile_size);
+
+    int32_t const num_tiles_x = (d[0] + ts - 1) / ts;
+    int32_t const num_tiles_y = (d[1] + ts - 1) / ts;
+
+    uint64_t const tile_bytes = uint64_t(tile_size * tile_size) * pixel_size;
+
+    uint64_t const pixels_size = uint64_t(num_tiles_x * num_tiles_y) * tile_bytes;
+
+    std::ostringstream jstream;
+
+    newline(jstream, 0);
+    jstream << "{";
+
+    newline(jstream, 1);
+    jstream << R"("image":{)";
+
+    newline(jstream, 2);
+    jstream << R"("description":{)";
+
+    newline(jstream, 3);
+    jstream << R"("type":")" << image_type_string(image.type()) << R"(",)";
+
+    newline(jstream, 3);
+    jstream << R"("dimensions":[)";
+    jstream << d[0] << "," << d[1] << ",1]";
+
+    // close description
+    newline(jstream, 2);
+    jstream << "},";
+
+    newline(jstream, 2);
+    jstream << R"("pixels":{)";
+
+    newline(jstream, 3);
+    binary_tag(jstream, 0, pixels_size);
+    jstream << ",";
+
+    newline(jstream, 3);
+    jstream << R"("encoding":")" << image_type_encoding(image.type()) << R"(",)";
+
+    newline(jstream, 3);
+    jstream << R"("tile_size":)" << tile_size;
+
+    // close pixels
+    newline(jstream, 2);
+    jstream << "}";
+
+    // close image
+    newline(jstream, 1);
+    jstream << "}";
+
+    // close start
+    newline(jstream, 0);
+    jstream << "}";
+
+    newline(jstream, 0);
+
+    std::string const json_string = jstream.str();
+    uint64_t const    json_size   = json_string.size() - 1;
+
+    stream.write(reinterpret_cast<char const*>(&json_size), sizeof(uint64_t));
+    stream.write(reinterpret_cast<char const*>(json_string.data()),
+                 std::streamsize(json_size * sizeof(char)));
+
+    // Tiles in rows, and the pixels of each tile in rows.
+    // The tiles at the right and bottom edges are padded to full size.
+
+    std::vector<char> tile(tile_bytes);
+
+    char const* pixels = image.data();
+
+    uint64_t const row_bytes = uint64_t(d[0]) * pixel_size;
+
+    for (int32_t ty = 0; ty < d[1]; ty += ts) {
+        int32_t const height = std::min(ts, d[1] - ty);
+
+        for (int32_t tx = 0; tx < d[0]; tx += ts) {
+            int32_t const width = std::min(ts, d[0] - tx);
+
+            std::fill(tile.begin(), tile.end(), 0);
+
+            for (int32_t y = 0; y < height; ++y) {
+                char const* row = pixels + uint64_t(ty + y) * row_bytes + uint64_t(tx) * pixel_size;
+
+                std::copy(row, row + uint64_t(width) * pixel_size,
+                          tile.data() + uint64_t(y * ts) * pixel_size);
+            }
+
+            stream.write(tile.data(), std::streamsize(tile_bytes));
+        }
+    }
+}
+
+static void write_sparse(std::ostream& stream, Float1_sparse const& image) {
+    using Sparse = Float1_sparse;
+
+    int3 const nt = image.num_tiles();
+
+    uint32_t const num_tiles = uint32_t(nt[0] * nt[1] * nt[2]);
+
+    std::vector<Sparse_tile> tiles(num_tiles);
+
+    uint32_t num_cells  = 0;
+    uint64_t num_blocks = 0;
+
+    for (uint32_t i = 0; i < num_tiles; ++i) {
+        Sparse::Tile const& tile = image.tile(int32_t(i));
+
+        if (!tile.cells) {
+            tiles[i] = Sparse_tile{0, tile.value, 0xFFFFFFFF};
+            continue;
+        }
+
+        tiles[i] = Sparse_tile{tile.active, tile.value, num_cells};
+
+        num_cells += Sparse::Tile_len;
+
+        num_blocks += uint64_t(std::popcount(tile.active));
+    }
+
+    uint64_t const tiles_size  = tiles.size() * sizeof(Sparse_tile);
+    uint64_t const cells_size  = uint64_t(num_cells) * sizeof(float2);
+    uint64_t const cell_bytes  = Sparse::Cell_len * sizeof(float);
+    uint64_t const pixels_size = num_blocks * cell_bytes;
+
+    std::ostringstream jstream;
+
+    newline(jstream, 0);
+    jstream << "{";
+
+    newline(jstream, 1);
+    jstream << R"("image":{)";
+
+    newline(jstream, 2);
+    jstream << R"("description":{)";
+
+    newline(jstream, 3);
+    jstream << R"("type":"Float1",)";
+
+    int3 const d = image.description().dimensions();
+    newline(jstream, 3);
+    jstream << R"("dimensions":[)";
+    jstream << d[0] << "," << d[1] << "," << d[2] << "]";
+
+    // close description
+    newline(jstream, 2);
+    jstream << "},";
+
+    newline(jstream, 2);
+    jstream << R"("sparse":{)";
+
+    newline(jstream, 3);
+    jstream << R"("cell_size":)" << Sparse::Cell_dim << ",";
+
+    newline(jstream, 3);
+    jstream << R"("tile_size":)" << Sparse::Tile_dim << ",";
+
+    newline(jstream, 3);
+    jstream << R"("tiles":{)";
+    binary_tag(jstream, 0, tiles_size);
+    jstream << "},";
+
+    newline(jstream, 3);
+    jstream << R"("cells":{)";
+    binary_tag(jstream, tiles_size, cells_size);
+    jstream << "}";
+
+    // close sparse
+    newline(jstream, 2);
+    jstream << "},";
+
+    newline(jstream, 2);
+    jstream << R"("pixels":{)";
+
+    newline(jstream, 3);
+    binary_tag(jstream, tiles_size + cells_size, pixels_size);
+    jstream << ",";
+
+    newline(jstream, 3);
+    jstream << R"("encoding":"Float32")";
+
+    // close pixels
+    newline(jstream, 2);
+    jstream << "}";
+
+    // close image
+    newline(jstream, 1);
+    jstream << "}";
+
+    // close start
+    newline(jstream, 0);
+    jstream << "}";
+
+    newline(jstream, 0);
+
+    std::string json_string = jstream.str();
+
+    // Align the binary part, so that the voxels can be mapped
+    while (0 != (4 + sizeof(uint64_t) + json_string.size()) % 16) {
+        json_string.push_back(' ');
+    }
+
+    uint64_t const json_size = json_string.size();
+
+    stream.write(reinterpret_cast<char const*>(&json_size), sizeof(uint64_t));
+    stream.write(reinterpret_cast<char const*>(json_string.data()),
+                 std::streamsize(json_size * sizeof(char)));
+
+    stream.write(reinterpret_cast<char const*>(tiles.data()), std::streamsize(tiles_size));
+
+    for (uint32_t i = 0; i < num_tiles; ++i) {
+        Sparse::Tile const& tile = image.tile(int32_t(i));
+
+        if (tile.cells) {
+            for (int32_t c = 0; c < Sparse::Tile_len; ++c) {
+                float2 const range(tile.cells[c].min, tile.cells[c].max);
+
+                stream.write(reinterpret_cast<char const*>(&range), sizeof(float2));
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < num_tiles; ++i) {
+        Sparse::Tile const& tile = image.tile(int32_t(i));
+
+        if (!tile.cells) {
+            continue;
+        }
+
+        for (int32_t c = 0; c < Sparse::Tile_len; ++c) {
+            if (float const* data = tile.cells[c].data; data) {
+                stream.write(reinterpret_cast<char const*>(data), std::streamsize(cell_bytes));
+            }
+        }
+    }
+}
+
+void Writer::write_sparse(std::string const& filename, Image const& image) {
+    Image::Type const type = image.type();
+
+    // Dense volumes must be resident
+    if (Image::Type::Float1_sparse != type && (Image::Type::Float1 != type || !image.data())) {
+        return;
+    }
+
+    std::string const out_name = string::extract_filename(filename) + ".sub";
+
+    std::cout << "Export " << out_name << std::endl;
+
+    std::ofstream stream(out_name, std::ios::binary);
+
+    if (!stream) {
+        return;
+    }
+
+    const char header[] = "SUB\000";
+    stream.write(header, sizeof(char) * 4);
+
+    if (Image::Type::Float1_sparse == type) {
+        sub::write_sparse(stream, image.float1_sparse());
+        return;
+    }
+
+    auto const& description = image.description();
+
+    Float1_sparse sparse(description);
+
+    float const* data = image.float1().data();
+
+    for (uint64_t i = 0, len = description.num_pixels(); i < len; ++i) {
+        if (float const density = data[i]; 0.f != density) {
+            sparse.store_sequentially(int64_t(i), density);
+        }
+    }
+
+    sparse.optimize();
+
+    sub::write_sparse(stream, sparse);
+}
+
 }  // namespace image::encoding::sub
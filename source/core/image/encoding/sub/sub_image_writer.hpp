@@ -1,6 +1,7 @@
 #ifndef SU_CORE_IMAGE_ENCODING_SUB_WRITER_HPP
 #define SU_CORE_IMAGE_ENCODING_SUB_WRITER_HPP
 
+#include <cstdint>
 #include <string>
 
 namespace image {
@@ -12,6 +13,18 @@ namespace encoding::sub {
 class Writer {
   public:
     static void write(std::string const& filename, Image const& image);
+
+    // Stores the pixels of a 2D image in tiles of tile_size x tile_size pixels,
+    // which can then be loaded on demand. tile_size must be a power of two of at least 8.
+    static void write_tiled(std::string const& filename, Image const& image, uint32_t tile_size);
+
+    // Stores a Float1 volume in the layout of Float1_sparse, so that it can be loaded directly.
+    // Binary sections:
+    // "tiles": For each tile {uint64 active; float value; uint32 cells}, where cells is the index
+    //          of the first of the tile's cell records, or 0xFFFFFFFF for a uniform tile
+    // "cells": For each cell {float min; float max}
+    // "pixels": The voxels of all active cells, in the order of the tiles and their active bits
+    static void write_sparse(std::string const& filename, Image const& image);
 };
 
 }  // namespace encoding::sub
@@ -31,6 +31,24 @@ namespace image {
             return float3_.NAME(__VA_ARGS__);        \
         case Type::Float4:                           \
             return float4_.NAME(__VA_ARGS__);        \
+        case Type::Byte1_tiled:                      \
+            return byte1_tiled_.NAME(__VA_ARGS__);   \
+        case Type::Byte2_tiled:                      \
+            return byte2_tiled_.NAME(__VA_ARGS__);   \
+        case Type::Byte3_tiled:                      \
+            return byte3_tiled_.NAME(__VA_ARGS__);   \
+        case Type::Byte4_tiled:                      \
+            return byte4_tiled_.NAME(__VA_ARGS__);   \
+        case Type::Short3_tiled:                     \
+            return short3_tiled_.NAME(__VA_ARGS__);  \
+        case Type::Float1_tiled:                     \
+            return float1_tiled_.NAME(__VA_ARGS__);  \
+        case Type::Float2_tiled:                     \
+            return float2_tiled_.NAME(__VA_ARGS__);  \
+        case Type::Float3_tiled:                     \
+            return float3_tiled_.NAME(__VA_ARGS__);  \
+        case Type::Float4_tiled:                     \
+            return float4_tiled_.NAME(__VA_ARGS__);  \
     }
 
 char const* Image::identifier() {
@@ -47,8 +65,23 @@ IMAGE_CONSTRUCTOR(Float1_sparse, float1_sparse_)
 IMAGE_CONSTRUCTOR(Float2, float2_)
 IMAGE_CONSTRUCTOR(Float3, float3_)
 IMAGE_CONSTRUCTOR(Float4, float4_)
+IMAGE_CONSTRUCTOR(Byte1_tiled, byte1_tiled_)
+IMAGE_CONSTRUCTOR(Byte2_tiled, byte2_tiled_)
+IMAGE_CONSTRUCTOR(Byte3_tiled, byte3_tiled_)
+IMAGE_CONSTRUCTOR(Byte4_tiled, byte4_tiled_)
+IMAGE_CONSTRUCTOR(Short3_tiled, short3_tiled_)
+IMAGE_CONSTRUCTOR(Float1_tiled, float1_tiled_)
+IMAGE_CONSTRUCTOR(Float2_tiled, float2_tiled_)
+IMAGE_CONSTRUCTOR(Float3_tiled, float3_tiled_)
+IMAGE_CONSTRUCTOR(Float4_tiled, float4_tiled_)
 
 Image::~Image() {
+    for (uint32_t i = 1; i < num_levels_; ++i) {
+        delete levels_[i - 1];
+    }
+
+    delete[] levels_;
+
     switch (type_) {
         case Type::Byte1:
             byte1_.~Byte1();
@@ -80,6 +113,33 @@ Image::~Image() {
         case Type::Float4:
             float4_.~Float4();
             break;
+        case Type::Byte1_tiled:
+            byte1_tiled_.~Byte1_tiled();
+            break;
+        case Type::Byte2_tiled:
+            byte2_tiled_.~Byte2_tiled();
+            break;
+        case Type::Byte3_tiled:
+            byte3_tiled_.~Byte3_tiled();
+            break;
+        case Type::Byte4_tiled:
+            byte4_tiled_.~Byte4_tiled();
+            break;
+        case Type::Short3_tiled:
+            short3_tiled_.~Short3_tiled();
+            break;
+        case Type::Float1_tiled:
+            float1_tiled_.~Float1_tiled();
+            break;
+        case Type::Float2_tiled:
+            float2_tiled_.~Float2_tiled();
+            break;
+        case Type::Float3_tiled:
+            float3_tiled_.~Float3_tiled();
+            break;
+        case Type::Float4_tiled:
+            float4_tiled_.~Float4_tiled();
+            break;
     }
 }
 
@@ -115,11 +175,40 @@ char* Image::data() const {
             return reinterpret_cast<char*>(float3_.data());
         case Type::Float4:
             return reinterpret_cast<char*>(float4_.data());
+        case Type::Byte1_tiled:
+        case Type::Byte2_tiled:
+        case Type::Byte3_tiled:
+        case Type::Byte4_tiled:
+        case Type::Short3_tiled:
+        case Type::Float1_tiled:
+        case Type::Float2_tiled:
+        case Type::Float3_tiled:
+        case Type::Float4_tiled:
+            return nullptr;
     }
 
     return reinterpret_cast<char*>(byte1_.data());
 }
 
+uint32_t Image::num_levels() const {
+    return num_levels_;
+}
+
+Image const* Image::level(uint32_t level) const {
+    return 0 == level ? this : levels_[level - 1];
+}
+
+void Image::set_levels(uint32_t num_levels, Image** levels) {
+    for (uint32_t i = 1; i < num_levels_; ++i) {
+        delete levels_[i - 1];
+    }
+
+    delete[] levels_;
+
+    num_levels_ = num_levels;
+    levels_     = levels;
+}
+
 Byte1 const& Image::byte1() const {
     return byte1_;
 }
@@ -160,6 +249,42 @@ Float4 const& Image::float4() const {
     return float4_;
 }
 
+Byte1_tiled const& Image::byte1_tiled() const {
+    return byte1_tiled_;
+}
+
+Byte2_tiled const& Image::byte2_tiled() const {
+    return byte2_tiled_;
+}
+
+Byte3_tiled const& Image::byte3_tiled() const {
+    return byte3_tiled_;
+}
+
+Byte4_tiled const& Image::byte4_tiled() const {
+    return byte4_tiled_;
+}
+
+Short3_tiled const& Image::short3_tiled() const {
+    return short3_tiled_;
+}
+
+Float1_tiled const& Image::float1_tiled() const {
+    return float1_tiled_;
+}
+
+Float2_tiled const& Image::float2_tiled() const {
+    return float2_tiled_;
+}
+
+Float3_tiled const& Image::float3_tiled() const {
+    return float3_tiled_;
+}
+
+Float4_tiled const& Image::float4_tiled() const {
+    return float4_tiled_;
+}
+
 Byte1& Image::byte1() {
     return byte1_;
 }
@@ -200,6 +325,42 @@ Float4& Image::float4() {
     return float4_;
 }
 
+Byte1_tiled& Image::byte1_tiled() {
+    return byte1_tiled_;
+}
+
+Byte2_tiled& Image::byte2_tiled() {
+    return byte2_tiled_;
+}
+
+Byte3_tiled& Image::byte3_tiled() {
+    return byte3_tiled_;
+}
+
+Byte4_tiled& Image::byte4_tiled() {
+    return byte4_tiled_;
+}
+
+Short3_tiled& Image::short3_tiled() {
+    return short3_tiled_;
+}
+
+Float1_tiled& Image::float1_tiled() {
+    return float1_tiled_;
+}
+
+Float2_tiled& Image::float2_tiled() {
+    return float2_tiled_;
+}
+
+Float3_tiled& Image::float3_tiled() {
+    return float3_tiled_;
+}
+
+Float4_tiled& Image::float4_tiled() {
+    return float4_tiled_;
+}
+
 }  // namespace image
 
 #endif
@@ -17,7 +17,16 @@ class Image {
         Float1_sparse,
         Float2,
         Float3,
-        Float4
+        Float4,
+        Byte1_tiled,
+        Byte2_tiled,
+        Byte3_tiled,
+        Byte4_tiled,
+        Short3_tiled,
+        Float1_tiled,
+        Float2_tiled,
+        Float3_tiled,
+        Float4_tiled
     };
 
     static char const* identifier();
@@ -32,6 +41,15 @@ class Image {
     Image(Float2&& image) noexcept;
     Image(Float3&& image) noexcept;
     Image(Float4&& image) noexcept;
+    Image(Byte1_tiled&& image) noexcept;
+    Image(Byte2_tiled&& image) noexcept;
+    Image(Byte3_tiled&& image) noexcept;
+    Image(Byte4_tiled&& image) noexcept;
+    Image(Short3_tiled&& image) noexcept;
+    Image(Float1_tiled&& image) noexcept;
+    Image(Float2_tiled&& image) noexcept;
+    Image(Float3_tiled&& image) noexcept;
+    Image(Float4_tiled&& image) noexcept;
 
     ~Image();
 
@@ -41,6 +59,15 @@ class Image {
 
     char* data() const;
 
+    // Number of mip levels, including the image itself
+    uint32_t num_levels() const;
+
+    // Level 0 is the image itself, every further level halves the dimensions of the previous one
+    Image const* level(uint32_t level) const;
+
+    // Takes ownership of the num_levels - 1 downsampled images
+    void set_levels(uint32_t num_levels, Image** levels);
+
     Byte1 const&         byte1() const;
     Byte2 const&         byte2() const;
     Byte3 const&         byte3() const;
@@ -52,6 +79,16 @@ class Image {
     Float3 const&        float3() const;
     Float4 const&        float4() const;
 
+    Byte1_tiled const&  byte1_tiled() const;
+    Byte2_tiled const&  byte2_tiled() const;
+    Byte3_tiled const&  byte3_tiled() const;
+    Byte4_tiled const&  byte4_tiled() const;
+    Short3_tiled const& short3_tiled() const;
+    Float1_tiled const& float1_tiled() const;
+    Float2_tiled const& float2_tiled() const;
+    Float3_tiled const& float3_tiled() const;
+    Float4_tiled const& float4_tiled() const;
+
     Byte1&         byte1();
     Byte2&         byte2();
     Byte3&         byte3();
@@ -63,6 +100,16 @@ class Image {
     Float3&        float3();
     Float4&        float4();
 
+    Byte1_tiled&  byte1_tiled();
+    Byte2_tiled&  byte2_tiled();
+    Byte3_tiled&  byte3_tiled();
+    Byte4_tiled&  byte4_tiled();
+    Short3_tiled& short3_tiled();
+    Float1_tiled& float1_tiled();
+    Float2_tiled& float2_tiled();
+    Float3_tiled& float3_tiled();
+    Float4_tiled& float4_tiled();
+
   private:
     Type const type_;
 
@@ -77,7 +124,20 @@ class Image {
         Float2        float2_;
         Float3        float3_;
         Float4        float4_;
+        Byte1_tiled   byte1_tiled_;
+        Byte2_tiled   byte2_tiled_;
+        Byte3_tiled   byte3_tiled_;
+        Byte4_tiled   byte4_tiled_;
+        Short3_tiled  short3_tiled_;
+        Float1_tiled  float1_tiled_;
+        Float2_tiled  float2_tiled_;
+        Float3_tiled  float3_tiled_;
+        Float4_tiled  float4_tiled_;
     };
+
+    uint32_t num_levels_ = 1;
+
+    Image** levels_ = nullptr;
 };
 
 }  // namespace image
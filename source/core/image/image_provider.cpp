@@ -15,13 +15,18 @@
 #include "resource/resource_provider.inl"
 #include "string/string.hpp"
 
+#include <algorithm>
 #include <istream>
 
 namespace image {
 
 Provider::Provider() = default;
 
-Provider::~Provider() = default;
+Provider::~Provider() {
+    for (auto r : png_readers_) {
+        delete r;
+    }
+}
 
 Image* Provider::load(std::string const& filename, Variants const& options, Resources& resources,
                       std::string& resolved_name) {
@@ -38,16 +43,12 @@ Image* Provider::load(std::string const& filename, Variants const& options, Reso
         return nullptr;
     }
 
-    bool const same_file = previous_name_ == resolved_name;
-
-    previous_name_ = resolved_name;
-
     file::Type const type = file::query_type(*stream);
 
     if (file::Type::EXR == type) {
         bool const color = options.query("color", false);
 
-        return encoding::exr::Reader::read(*stream, color);
+        return encoding::exr::Reader::read(*stream, color, resources.threads());
     }
 
     if (file::Type::PNG == type) {
@@ -55,11 +56,21 @@ Image* Provider::load(std::string const& filename, Variants const& options, Reso
 
         bool const invert = options.query("invert", false);
 
-        if (same_file) {
-            return png_reader_.create_from_buffer(swizzle, invert);
+        Png_reader* png = acquire_png_reader(resolved_name);
+
+        Image* image;
+
+        if (png->name == resolved_name) {
+            image = png->reader.create_from_buffer(swizzle, invert);
+        } else {
+            image = png->reader.read(*stream, swizzle, invert, resources.threads());
+
+            png->name = image ? resolved_name : "";
         }
 
-        return png_reader_.read(*stream, swizzle, invert);
+        release_png_reader(png);
+
+        return image;
     }
 
     if (file::Type::RGBE == type) {
@@ -67,7 +78,9 @@ Image* Provider::load(std::string const& filename, Variants const& options, Reso
     }
 
     if (file::Type::SUB == type) {
-        return encoding::sub::Reader::read(*stream);
+        bool const uncompressed = file::System::Stream_ptr::Type::Uncompressed == stream.type();
+
+        return encoding::sub::Reader::read(*stream, uncompressed ? resolved_name : "");
     }
 
     if (file::Type::Undefined == type) {
@@ -169,7 +182,43 @@ Image* Provider::load(void const* data, std::string const& /*source_name*/,
 }
 
 void Provider::increment_generation() {
-    previous_name_.clear();
+    std::lock_guard<std::mutex> lock(png_mutex_);
+
+    for (auto r : png_readers_) {
+        r->name.clear();
+    }
+}
+
+Provider::Png_reader* Provider::acquire_png_reader(std::string const& name) {
+    std::lock_guard<std::mutex> lock(png_mutex_);
+
+    if (free_png_readers_.empty()) {
+        auto r = new Png_reader;
+
+        png_readers_.push_back(r);
+
+        return r;
+    }
+
+    // Prefer a reader that still holds the requested file
+    auto r = std::find_if(free_png_readers_.begin(), free_png_readers_.end(),
+                          [&name](Png_reader const* png) { return png->name == name; });
+
+    if (free_png_readers_.end() == r) {
+        r = free_png_readers_.end() - 1;
+    }
+
+    Png_reader* reader = *r;
+
+    free_png_readers_.erase(r);
+
+    return reader;
+}
+
+void Provider::release_png_reader(Png_reader* reader) {
+    std::lock_guard<std::mutex> lock(png_mutex_);
+
+    free_png_readers_.push_back(reader);
 }
 
 }  // namespace image
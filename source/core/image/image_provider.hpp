@@ -5,6 +5,9 @@
 #include "procedural/flakes/flakes_provider.hpp"
 #include "resource/resource_provider.hpp"
 
+#include <mutex>
+#include <vector>
+
 namespace image {
 
 class Image;
@@ -40,11 +43,24 @@ class Provider final : public resource::Provider<Image> {
     void increment_generation() final;
 
   private:
-    encoding::png::Reader png_reader_;
+    // Readers keep the last decoded file, so that it can be swizzled differently without
+    // decoding it again. Several of them allow loading images concurrently.
+    struct Png_reader {
+        encoding::png::Reader reader;
+
+        std::string name;
+    };
+
+    Png_reader* acquire_png_reader(std::string const& name);
+
+    void release_png_reader(Png_reader* reader);
 
     procedural::flakes::Provider flakes_provider_;
 
-    std::string previous_name_;
+    std::mutex png_mutex_;
+
+    std::vector<Png_reader*> png_readers_;
+    std::vector<Png_reader*> free_png_readers_;
 };
 
 }  // namespace image
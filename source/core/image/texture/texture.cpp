@@ -20,6 +20,13 @@ float Texture::at_1(int32_t x, int32_t y, Scene const& scene) const {
         case Type::Float1: {
             return image->float1().at(x, y);
         }
+        case Type::Byte1_unorm_tiled: {
+            uint8_t const value = image->byte1_tiled().at(x, y);
+            return encoding::cached_unorm_to_float(value);
+        }
+        case Type::Float1_tiled: {
+            return image->float1_tiled().at(x, y);
+        }
         default:
             SOFT_ASSERT(false);
             return 0.f;
@@ -49,6 +56,25 @@ float2 Texture::at_2(int32_t x, int32_t y, Scene const& scene) const {
         case Type::Float2: {
             return image->float2().at(x, y);
         }
+        case Type::Byte1_unorm_tiled: {
+            uint8_t const value = image->byte1_tiled().at(x, y);
+            return float2(encoding::cached_unorm_to_float(value), 0.f);
+        }
+        case Type::Byte2_snorm_tiled: {
+            byte2 const value = image->byte2_tiled().at(x, y);
+            return encoding::cached_snorm_to_float(value);
+        }
+        case Type::Byte2_unorm_tiled: {
+            byte2 const value = image->byte2_tiled().at(x, y);
+            return encoding::cached_unorm_to_float(value);
+        }
+        case Type::Byte3_snorm_tiled: {
+            byte3 const value = image->byte3_tiled().at(x, y);
+            return encoding::cached_snorm_to_float(value.xy());
+        }
+        case Type::Float2_tiled: {
+            return image->float2_tiled().at(x, y);
+        }
         default:
             SOFT_ASSERT(false);
             return float2(0.f);
@@ -77,6 +103,24 @@ float3 Texture::at_3(int32_t x, int32_t y, Scene const& scene) const {
         case Type::Float3: {
             return float3(image->float3().at(x, y));
         }
+        case Type::Byte3_snorm_tiled: {
+            byte3 const value = image->byte3_tiled().at(x, y);
+            return encoding::cached_snorm_to_float(value);
+        }
+        case Type::Byte3_sRGB_tiled: {
+            byte3 const value = image->byte3_tiled().at(x, y);
+#ifdef SU_ACESCG
+            return spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(value));
+#else
+            return encoding::cached_srgb_to_float(value);
+#endif
+        }
+        case Type::Half3_tiled: {
+            return float3(half_to_float(image->short3_tiled().at(x, y)));
+        }
+        case Type::Float3_tiled: {
+            return float3(image->float3_tiled().at(x, y));
+        }
         default:
             SOFT_ASSERT(false);
             return float3(0.f);
@@ -115,6 +159,34 @@ float4 Texture::at_4(int32_t x, int32_t y, Scene const& scene) const {
         case Type::Float3: {
             return float4(image->float3().at(x, y));
         }
+        case Type::Byte3_snorm_tiled: {
+            byte3 const value = image->byte3_tiled().at(x, y);
+            return float4(encoding::cached_snorm_to_float(value));
+        }
+        case Type::Byte3_sRGB_tiled: {
+            byte3 const value = image->byte3_tiled().at(x, y);
+#ifdef SU_ACESCG
+            return float4(spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(value)));
+#else
+            return encoding::cached_srgb_to_float(value);
+#endif
+        }
+        case Type::Byte4_sRGB_tiled: {
+            byte4 const value = image->byte4_tiled().at(x, y);
+#ifdef SU_ACESCG
+            return float4(spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(value.xyz())),
+                          encoding::cached_unorm_to_float(value[3]));
+#else
+            return float4(encoding::cached_srgb_to_float(value),
+                          encoding::cached_unorm_to_float(value[3]));
+#endif
+        }
+        case Type::Half3_tiled: {
+            return float4(half_to_float(image->short3_tiled().at(x, y)));
+        }
+        case Type::Float3_tiled: {
+            return float4(image->float3_tiled().at(x, y));
+        }
         default:
             SOFT_ASSERT(false);
             return float4(0.f);
@@ -122,7 +194,14 @@ float4 Texture::at_4(int32_t x, int32_t y, Scene const& scene) const {
 }
 
 void Texture::gather_1(int4_p xy_xy1, Scene const& scene, float c[4]) const {
-    Image const* image = scene.image(image_);
+    gather_1(scene.image(image_), xy_xy1, c);
+}
+
+void Texture::gather_1(int4_p xy_xy1, uint32_t level, Scene const& scene, float c[4]) const {
+    gather_1(scene.image(image_)->level(level), xy_xy1, c);
+}
+
+void Texture::gather_1(Image const* image, int4_p xy_xy1, float c[4]) const {
 
     switch (type_) {
         case Type::Byte1_unorm: {
@@ -135,6 +214,16 @@ void Texture::gather_1(int4_p xy_xy1, Scene const& scene, float c[4]) const {
             c[3] = encoding::cached_unorm_to_float(values[3]);
             return;
         }
+        case Type::Byte1_unorm_tiled: {
+            uint8_t values[4];
+            image->byte1_tiled().gather(xy_xy1, values);
+
+            c[0] = encoding::cached_unorm_to_float(values[0]);
+            c[1] = encoding::cached_unorm_to_float(values[1]);
+            c[2] = encoding::cached_unorm_to_float(values[2]);
+            c[3] = encoding::cached_unorm_to_float(values[3]);
+            return;
+        }
         default:
             SOFT_ASSERT(false);
             return;
@@ -142,7 +231,14 @@ void Texture::gather_1(int4_p xy_xy1, Scene const& scene, float c[4]) const {
 }
 
 void Texture::gather_2(int4_p xy_xy1, Scene const& scene, float2 c[4]) const {
-    Image const* image = scene.image(image_);
+    gather_2(scene.image(image_), xy_xy1, c);
+}
+
+void Texture::gather_2(int4_p xy_xy1, uint32_t level, Scene const& scene, float2 c[4]) const {
+    gather_2(scene.image(image_)->level(level), xy_xy1, c);
+}
+
+void Texture::gather_2(Image const* image, int4_p xy_xy1, float2 c[4]) const {
 
     switch (type_) {
         case Type::Byte1_unorm: {
@@ -185,6 +281,46 @@ void Texture::gather_2(int4_p xy_xy1, Scene const& scene, float2 c[4]) const {
             c[3] = encoding::cached_snorm_to_float(values[3].xy());
             return;
         }
+        case Type::Byte1_unorm_tiled: {
+            uint8_t values[4];
+            image->byte1_tiled().gather(xy_xy1, values);
+
+            c[0] = float2(encoding::cached_unorm_to_float(values[0]), 0.f);
+            c[1] = float2(encoding::cached_unorm_to_float(values[1]), 0.f);
+            c[2] = float2(encoding::cached_unorm_to_float(values[2]), 0.f);
+            c[3] = float2(encoding::cached_unorm_to_float(values[3]), 0.f);
+            return;
+        }
+        case Type::Byte2_snorm_tiled: {
+            byte2 values[4];
+            image->byte2_tiled().gather(xy_xy1, values);
+
+            c[0] = encoding::cached_snorm_to_float(values[0]);
+            c[1] = encoding::cached_snorm_to_float(values[1]);
+            c[2] = encoding::cached_snorm_to_float(values[2]);
+            c[3] = encoding::cached_snorm_to_float(values[3]);
+            return;
+        }
+        case Type::Byte2_unorm_tiled: {
+            byte2 values[4];
+            image->byte2_tiled().gather(xy_xy1, values);
+
+            c[0] = encoding::cached_unorm_to_float(values[0]);
+            c[1] = encoding::cached_unorm_to_float(values[1]);
+            c[2] = encoding::cached_unorm_to_float(values[2]);
+            c[3] = encoding::cached_unorm_to_float(values[3]);
+            return;
+        }
+        case Type::Byte3_snorm_tiled: {
+            byte3 values[4];
+            image->byte3_tiled().gather(xy_xy1, values);
+
+            c[0] = encoding::cached_snorm_to_float(values[0].xy());
+            c[1] = encoding::cached_snorm_to_float(values[1].xy());
+            c[2] = encoding::cached_snorm_to_float(values[2].xy());
+            c[3] = encoding::cached_snorm_to_float(values[3].xy());
+            return;
+        }
         default:
             SOFT_ASSERT(false);
             return;
@@ -192,7 +328,14 @@ void Texture::gather_2(int4_p xy_xy1, Scene const& scene, float2 c[4]) const {
 }
 
 void Texture::gather_3(int4_p xy_xy1, Scene const& scene, float3 c[4]) const {
-    Image const* image = scene.image(image_);
+    gather_3(scene.image(image_), xy_xy1, c);
+}
+
+void Texture::gather_3(int4_p xy_xy1, uint32_t level, Scene const& scene, float3 c[4]) const {
+    gather_3(scene.image(image_)->level(level), xy_xy1, c);
+}
+
+void Texture::gather_3(Image const* image, int4_p xy_xy1, float3 c[4]) const {
 
     switch (type_) {
         case Type::Byte3_snorm: {
@@ -239,6 +382,50 @@ void Texture::gather_3(int4_p xy_xy1, Scene const& scene, float3 c[4]) const {
             c[3] = float3(values[3]);
             return;
         }
+        case Type::Byte3_snorm_tiled: {
+            byte3 values[4];
+            image->byte3_tiled().gather(xy_xy1, values);
+
+            c[0] = encoding::cached_snorm_to_float(values[0]);
+            c[1] = encoding::cached_snorm_to_float(values[1]);
+            c[2] = encoding::cached_snorm_to_float(values[2]);
+            c[3] = encoding::cached_snorm_to_float(values[3]);
+            return;
+        }
+        case Type::Byte3_sRGB_tiled: {
+            byte3 values[4];
+            image->byte3_tiled().gather(xy_xy1, values);
+#ifdef SU_ACESCG
+            c[0] = spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(values[0]));
+            c[1] = spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(values[1]));
+            c[2] = spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(values[2]));
+            c[3] = spectrum::sRGB_to_AP1(encoding::cached_srgb_to_float(values[3]));
+#else
+            c[0] = encoding::cached_srgb_to_float(values[0]);
+            c[1] = encoding::cached_srgb_to_float(values[1]);
+            c[2] = encoding::cached_srgb_to_float(values[2]);
+            c[3] = encoding::cached_srgb_to_float(values[3]);
+#endif
+            return;
+        }
+        case Type::Half3_tiled: {
+            ushort3 values[4];
+            image->short3_tiled().gather(xy_xy1, values);
+            c[0] = half_to_float(values[0]);
+            c[1] = half_to_float(values[1]);
+            c[2] = half_to_float(values[2]);
+            c[3] = half_to_float(values[3]);
+            return;
+        }
+        case Type::Float3_tiled: {
+            packed_float3 values[4];
+            image->float3_tiled().gather(xy_xy1, values);
+            c[0] = float3(values[0]);
+            c[1] = float3(values[1]);
+            c[2] = float3(values[2]);
+            c[3] = float3(values[3]);
+            return;
+        }
         default:
             SOFT_ASSERT(false);
             return;
@@ -10,6 +10,7 @@ class Scene;
 namespace image {
 
 struct Description;
+class Image;
 
 namespace texture {
 
@@ -31,6 +32,17 @@ class Texture {
         Float1_sparse,
         Float2,
         Float3,
+        Byte1_unorm_tiled,
+        Byte2_snorm_tiled,
+        Byte2_unorm_tiled,
+        Byte3_snorm_tiled,
+        Byte3_unorm_tiled,
+        Byte3_sRGB_tiled,
+        Byte4_sRGB_tiled,
+        Half3_tiled,
+        Float1_tiled,
+        Float2_tiled,
+        Float3_tiled,
     };
 
     Texture();
@@ -44,6 +56,11 @@ class Texture {
     int32_t num_channels() const;
 
     Description const& description(Scene const& scene) const;
+    Description const& description(uint32_t level, Scene const& scene) const;
+
+    uint32_t num_levels(Scene const& scene) const;
+
+    Image const* image(Scene const& scene) const;
 
     float2 scale() const;
 
@@ -56,6 +73,10 @@ class Texture {
     void gather_2(int4_p xy_xy1, Scene const& scene, float2 c[4]) const;
     void gather_3(int4_p xy_xy1, Scene const& scene, float3 c[4]) const;
 
+    void gather_1(int4_p xy_xy1, uint32_t level, Scene const& scene, float c[4]) const;
+    void gather_2(int4_p xy_xy1, uint32_t level, Scene const& scene, float2 c[4]) const;
+    void gather_3(int4_p xy_xy1, uint32_t level, Scene const& scene, float3 c[4]) const;
+
     float  at_1(int32_t x, int32_t y, int32_t z, Scene const& scene) const;
     float2 at_2(int32_t x, int32_t y, int32_t z, Scene const& scene) const;
     float3 at_3(int32_t x, int32_t y, int32_t z, Scene const& scene) const;
@@ -68,6 +89,10 @@ class Texture {
     float3 average_3(Scene const& scene) const;
 
   private:
+    void gather_1(Image const* image, int4_p xy_xy1, float c[4]) const;
+    void gather_2(Image const* image, int4_p xy_xy1, float2 c[4]) const;
+    void gather_3(Image const* image, int4_p xy_xy1, float3 c[4]) const;
+
     Type type_;
 
     uint32_t image_;
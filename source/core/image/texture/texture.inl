@@ -29,18 +29,29 @@ inline int32_t Texture::num_channels() const {
         case Type::Byte1_unorm:
         case Type::Float1:
         case Type::Float1_sparse:
+        case Type::Byte1_unorm_tiled:
+        case Type::Float1_tiled:
             return 1;
         case Type::Byte2_snorm:
         case Type::Byte2_unorm:
         case Type::Float2:
+        case Type::Byte2_snorm_tiled:
+        case Type::Byte2_unorm_tiled:
+        case Type::Float2_tiled:
             return 2;
         case Type::Byte3_snorm:
         case Type::Byte3_unorm:
         case Type::Byte3_sRGB:
         case Type::Half3:
         case Type::Float3:
+        case Type::Byte3_snorm_tiled:
+        case Type::Byte3_unorm_tiled:
+        case Type::Byte3_sRGB_tiled:
+        case Type::Half3_tiled:
+        case Type::Float3_tiled:
             return 3;
         case Type::Byte4_sRGB:
+        case Type::Byte4_sRGB_tiled:
             return 4;
     }
 }
@@ -49,6 +60,18 @@ inline Description const& Texture::description(Scene const& scene) const {
     return scene.image(image_)->description();
 }
 
+inline Description const& Texture::description(uint32_t level, Scene const& scene) const {
+    return scene.image(image_)->level(level)->description();
+}
+
+inline uint32_t Texture::num_levels(Scene const& scene) const {
+    return scene.image(image_)->num_levels();
+}
+
+inline Image const* Texture::image(Scene const& scene) const {
+    return scene.image(image_);
+}
+
 inline float2 Texture::scale() const {
     return scale_;
 }
@@ -1,9 +1,13 @@
 #include "texture_provider.hpp"
+#include "base/encoding/encoding.inl"
+#include "base/math/half.inl"
 #include "base/math/vector4.inl"
 #include "base/memory/variant_map.inl"
+#include "base/spectrum/rgb.hpp"
 #include "image/channels.hpp"
 #include "image/image.hpp"
 #include "image/image_provider.hpp"
+#include "image/typed_image.hpp"
 #include "logging/logging.hpp"
 #include "resource/resource_manager.inl"
 #include "texture.inl"
@@ -11,9 +15,12 @@
 #include "base/debug/assert.hpp"
 
 #include <charconv>
+#include <mutex>
 
 namespace image::texture {
 
+static void generate_mip_maps(Image& image, bool srgb);
+
 Texture Provider::load(std::string const& filename, Variants const& options, float2 scale,
                        Resources& resources) {
     Swizzle swizzle = options.query("swizzle", Swizzle::Undefined);
@@ -74,11 +81,19 @@ Texture Provider::load(std::string const& filename, Variants const& options, flo
         return Texture();
     }
 
-    if (Image::Type::Byte1 == image->type()) {
+    if (options.query("mip_maps", false)) {
+        generate_mip_maps(*image, color);
+    }
+
+    return create(*image, image_id, usage, scale);
+}
+
+Texture Provider::create(Image const& image, uint32_t image_id, Usage usage, float2 scale) {
+    if (Image::Type::Byte1 == image.type()) {
         return Texture(Texture::Type::Byte1_unorm, image_id, scale);
     }
 
-    if (Image::Type::Byte2 == image->type()) {
+    if (Image::Type::Byte2 == image.type()) {
         if (Usage::Normal == usage) {
             return Texture(Texture::Type::Byte2_snorm, image_id, scale);
         }
@@ -86,7 +101,7 @@ Texture Provider::load(std::string const& filename, Variants const& options, flo
         return Texture(Texture::Type::Byte2_unorm, image_id, scale);
     }
 
-    if (Image::Type::Byte3 == image->type()) {
+    if (Image::Type::Byte3 == image.type()) {
         if (Usage::Color == usage || Usage::Emission == usage) {
             return Texture(Texture::Type::Byte3_sRGB, image_id, scale);
         }
@@ -94,30 +109,75 @@ Texture Provider::load(std::string const& filename, Variants const& options, flo
         return Texture(Texture::Type::Byte3_unorm, image_id, scale);
     }
 
-    if (Image::Type::Byte4 == image->type()) {
+    if (Image::Type::Byte4 == image.type()) {
         return Texture(Texture::Type::Byte4_sRGB, image_id, scale);
     }
 
-    if (Image::Type::Short3 == image->type()) {
+    if (Image::Type::Short3 == image.type()) {
         return Texture(Texture::Type::Half3, image_id, scale);
     }
 
-    if (Image::Type::Float1 == image->type()) {
+    if (Image::Type::Float1 == image.type()) {
         return Texture(Texture::Type::Float1, image_id, scale);
     }
 
-    if (Image::Type::Float1_sparse == image->type()) {
+    if (Image::Type::Float1_sparse == image.type()) {
         return Texture(Texture::Type::Float1_sparse, image_id, scale);
     }
 
-    if (Image::Type::Float2 == image->type()) {
+    if (Image::Type::Float2 == image.type()) {
         return Texture(Texture::Type::Float2, image_id, scale);
     }
 
-    if (Image::Type::Float3 == image->type()) {
+    if (Image::Type::Float3 == image.type()) {
         return Texture(Texture::Type::Float3, image_id, scale);
     }
 
+    if (Image::Type::Byte1_tiled == image.type()) {
+        return Texture(Texture::Type::Byte1_unorm_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Byte2_tiled == image.type()) {
+        if (Usage::Normal == usage) {
+            return Texture(Texture::Type::Byte2_snorm_tiled, image_id, scale);
+        }
+
+        return Texture(Texture::Type::Byte2_unorm_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Byte3_tiled == image.type()) {
+        if (Usage::Color == usage || Usage::Emission == usage) {
+            return Texture(Texture::Type::Byte3_sRGB_tiled, image_id, scale);
+        }
+
+        // Tiled files keep all channels of normal maps
+        if (Usage::Normal == usage) {
+            return Texture(Texture::Type::Byte3_snorm_tiled, image_id, scale);
+        }
+
+        return Texture(Texture::Type::Byte3_unorm_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Byte4_tiled == image.type()) {
+        return Texture(Texture::Type::Byte4_sRGB_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Short3_tiled == image.type()) {
+        return Texture(Texture::Type::Half3_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Float1_tiled == image.type()) {
+        return Texture(Texture::Type::Float1_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Float2_tiled == image.type()) {
+        return Texture(Texture::Type::Float2_tiled, image_id, scale);
+    }
+
+    if (Image::Type::Float3_tiled == image.type()) {
+        return Texture(Texture::Type::Float3_tiled, image_id, scale);
+    }
+
     return Texture();
 }
 
@@ -135,4 +195,153 @@ uint32_t Provider::decode_name(std::string_view name) {
     return id;
 }
 
+// 2x2 box filter, that repeats the last row and column of odd dimensions
+template <typename T, typename Decode, typename Encode>
+static Image* downsample(Typed_image<T> const& source, Decode decode, Encode encode) {
+    int2 const sd = source.description().dimensions().xy();
+
+    int2 const d(std::max(sd[0] / 2, 1), std::max(sd[1] / 2, 1));
+
+    Typed_image<T> target = Typed_image<T>(Description(d));
+
+    for (int32_t y = 0; y < d[1]; ++y) {
+        int32_t const y0 = std::min(2 * y, sd[1] - 1);
+        int32_t const y1 = std::min(2 * y + 1, sd[1] - 1);
+
+        for (int32_t x = 0; x < d[0]; ++x) {
+            int32_t const x0 = std::min(2 * x, sd[0] - 1);
+            int32_t const x1 = std::min(2 * x + 1, sd[0] - 1);
+
+            auto const c = decode(source.at(x0, y0)) + decode(source.at(x1, y0)) +
+                           decode(source.at(x0, y1)) + decode(source.at(x1, y1));
+
+            target.store(x, y, encode(0.25f * c));
+        }
+    }
+
+    return new Image(std::move(target));
+}
+
+static Image* downsample(Image const& image, bool srgb) {
+    using namespace ::encoding;
+
+    auto const unorm = [](float x) { return float_to_unorm(std::min(x, 1.f)); };
+
+    auto const identity = [](auto c) { return c; };
+
+    switch (image.type()) {
+        case Image::Type::Byte1:
+            return downsample(
+                image.byte1(), [](uint8_t c) { return unorm_to_float(c); }, unorm);
+        case Image::Type::Byte2:
+            return downsample(
+                image.byte2(),
+                [](byte2 c) { return float2(unorm_to_float(c[0]), unorm_to_float(c[1])); },
+                [unorm](float2 c) { return byte2(unorm(c[0]), unorm(c[1])); });
+        case Image::Type::Byte3:
+            if (srgb) {
+                return downsample(
+                    image.byte3(), [](byte3 c) { return spectrum::gamma_to_linear_sRGB(c); },
+                    [](float3_p c) { return float_to_unorm(spectrum::linear_to_gamma_sRGB(c)); });
+            }
+
+            return downsample(
+                image.byte3(), [](byte3 c) { return unorm_to_float(c); },
+                [](float3_p c) { return float_to_unorm(min(c, 1.f)); });
+        case Image::Type::Byte4:
+            // Byte4 is only used for color with alpha
+            return downsample(
+                image.byte4(),
+                [](byte4 c) {
+                    return float4(spectrum::gamma_to_linear_sRGB(c.xyz()), unorm_to_float(c[3]));
+                },
+                [](float4_p c) {
+                    return float_to_unorm(float4(spectrum::linear_to_gamma_sRGB(c.xyz()),
+                                                 std::min(c[3], 1.f)));
+                });
+        case Image::Type::Short3:
+            return downsample(
+                image.short3(), [](ushort3 c) { return float3(half_to_float(c)); },
+                [](float3_p c) { return float_to_half(c); });
+        case Image::Type::Float1:
+            return downsample(image.float1(), identity, identity);
+        case Image::Type::Float2:
+            return downsample(image.float2(), identity, identity);
+        case Image::Type::Float3:
+            return downsample(
+                image.float3(), [](packed_float3 c) { return float3(c); },
+                [](float3_p c) { return packed_float3(c); });
+        case Image::Type::Float4:
+            return downsample(image.float4(), identity, identity);
+        case Image::Type::Float1_sparse:
+        case Image::Type::Byte1_tiled:
+        case Image::Type::Byte2_tiled:
+        case Image::Type::Byte3_tiled:
+        case Image::Type::Byte4_tiled:
+        case Image::Type::Short3_tiled:
+        case Image::Type::Float1_tiled:
+        case Image::Type::Float2_tiled:
+        case Image::Type::Float3_tiled:
+        case Image::Type::Float4_tiled:
+            return nullptr;
+    }
+
+    return nullptr;
+}
+
+void generate_mip_maps(Image& image, bool srgb) {
+    static std::mutex mutex;
+
+    // Sparse and tiled images are not resident as a whole, and the levels should not make them so
+    if (!image.data()) {
+        return;
+    }
+
+    int3 const d = image.description().dimensions();
+
+    if (d[2] > 1) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (image.num_levels() > 1) {
+            return;
+        }
+    }
+
+    uint32_t num_levels = 1;
+    for (int32_t l = std::max(d[0], d[1]); l > 1; l /= 2) {
+        ++num_levels;
+    }
+
+    if (1 == num_levels) {
+        return;
+    }
+
+    Image** levels = new Image*[num_levels - 1];
+
+    Image const* previous = &image;
+
+    for (uint32_t i = 0, len = num_levels - 1; i < len; ++i) {
+        levels[i] = downsample(*previous, srgb);
+        previous  = levels[i];
+    }
+
+    // Another texture could have generated the levels of the same image in the meantime
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (image.num_levels() > 1) {
+        for (uint32_t i = 0, len = num_levels - 1; i < len; ++i) {
+            delete levels[i];
+        }
+
+        delete[] levels;
+        return;
+    }
+
+    image.set_levels(num_levels, levels);
+}
+
 }  // namespace image::texture
@@ -10,9 +10,12 @@ namespace resource {
 class Manager;
 }
 
-namespace image::texture {
+namespace image {
+
+class Image;
+
+namespace texture {
 
-class Texture;
 class Texture;
 
 class Provider {
@@ -25,11 +28,15 @@ class Provider {
     static Texture load(std::string const& filename, Variants const& options, float2 scale,
                         Resources& resources);
 
+    // Texture of the appropriate type for an image with the given id, that was loaded elsewhere
+    static Texture create(Image const& image, uint32_t image_id, Usage usage, float2 scale);
+
     static std::string encode_name(uint32_t image_id);
 
     static uint32_t decode_name(std::string_view name);
 };
 
-}  // namespace image::texture
+}  // namespace texture
+}  // namespace image
 
 #endif
@@ -2,14 +2,35 @@
 #include "address_mode.hpp"
 #include "base/math/vector2.inl"
 #include "bilinear.hpp"
+#include "image/image.hpp"
 #include "image/texture/texture.inl"
 
 #include <algorithm>
+#include <cmath>
 
 namespace image::texture {
 
 Sampler_2D::~Sampler_2D() = default;
 
+float Sampler_2D::sample_1(Texture const& texture, float2 uv, float4_p /*uv_dif*/,
+                           Scene const& scene) const {
+    return sample_1(texture, uv, scene);
+}
+
+float2 Sampler_2D::sample_2(Texture const& texture, float2 uv, float4_p /*uv_dif*/,
+                            Scene const& scene) const {
+    return sample_2(texture, uv, scene);
+}
+
+float3 Sampler_2D::sample_3(Texture const& texture, float2 uv, float4_p /*uv_dif*/,
+                            Scene const& scene) const {
+    return sample_3(texture, uv, scene);
+}
+
+bool Sampler_2D::uses_differentials() const {
+    return false;
+}
+
 template <typename Address_U, typename Address_V>
 float Nearest_2D<Address_U, Address_V>::sample_1(Texture const& texture, float2 uv,
                                                  Scene const& scene) const {
@@ -118,6 +139,164 @@ float2 Linear_2D<Address_U, Address_V>::map(int2 d, float2 uv, int4& xy_xy1) {
     return float2(u - fu, v - fv);
 }
 
+static inline void gather(Texture const& texture, int4_p xy_xy1, uint32_t level,
+                          scene::Scene const& scene, float c[4]) {
+    texture.gather_1(xy_xy1, level, scene, c);
+}
+
+static inline void gather(Texture const& texture, int4_p xy_xy1, uint32_t level,
+                          scene::Scene const& scene, float2 c[4]) {
+    texture.gather_2(xy_xy1, level, scene, c);
+}
+
+static inline void gather(Texture const& texture, int4_p xy_xy1, uint32_t level,
+                          scene::Scene const& scene, float3 c[4]) {
+    texture.gather_3(xy_xy1, level, scene, c);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float Mipmap_2D<Address_U, Address_V, Anisotropic>::sample_1(Texture const& texture, float2 uv,
+                                                             Scene const& scene) const {
+    return linear<float>(texture, texture.scale() * uv, 0, scene);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float2 Mipmap_2D<Address_U, Address_V, Anisotropic>::sample_2(Texture const& texture, float2 uv,
+                                                              Scene const& scene) const {
+    return linear<float2>(texture, texture.scale() * uv, 0, scene);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float3 Mipmap_2D<Address_U, Address_V, Anisotropic>::sample_3(Texture const& texture, float2 uv,
+                                                              Scene const& scene) const {
+    return linear<float3>(texture, texture.scale() * uv, 0, scene);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float Mipmap_2D<Address_U, Address_V, Anisotropic>::sample_1(Texture const& texture, float2 uv,
+                                                             float4_p     uv_dif,
+                                                             Scene const& scene) const {
+    return sample<float>(texture, uv, uv_dif, scene);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float2 Mipmap_2D<Address_U, Address_V, Anisotropic>::sample_2(Texture const& texture, float2 uv,
+                                                              float4_p     uv_dif,
+                                                              Scene const& scene) const {
+    return sample<float2>(texture, uv, uv_dif, scene);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float3 Mipmap_2D<Address_U, Address_V, Anisotropic>::sample_3(Texture const& texture, float2 uv,
+                                                              float4_p     uv_dif,
+                                                              Scene const& scene) const {
+    return sample<float3>(texture, uv, uv_dif, scene);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+float2 Mipmap_2D<Address_U, Address_V, Anisotropic>::address(float2 uv) const {
+    return float2(Address_U::f(uv[0]), Address_V::f(uv[1]));
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+bool Mipmap_2D<Address_U, Address_V, Anisotropic>::uses_differentials() const {
+    return true;
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+template <typename T>
+T Mipmap_2D<Address_U, Address_V, Anisotropic>::sample(Texture const& texture, float2 uv,
+                                                       float4_p uv_dif, Scene const& scene) {
+    float2 const scale = texture.scale();
+
+    float2 const st = scale * uv;
+
+    uint32_t const num_levels = texture.num_levels(scene);
+
+    if (1 == num_levels) {
+        return linear<T>(texture, st, 0, scene);
+    }
+
+    // Axes of the footprint, in texture space and in texels of the base level
+    float2 const ax = scale * uv_dif.xy();
+    float2 const ay = scale * uv_dif.zw();
+
+    float2 const d = float2(texture.description(scene).dimensions().xy());
+
+    float const lx = length(d * ax);
+    float const ly = length(d * ay);
+
+    float const max_level = float(num_levels - 1);
+
+    if constexpr (!Anisotropic) {
+        float const width = std::max(std::max(lx, ly), 1.f);
+
+        return trilinear<T>(texture, st, std::min(std::log2(width), max_level), scene);
+    } else {
+        float2 const major = lx > ly ? ax : ay;
+
+        float const major_length = std::max(lx, ly);
+        float const minor_length = std::max(std::min(lx, ly),
+                                            major_length / float(Max_anisotropy));
+
+        float const width = std::max(minor_length, 1.f);
+
+        float const level = std::min(std::log2(width), max_level);
+
+        uint32_t const num_probes = std::clamp(uint32_t(std::ceil(major_length / width)), 1u,
+                                               Max_anisotropy);
+
+        if (1 == num_probes) {
+            return trilinear<T>(texture, st, level, scene);
+        }
+
+        float const step = 1.f / float(num_probes);
+
+        T result(0.f);
+
+        for (uint32_t i = 0; i < num_probes; ++i) {
+            float const o = (float(i) + 0.5f) * step - 0.5f;
+
+            result += trilinear<T>(texture, st + o * major, level, scene);
+        }
+
+        return step * result;
+    }
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+template <typename T>
+T Mipmap_2D<Address_U, Address_V, Anisotropic>::trilinear(Texture const& texture, float2 st,
+                                                          float level, Scene const& scene) {
+    uint32_t const l = uint32_t(level);
+
+    float const t = level - float(l);
+
+    T const c0 = linear<T>(texture, st, l, scene);
+
+    if (t <= 0.f) {
+        return c0;
+    }
+
+    T const c1 = linear<T>(texture, st, l + 1, scene);
+
+    return lerp(c0, c1, t);
+}
+
+template <typename Address_U, typename Address_V, bool Anisotropic>
+template <typename T>
+T Mipmap_2D<Address_U, Address_V, Anisotropic>::linear(Texture const& texture, float2 st,
+                                                       uint32_t level, Scene const& scene) {
+    int4         xy_xy1;
+    float2 const w = Linear_2D<Address_U, Address_V>::map(
+        texture.description(level, scene).dimensions().xy(), st, xy_xy1);
+
+    T c[4];
+    gather(texture, xy_xy1, level, scene, c);
+
+    return bilinear(c, w[0], w[1]);
+}
+
 Sampler_3D::~Sampler_3D() = default;
 
 template <typename Address_mode>
@@ -291,6 +470,16 @@ template class Linear_2D<Address_mode_clamp, Address_mode_repeat>;
 template class Linear_2D<Address_mode_repeat, Address_mode_clamp>;
 template class Linear_2D<Address_mode_repeat, Address_mode_repeat>;
 
+template class Mipmap_2D<Address_mode_clamp, Address_mode_clamp, false>;
+template class Mipmap_2D<Address_mode_clamp, Address_mode_repeat, false>;
+template class Mipmap_2D<Address_mode_repeat, Address_mode_clamp, false>;
+template class Mipmap_2D<Address_mode_repeat, Address_mode_repeat, false>;
+
+template class Mipmap_2D<Address_mode_clamp, Address_mode_clamp, true>;
+template class Mipmap_2D<Address_mode_clamp, Address_mode_repeat, true>;
+template class Mipmap_2D<Address_mode_repeat, Address_mode_clamp, true>;
+template class Mipmap_2D<Address_mode_repeat, Address_mode_repeat, true>;
+
 template class Nearest_3D<Address_mode_clamp>;
 template class Nearest_3D<Address_mode_repeat>;
 
@@ -9,7 +9,6 @@ class Scene;
 
 namespace image::texture {
 
-class Texture;
 class Texture;
 
 class Sampler_2D {
@@ -22,12 +21,28 @@ class Sampler_2D {
     virtual float2 sample_2(Texture const& texture, float2 uv, Scene const& scene) const = 0;
     virtual float3 sample_3(Texture const& texture, float2 uv, Scene const& scene) const = 0;
 
+    // uv_dif holds the derivatives (du/dx, dv/dx, du/dy, dv/dy) of the texture coordinates
+    // over the footprint of a pixel. Samplers without mip maps ignore them.
+    virtual float  sample_1(Texture const& texture, float2 uv, float4_p uv_dif,
+                            Scene const& scene) const;
+    virtual float2 sample_2(Texture const& texture, float2 uv, float4_p uv_dif,
+                            Scene const& scene) const;
+    virtual float3 sample_3(Texture const& texture, float2 uv, float4_p uv_dif,
+                            Scene const& scene) const;
+
     virtual float2 address(float2 uv) const = 0;
+
+    // Whether the result depends on uv_dif, which is not free to compute
+    virtual bool uses_differentials() const;
 };
 
 template <typename Address_U, typename Address_V>
 class Nearest_2D final : public Sampler_2D {
   public:
+    using Sampler_2D::sample_1;
+    using Sampler_2D::sample_2;
+    using Sampler_2D::sample_3;
+
     float  sample_1(Texture const& texture, float2 uv, Scene const& scene) const final;
     float2 sample_2(Texture const& texture, float2 uv, Scene const& scene) const final;
     float3 sample_3(Texture const& texture, float2 uv, Scene const& scene) const final;
@@ -38,9 +53,16 @@ class Nearest_2D final : public Sampler_2D {
     static int2 map(int2 d, float2 uv);
 };
 
+template <typename Address_U, typename Address_V, bool Anisotropic>
+class Mipmap_2D;
+
 template <typename Address_U, typename Address_V>
 class Linear_2D : public Sampler_2D {
   public:
+    using Sampler_2D::sample_1;
+    using Sampler_2D::sample_2;
+    using Sampler_2D::sample_3;
+
     float  sample_1(Texture const& texture, float2 uv, Scene const& scene) const final;
     float2 sample_2(Texture const& texture, float2 uv, Scene const& scene) const final;
     float3 sample_3(Texture const& texture, float2 uv, Scene const& scene) const final;
@@ -49,6 +71,44 @@ class Linear_2D : public Sampler_2D {
 
   private:
     static float2 map(int2 d, float2 uv, int4& xy_xy1);
+
+    template <typename, typename, bool>
+    friend class Mipmap_2D;
+};
+
+// Trilinear filtering between the two mip levels that match the footprint given by uv_dif.
+// The anisotropic variant takes several trilinear samples along the major axis of the
+// footprint, on the level that matches its minor axis.
+// Without uv_dif, or for textures without mip maps, it falls back to bilinear filtering.
+template <typename Address_U, typename Address_V, bool Anisotropic>
+class Mipmap_2D final : public Sampler_2D {
+  public:
+    float  sample_1(Texture const& texture, float2 uv, Scene const& scene) const final;
+    float2 sample_2(Texture const& texture, float2 uv, Scene const& scene) const final;
+    float3 sample_3(Texture const& texture, float2 uv, Scene const& scene) const final;
+
+    float  sample_1(Texture const& texture, float2 uv, float4_p uv_dif,
+                    Scene const& scene) const final;
+    float2 sample_2(Texture const& texture, float2 uv, float4_p uv_dif,
+                    Scene const& scene) const final;
+    float3 sample_3(Texture const& texture, float2 uv, float4_p uv_dif,
+                    Scene const& scene) const final;
+
+    float2 address(float2 uv) const final;
+
+    bool uses_differentials() const final;
+
+  private:
+    template <typename T>
+    static T sample(Texture const& texture, float2 uv, float4_p uv_dif, Scene const& scene);
+
+    template <typename T>
+    static T trilinear(Texture const& texture, float2 st, float level, Scene const& scene);
+
+    template <typename T>
+    static T linear(Texture const& texture, float2 st, uint32_t level, Scene const& scene);
+
+    static uint32_t constexpr Max_anisotropy = 8;
 };
 
 class Sampler_3D {
@@ -106,6 +166,16 @@ extern template class Linear_2D<Address_mode_clamp, Address_mode_repeat>;
 extern template class Linear_2D<Address_mode_repeat, Address_mode_clamp>;
 extern template class Linear_2D<Address_mode_repeat, Address_mode_repeat>;
 
+extern template class Mipmap_2D<Address_mode_clamp, Address_mode_clamp, false>;
+extern template class Mipmap_2D<Address_mode_clamp, Address_mode_repeat, false>;
+extern template class Mipmap_2D<Address_mode_repeat, Address_mode_clamp, false>;
+extern template class Mipmap_2D<Address_mode_repeat, Address_mode_repeat, false>;
+
+extern template class Mipmap_2D<Address_mode_clamp, Address_mode_clamp, true>;
+extern template class Mipmap_2D<Address_mode_clamp, Address_mode_repeat, true>;
+extern template class Mipmap_2D<Address_mode_repeat, Address_mode_clamp, true>;
+extern template class Mipmap_2D<Address_mode_repeat, Address_mode_repeat, true>;
+
 extern template class Nearest_3D<Address_mode_clamp>;
 extern template class Nearest_3D<Address_mode_repeat>;
 
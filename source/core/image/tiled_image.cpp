@@ -0,0 +1,340 @@
+#include "tiled_image.hpp"
+#include "base/math/vector3.inl"
+#include "base/memory/align.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace image {
+
+struct Tile {
+    std::atomic<uint32_t> num_references;
+
+    uint32_t num_bytes;
+
+    // Slot of the tile in its image, while it is resident in the cache
+    Tile** slot;
+
+    Tile* newer;
+    Tile* older;
+
+    char* data;
+};
+
+static void release(Tile* tile) {
+    if (1 == tile->num_references.fetch_sub(1, std::memory_order_acq_rel)) {
+        memory::free_aligned(tile->data);
+        delete tile;
+    }
+}
+
+struct Thread_cache;
+
+// The resident tiles of all tiled images, from the most to the least recently used one.
+// The cache holds one reference to each of them, and every thread cache that uses one another.
+// Evicted tiles are therefore only freed once no thread cache refers to them anymore.
+class Tile_cache {
+  public:
+    ~Tile_cache() {
+        for (Tile* tile = newest_; tile;) {
+            Tile* older = tile->older;
+            release(tile);
+            tile = older;
+        }
+    }
+
+    void set_budget(uint64_t num_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        budget_ = num_bytes;
+
+        evict(nullptr);
+    }
+
+    Tile* acquire(Tile** slots, uint32_t index, char const* source, uint32_t num_bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            ++num_lookups_;
+
+            if (Tile* tile = slots[index]; tile) {
+                unlink(tile);
+                push(tile);
+
+                tile->num_references.fetch_add(1, std::memory_order_relaxed);
+                return tile;
+            }
+        }
+
+        // Reading from the mapping can fault, so copy the tile outside of the lock
+        char* data = memory::allocate_aligned<char>(num_bytes);
+        std::memcpy(data, source, num_bytes);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (Tile* tile = slots[index]; tile) {
+            // Another thread was faster
+            memory::free_aligned(data);
+
+            tile->num_references.fetch_add(1, std::memory_order_relaxed);
+            return tile;
+        }
+
+        ++num_misses_;
+
+        Tile* tile = new Tile;
+
+        tile->num_references = 2;
+        tile->num_bytes      = num_bytes;
+        tile->slot           = &slots[index];
+        tile->data           = data;
+
+        slots[index] = tile;
+
+        push(tile);
+
+        num_bytes_ += num_bytes;
+        max_bytes_ = std::max(max_bytes_, num_bytes_);
+
+        evict(tile);
+
+        return tile;
+    }
+
+    void remove(Tile** slots, uint32_t num_slots) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (uint32_t i = 0; i < num_slots; ++i) {
+            if (Tile* tile = slots[i]; tile) {
+                erase(tile);
+            }
+        }
+    }
+
+    void add(Thread_cache* thread) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        threads_.push_back(thread);
+    }
+
+    void remove(Thread_cache* thread);
+
+    Tiled_image::Statistics statistics();
+
+  private:
+    // Keeps the tile that was just added, even if it alone exceeds the budget
+    void evict(Tile const* keep) {
+        if (0 == budget_) {
+            return;
+        }
+
+        while (num_bytes_ > budget_ && oldest_ && oldest_ != keep) {
+            erase(oldest_);
+
+            ++num_evictions_;
+        }
+    }
+
+    void erase(Tile* tile) {
+        unlink(tile);
+
+        *tile->slot = nullptr;
+
+        num_bytes_ -= tile->num_bytes;
+
+        release(tile);
+    }
+
+    void push(Tile* tile) {
+        tile->newer = nullptr;
+        tile->older = newest_;
+
+        if (newest_) {
+            newest_->newer = tile;
+        } else {
+            oldest_ = tile;
+        }
+
+        newest_ = tile;
+    }
+
+    void unlink(Tile* tile) {
+        if (tile->newer) {
+            tile->newer->older = tile->older;
+        } else {
+            newest_ = tile->older;
+        }
+
+        if (tile->older) {
+            tile->older->newer = tile->newer;
+        } else {
+            oldest_ = tile->newer;
+        }
+    }
+
+    std::mutex mutex_;
+
+    Tile* newest_ = nullptr;
+    Tile* oldest_ = nullptr;
+
+    uint64_t budget_ = 0;
+
+    uint64_t num_bytes_ = 0;
+    uint64_t max_bytes_ = 0;
+
+    uint64_t num_lookups_   = 0;
+    uint64_t num_misses_    = 0;
+    uint64_t num_evictions_ = 0;
+
+    std::vector<Thread_cache*> threads_;
+};
+
+static Tile_cache Cache;
+
+// Direct mapped, indexed by tile and image
+struct Thread_cache {
+    static uint32_t constexpr Num_entries = 64;
+
+    Thread_cache() {
+        Cache.add(this);
+    }
+
+    ~Thread_cache() {
+        Cache.remove(this);
+
+        for (auto& e : entries) {
+            if (e.tile) {
+                release(e.tile);
+            }
+        }
+    }
+
+    Tile const* get(Tile** slots, uint32_t index, uint64_t key, char const* source,
+                    uint32_t num_bytes) {
+        Entry& e = entries[(index + uint32_t(key >> 32) * 17) & (Num_entries - 1)];
+
+        if (key == e.key) {
+            // Only ever written by this thread, so no atomic increment is needed
+            num_hits.store(num_hits.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+            return e.tile;
+        }
+
+        Tile* tile = Cache.acquire(slots, index, source, num_bytes);
+
+        if (e.tile) {
+            release(e.tile);
+        }
+
+        e.key  = key;
+        e.tile = tile;
+
+        return tile;
+    }
+
+    struct Entry {
+        uint64_t key = 0;
+
+        Tile* tile = nullptr;
+    };
+
+    Entry entries[Num_entries];
+
+    std::atomic<uint64_t> num_hits = 0;
+};
+
+void Tile_cache::remove(Thread_cache* thread) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    num_lookups_ += thread->num_hits.load(std::memory_order_relaxed);
+
+    threads_.erase(std::find(threads_.begin(), threads_.end(), thread));
+}
+
+Tiled_image::Statistics Tile_cache::statistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t num_lookups = num_lookups_;
+
+    for (auto const t : threads_) {
+        num_lookups += t->num_hits.load(std::memory_order_relaxed);
+    }
+
+    return {num_lookups, num_misses_, num_evictions_, num_bytes_, max_bytes_};
+}
+
+static thread_local Thread_cache Local_cache;
+
+// 0 is never a valid id, so that the zeroed keys of empty thread cache entries never match
+static std::atomic<uint32_t> Current_id = 1;
+
+Tiled_image::Tiled_image(Description const& description, uint32_t pixel_size,
+                         uint32_t log_tile_size, file::Mapping&& mapping, uint64_t offset)
+    : id_(Current_id.fetch_add(1, std::memory_order_relaxed)),
+      pixel_size_(pixel_size),
+      log_tile_size_(log_tile_size),
+      pixels_(mapping.data() + offset),
+      mapping_(std::move(mapping)) {
+    int32_t const tile_size = 1 << log_tile_size;
+
+    int2 const d = description.dimensions().xy();
+
+    num_tiles_x_ = (d[0] + tile_size - 1) >> log_tile_size;
+
+    num_tiles_ = uint32_t(num_tiles_x_ * ((d[1] + tile_size - 1) >> log_tile_size));
+
+    tile_bytes_ = uint32_t(tile_size * tile_size) * pixel_size;
+
+    tiles_ = new Tile*[num_tiles_];
+
+    std::fill_n(tiles_, num_tiles_, nullptr);
+}
+
+Tiled_image::~Tiled_image() {
+    Cache.remove(tiles_, num_tiles_);
+
+    delete[] tiles_;
+}
+
+char const* Tiled_image::at(int32_t x, int32_t y) const {
+    uint32_t const log = log_tile_size_;
+
+    uint32_t const index = uint32_t((y >> log) * num_tiles_x_ + (x >> log));
+
+    uint64_t const key = (uint64_t(id_) << 32) | uint64_t(index);
+
+    Tile const* tile = Local_cache.get(tiles_, index, key,
+                                       pixels_ + uint64_t(index) * uint64_t(tile_bytes_),
+                                       tile_bytes_);
+
+    int32_t const mask = (1 << log) - 1;
+
+    uint32_t const i = (uint32_t(y & mask) << log) + uint32_t(x & mask);
+
+    return tile->data + i * pixel_size_;
+}
+
+uint64_t Tiled_image::num_bytes(Description const& description, uint32_t pixel_size,
+                                uint32_t log_tile_size) {
+    int32_t const tile_size = 1 << log_tile_size;
+
+    int2 const d = description.dimensions().xy();
+
+    uint64_t const num_tiles_x = uint64_t((d[0] + tile_size - 1) >> log_tile_size);
+    uint64_t const num_tiles_y = uint64_t((d[1] + tile_size - 1) >> log_tile_size);
+
+    return num_tiles_x * num_tiles_y * uint64_t(tile_size * tile_size) * uint64_t(pixel_size);
+}
+
+void Tiled_image::set_cache_budget(uint64_t num_bytes) {
+    Cache.set_budget(num_bytes);
+}
+
+Tiled_image::Statistics Tiled_image::cache_statistics() {
+    return Cache.statistics();
+}
+
+}  // namespace image
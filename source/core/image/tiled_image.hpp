@@ -1,24 +1,64 @@
-#pragma once
+#ifndef SU_CORE_IMAGE_TILED_IMAGE_HPP
+#define SU_CORE_IMAGE_TILED_IMAGE_HPP
 
-#include "base/memory/tiled_array.hpp"
-#include "base/spectrum/rgb.hpp"
-#include "image.hpp"
+#include "file/file_mapping.hpp"
+#include "typed_image_fwd.hpp"
 
 namespace image {
 
-template <typename T, uint32_t Log_tile_size>
-class Tiled_image : public Image {
+struct Tile;
+
+// Pixels of a file that stores them in square tiles, of which only the ones that are looked up
+// are read into memory. The resident tiles of all tiled images share the budget of one cache,
+// and the least recently used tiles are evicted to stay within it.
+// Every thread additionally keeps its last used tiles, so that most lookups don't need to lock.
+class Tiled_image {
   public:
-    Tiled_image(const Description& description);
+    struct Statistics {
+        uint64_t num_lookups;
+        uint64_t num_misses;
+        uint64_t num_evictions;
+        uint64_t num_bytes;
+        uint64_t max_bytes;
+    };
+
+    Tiled_image(Description const& description, uint32_t pixel_size, uint32_t log_tile_size,
+                file::Mapping&& mapping, uint64_t offset);
+
     ~Tiled_image();
 
-    T const& at(uint32_t x, uint32_t y) const;
-    T&       at(uint32_t x, uint32_t y);
+    // The address stays valid until the calling thread looks up the next pixel
+    char const* at(int32_t x, int32_t y) const;
+
+    // Size of the pixels in the file, with the tiles at the right and bottom edges padded
+    static uint64_t num_bytes(Description const& description, uint32_t pixel_size,
+                              uint32_t log_tile_size);
+
+    // 0 means no limit
+    static void set_cache_budget(uint64_t num_bytes);
+
+    static Statistics cache_statistics();
 
   private:
-    memory::Tiled_array<T, Log_tile_size> data_;
-};
+    uint32_t const id_;
+
+    uint32_t const pixel_size_;
+    uint32_t const log_tile_size_;
 
-// using Byte3 = Tiled_image<spectrum::Color3c, 1> Byte3;
+    int32_t num_tiles_x_;
+
+    uint32_t num_tiles_;
+
+    uint32_t tile_bytes_;
+
+    // Resident tiles, guarded by the cache
+    Tile** tiles_;
+
+    char const* pixels_;
+
+    file::Mapping mapping_;
+};
 
 }  // namespace image
+
+#endif
@@ -1,7 +1,9 @@
 #include "typed_image.hpp"
 #include "base/math/vector4.inl"
+#include "tiled_image.hpp"
 
-#include <cstring>
+#include <algorithm>
+#include <utility>
 
 namespace image {
 
@@ -31,15 +33,26 @@ template <typename T>
 Typed_image<T>::Typed_image(Description const& description)
     : description_(description), data_(new T[description.num_pixels()]) {}
 
+template <typename T>
+Typed_image<T>::Typed_image(Description const& description, file::Mapping&& mapping,
+                            uint64_t offset)
+    : description_(description),
+      data_(reinterpret_cast<T*>(mapping.data() + offset)),
+      mapping_(std::move(mapping)) {}
+
 template <typename T>
 Typed_image<T>::Typed_image(Typed_image&& other) noexcept
-    : description_(other.description_), data_(other.data_) {
+    : description_(other.description_),
+      data_(other.data_),
+      mapping_(std::move(other.mapping_)) {
     other.data_ = nullptr;
 }
 
 template <typename T>
 Typed_image<T>::~Typed_image() {
-    delete[] data_;
+    if (!mapping_.is_open()) {
+        delete[] data_;
+    }
 }
 
 template <typename T>
@@ -61,7 +74,11 @@ void Typed_image<T>::resize(Description const& description) {
         return;
     }
 
-    delete[] data_;
+    if (mapping_.is_open()) {
+        mapping_.close();
+    } else {
+        delete[] data_;
+    }
 
     description_.dimensions_ = description.dimensions_;
 
@@ -169,47 +186,54 @@ T* Typed_image<T>::data() const {
 
 template <typename T>
 void Typed_image<T>::copy(Typed_image& destination) const {
-    std::copy(&data_[0], &data_[description_.num_pixels() - 1], destination.data_);
+    std::copy(data_, data_ + description_.num_pixels(), destination.data_);
 }
 
-// template <typename T>
-// Typed_sparse_image<T>::Typed_sparse_image()  = default;
-
 template <typename T>
 Typed_sparse_image<T>::Typed_sparse_image(Description const& description)
     : description_(description) {
     int3 const d = description.dimensions_;
 
-    num_cells_ = d >> Log2_cell_dim;
+    int32_t constexpr Log2_dim = Log2_cell_dim + Log2_tile_dim;
+
+    num_tiles_ = d >> Log2_dim;
 
-    num_cells_ += math::min(d - (num_cells_ << Log2_cell_dim), 1);
+    num_tiles_ += math::min(d - (num_tiles_ << Log2_dim), 1);
 
-    int32_t const cells_len = num_cells_[0] * num_cells_[1] * num_cells_[2];
+    int32_t const tiles_len = num_tiles_[0] * num_tiles_[1] * num_tiles_[2];
 
-    cells_ = new Cell[uint32_t(cells_len)];
+    tiles_ = new Tile[uint32_t(tiles_len)];
 
-    for (int32_t i = 0; i < cells_len; ++i) {
-        cells_[i].data  = nullptr;
-        cells_[i].value = T(0);
+    for (int32_t i = 0; i < tiles_len; ++i) {
+        tiles_[i] = Tile{0, T(0), nullptr};
     }
 }
 
+template <typename T>
+Typed_sparse_image<T>::Typed_sparse_image(Description const& description, file::Mapping&& mapping)
+    : Typed_sparse_image(description) {
+    mapping_ = std::move(mapping);
+}
+
 template <typename T>
 Typed_sparse_image<T>::Typed_sparse_image(Typed_sparse_image&& other) noexcept
-    : description_(other.description()), num_cells_(other.num_cells_), cells_(other.cells_) {
-    other.num_cells_ = int3(0);
-    other.cells_     = nullptr;
+    : description_(other.description()),
+      num_tiles_(other.num_tiles_),
+      tiles_(other.tiles_),
+      mapping_(std::move(other.mapping_)) {
+    other.num_tiles_ = int3(0);
+    other.tiles_     = nullptr;
 }
 
 template <typename T>
 Typed_sparse_image<T>::~Typed_sparse_image() {
-    int32_t const cell_len = num_cells_[0] * num_cells_[1] * num_cells_[2];
+    int32_t const tiles_len = num_tiles_[0] * num_tiles_[1] * num_tiles_[2];
 
-    for (int32_t i = 0; i < cell_len; ++i) {
-        delete[] cells_[i].data;
+    for (int32_t i = 0; i < tiles_len; ++i) {
+        release_cells(tiles_[i]);
     }
 
-    delete[] cells_;
+    delete[] tiles_;
 }
 
 template <typename T>
@@ -218,70 +242,158 @@ Description const& Typed_sparse_image<T>::description() const {
 }
 
 template <typename T>
-void Typed_sparse_image<T>::store_sequentially(int64_t index, T v) {
-    int3 const c  = coordinates_3(index);
-    int3 const cc = c >> Log2_cell_dim;
-
-    int32_t const cell_index = (cc[2] * num_cells_[1] + cc[1]) * num_cells_[0] + cc[0];
+int3 Typed_sparse_image<T>::num_tiles() const {
+    return num_tiles_;
+}
 
-    int32_t constexpr len = Cell_dim * Cell_dim * Cell_dim;
+template <typename T>
+typename Typed_sparse_image<T>::Tile const& Typed_sparse_image<T>::tile(int32_t index) const {
+    return tiles_[index];
+}
 
-    Cell& cell = cells_[cell_index];
+template <typename T>
+void Typed_sparse_image<T>::set_tile(int32_t index, T value) {
+    Tile& tile = tiles_[index];
 
-    if (!cell.data) {
-        cell.data = new T[len];
+    release_cells(tile);
 
-        std::memset(cell.data, 0, len * sizeof(T));
-    }
+    tile.value = value;
+}
 
-    int3 const cs = cc << Log2_cell_dim;
+template <typename T>
+void Typed_sparse_image<T>::set_cell(int32_t tile, int32_t cell, T* data, T min, T max) {
+    Tile& t = tiles_[tile];
 
-    int3 const cxyz = c - cs;
+    if (!t.cells) {
+        t.cells = new Cell[Tile_len];
 
-    int32_t const ci = (((cxyz[2] << Log2_cell_dim) + cxyz[1]) << Log2_cell_dim) + cxyz[0];
+        for (int32_t i = 0; i < Tile_len; ++i) {
+            t.cells[i] = Cell{nullptr, t.value, t.value};
+        }
+    }
 
-    cell.data[ci] = v;
+    Cell& c = t.cells[cell];
 
-    if (ci == len - 1) {
-        bool homogeneous = true;
-        T    value       = cell.data[0];
+    if (!mapping_.is_open()) {
+        delete[] c.data;
+    }
 
-        for (int32_t i = 1; i < len; ++i) {
-            if (value != cell.data[i]) {
-                homogeneous = false;
-                break;
-            }
-        }
+    c = Cell{data, min, max};
 
-        if (homogeneous) {
-            delete[] cell.data;
+    uint64_t const bit = uint64_t(1) << uint32_t(cell);
 
-            cell.data  = nullptr;
-            cell.value = value;
-        }
+    if (data) {
+        t.active |= bit;
+    } else {
+        t.active &= ~bit;
     }
 }
 
 template <typename T>
-T Typed_sparse_image<T>::at(int64_t index) const {
+void Typed_sparse_image<T>::store_sequentially(int64_t index, T v) {
     int3 const c  = coordinates_3(index);
     int3 const cc = c >> Log2_cell_dim;
+    int3 const tc = cc >> Log2_tile_dim;
+    int3 const lc = cc - (tc << Log2_tile_dim);
 
-    int32_t const cell_index = (cc[2] * num_cells_[1] + cc[1]) * num_cells_[0] + cc[0];
+    int32_t const tile_index = (tc[2] * num_tiles_[1] + tc[1]) * num_tiles_[0] + tc[0];
+    int32_t const cell_index = (((lc[2] << Log2_tile_dim) + lc[1]) << Log2_tile_dim) + lc[0];
 
-    Cell const& cell = cells_[cell_index];
+    Tile const& tile = tiles_[tile_index];
 
-    if (!cell.data) {
-        return cell.value;
+    if (!tile.cells || !tile.cells[cell_index].data) {
+        T const value = tile.cells ? tile.cells[cell_index].min : tile.value;
+
+        T* data = new T[Cell_len];
+
+        std::fill(data, data + Cell_len, value);
+
+        set_cell(tile_index, cell_index, data, value, value);
     }
 
-    int3 const cs = cc << Log2_cell_dim;
+    tile.cells[cell_index].data[voxel_index(c - (cc << Log2_cell_dim))] = v;
+}
+
+template <typename T>
+void Typed_sparse_image<T>::optimize() {
+    int3 const d = description_.dimensions_;
+
+    int32_t tile_index = 0;
+
+    for (int32_t tz = 0; tz < num_tiles_[2]; ++tz) {
+        for (int32_t ty = 0; ty < num_tiles_[1]; ++ty) {
+            for (int32_t tx = 0; tx < num_tiles_[0]; ++tx, ++tile_index) {
+                Tile& tile = tiles_[tile_index];
+
+                if (!tile.cells) {
+                    continue;
+                }
+
+                int3 const tile_cells = int3(tx, ty, tz) << Log2_tile_dim;
+
+                bool uniform = true;
+
+                T value = T(0);
+
+                for (int32_t i = 0; i < Tile_len; ++i) {
+                    int3 const lc(i & (Tile_dim - 1), (i >> Log2_tile_dim) & (Tile_dim - 1),
+                                  i >> (2 * Log2_tile_dim));
+
+                    int3 const begin = (tile_cells + lc) << Log2_cell_dim;
+
+                    // Cells of border tiles can be completely outside of the volume
+                    if (any_greater_equal(begin, d)) {
+                        continue;
+                    }
 
-    int3 const cxyz = c - cs;
+                    Cell& cell = tile.cells[i];
 
-    int32_t const ci = (((cxyz[2] << Log2_cell_dim) + cxyz[1]) << Log2_cell_dim) + cxyz[0];
+                    if (cell.data) {
+                        // Only the voxels inside of the volume
+                        int3 const end = math::min(begin + Cell_dim, d) - begin;
 
-    return cell.data[ci];
+                        T min = cell.data[0];
+                        T max = min;
+
+                        for (int32_t z = 0; z < end[2]; ++z) {
+                            for (int32_t y = 0; y < end[1]; ++y) {
+                                for (int32_t x = 0; x < end[0]; ++x) {
+                                    T const v = cell.data[voxel_index(int3(x, y, z))];
+
+                                    min = std::min(v, min);
+                                    max = std::max(v, max);
+                                }
+                            }
+                        }
+
+                        if (min == max) {
+                            set_cell(tile_index, i, nullptr, min, max);
+                        } else {
+                            cell.min = min;
+                            cell.max = max;
+                        }
+                    }
+
+                    if (uniform && 0 == i) {
+                        value = cell.min;
+                    }
+
+                    uniform = uniform && !cell.data && value == cell.min;
+                }
+
+                if (uniform) {
+                    set_tile(tile_index, value);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+T Typed_sparse_image<T>::at(int64_t index) const {
+    int3 const c = coordinates_3(index);
+
+    return at(c[0], c[1], c[2]);
 }
 
 template <typename T>
@@ -303,21 +415,15 @@ T Typed_sparse_image<T>::at(int32_t x, int32_t y, int32_t z) const {
     int3 const c(x, y, z);
     int3 const cc = c >> Log2_cell_dim;
 
-    int32_t const cell_index = (cc[2] * num_cells_[1] + cc[1]) * num_cells_[0] + cc[0];
+    Cell uniform;
 
-    Cell const& cell = cells_[cell_index];
+    Cell const& cell = this->cell(cc, uniform);
 
     if (!cell.data) {
-        return cell.value;
+        return cell.min;
     }
 
-    int3 const cs = cc << Log2_cell_dim;
-
-    int3 const cxyz = c - cs;
-
-    int32_t const ci = (((cxyz[2] << Log2_cell_dim) + cxyz[1]) << Log2_cell_dim) + cxyz[0];
-
-    return cell.data[ci];
+    return cell.data[voxel_index(c - (cc << Log2_cell_dim))];
 }
 
 template <typename T>
@@ -346,19 +452,19 @@ void Typed_sparse_image<T>::gather(int3_p xyz, int3_p xyz1, T c[8]) const {
     int3 const cc1 = xyz1 >> Log2_cell_dim;
 
     if (cc0 == cc1) {
-        int32_t const cell_index = (cc0[2] * num_cells_[1] + cc0[1]) * num_cells_[0] + cc0[0];
+        Cell uniform;
 
-        Cell const& cell = cells_[cell_index];
+        Cell const& cell = this->cell(cc0, uniform);
 
         if (!cell.data) {
-            c[0] = cell.value;
-            c[1] = cell.value;
-            c[2] = cell.value;
-            c[3] = cell.value;
-            c[4] = cell.value;
-            c[5] = cell.value;
-            c[6] = cell.value;
-            c[7] = cell.value;
+            c[0] = cell.min;
+            c[1] = cell.min;
+            c[2] = cell.min;
+            c[3] = cell.min;
+            c[4] = cell.min;
+            c[5] = cell.min;
+            c[6] = cell.min;
+            c[7] = cell.min;
 
             return;
         }
@@ -431,6 +537,56 @@ void Typed_sparse_image<T>::gather(int3_p xyz, int3_p xyz1, T c[8]) const {
     c[7] = at(xyz1[0], xyz1[1], xyz1[2]);
 }
 
+template <typename T>
+void Typed_sparse_image<T>::min_max(int3_p begin, int3_p end, T& min, T& max) const {
+    int3 const d = description_.dimensions_;
+
+    int3 const b = math::max(begin, 0);
+    int3 const e = math::min(end, d);
+
+    if (any_greater_equal(b, e)) {
+        return;
+    }
+
+    int3 const cb = b >> Log2_cell_dim;
+    int3 const ce = ((e - 1) >> Log2_cell_dim) + 1;
+
+    for (int32_t cz = cb[2]; cz < ce[2]; ++cz) {
+        for (int32_t cy = cb[1]; cy < ce[1]; ++cy) {
+            for (int32_t cx = cb[0]; cx < ce[0]; ++cx) {
+                int3 const cc(cx, cy, cz);
+
+                Cell uniform;
+
+                Cell const& cell = this->cell(cc, uniform);
+
+                int3 const cs = cc << Log2_cell_dim;
+
+                int3 const lo = math::max(b, cs);
+                int3 const hi = math::min(e, cs + Cell_dim);
+
+                // The range of the cell is only exact, if the cell is completely covered
+                if (!cell.data || (lo == cs && hi == math::min(cs + Cell_dim, d))) {
+                    min = std::min(cell.min, min);
+                    max = std::max(cell.max, max);
+                    continue;
+                }
+
+                for (int32_t z = lo[2]; z < hi[2]; ++z) {
+                    for (int32_t y = lo[1]; y < hi[1]; ++y) {
+                        for (int32_t x = lo[0]; x < hi[0]; ++x) {
+                            T const v = cell.data[voxel_index(int3(x, y, z) - cs)];
+
+                            min = std::min(v, min);
+                            max = std::max(v, max);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 template <typename T>
 int3 Typed_sparse_image<T>::coordinates_3(int64_t index) const {
     int64_t const w = int64_t(description_.dimensions_[0]);
@@ -444,6 +600,80 @@ int3 Typed_sparse_image<T>::coordinates_3(int64_t index) const {
     return int3(index - (t + c1 * w), c1, c2);
 }
 
+template <typename T>
+typename Typed_sparse_image<T>::Cell const& Typed_sparse_image<T>::cell(int3_p cc,
+                                                                         Cell&  uniform) const {
+    int3 const tc = cc >> Log2_tile_dim;
+
+    Tile const& tile = tiles_[(tc[2] * num_tiles_[1] + tc[1]) * num_tiles_[0] + tc[0]];
+
+    if (!tile.cells) {
+        uniform = Cell{nullptr, tile.value, tile.value};
+        return uniform;
+    }
+
+    int3 const lc = cc - (tc << Log2_tile_dim);
+
+    return tile.cells[(((lc[2] << Log2_tile_dim) + lc[1]) << Log2_tile_dim) + lc[0]];
+}
+
+template <typename T>
+int32_t Typed_sparse_image<T>::voxel_index(int3_p cxyz) {
+    return (((cxyz[2] << Log2_cell_dim) + cxyz[1]) << Log2_cell_dim) + cxyz[0];
+}
+
+template <typename T>
+void Typed_sparse_image<T>::release_cells(Tile& tile) {
+    if (!tile.cells) {
+        return;
+    }
+
+    if (!mapping_.is_open()) {
+        for (int32_t i = 0; i < Tile_len; ++i) {
+            delete[] tile.cells[i].data;
+        }
+    }
+
+    delete[] tile.cells;
+
+    tile.active = 0;
+    tile.cells  = nullptr;
+}
+
+template <typename T>
+Typed_tiled_image<T>::Typed_tiled_image(Description const& description, Tiled_image* tiled)
+    : description_(description), tiled_(tiled) {}
+
+template <typename T>
+Typed_tiled_image<T>::Typed_tiled_image(Typed_tiled_image&& other) noexcept
+    : description_(other.description_), tiled_(other.tiled_) {
+    other.tiled_ = nullptr;
+}
+
+template <typename T>
+Typed_tiled_image<T>::~Typed_tiled_image() {
+    delete tiled_;
+}
+
+template <typename T>
+Description const& Typed_tiled_image<T>::description() const {
+    return description_;
+}
+
+template <typename T>
+T Typed_tiled_image<T>::at(int32_t x, int32_t y) const {
+    return *reinterpret_cast<T const*>(tiled_->at(x, y));
+}
+
+template <typename T>
+void Typed_tiled_image<T>::gather(int4_p xy_xy1, T c[4]) const {
+    // Every lookup can replace the tile of the previous one, so copy the pixels right away
+    c[0] = *reinterpret_cast<T const*>(tiled_->at(xy_xy1[0], xy_xy1[1]));
+    c[1] = *reinterpret_cast<T const*>(tiled_->at(xy_xy1[2], xy_xy1[1]));
+    c[2] = *reinterpret_cast<T const*>(tiled_->at(xy_xy1[0], xy_xy1[3]));
+    c[3] = *reinterpret_cast<T const*>(tiled_->at(xy_xy1[2], xy_xy1[3]));
+}
+
 template class Typed_image<uint8_t>;
 template class Typed_image<byte2>;
 template class Typed_image<byte3>;
@@ -454,5 +684,14 @@ template class Typed_sparse_image<float>;
 template class Typed_image<float2>;
 template class Typed_image<packed_float3>;
 template class Typed_image<float4>;
+template class Typed_tiled_image<uint8_t>;
+template class Typed_tiled_image<byte2>;
+template class Typed_tiled_image<byte3>;
+template class Typed_tiled_image<byte4>;
+template class Typed_tiled_image<ushort3>;
+template class Typed_tiled_image<float>;
+template class Typed_tiled_image<float2>;
+template class Typed_tiled_image<packed_float3>;
+template class Typed_tiled_image<float4>;
 
 }  // namespace image
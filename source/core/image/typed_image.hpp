@@ -2,10 +2,13 @@
 #define SU_CORE_IMAGE_TYPED_IMAGE_HPP
 
 #include "base/math/vector3.hpp"
+#include "file/file_mapping.hpp"
 #include "typed_image_fwd.hpp"
 
 namespace image {
 
+class Tiled_image;
+
 template <typename T>
 class alignas(16) Typed_image {
   public:
@@ -13,6 +16,9 @@ class alignas(16) Typed_image {
 
     Typed_image(Description const& description);
 
+    // The pixels are used in place, starting at offset bytes into the mapped file
+    Typed_image(Description const& description, file::Mapping&& mapping, uint64_t offset);
+
     Typed_image(Typed_image&& other) noexcept;
 
     ~Typed_image();
@@ -47,21 +53,73 @@ class alignas(16) Typed_image {
     Description description_;
 
     T* data_ = nullptr;
+
+    file::Mapping mapping_;
 };
 
+// Sparse in two levels: The volume is divided into tiles of Tile_dim^3 cells, and the cells into
+// Cell_dim^3 voxels. Uniform tiles are stored as a single value. The other tiles have cells,
+// and mark the ones that are not uniform as active. Only active cells have voxels.
 template <typename T>
 class Typed_sparse_image {
   public:
+    static int32_t constexpr Log2_cell_dim = 4;
+    static int32_t constexpr Cell_dim      = 1 << Log2_cell_dim;
+    static int32_t constexpr Cell_len      = Cell_dim * Cell_dim * Cell_dim;
+
+    static int32_t constexpr Log2_tile_dim = 2;
+    static int32_t constexpr Tile_dim      = 1 << Log2_tile_dim;
+    static int32_t constexpr Tile_len      = Tile_dim * Tile_dim * Tile_dim;
+
+    struct Cell {
+        // nullptr for inactive cells, where all voxels have the value min (== max)
+        T* data;
+
+        T min;
+        T max;
+    };
+
+    struct Tile {
+        // One bit per cell
+        uint64_t active;
+
+        // Of all the voxels in a uniform tile
+        T value;
+
+        // Tile_len cells, or nullptr for a uniform tile
+        Cell* cells;
+    };
+
+    static_assert(Tile_len <= 64);
+
     Typed_sparse_image(Description const& description);
 
+    // The voxels of active cells can point into the mapped file
+    Typed_sparse_image(Description const& description, file::Mapping&& mapping);
+
     Typed_sparse_image(Typed_sparse_image&& other) noexcept;
 
     ~Typed_sparse_image();
 
     Description const& description() const;
 
+    int3 num_tiles() const;
+
+    Tile const& tile(int32_t index) const;
+
+    // Makes a tile uniform
+    void set_tile(int32_t index, T value);
+
+    // Takes ownership of data, unless the image was created with a mapping.
+    // With data == nullptr the cell is inactive with value min.
+    void set_cell(int32_t tile, int32_t cell, T* data, T min, T max);
+
+    // Any order works as well, as long as optimize() is called afterwards
     void store_sequentially(int64_t index, T v);
 
+    // Deactivates uniform cells, collapses uniform tiles and updates the ranges of the active cells
+    void optimize();
+
     T at(int64_t index) const;
 
     void store(int32_t x, int32_t y, T v);
@@ -74,22 +132,51 @@ class Typed_sparse_image {
 
     void gather(int3_p xyz, int3_p xyz1, T c[8]) const;
 
+    // Minimum and maximum of the voxels in [begin, end),
+    // only touching voxels of cells that are partially covered
+    void min_max(int3_p begin, int3_p end, T& min, T& max) const;
+
   private:
     int3 coordinates_3(int64_t index) const;
 
-    static int32_t constexpr Log2_cell_dim = 4;
-    static int32_t constexpr Cell_dim      = 1 << Log2_cell_dim;
+    // The cell at cc, or uniform filled in with the value of the tile, if the tile has no cells
+    Cell const& cell(int3_p cc, Cell& uniform) const;
+
+    static int32_t voxel_index(int3_p cxyz);
+
+    void release_cells(Tile& tile);
 
     Description description_;
 
-    int3 num_cells_;
+    int3 num_tiles_;
 
-    struct Cell {
-        T* data;
-        T  value;
-    };
+    Tile* tiles_ = nullptr;
+
+    file::Mapping mapping_;
+};
+
+// The pixels are loaded tile by tile on demand, see Tiled_image.
+// Kept apart from Typed_image, so that lookups in resident images don't have to check for tiles.
+template <typename T>
+class Typed_tiled_image {
+  public:
+    // Takes ownership of tiled
+    Typed_tiled_image(Description const& description, Tiled_image* tiled);
+
+    Typed_tiled_image(Typed_tiled_image&& other) noexcept;
+
+    ~Typed_tiled_image();
+
+    Description const& description() const;
+
+    T at(int32_t x, int32_t y) const;
+
+    void gather(int4_p xy_xy1, T c[4]) const;
+
+  private:
+    Description description_;
 
-    Cell* cells_ = nullptr;
+    Tiled_image* tiled_;
 };
 
 extern template class Typed_image<uint8_t>;
@@ -102,6 +189,15 @@ extern template class Typed_sparse_image<float>;
 extern template class Typed_image<float2>;
 extern template class Typed_image<packed_float3>;
 extern template class Typed_image<float4>;
+extern template class Typed_tiled_image<uint8_t>;
+extern template class Typed_tiled_image<byte2>;
+extern template class Typed_tiled_image<byte3>;
+extern template class Typed_tiled_image<byte4>;
+extern template class Typed_tiled_image<ushort3>;
+extern template class Typed_tiled_image<float>;
+extern template class Typed_tiled_image<float2>;
+extern template class Typed_tiled_image<packed_float3>;
+extern template class Typed_tiled_image<float4>;
 
 }  // namespace image
 
@@ -29,6 +29,9 @@ class Typed_image;
 template <typename T>
 class Typed_sparse_image;
 
+template <typename T>
+class Typed_tiled_image;
+
 using Byte1 = Typed_image<uint8_t>;
 using Byte2 = Typed_image<byte2>;
 using Byte3 = Typed_image<byte3>;
@@ -43,6 +46,16 @@ using Float3        = Typed_image<packed_float3>;
 // using Float3 = Typed_image<float3>;
 using Float4 = Typed_image<float4>;
 
+using Byte1_tiled  = Typed_tiled_image<uint8_t>;
+using Byte2_tiled  = Typed_tiled_image<byte2>;
+using Byte3_tiled  = Typed_tiled_image<byte3>;
+using Byte4_tiled  = Typed_tiled_image<byte4>;
+using Short3_tiled = Typed_tiled_image<ushort3>;
+using Float1_tiled = Typed_tiled_image<float>;
+using Float2_tiled = Typed_tiled_image<float2>;
+using Float3_tiled = Typed_tiled_image<packed_float3>;
+using Float4_tiled = Typed_tiled_image<float4>;
+
 }  // namespace image
 
 #endif
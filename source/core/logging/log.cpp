@@ -18,6 +18,8 @@ static std::string resolve(std::string const& text, std::string const& a) {
 Log::~Log() = default;
 
 void Log::post(Type type, std::string const& text) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
     if (0 == current_entry_) {
         internal_post(type, text);
     } else {
@@ -45,6 +47,8 @@ void Log::post(Type type, std::string const& text, std::string const& a) {
 }
 
 void Log::push(Type type, std::string const& text) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
     if (Num_entries == current_entry_) {
         post(type);
     }
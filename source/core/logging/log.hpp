@@ -1,6 +1,7 @@
 #ifndef SU_CORE_LOGGING_LOG_HPP
 #define SU_CORE_LOGGING_LOG_HPP
 
+#include <mutex>
 #include <string>
 
 namespace logging {
@@ -36,6 +37,9 @@ class Log {
     int32_t current_entry_ = 0;
 
     Entry entries_[Num_entries];
+
+    // Resources can be loaded from several threads at once
+    std::recursive_mutex mutex_;
 };
 
 }  // namespace logging
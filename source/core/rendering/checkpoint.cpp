@@ -0,0 +1,78 @@
+#include "checkpoint.hpp"
+#include "base/math/vector4.inl"
+#include "logging/logging.hpp"
+#include "rendering/sensor/sensor.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace rendering {
+
+struct Header {
+    char     id[4];
+    uint32_t version;
+    uint32_t frame;
+    uint32_t num_iterations;
+    uint32_t split_index;
+    uint32_t num_splits;
+    float    seconds;
+};
+
+static uint32_t constexpr Version = 2;
+
+bool Checkpoint::write(std::string const& filename, sensor::Sensor const& sensor) const {
+    std::string const temp_name = filename + ".tmp";
+
+    {
+        std::ofstream stream(temp_name, std::ios::binary);
+        if (!stream) {
+            logging::error("Could not create checkpoint %S.", temp_name);
+            return false;
+        }
+
+        Header const header{{'S', 'U', 'C', 'P'}, Version,    frame,  num_iterations,
+                            split_index,          num_splits, seconds};
+
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+        sensor.write(stream);
+
+        if (!stream) {
+            logging::error("Could not write checkpoint %S.", temp_name);
+            return false;
+        }
+    }
+
+    // Unlike std::rename() this also replaces an existing checkpoint on Windows
+    std::error_code ec;
+    std::filesystem::rename(temp_name, filename, ec);
+
+    if (ec) {
+        logging::warning("Could not replace checkpoint %S.", filename);
+        std::filesystem::remove(temp_name, ec);
+        return false;
+    }
+
+    return true;
+}
+
+bool Checkpoint::read(std::istream& stream) {
+    Header header;
+
+    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!stream || 'S' != header.id[0] || 'U' != header.id[1] || 'C' != header.id[2] ||
+        'P' != header.id[3] || Version != header.version) {
+        return false;
+    }
+
+    frame          = header.frame;
+    num_iterations = header.num_iterations;
+    split_index    = header.split_index;
+    num_splits     = header.num_splits;
+    seconds        = header.seconds;
+
+    return true;
+}
+
+}  // namespace rendering
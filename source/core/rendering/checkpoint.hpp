@@ -0,0 +1,35 @@
+#ifndef SU_CORE_RENDERING_CHECKPOINT_HPP
+#define SU_CORE_RENDERING_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace rendering {
+
+namespace sensor {
+class Sensor;
+}
+
+// Header of the files that store the raw sensor buffers of a progressive frame,
+// which directly follow it
+struct Checkpoint {
+    uint32_t frame;
+    uint32_t num_iterations;
+
+    // The iterations split_index, split_index + num_splits, ... were rendered
+    uint32_t split_index;
+    uint32_t num_splits;
+
+    float seconds;
+
+    // Writes to a temporary file first, so that an interruption never leaves a broken one
+    bool write(std::string const& filename, sensor::Sensor const& sensor) const;
+
+    // Leaves the stream at the sensor buffers
+    bool read(std::istream& stream);
+};
+
+}  // namespace rendering
+
+#endif
@@ -3,6 +3,7 @@
 #include "base/math/plane.inl"
 #include "base/math/vector3.inl"
 #include "base/memory/align.hpp"
+#include "base/memory/buffer.hpp"
 #include "base/thread/thread_pool.hpp"
 #include "photon.hpp"
 #include "scene/composed_transformation.inl"
@@ -14,6 +15,7 @@
 #include "scene/shape/shape.hpp"
 
 #include <algorithm>
+#include <bit>
 
 #include <iostream>
 #include "base/math/print.inl"
@@ -38,10 +40,40 @@ static inline uint8_t adjacent(float s, float2 cell_bound) {
 
 static float3 scattering_coefficient(prop::Intersection const& isec, Worker const& worker);
 
-Grid::Grid() : dimensions_(0), grid_(nullptr) {}
+static uint32_t constexpr Radix_bits = 8;
+static uint32_t constexpr Radix_size = 1 << Radix_bits;
+
+// Blocks of photons that are processed in the same order independently of the number of threads,
+// which keeps the results of the sort and the compaction deterministic
+static uint32_t block_size(uint32_t num_photons, Threads const& threads) {
+    uint32_t const num_blocks = threads.num_threads() * 4;
+
+    return std::max((num_photons + num_blocks - 1) / num_blocks, 4096u);
+}
+
+Grid::Grid()
+    : num_photons_(0),
+      capacity_(0),
+      positions_(nullptr),
+      directions_(nullptr),
+      alphas_(nullptr),
+      properties_(nullptr),
+      keys_{nullptr, nullptr},
+      indices_{nullptr, nullptr},
+      dimensions_(0),
+      grid_(nullptr) {}
 
 Grid::~Grid() {
     memory::free_aligned(grid_);
+
+    memory::free_aligned(indices_[1]);
+    memory::free_aligned(indices_[0]);
+    memory::free_aligned(keys_[1]);
+    memory::free_aligned(keys_[0]);
+    memory::free_aligned(properties_);
+    memory::free_aligned(alphas_);
+    memory::free_aligned(directions_);
+    memory::free_aligned(positions_);
 }
 
 void Grid::init(float search_radius, float grid_cell_factor, bool check_disk) {
@@ -232,41 +264,56 @@ void Grid::resize(AABB const& aabb) {
     }
 }
 
-void Grid::init_cells(uint32_t num_photons, Photon* photons) {
+void Grid::init_cells(uint32_t num_photons, Photon const* photons, Threads& threads) {
     num_photons_ = num_photons;
-    photons_     = photons;
 
     if (0 == num_photons) {
         return;
     }
 
-    std::sort(photons, photons + num_photons, [this](Photon const& a, Photon const& b) {
-        int32_t const ida = map1(a.p);
-        int32_t const idb = map1(b.p);
+    reserve(num_photons);
 
-        return ida < idb;
-    });
+    sort(num_photons, photons, threads);
 
-    int32_t const num_cells = dimensions_[0] * dimensions_[1] * dimensions_[2] + 1;
+    threads.run_range(
+        [this, photons](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+            uint32_t const* keys    = keys_[0];
+            uint32_t const* indices = indices_[0];
 
-    int32_t const len = int32_t(num_photons);
+            for (int32_t i = begin; i < end; ++i) {
+                Photon const& p = photons[indices[i]];
 
-    int32_t current = 0;
-    for (int32_t c = 0; c < num_cells; ++c) {
-        grid_[c] = current;
-        for (; current < len; ++current) {
-            if (map1(photons[current].p) != c) {
-                break;
+                positions_[i]  = p.p;
+                directions_[i] = p.wi;
+                alphas_[i]     = float3(p.alpha);
+                properties_[i] = p.properties;
+
+                // The cells from the one after the previous key up to this key start here
+                int32_t const previous = 0 == i ? -1 : int32_t(keys[i - 1]);
+
+                for (int32_t c = previous + 1, last = int32_t(keys[i]); c <= last; ++c) {
+                    grid_[c] = i;
+                }
             }
-        }
-    }
+        },
+        0, int32_t(num_photons));
+
+    int32_t const num_cells = dimensions_[0] * dimensions_[1] * dimensions_[2] + 1;
+
+    int32_t const last = int32_t(keys_[0][num_photons - 1]);
+
+    std::fill(grid_ + last + 1, grid_ + num_cells, int32_t(num_photons));
 }
 
 uint32_t Grid::reduce_and_move(Photon* photons, float merge_radius, uint32_t* num_reduced,
                                Threads& threads) {
+    for (uint32_t i = 0, len = threads.num_threads(); i < len; ++i) {
+        num_reduced[i] = 0;
+    }
+
     threads.run_range(
         [this, merge_radius, num_reduced](uint32_t id, int32_t begin, int32_t end) noexcept {
-            num_reduced[id] = reduce(merge_radius, begin, end);
+            num_reduced[id] += reduce(merge_radius, begin, end);
         },
         0, int32_t(num_photons_));
 
@@ -276,18 +323,69 @@ uint32_t Grid::reduce_and_move(Photon* photons, float merge_radius, uint32_t* nu
         comp_num_photons -= num_reduced[i];
     }
 
-    std::partition(photons_, photons_ + num_photons_,
-                   [](Photon const& p) { return p.alpha[0] >= 0.f; });
+    // Stable compaction: Count the remaining photons of every block, and then copy each block
+    // behind the ones before it
+    uint32_t const block = block_size(num_photons_, threads);
 
-    if (photons != photons_) {
-        Photon* old_photons = photons_;
-        photons_            = photons;
+    uint32_t const num_blocks = (num_photons_ + block - 1) / block;
 
-        for (uint32_t i = 0; i < comp_num_photons; ++i) {
-            photons[i] = old_photons[i];
-        }
+    memory::Buffer<uint32_t> offsets(num_blocks);
+
+    threads.run_range(
+        [this, block, &offsets](uint32_t /*id*/, int32_t begin_block, int32_t end_block) noexcept {
+            for (int32_t b = begin_block; b < end_block; ++b) {
+                uint32_t const begin = uint32_t(b) * block;
+                uint32_t const end   = std::min(begin + block, num_photons_);
+
+                uint32_t count = 0;
+
+                for (uint32_t i = begin; i < end; ++i) {
+                    if (alphas_[i][0] >= 0.f) {
+                        ++count;
+                    }
+                }
+
+                offsets[b] = count;
+            }
+        },
+        0, int32_t(num_blocks), 1);
+
+    for (uint32_t b = 0, offset = 0; b < num_blocks; ++b) {
+        uint32_t const count = offsets[b];
+
+        offsets[b] = offset;
+
+        offset += count;
     }
 
+    threads.run_range(
+        [this, photons, block, &offsets](uint32_t /*id*/, int32_t begin_block,
+                                         int32_t end_block) noexcept {
+            for (int32_t b = begin_block; b < end_block; ++b) {
+                uint32_t const begin = uint32_t(b) * block;
+                uint32_t const end   = std::min(begin + block, num_photons_);
+
+                for (uint32_t i = begin, o = offsets[b]; i < end; ++i) {
+                    float3 const alpha = alphas_[i];
+
+                    if (alpha[0] < 0.f) {
+                        continue;
+                    }
+
+                    Photon& p = photons[o++];
+
+                    p.p        = positions_[i];
+                    p.wi       = directions_[i];
+                    p.alpha[0] = alpha[0];
+                    p.alpha[1] = alpha[1];
+                    p.alpha[2] = alpha[2];
+
+                    p.properties = properties_[i];
+                }
+            }
+        },
+        0, int32_t(num_blocks), 1);
+
     return comp_num_photons;
 }
 
@@ -319,7 +417,7 @@ void Grid::set_num_paths(uint64_t num_paths) {
 }
 
 float3 Grid::li(Intersection const& isec, Material_sample const& sample,
-                scene::Worker const& worker) const {
+                scene::Worker const& worker, uint64_t& num_photons) const {
     if (0 == num_photons_) {
         return float3(0.f);
     }
@@ -341,18 +439,17 @@ float3 Grid::li(Intersection const& isec, Material_sample const& sample,
         for (uint32_t c = 0; c < adjacency.num_cells; ++c) {
             int2 const cell = adjacency.cells[c];
 
-            for (int32_t i = cell[0], len = cell[1]; i < len; ++i) {
-                auto const& photon = photons_[i];
+            num_photons += uint64_t(cell[1] - cell[0]);
 
-                if (photon.properties.no(Photon::Property::Volumetric)) {
+            for (int32_t i = cell[0], len = cell[1]; i < len; ++i) {
+                if (squared_distance(positions_[i], position) > radius2 ||
+                    properties_[i].no(Photon::Property::Volumetric)) {
                     continue;
                 }
 
-                if (squared_distance(photon.p, position) <= radius2) {
-                    auto const bxdf = sample.evaluate(photon.wi);
+                auto const bxdf = sample.evaluate(directions_[i]);
 
-                    result += float3(photon.alpha) * bxdf.reflection;
-                }
+                result += alphas_[i] * bxdf.reflection;
             }
         }
 
@@ -369,32 +466,34 @@ float3 Grid::li(Intersection const& isec, Material_sample const& sample,
         for (uint32_t c = 0; c < adjacency.num_cells; ++c) {
             int2 const cell = adjacency.cells[c];
 
+            num_photons += uint64_t(cell[1] - cell[0]);
+
             for (int32_t i = cell[0], len = cell[1]; i < len; ++i) {
-                auto const& photon = photons_[i];
+                float3 const p = positions_[i];
 
-                if (photon.properties.is(Photon::Property::Volumetric)) {
-                    continue;
-                }
+                if (float const distance2 = squared_distance(p, position); distance2 < radius2) {
+                    if (properties_[i].is(Photon::Property::Volumetric)) {
+                        continue;
+                    }
 
-                if (float const distance2 = squared_distance(photon.p, position);
-                    distance2 < radius2) {
-                    if (check_disk_ && std::abs(plane::dot(disk, photon.p)) > disk_thickness) {
+                    if (check_disk_ && std::abs(plane::dot(disk, p)) > disk_thickness) {
                         continue;
                     }
 
-                    if (dot(sample.interpolated_normal(), photon.wi) > 0.f) {
+                    float3 const wi = directions_[i];
+
+                    if (dot(sample.interpolated_normal(), wi) > 0.f) {
                         // float const k = 1.f;
 
                         // float const k = cone_filter(distance2, inv_radius2);
 
-                        float const n_dot_wi = material::clamp_dot(sample.shading_normal(),
-                                                                   photon.wi);
+                        float const n_dot_wi = material::clamp_dot(sample.shading_normal(), wi);
 
                         float const k = conely_filter(distance2, inv_radius2);
 
-                        auto const bxdf = sample.evaluate(photon.wi);
+                        auto const bxdf = sample.evaluate(wi);
 
-                        result += (k / n_dot_wi) * float3(photon.alpha) * bxdf.reflection;
+                        result += (k / n_dot_wi) * alphas_[i] * bxdf.reflection;
                     }
                 }
             }
@@ -409,6 +508,113 @@ float3 Grid::li(Intersection const& isec, Material_sample const& sample,
     return result;
 }
 
+void Grid::reserve(uint32_t num_photons) {
+    if (num_photons <= capacity_) {
+        return;
+    }
+
+    memory::free_aligned(indices_[1]);
+    memory::free_aligned(indices_[0]);
+    memory::free_aligned(keys_[1]);
+    memory::free_aligned(keys_[0]);
+    memory::free_aligned(properties_);
+    memory::free_aligned(alphas_);
+    memory::free_aligned(directions_);
+    memory::free_aligned(positions_);
+
+    positions_  = memory::allocate_aligned<float3>(num_photons);
+    directions_ = memory::allocate_aligned<float3>(num_photons);
+    alphas_     = memory::allocate_aligned<float3>(num_photons);
+    properties_ = memory::allocate_aligned<flags::Flags<Photon::Property>>(num_photons);
+    keys_[0]    = memory::allocate_aligned<uint32_t>(num_photons);
+    keys_[1]    = memory::allocate_aligned<uint32_t>(num_photons);
+    indices_[0] = memory::allocate_aligned<uint32_t>(num_photons);
+    indices_[1] = memory::allocate_aligned<uint32_t>(num_photons);
+
+    capacity_ = num_photons;
+}
+
+// Parallel LSD radix sort of the cells, which is stable.
+// Every pass counts the digits of each block, and then scatters the blocks in parallel to the
+// offsets given by the prefix sum over the counts of all blocks, ordered by digit and block.
+void Grid::sort(uint32_t num_photons, Photon const* photons, Threads& threads) {
+    threads.run_range(
+        [this, photons](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+            for (int32_t i = begin; i < end; ++i) {
+                keys_[0][i]    = uint32_t(map1(photons[i].p));
+                indices_[0][i] = uint32_t(i);
+            }
+        },
+        0, int32_t(num_photons));
+
+    uint32_t const num_cells = uint32_t(dimensions_[0] * dimensions_[1] * dimensions_[2] + 1);
+
+    uint32_t const num_passes = (uint32_t(std::bit_width(num_cells - 1)) + Radix_bits - 1) /
+                                Radix_bits;
+
+    uint32_t const block = block_size(num_photons, threads);
+
+    uint32_t const num_blocks = (num_photons + block - 1) / block;
+
+    memory::Buffer<uint32_t> offsets(num_blocks * Radix_size);
+
+    for (uint32_t pass = 0; pass < num_passes; ++pass) {
+        uint32_t const shift = pass * Radix_bits;
+
+        threads.run_range(
+            [this, num_photons, block, shift, &offsets](uint32_t /*id*/, int32_t begin_block,
+                                                        int32_t end_block) noexcept {
+                for (int32_t b = begin_block; b < end_block; ++b) {
+                    uint32_t const begin = uint32_t(b) * block;
+                    uint32_t const end   = std::min(begin + block, num_photons);
+
+                    uint32_t* counts = offsets.data() + uint32_t(b) * Radix_size;
+
+                    std::fill_n(counts, Radix_size, 0);
+
+                    for (uint32_t i = begin; i < end; ++i) {
+                        ++counts[(keys_[0][i] >> shift) & (Radix_size - 1)];
+                    }
+                }
+            },
+            0, int32_t(num_blocks), 1);
+
+        for (uint32_t d = 0, offset = 0; d < Radix_size; ++d) {
+            for (uint32_t b = 0; b < num_blocks; ++b) {
+                uint32_t const count = offsets[b * Radix_size + d];
+
+                offsets[b * Radix_size + d] = offset;
+
+                offset += count;
+            }
+        }
+
+        threads.run_range(
+            [this, num_photons, block, shift, &offsets](uint32_t /*id*/, int32_t begin_block,
+                                                        int32_t end_block) noexcept {
+                for (int32_t b = begin_block; b < end_block; ++b) {
+                    uint32_t const begin = uint32_t(b) * block;
+                    uint32_t const end   = std::min(begin + block, num_photons);
+
+                    uint32_t* targets = offsets.data() + uint32_t(b) * Radix_size;
+
+                    for (uint32_t i = begin; i < end; ++i) {
+                        uint32_t const key = keys_[0][i];
+
+                        uint32_t const t = targets[(key >> shift) & (Radix_size - 1)]++;
+
+                        keys_[1][t]    = key;
+                        indices_[1][t] = indices_[0][i];
+                    }
+                }
+            },
+            0, int32_t(num_blocks), 1);
+
+        std::swap(keys_[0], keys_[1]);
+        std::swap(indices_[0], indices_[1]);
+    }
+}
+
 uint32_t Grid::reduce(float merge_radius, int32_t begin, int32_t end) {
     float const merge_grid_cell_factor = (search_radius_ * grid_cell_factor_) / merge_radius;
 
@@ -419,24 +625,24 @@ uint32_t Grid::reduce(float merge_radius, int32_t begin, int32_t end) {
     uint32_t num_reduced = 0;
 
     for (int32_t i = begin, ilen = end; i < ilen; ++i) {
-        auto& a = photons_[i];
-
-        if (a.alpha[0] < 0.f) {
+        if (alphas_[i][0] < 0.f) {
             continue;
         }
 
-        float3 a_alpha = float3(a.alpha);
+        float3 const a_p = positions_[i];
+
+        float3 a_alpha = alphas_[i];
 
         float total_weight = average(a_alpha);
 
-        float3 position = total_weight * a.p;
+        float3 position = total_weight * a_p;
 
-        float3 wi = a.wi;
+        float3 wi = directions_[i];
 
         uint32_t local_reduced = 0;
 
         Adjacency adjacency;
-        adjacent_cells(a.p, cell_bound, adjacency);
+        adjacent_cells(a_p, cell_bound, adjacency);
 
         for (uint32_t c = 0; c < adjacency.num_cells; ++c) {
             int2 const cell = adjacency.cells[c];
@@ -447,17 +653,17 @@ uint32_t Grid::reduce(float merge_radius, int32_t begin, int32_t end) {
                     continue;
                 }
 
-                auto& b = photons_[j];
-
-                if (b.alpha[0] < 0.f) {
+                if (alphas_[j][0] < 0.f) {
                     continue;
                 }
 
-                if (squared_distance(a.p, b.p) > merge_radius2) {
+                float3 const b_p = positions_[j];
+
+                if (squared_distance(a_p, b_p) > merge_radius2) {
                     continue;
                 }
 
-                float3 const b_alpha = float3(b.alpha);
+                float3 const b_alpha = alphas_[j];
 
                 float const weight = average(b_alpha);
 
@@ -466,21 +672,23 @@ uint32_t Grid::reduce(float merge_radius, int32_t begin, int32_t end) {
 
                 float const threshold = std::max(ratio - 0.1f, 0.f);
 
-                if (dot(wi, b.wi) < threshold) {
+                float3 const b_wi = directions_[j];
+
+                if (dot(wi, b_wi) < threshold) {
                     continue;
                 }
 
                 a_alpha += b_alpha;
 
-                b.alpha[0] = -1.f;
+                alphas_[j][0] = -1.f;
 
                 if (weight > total_weight) {
-                    wi = b.wi;
+                    wi = b_wi;
                 }
 
                 total_weight += weight;
 
-                position += weight * b.p;
+                position += weight * b_p;
 
                 ++local_reduced;
             }
@@ -488,16 +696,12 @@ uint32_t Grid::reduce(float merge_radius, int32_t begin, int32_t end) {
 
         if (local_reduced > 0) {
             if (total_weight < 1.e-10f) {
-                a.alpha[0] = -1.f;
+                alphas_[i][0] = -1.f;
                 ++local_reduced;
             } else {
-                a.p = position / total_weight;
-
-                a.wi = wi;
-
-                a.alpha[0] = a_alpha[0];
-                a.alpha[1] = a_alpha[1];
-                a.alpha[2] = a_alpha[2];
+                positions_[i]  = position / total_weight;
+                directions_[i] = wi;
+                alphas_[i]     = a_alpha;
             }
         }
 
@@ -4,6 +4,7 @@
 #include "base/math/aabb.hpp"
 #include "base/math/vector2.hpp"
 #include "base/math/vector3.hpp"
+#include "photon.hpp"
 
 namespace thread {
 class Pool;
@@ -27,8 +28,6 @@ class Worker;
 
 namespace rendering::integrator::particle::photon {
 
-struct Photon;
-
 class Grid {
   public:
     using Intersection    = scene::prop::Intersection;
@@ -42,17 +41,25 @@ class Grid {
 
     void resize(AABB const& aabb);
 
-    void init_cells(uint32_t num_photons, Photon* photons);
+    // Copies the photons into the grid, sorted by cell
+    void init_cells(uint32_t num_photons, Photon const* photons, Threads& threads);
 
+    // Stores the photons that are left after merging in photons, in the order of the cells
     uint32_t reduce_and_move(Photon* photons, float merge_radius, uint32_t* num_reduced,
                              Threads& threads);
 
     void set_num_paths(uint64_t num_paths);
 
+    // num_photons is incremented by the number of photons in the visited cells
     float3 li(Intersection const& isec, Material_sample const& sample,
-              scene::Worker const& worker) const;
+              scene::Worker const& worker, uint64_t& num_photons) const;
 
   private:
+    void reserve(uint32_t num_photons);
+
+    // Leaves the indices of the photons, ordered by cell, in indices_[0]
+    void sort(uint32_t num_photons, Photon const* photons, Threads& threads);
+
     uint32_t reduce(float merge_radius, int32_t begin, int32_t end);
 
     int32_t map1(float3_p v) const;
@@ -67,7 +74,19 @@ class Grid {
     void adjacent_cells(float3_p v, float2 cell_bound, Adjacency& adjacency) const;
 
     uint32_t num_photons_;
-    Photon*  photons_;
+    uint32_t capacity_;
+
+    // The photons sorted by cell, one array per member,
+    // so that the lookups only touch the properties of the photons close enough
+    float3* positions_;
+    float3* directions_;
+    float3* alphas_;
+
+    flags::Flags<Photon::Property>* properties_;
+
+    // Cell of every photon, and the permutation that sorts them, twice for the radix sort
+    uint32_t* keys_[2];
+    uint32_t* indices_[2];
 
     AABB aabb_;
 
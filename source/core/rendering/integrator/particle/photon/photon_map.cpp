@@ -50,7 +50,7 @@ uint32_t Map::compile_iteration(uint32_t num_photons, uint64_t num_paths, Thread
 
     num_paths_ = num_paths;
 
-    grid_.init_cells(num_photons, photons_.data());
+    grid_.init_cells(num_photons, photons_.data(), threads);
 
     uint32_t const total_num_photons = photons_.size();
 
@@ -69,14 +69,14 @@ uint32_t Map::compile_iteration(uint32_t num_photons, uint64_t num_paths, Thread
     return reduced_num;
 }
 
-void Map::compile_finalize() {
-    grid_.init_cells(reduced_num_, photons_.data());
+void Map::compile_finalize(Threads& threads) {
+    grid_.init_cells(reduced_num_, photons_.data(), threads);
     grid_.set_num_paths(num_paths_);
 }
 
 float3 Map::li(Intersection const& isec, Material_sample const& sample,
-               scene::Worker const& worker) const {
-    return grid_.li(isec, sample, worker);
+               scene::Worker const& worker, uint64_t& num_photons) const {
+    return grid_.li(isec, sample, worker, num_photons);
 }
 
 bool Map::caustics_only() const {
@@ -84,6 +84,10 @@ bool Map::caustics_only() const {
 }
 
 AABB Map::calculate_aabb(uint32_t num_photons, Threads& threads) const {
+    for (uint32_t i = 0, len = threads.num_threads(); i < len; ++i) {
+        aabbs_[i] = AABB(Empty_AABB);
+    }
+
     threads.run_range(
         [this](uint32_t id, int32_t begin, int32_t end) {
             AABB aabb(Empty_AABB);
@@ -92,7 +96,7 @@ AABB Map::calculate_aabb(uint32_t num_photons, Threads& threads) const {
                 aabb.insert(photons_[i].p);
             }
 
-            aabbs_[id] = aabb;
+            aabbs_[id].merge_assign(aabb);
         },
         0, int32_t(num_photons));
 
@@ -29,10 +29,11 @@ class Map {
 
     uint32_t compile_iteration(uint32_t num_photons, uint64_t num_paths, Threads& threads);
 
-    void compile_finalize();
+    void compile_finalize(Threads& threads);
 
+    // num_photons is incremented by the number of photons that were considered
     float3 li(Intersection const& isec, Material_sample const& sample,
-              scene::Worker const& worker) const;
+              scene::Worker const& worker, uint64_t& num_photons) const;
 
     bool caustics_only() const;
 
@@ -290,9 +290,13 @@ void Sparse_grid::init_cells(uint32_t num_photons, Photon* photons) {
 
 uint32_t Sparse_grid::reduce_and_move(Photon* photons, float merge_radius, uint32_t* num_reduced,
                                       Threads& threads) {
+    for (uint32_t i = 0, len = threads.num_threads(); i < len; ++i) {
+        num_reduced[i] = 0;
+    }
+
     threads.run_range(
         [this, merge_radius, num_reduced](uint32_t id, int32_t begin, int32_t end) {
-            num_reduced[id] = reduce(merge_radius, begin, end);
+            num_reduced[id] += reduce(merge_radius, begin, end);
         },
         0, static_cast<int32_t>(num_photons_));
 
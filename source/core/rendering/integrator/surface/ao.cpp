@@ -11,8 +11,11 @@
 #include "scene/material/material.inl"
 #include "scene/material/material_sample.inl"
 #include "scene/prop/prop_intersection.inl"
+#include "scene/scene_constants.hpp"
 #include "scene/scene_ray.inl"
 
+#include <bit>
+
 namespace rendering::integrator::surface {
 
 static sampler::Sampler* create_sampler(uint32_t max_samples_per_pixel, bool progressive) {
@@ -55,24 +58,33 @@ float4 AO::li(Ray& ray, Intersection& isec, Worker& worker, Interface_stack cons
     occlusion_ray.max_t() = settings_.radius;
     occlusion_ray.time    = ray.time;
 
-    for (uint32_t i = settings_.num_samples; i > 0; --i) {
-        float2 const sample = sampler_->sample_2D(worker.rng());
+    // All occlusion rays start at the same point, so they are traced as packets
+    for (uint32_t s = 0, num_samples = settings_.num_samples; s < num_samples;
+         s += scene::Packet_size) {
+        uint32_t const num = std::min(num_samples - s, scene::Packet_size);
+
+        Ray occlusion_rays[scene::Packet_size];
 
-        float3 const t = mat_sample.shading_tangent();
-        float3 const b = mat_sample.shading_bitangent();
-        float3 const n = mat_sample.shading_normal();
+        for (uint32_t i = 0; i < num; ++i) {
+            float2 const sample = sampler_->sample_2D(worker.rng());
 
-        float3 const ws = sample_oriented_hemisphere_cosine(sample, t, b, n);
+            float3 const t = mat_sample.shading_tangent();
+            float3 const b = mat_sample.shading_bitangent();
+            float3 const n = mat_sample.shading_normal();
 
-        occlusion_ray.set_direction(ws);
+            float3 const ws = sample_oriented_hemisphere_cosine(sample, t, b, n);
 
-        //        if (auto const v = worker.visibility(occlusion_ray, Filter::Undefined); v.valid) {
-        //            result += num_samples_reciprocal;
-        //        }
+            occlusion_ray.set_direction(ws);
 
-        if (float3 v; worker.visibility(occlusion_ray, Filter::Undefined, v)) {
-            result += num_samples_reciprocal;
+            occlusion_rays[i] = occlusion_ray;
         }
+
+        float3 vs[scene::Packet_size];
+
+        uint32_t const visible = worker.visibility(occlusion_rays, (1u << num) - 1,
+                                                   Filter::Undefined, vs);
+
+        result += float(std::popcount(visible)) * num_samples_reciprocal;
     }
 
     return float4(result, result, result, 1.f);
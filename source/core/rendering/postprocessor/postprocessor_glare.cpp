@@ -1,5 +1,6 @@
 #include "postprocessor_glare.hpp"
 #include "base/math/exp.hpp"
+#include "base/math/vector2.inl"
 #include "base/math/vector4.inl"
 #include "base/memory/array.inl"
 #include "base/memory/buffer.hpp"
@@ -10,14 +11,22 @@
 #include "image/typed_image.hpp"
 #include "scene/camera/camera.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
 namespace rendering::postprocessor {
 
 Glare::Glare(Adaption adaption, float threshold, float intensity)
-    : Postprocessor(2),
-      adaption_(adaption),
+    : adaption_(adaption),
       threshold_(threshold),
       intensity_(intensity),
-      kernel_(nullptr) {}
+      angle_(0.f),
+      fft_(false),
+      dimensions_(0),
+      fft_dimensions_(0),
+      kernel_(nullptr),
+      scratch_size_(0) {}
 
 Glare::~Glare() {
     delete[] kernel_;
@@ -46,14 +55,31 @@ static inline float f3(float theta, float lambda) {
 void Glare::init(Camera const& camera, Threads& threads) {
     auto const dim = camera.sensor_dimensions();
 
+    float const angle = math::radians_to_degrees(std::sqrt(camera.pixel_solid_angle()));
+
+    if (kernel_ && dim == dimensions_ && angle == angle_) {
+        return;
+    }
+
+    dimensions_ = dim;
+    angle_      = angle;
+
     uint32_t const buffer_size = uint32_t(dim[0] * dim[1]);
 
     high_.reserve(buffer_size);
 
-    float const angle = math::radians_to_degrees(std::sqrt(camera.pixel_solid_angle()));
-
+    delete[] kernel_;
     kernel_ = new float3[buffer_size];
 
+    // The offsets between pixels span [-(d - 1), d - 1] in each dimension
+    fft_dimensions_ = int2(std::max(std::bit_ceil(uint32_t(2 * dim[0] - 1)), 4u),
+                           std::max(std::bit_ceil(uint32_t(2 * dim[1] - 1)), 4u));
+
+    kernel_spectrum_.release();
+    spectrum_.release();
+    scratch_.release();
+    glare_.release();
+
     spectrum::Interpolated const CIE_X(spectrum::CIE_XYZ_Num, spectrum::CIE_Wavelengths_360_830_1nm,
                                        spectrum::CIE_X_360_830_1nm);
     spectrum::Interpolated const CIE_Y(spectrum::CIE_XYZ_Num, spectrum::CIE_Wavelengths_360_830_1nm,
@@ -189,45 +215,43 @@ void Glare::init(Camera const& camera, Threads& threads) {
     }
 }
 
-void Glare::pre_apply(image::Float4 const& /*source*/, image::Float4& /*destination*/,
-                      Threads& /*threads*/) {
+void Glare::pre_apply(image::Float4 const& source, image::Float4& /*destination*/,
+                      Threads& threads) {
     high_.clear();
-}
 
-void Glare::apply(uint32_t /*id*/, uint32_t pass, int32_t begin, int32_t end,
-                  image::Float4 const& source, image::Float4& destination, Scene const& /*scene*/) {
-    if (0 == pass) {
-        float threshold = threshold_;
+    float const threshold = threshold_;
 
-        for (int32_t i = begin; i < end; ++i) {
-            float3 const color = source.at(i).xyz();
+    threads.run_range(
+        [this, threshold, &source](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+            for (int32_t i = begin; i < end; ++i) {
+                float3 const color = source.at(i).xyz();
 
-            float const l = spectrum::luminance(color);
+                float const l = spectrum::luminance(color);
 
-            if (l > threshold) {
-                int2 const c = destination.coordinates_2(i);
-                high_.push_back(c);
+                if (l > threshold) {
+                    int2 const c = source.coordinates_2(i);
+                    high_.push_back(c);
+                }
             }
-        }
-    } else {
-        Simdf const intensity(intensity_);
+        },
+        0, int32_t(source.description().num_pixels()));
 
-        int32_t const d0 = destination.description().dimensions()[0];
+    std::sort(high_.begin(), high_.end());
 
-        for (int32_t i = begin; i < end; ++i) {
-            int2 const kb = -destination.coordinates_2(i);
+    fft_ = prefer_fft();
 
-            Simdf glare(simd::Zero);
-            for (int2 hc : high_) {
-                int2 const kc = abs(kb + hc);
-
-                int32_t const ki = kc[1] * d0 + kc[0];
+    if (fft_) {
+        convolve(source, threads);
+    }
+}
 
-                Simdf const k(kernel_[ki].v);
-                Simdf const h(source.at(hc[0], hc[1]).v);
+void Glare::apply(uint32_t /*id*/, uint32_t /*pass*/, int32_t begin, int32_t end,
+                  image::Float4 const& source, image::Float4& destination, Scene const& /*scene*/) {
+    Simdf const intensity(intensity_);
 
-                glare += k * h;
-            }
+    if (fft_) {
+        for (int32_t i = begin; i < end; ++i) {
+            Simdf glare(glare_[i].v);
 
             glare *= intensity;
 
@@ -237,12 +261,201 @@ void Glare::apply(uint32_t /*id*/, uint32_t pass, int32_t begin, int32_t end,
 
             simd::store_float4(reinterpret_cast<float*>(destination.data() + i), s.v);
         }
+
+        return;
+    }
+
+    int32_t const d0 = destination.description().dimensions()[0];
+
+    for (int32_t i = begin; i < end; ++i) {
+        int2 const kb = -destination.coordinates_2(i);
+
+        Simdf glare(simd::Zero);
+        for (int2 hc : high_) {
+            int2 const kc = abs(kb + hc);
+
+            int32_t const ki = kc[1] * d0 + kc[0];
+
+            Simdf const k(kernel_[ki].v);
+            Simdf const h(source.at(hc[0], hc[1]).v);
+
+            glare += k * h;
+        }
+
+        glare *= intensity;
+
+        Simdf s(reinterpret_cast<float*>(source.data() + i));
+
+        s += glare;
+
+        simd::store_float4(reinterpret_cast<float*>(destination.data() + i), s.v);
+    }
+}
+
+bool Glare::prefer_fft() const {
+    uint64_t const num_pixels = uint64_t(dimensions_[0] * dimensions_[1]);
+
+    uint64_t const direct = num_pixels * uint64_t(high_.size());
+
+    // Three channels, each transformed forward and backward,
+    // plus the kernel spectrum if it isn't cached yet
+    uint64_t const fft_size = uint64_t(fft_dimensions_[0] * fft_dimensions_[1]);
+
+    uint64_t const log_size = uint64_t(std::countr_zero(fft_size));
+
+    uint64_t const fft = (kernel_spectrum_ ? 6 : 9) * fft_size * log_size;
+
+    // A term of the direct sum measured roughly twice as expensive as a butterfly
+    return 2 * direct > fft;
+}
+
+void Glare::init_fft(Threads& threads) {
+    int32_t const width  = fft_dimensions_[0];
+    int32_t const height = fft_dimensions_[1];
+
+    int32_t const row_size = width / 2 + 1;
+
+    row_fft_.init(uint32_t(width / 2));
+    column_fft_.init(uint32_t(height));
+
+    spectrum_.resize(uint32_t(row_size * height));
+
+    // One real row or one complex column per thread
+    scratch_size_ = uint32_t(std::max(width, 2 * height));
+    scratch_.resize(threads.num_threads() * scratch_size_);
+
+    uint32_t const num_pixels = uint32_t(dimensions_[0] * dimensions_[1]);
+
+    glare_.resize(num_pixels);
+
+    // Only the color channels are written by convolve()
+    std::fill_n(glare_.data(), num_pixels, float3(0.f));
+
+    int32_t const half_height = height / 2 + 1;
+
+    kernel_spectrum_.resize(uint32_t(row_size * half_height));
+
+    int2 const d = dimensions_;
+
+    for (uint32_t c = 0; c < 3; ++c) {
+        // Kernel values for the offsets [0, d - 1] at the start of each dimension,
+        // and for [-(d - 1), -1] wrapped around to the end
+        threads.run_range(
+            [this, c, d, width, height, row_size](uint32_t id, int32_t begin, int32_t end) noexcept {
+                float* row = scratch_.data() + id * scratch_size_;
+
+                for (int32_t y = begin; y < end; ++y) {
+                    int32_t const ky = y < d[1] ? y : (height - y < d[1] ? height - y : -1);
+
+                    for (int32_t x = 0; x < width; ++x) {
+                        int32_t const kx = x < d[0] ? x : (width - x < d[0] ? width - x : -1);
+
+                        row[x] = (ky >= 0 && kx >= 0) ? kernel_[ky * d[0] + kx][c] : 0.f;
+                    }
+
+                    row_fft_.forward_real(row, spectrum_.data() + y * row_size);
+                }
+            },
+            0, height);
+
+        threads.run_range(
+            [this, c, height, half_height, row_size](uint32_t id, int32_t begin,
+                                                     int32_t end) noexcept {
+                float2* column = reinterpret_cast<float2*>(scratch_.data() + id * scratch_size_);
+
+                for (int32_t x = begin; x < end; ++x) {
+                    for (int32_t y = 0; y < height; ++y) {
+                        column[y] = spectrum_[y * row_size + x];
+                    }
+
+                    column_fft_.forward(column);
+
+                    for (int32_t y = 0; y < half_height; ++y) {
+                        kernel_spectrum_[y * row_size + x][c] = column[y][0];
+                    }
+                }
+            },
+            0, row_size);
     }
 }
 
-void Glare::post_pass(uint32_t pass) {
-    if (0 == pass) {
-        std::sort(high_.begin(), high_.end());
+void Glare::convolve(image::Float4 const& source, Threads& threads) {
+    if (!kernel_spectrum_) {
+        init_fft(threads);
+    }
+
+    int2 const d = dimensions_;
+
+    int32_t const width  = fft_dimensions_[0];
+    int32_t const height = fft_dimensions_[1];
+
+    int32_t const row_size = width / 2 + 1;
+
+    float const threshold = threshold_;
+
+    for (uint32_t c = 0; c < 3; ++c) {
+        // Only the first d[1] rows contain high pixels, the others are zero
+        threads.run_range(
+            [this, c, d, width, row_size, threshold, &source](uint32_t id, int32_t begin,
+                                                              int32_t end) noexcept {
+                float* row = scratch_.data() + id * scratch_size_;
+
+                for (int32_t y = begin; y < end; ++y) {
+                    for (int32_t x = 0; x < d[0]; ++x) {
+                        float3 const color = source.at(x, y).xyz();
+
+                        row[x] = spectrum::luminance(color) > threshold ? color[c] : 0.f;
+                    }
+
+                    std::fill(row + d[0], row + width, 0.f);
+
+                    row_fft_.forward_real(row, spectrum_.data() + y * row_size);
+                }
+            },
+            0, d[1]);
+
+        // Transforming, filtering and transforming back each column in one go
+        threads.run_range(
+            [this, c, d, height, row_size](uint32_t id, int32_t begin, int32_t end) noexcept {
+                float2* column = reinterpret_cast<float2*>(scratch_.data() + id * scratch_size_);
+
+                for (int32_t x = begin; x < end; ++x) {
+                    for (int32_t y = 0; y < d[1]; ++y) {
+                        column[y] = spectrum_[y * row_size + x];
+                    }
+
+                    std::fill(column + d[1], column + height, float2(0.f));
+
+                    column_fft_.forward(column);
+
+                    for (int32_t y = 0; y < height; ++y) {
+                        int32_t const ky = std::min(y, height - y);
+
+                        column[y] *= kernel_spectrum_[ky * row_size + x][c];
+                    }
+
+                    column_fft_.inverse(column);
+
+                    for (int32_t y = 0; y < d[1]; ++y) {
+                        spectrum_[y * row_size + x] = column[y];
+                    }
+                }
+            },
+            0, row_size);
+
+        threads.run_range(
+            [this, c, d, row_size](uint32_t id, int32_t begin, int32_t end) noexcept {
+                float* row = scratch_.data() + id * scratch_size_;
+
+                for (int32_t y = begin; y < end; ++y) {
+                    row_fft_.inverse_real(spectrum_.data() + y * row_size, row);
+
+                    for (int32_t x = 0; x < d[0]; ++x) {
+                        glare_[y * d[0] + x][c] = row[x];
+                    }
+                }
+            },
+            0, d[1]);
     }
 }
 
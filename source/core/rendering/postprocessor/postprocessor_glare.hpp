@@ -1,8 +1,10 @@
 #ifndef SU_CORE_RENDERING_POSTPROCESSOR_GLARE_HPP
 #define SU_CORE_RENDERING_POSTPROCESSOR_GLARE_HPP
 
+#include "base/math/fft.hpp"
 #include "base/math/vector2.hpp"
 #include "base/memory/array.hpp"
+#include "base/memory/buffer.hpp"
 #include "postprocessor.hpp"
 
 namespace rendering::postprocessor {
@@ -23,18 +25,49 @@ class Glare final : public Postprocessor {
     void apply(uint32_t id, uint32_t pass, int32_t begin, int32_t end, image::Float4 const& source,
                image::Float4& destination, Scene const& scene) final;
 
-    void post_pass(uint32_t pass) final;
+    // Whether the convolution in the Fourier domain is expected to be faster than
+    // summing the contribution of every high pixel directly
+    bool prefer_fft() const;
+
+    void init_fft(Threads& threads);
+
+    // Stores the convolution of the high pixels with the kernel in glare_
+    void convolve(image::Float4 const& source, Threads& threads);
 
     Adaption adaption_;
 
     float threshold_;
     float intensity_;
 
+    float angle_;
+
+    bool fft_;
+
     int2 dimensions_;
 
+    // Power of two sizes, large enough to avoid wrap-around for all kernel offsets
+    int2 fft_dimensions_;
+
     memory::Concurrent_array<int2> high_;
 
     float3* kernel_;
+
+    math::FFT row_fft_;
+    math::FFT column_fft_;
+
+    // (fft_dimensions_[0] / 2 + 1) x fft_dimensions_[1], for one channel at a time
+    memory::Buffer<float2> spectrum_;
+
+    // The kernel is real and symmetric, and so is its spectrum.
+    // Only the real parts of the rows [0, fft_dimensions_[1] / 2] are therefore stored.
+    // Kept as long as dimensions and adaption don't change.
+    memory::Buffer<float3> kernel_spectrum_;
+
+    memory::Buffer<float> scratch_;
+
+    uint32_t scratch_size_;
+
+    memory::Buffer<float3> glare_;
 };
 
 }  // namespace rendering::postprocessor
@@ -1,6 +1,6 @@
 #include "tonemapper.hpp"
 #include "base/math/vector4.inl"
-#include "base/memory/buffer.hpp"
+#include "base/memory/array.inl"
 #include "base/spectrum/rgb.hpp"
 #include "base/thread/thread_pool.hpp"
 #include "image/typed_image.hpp"
@@ -24,7 +24,7 @@ void Tonemapper::pre_apply(image::Float4 const& source, image::Float4& /*destina
 
     int32_t const num_pixels = int32_t(source.description().num_pixels());
 
-    memory::Buffer<float> luminances(threads.num_threads());
+    memory::Array<float> luminances(threads.num_threads(), 0.f);
 
     threads.run_range(
         [&source, &luminances](uint32_t id, int32_t begin, int32_t end) {
@@ -40,7 +40,7 @@ void Tonemapper::pre_apply(image::Float4 const& source, image::Float4& /*destina
                 average += luminance * iaf;
             }
 
-            luminances[id] = average;
+            luminances[id] += average;
         },
         0, num_pixels);
 
@@ -7,16 +7,27 @@
 #include "exporting/exporting_sink.hpp"
 #include "logging/logging.hpp"
 #include "progress/progress_sink.hpp"
+#include "rendering/checkpoint.hpp"
 #include "rendering/rendering_worker.hpp"
 #include "rendering/sensor/sensor.hpp"
 #include "scene/camera/camera.hpp"
 #include "scene/scene.inl"
 #include "take/take.hpp"
 
+#include <algorithm>
+#include <fstream>
+
 namespace rendering {
 
 static uint32_t constexpr Num_particles_per_chunk = 1024;
 
+// chrono::seconds_since() only resolves milliseconds, which is too coarse for single tiles
+static float tile_seconds_since(std::chrono::high_resolution_clock::time_point time_point) {
+    auto const duration = std::chrono::high_resolution_clock::now() - time_point;
+    return float(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()) *
+           1.e-6f;
+}
+
 Driver::Driver(Threads& threads, progress::Sink& progressor)
     : threads_(threads),
       scene_(nullptr),
@@ -25,23 +36,34 @@ Driver::Driver(Threads& threads, progress::Sink& progressor)
       frame_(0),
       frame_view_(0),
       frame_iteration_(0),
+      split_index_(0),
+      num_splits_(1),
+      exporting_(false),
+      export_duration_(0.f),
+      hidden_export_duration_(0.f),
       photon_infos_(new Photon_info[threads.num_threads()]),
       progressor_(progressor) {}
 
 Driver::~Driver() {
+    finish_export();
+
     delete[] photon_infos_;
 
     delete[] workers_;
 }
 
 void Driver::init(take::View& view, Scene& scene, bool progressive) {
+    finish_export();
+
     view_ = &view;
 
     scene_ = &scene;
 
     Camera const& camera = *view.camera;
 
-    tiles_.init(camera.crop(), 32, camera.sensor().filter_radius_int());
+    tiles_.init(camera.crop(), int32_t(view.tile_settings.dimensions),
+                camera.sensor().filter_radius_int(), threads_.num_threads(),
+                view.tile_settings.subdivide, view.tile_settings.cost_order);
 
     int2 const d = camera.sensor_dimensions();
 
@@ -49,6 +71,12 @@ void Driver::init(take::View& view, Scene& scene, bool progressive) {
 
     target_.resize(d);
 
+    export_targets_.resize(view.aovs.num_slots() + 1);
+
+    for (auto& t : export_targets_) {
+        t.resize(d);
+    }
+
     int2 const r = camera.resolution();
 
     uint64_t const num_particles = uint64_t(r[0] * r[1]) *
@@ -84,11 +112,19 @@ void Driver::init(take::View& view, Scene& scene, bool progressive) {
         particle_importance_.init(scene);
     }
 
+    sensor::Variance* variance = nullptr;
+
+    if (!progressive && view.adaptive_settings.num_base_samples > 0) {
+        variance_.resize(camera.resolution(), camera.num_views());
+
+        variance = &variance_;
+    }
+
     for (uint32_t i = 0, len = threads_.num_threads(); i < len; ++i) {
         workers_[i].init(i, scene, camera, view.num_samples_per_pixel, view.surface_integrators,
                          *view.volume_integrators, *view.samplers, photon_map, view.photon_settings,
                          view.lighttracers, Num_particles_per_chunk, view.aovs,
-                         &particle_importance_);
+                         &particle_importance_, variance);
     }
 }
 
@@ -157,6 +193,11 @@ void Driver::render(uint32_t frame, uint32_t iteration) {
     render_frame_forward(frame, iteration);
 }
 
+void Driver::set_split(uint32_t split_index, uint32_t num_splits) {
+    split_index_ = split_index;
+    num_splits_  = num_splits;
+}
+
 void Driver::postprocess() {
     auto& camera = *view_->camera;
 
@@ -167,27 +208,101 @@ void Driver::postprocess() {
     }
 }
 
+bool Driver::write_checkpoint(std::string const& filename, uint32_t frame,
+                              uint32_t num_iterations, float seconds) const {
+    Checkpoint const checkpoint{frame, num_iterations, split_index_, num_splits_, seconds};
+
+    return checkpoint.write(filename, view_->camera->sensor());
+}
+
+bool Driver::read_checkpoint(std::string const& filename, uint32_t frame,
+                             uint32_t& num_iterations, float& seconds) {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream) {
+        return false;
+    }
+
+    Checkpoint checkpoint;
+
+    if (!checkpoint.read(stream) || frame != checkpoint.frame ||
+        split_index_ != checkpoint.split_index || num_splits_ != checkpoint.num_splits) {
+        logging::warning("Checkpoint %S does not belong to this frame.", filename);
+        return false;
+    }
+
+    auto& sensor = view_->camera->sensor();
+
+    if (!sensor.read(stream)) {
+        logging::warning("Checkpoint %S does not match the sensor.", filename);
+
+        sensor.clear(0.f, view_->aovs);
+        return false;
+    }
+
+    num_iterations = checkpoint.num_iterations;
+    seconds        = checkpoint.seconds;
+
+    return true;
+}
+
 void Driver::export_frame(uint32_t frame, Exporters& exporters) {
     using namespace sensor;
 
-    auto const export_start = std::chrono::high_resolution_clock::now();
+    finish_export();
 
-    for (auto& e : exporters) {
-        e->write(target_, aov::Property::Unknown, frame, threads_);
-    }
+    target_.copy(export_targets_[0]);
 
     for (uint32_t i = 0, len = view_->aovs.num_slots(); i < len; ++i) {
-        auto const property = view_->aovs.property(i);
+        view_->camera->sensor().resolve(i, view_->aovs.property(i), threads_,
+                                        export_targets_[i + 1]);
+    }
+
+    exporting_ = true;
 
-        view_->camera->sensor().resolve(i, property, threads_, target_);
+    threads_.run_async([this, frame, &exporters]() noexcept {
+        auto const export_start = std::chrono::high_resolution_clock::now();
 
         for (auto& e : exporters) {
-            e->write(target_, property, frame, threads_);
+            e->write(export_targets_[0], aov::Property::Unknown, frame, threads_);
         }
+
+        for (uint32_t i = 0, len = view_->aovs.num_slots(); i < len; ++i) {
+            auto const property = view_->aovs.property(i);
+
+            for (auto& e : exporters) {
+                e->write(export_targets_[i + 1], property, frame, threads_);
+            }
+        }
+
+        export_duration_ = tile_seconds_since(export_start);
+    });
+}
+
+void Driver::wait_export() {
+    finish_export();
+
+    logging::info("Hidden export time %f s", hidden_export_duration_);
+
+    hidden_export_duration_ = 0.f;
+}
+
+void Driver::finish_export() {
+    if (!exporting_) {
+        return;
     }
 
-    auto const export_duration = chrono::seconds_since(export_start);
-    logging::info("Export time %f s", export_duration);
+    auto const wait_start = std::chrono::high_resolution_clock::now();
+
+    threads_.wait_async();
+
+    float const wait_duration = tile_seconds_since(wait_start);
+
+    exporting_ = false;
+
+    hidden_export_duration_ += std::max(export_duration_ - wait_duration, 0.f);
+
+    logging::info("Export time %f s", export_duration_);
+    logging::info("Export wait time %f s", wait_duration);
 }
 
 void Driver::render_frame_backward(uint32_t frame) {
@@ -259,7 +374,7 @@ void Driver::render_frame_backward(uint32_t frame, uint32_t iteration) {
 
     frame_ = frame;
 
-    frame_iteration_ = iteration;
+    frame_iteration_ = iteration * num_splits_ + split_index_;
 
     auto& camera = *view_->camera;
 
@@ -307,6 +422,20 @@ void Driver::render_frame_forward(uint32_t frame) {
 
     frame_ = frame;
 
+    for (uint32_t i = 0, len = threads_.num_threads(); i < len; ++i) {
+        workers_[i].clear_photon_statistics();
+    }
+
+    if (view_->adaptive_settings.num_base_samples > 0) {
+        render_frame_forward_adaptive();
+
+        auto const duration = chrono::seconds_since(start);
+        logging::info("Camera ray time " + string::to_string(duration) + " s");
+
+        log_photon_statistics(duration);
+        return;
+    }
+
     progressor_.start(tiles_.size() * camera.num_views());
 
     for (uint32_t v = 0, len = camera.num_views(); v < len; ++v) {
@@ -314,21 +443,17 @@ void Driver::render_frame_forward(uint32_t frame) {
 
         tiles_.restart();
 
-        threads_.run_parallel([this](uint32_t index) noexcept {
-            auto& worker = workers_[index];
+        auto const view_start = std::chrono::high_resolution_clock::now();
 
-            uint32_t const num_samples = view_->num_samples_per_pixel;
+        render_tiles(0, view_->num_samples_per_pixel, true);
 
-            for (int4 tile; tiles_.pop(tile);) {
-                worker.render(frame_, frame_view_, 0, tile, num_samples);
-
-                progressor_.tick();
-            }
-        });
+        log_tile_statistics(chrono::seconds_since(view_start));
     }
 
     auto const duration = chrono::seconds_since(start);
     logging::info("Camera ray time " + string::to_string(duration) + " s");
+
+    log_photon_statistics(duration);
 }
 
 void Driver::render_frame_forward(uint32_t frame, uint32_t iteration) {
@@ -340,23 +465,142 @@ void Driver::render_frame_forward(uint32_t frame, uint32_t iteration) {
 
     frame_ = frame;
 
-    frame_iteration_ = iteration;
+    frame_iteration_ = iteration * num_splits_ + split_index_;
 
     for (uint32_t v = 0, len = camera.num_views(); v < len; ++v) {
         frame_view_ = v;
 
         tiles_.restart();
 
-        threads_.run_parallel([this](uint32_t index) noexcept {
-            auto& worker = workers_[index];
+        render_tiles(frame_iteration_, view_->num_samples_per_pixel, false);
+    }
+}
+
+void Driver::render_frame_forward_adaptive() {
+    auto const& settings = view_->adaptive_settings;
+
+    auto& camera = *view_->camera;
+
+    uint32_t const num_samples_per_pixel = view_->num_samples_per_pixel;
+
+    uint64_t num_samples = 0;
+    uint64_t max_samples = 0;
+
+    uint32_t max_passes = 0;
+
+    variance_.clear();
+
+    for (uint32_t v = 0, len = camera.num_views(); v < len; ++v) {
+        frame_view_ = v;
+
+        tiles_.activate_all();
+
+        uint32_t const num_tiles = tiles_.size();
+
+        max_samples += tiles_.num_pixels() * uint64_t(num_samples_per_pixel);
+
+        uint32_t pass = 0;
+
+        for (uint32_t current = 0; current < num_samples_per_pixel; ++pass) {
+            uint32_t const num = 0 == pass ? settings.num_base_samples
+                                           : std::min(settings.num_step_samples,
+                                                      num_samples_per_pixel - current);
+
+            if (pass > 0) {
+                uint32_t const num_active = tiles_.refine(settings.threshold);
+
+                if (0 == num_active) {
+                    break;
+                }
+
+                logging::info("Pass " + string::to_string(pass) + ": " +
+                              string::to_string(num_active) + " of " +
+                              string::to_string(num_tiles) + " tiles");
+            }
+
+            tiles_.restart();
+
+            progressor_.start(tiles_.size());
+
+            num_samples += tiles_.num_pixels() * uint64_t(num);
+
+            auto const pass_start = std::chrono::high_resolution_clock::now();
+
+            render_tiles(pass, num, true);
+
+            log_tile_statistics(chrono::seconds_since(pass_start));
+
+            current += num;
+        }
+
+        max_passes = std::max(max_passes, pass);
+    }
+
+    float const saved = 1.f - float(num_samples) / float(std::max(max_samples, uint64_t(1)));
 
-            uint32_t const num_samples = view_->num_samples_per_pixel;
+    logging::info("Adaptive sampling: " + string::to_string(max_passes) + " passes, " +
+                  string::to_string(num_samples) + " of " + string::to_string(max_samples) +
+                  " samples, " + string::to_string(saved * 100.f) + "% saved");
+}
+
+void Driver::render_tiles(uint32_t iteration, uint32_t num_samples, bool progress) {
+    threads_.run_parallel([this, iteration, num_samples, progress](uint32_t index) noexcept {
+        auto& worker = workers_[index];
+
+        int4     tile;
+        uint32_t id;
 
-            for (int4 tile; tiles_.pop(tile);) {
-                worker.render(frame_, frame_view_, frame_iteration_, tile, num_samples);
+        while (tiles_.pop(tile, id)) {
+            auto const tile_start = std::chrono::high_resolution_clock::now();
+
+            float const error = worker.render(frame_, frame_view_, iteration, tile, num_samples);
+
+            tiles_.record(id, tile_seconds_since(tile_start));
+            tiles_.record_error(id, error);
+
+            if (progress) {
+                progressor_.tick();
             }
-        });
+        }
+    });
+}
+
+void Driver::log_tile_statistics(float duration) const {
+    auto const s = tiles_.statistics();
+
+    // Fraction of the available thread time that was spent rendering tiles.
+    // The rest is mostly threads waiting for the last tiles of the pass.
+    float const utilization = s.total /
+                              (float(threads_.num_threads()) * std::max(duration, 1.e-6f));
+
+    logging::info("Tiles " + string::to_string(s.num_items) + ": min " +
+                  string::to_string(s.min * 1000.f) + " ms, avg " +
+                  string::to_string(s.total / float(s.num_items) * 1000.f) + " ms, max " +
+                  string::to_string(s.max * 1000.f) + " ms, utilization " +
+                  string::to_string(std::min(utilization, 1.f) * 100.f) + "%");
+}
+
+void Driver::log_photon_statistics(float duration) const {
+    uint64_t num_lookups = 0;
+    uint64_t num_photons = 0;
+
+    for (uint32_t i = 0, len = threads_.num_threads(); i < len; ++i) {
+        auto const& s = workers_[i].photon_statistics();
+
+        num_lookups += s.num_lookups;
+        num_photons += s.num_photons;
+    }
+
+    if (0 == num_lookups) {
+        return;
     }
+
+    // Relative to the whole camera ray time, so this is a lower bound of the lookup throughput
+    logging::info("Photon lookups " + string::to_string(num_lookups) + ": " +
+                  string::to_string(float(num_photons) / float(num_lookups)) +
+                  " photons per lookup, " +
+                  string::to_string(float(num_lookups) / std::max(duration, 1.e-6f) * 1.e-6f) +
+                  " M lookups/s");
 }
 
 void Driver::bake_photons(uint32_t frame) {
@@ -377,6 +621,8 @@ void Driver::bake_photons(uint32_t frame) {
     uint64_t num_paths = 0;
     uint32_t begin     = 0;
 
+    float build_duration = 0.f;
+
     float const iteration_threshold = view_->photon_settings.iteration_threshold;
 
     photon_map_.start();
@@ -395,11 +641,15 @@ void Driver::bake_photons(uint32_t frame) {
     for (uint32_t iteration = 0;; ++iteration) {
         frame_iteration_ = iteration;
 
+        for (uint32_t i = 0, len = threads_.num_threads(); i < len; ++i) {
+            photon_infos_[i].num_paths = 0;
+        }
+
         threads_.run_range(
             [this](uint32_t id, int32_t begin, int32_t end) {
                 auto& worker = workers_[id];
 
-                photon_infos_[id].num_paths = worker.bake_photons(begin, end, frame_,
+                photon_infos_[id].num_paths += worker.bake_photons(begin, end, frame_,
                                                                   frame_iteration_);
             },
             int32_t(begin), int32_t(num_photons));
@@ -413,8 +663,12 @@ void Driver::bake_photons(uint32_t frame) {
             break;
         }
 
+        auto const build_start = std::chrono::high_resolution_clock::now();
+
         uint32_t const new_begin = photon_map_.compile_iteration(num_photons, num_paths, threads_);
 
+        build_duration += tile_seconds_since(build_start);
+
 #ifdef PHOTON_GUIDING
         particle_importance_.prepare_sampling(*scene_, threads_);
         particle_importance_.set_training(false);
@@ -430,10 +684,15 @@ void Driver::bake_photons(uint32_t frame) {
         num_photons = settings_num_photons;
     }
 
-    photon_map_.compile_finalize();
+    auto const build_start = std::chrono::high_resolution_clock::now();
+
+    photon_map_.compile_finalize(threads_);
+
+    build_duration += tile_seconds_since(build_start);
 
     auto const duration = chrono::seconds_since(start);
     logging::info("Photon time " + string::to_string(duration) + " s");
+    logging::info("Photon map build time " + string::to_string(build_duration) + " s");
 }
 
 }  // namespace rendering
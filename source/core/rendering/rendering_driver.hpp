@@ -8,8 +8,11 @@
 #include "image/typed_image.hpp"
 #include "integrator/particle/particle_importance.hpp"
 #include "integrator/particle/photon/photon_map.hpp"
+#include "sensor/variance.hpp"
 #include "tile_queue.hpp"
 
+#include <string>
+
 namespace take {
 struct View;
 }  // namespace take
@@ -56,10 +59,34 @@ class Driver {
 
     void render(uint32_t frame, uint32_t iteration);
 
+    // Makes render(frame, iteration) render the samples of the iteration
+    // iteration * num_splits + split_index instead, so that separate processes can each
+    // render a disjoint part of the samples of a frame. Summing their sensors afterwards
+    // gives the same samples as a single process rendering all of the iterations.
+    void set_split(uint32_t split_index, uint32_t num_splits);
+
     void postprocess();
 
+    // Stores the accumulated state of the current progressive frame,
+    // so that rendering can be resumed from it later
+    bool write_checkpoint(std::string const& filename, uint32_t frame, uint32_t num_iterations,
+                          float seconds) const;
+
+    // Restores the state after start_frame(). Fails if the checkpoint doesn't exist,
+    // or belongs to another frame or sensor configuration.
+    bool read_checkpoint(std::string const& filename, uint32_t frame, uint32_t& num_iterations,
+                         float& seconds);
+
+    // Hands copies of the target and the AOVs to the exporters, which write them in the
+    // background while the next frame is rendered. At most one frame is exported at a time,
+    // so this first waits for the export of the previous frame to finish.
+    // The exporters must stay alive until wait_export().
     void export_frame(uint32_t frame, Exporters& exporters);
 
+    // Blocks until the last frame is exported, and logs how much of the total export time
+    // was hidden behind rendering
+    void wait_export();
+
   private:
     void render_frame_backward(uint32_t frame);
     void render_frame_backward(uint32_t frame, uint32_t iteration);
@@ -67,8 +94,22 @@ class Driver {
     void render_frame_forward(uint32_t frame);
     void render_frame_forward(uint32_t frame, uint32_t iteration);
 
+    // Renders a base pass for all tiles, followed by passes only for the tiles whose
+    // error estimate is still above the threshold
+    void render_frame_forward_adaptive();
+
+    // Renders the queued tiles of the current view with num_samples each,
+    // and records the time and the error estimate of every tile
+    void render_tiles(uint32_t iteration, uint32_t num_samples, bool progress);
+
     void bake_photons(uint32_t frame);
 
+    void log_tile_statistics(float duration) const;
+
+    void log_photon_statistics(float duration) const;
+
+    void finish_export();
+
     Threads& threads_;
 
     Scene* scene_;
@@ -81,12 +122,27 @@ class Driver {
     uint32_t frame_view_;
     uint32_t frame_iteration_;
 
+    uint32_t split_index_;
+    uint32_t num_splits_;
+
     Tile_queue tiles_;
 
     Range_queue ranges_;
 
+    sensor::Variance variance_;
+
     image::Float4 target_;
 
+    // Target and AOVs of the frame that is currently exported
+    memory::Array<image::Float4> export_targets_;
+
+    bool exporting_;
+
+    // Written by the export program, only read after it has finished
+    float export_duration_;
+
+    float hidden_export_duration_;
+
     integrator::particle::photon::Map photon_map_;
 
     integrator::particle::Importance_cache particle_importance_;
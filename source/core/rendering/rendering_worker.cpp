@@ -11,6 +11,7 @@
 #include "rendering/integrator/volume/volume_integrator.hpp"
 #include "rendering/sensor/aov/value.hpp"
 #include "rendering/sensor/sensor.hpp"
+#include "rendering/sensor/variance.hpp"
 #include "sampler/camera_sample.hpp"
 #include "sampler/sampler.hpp"
 #include "scene/material/material.inl"
@@ -39,7 +40,8 @@ void Worker::init(uint32_t id, Scene const& scene, Camera const& camera,
                   Volume_pool const& volumes, sampler::Pool const& samplers, Photon_map* photon_map,
                   take::Photon_settings const& photon_settings,
                   Lighttracer_pool const* lighttracers, uint32_t num_particles_per_chunk,
-                  AOV_pool const& aovs, Particle_importance* particle_importance) {
+                  AOV_pool const& aovs, Particle_importance* particle_importance,
+                  sensor::Variance* variance) {
     scene::Worker::init(scene, camera);
 
     if (surfaces) {
@@ -68,10 +70,12 @@ void Worker::init(uint32_t id, Scene const& scene, Camera const& camera,
     }
 
     particle_importance_ = particle_importance;
+
+    variance_ = variance;
 }
 
-void Worker::render(uint32_t frame, uint32_t view, uint32_t iteration, int4_p tile,
-                    uint32_t num_samples) {
+float Worker::render(uint32_t frame, uint32_t view, uint32_t iteration, int4_p tile,
+                     uint32_t num_samples) {
     Camera const& camera = *camera_;
 
     int2 const offset = camera.view_offset(view);
@@ -98,6 +102,12 @@ void Worker::render(uint32_t frame, uint32_t view, uint32_t iteration, int4_p ti
 
     AOV* aov = aov_;
 
+    sensor::Variance* variance = variance_;
+
+    int4 const camera_crop = camera.crop();
+
+    float error = 0.f;
+
     for (int32_t y = tile[1], y_back = tile[3]; y <= y_back; ++y) {
         uint64_t const o1 = uint64_t((y + fr) * r[0]) + o0;
         for (int32_t x = tile[0], x_back = tile[2]; x <= x_back; ++x) {
@@ -109,22 +119,68 @@ void Worker::render(uint32_t frame, uint32_t view, uint32_t iteration, int4_p ti
 
             int2 const pixel(x, y);
 
-            for (uint32_t i = num_samples; i > 0; --i) {
-                if (aov) {
-                    aov->clear();
+            // Luminance moments of the samples of this pixel
+            float mean = 0.f;
+            float m2   = 0.f;
+
+            // The camera rays of one pixel are coherent enough to be intersected as packets
+            for (uint32_t s = 0; s < num_samples; s += scene::Packet_size) {
+                uint32_t const num = std::min(num_samples - s, scene::Packet_size);
+
+                sampler::Camera_sample samples[scene::Packet_size];
+
+                Ray rays[scene::Packet_size];
+
+                uint32_t valid = 0;
+
+                for (uint32_t i = 0; i < num; ++i) {
+                    samples[i] = sampler_->camera_sample(rng(), pixel);
+
+                    if (camera.generate_ray(samples[i], frame, view, *scene_, rays[i])) {
+                        valid |= 1u << i;
+                    }
                 }
 
-                auto const sample = sampler_->camera_sample(rng(), pixel);
+                Intersection isecs[scene::Packet_size];
+
+                uint32_t const hits = camera.interface_stack().empty()
+                                          ? intersect(rays, valid, Interpolation::All, isecs)
+                                          : 0;
+
+                for (uint32_t i = 0; i < num; ++i) {
+                    if (aov) {
+                        aov->clear();
+                    }
+
+                    float4 color(0.f);
+
+                    if (uint32_t const bit = 1u << i; 0 != (valid & bit)) {
+                        color = li(rays[i], isecs[i], 0 != (hits & bit), camera.interface_stack(),
+                                   aov);
+                    }
 
-                if (Ray ray; camera.generate_ray(sample, frame, view, *scene_, ray)) {
-                    float4 const color = li(ray, camera.interface_stack(), aov);
-                    sensor.add_sample(sample, color, aov, isolated_bounds, offset, crop);
-                } else {
-                    sensor.add_sample(sample, float4(0.f), aov, isolated_bounds, offset, crop);
+                    sensor.add_sample(samples[i], color, aov, isolated_bounds, offset, crop);
+
+                    if (variance) {
+                        float const l     = spectrum::luminance(color.xyz());
+                        float const delta = l - mean;
+
+                        mean += delta / float(s + i + 1);
+                        m2 += delta * (l - mean);
+                    }
                 }
             }
+
+            if (variance && x >= camera_crop[0] && x < camera_crop[2] && y >= camera_crop[1] &&
+                y < camera_crop[3]) {
+                variance->add(view, pixel, float(num_samples), mean, m2);
+
+                error += variance->error(view, pixel);
+            }
         }
     }
+
+    return error;
 }
 
 void Worker::particles(uint32_t frame, uint64_t offset, ulong2 const& range) {
@@ -160,21 +216,30 @@ uint32_t Worker::bake_photons(int32_t begin, int32_t end, uint32_t frame, uint32
     return 0;
 }
 
-float3 Worker::photon_li(Intersection const& isec, Material_sample const& sample) const {
+float3 Worker::photon_li(Intersection const& isec, Material_sample const& sample) {
     if (photon_map_) {
-        return photon_map_->li(isec, sample, *this);
+        ++photon_statistics_.num_lookups;
+
+        return photon_map_->li(isec, sample, *this, photon_statistics_.num_photons);
     }
 
     return float3(0.f);
 }
 
+Worker::Photon_statistics const& Worker::photon_statistics() const {
+    return photon_statistics_;
+}
+
+void Worker::clear_photon_statistics() {
+    photon_statistics_ = {0, 0};
+}
+
 Worker::Particle_importance& Worker::particle_importance() const {
     return *particle_importance_;
 }
 
-float4 Worker::li(Ray& ray, Interface_stack const& interface_stack, AOV* aov) {
-    Intersection isec;
-
+float4 Worker::li(Ray& ray, Intersection& isec, bool hit, Interface_stack const& interface_stack,
+                  AOV* aov) {
     if (!interface_stack.empty()) {
         reset_interface_stack(interface_stack);
 
@@ -195,7 +260,7 @@ float4 Worker::li(Ray& ray, Interface_stack const& interface_stack, AOV* aov) {
         return float4(vtr * li.xyz() + vli, li[3]);
     }
 
-    if (intersect_and_resolve_mask(ray, isec, Filter::Undefined)) {
+    if (hit && resolve_mask(ray, isec, Filter::Undefined)) {
         float4 const li = surface_integrator_->li(ray, isec, *this, interface_stack, aov);
 
         SOFT_ASSERT(all_finite_and_positive(li));
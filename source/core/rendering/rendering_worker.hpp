@@ -26,10 +26,15 @@ namespace rendering {
 
 enum class Event;
 
-namespace sensor::aov {
+namespace sensor {
+
+class Variance;
+
+namespace aov {
 class Value;
 class Value_pool;
-}  // namespace sensor::aov
+}  // namespace aov
+}  // namespace sensor
 
 namespace integrator {
 
@@ -81,10 +86,11 @@ class alignas(64) Worker : public scene::Worker {
               sampler::Pool const& samplers, Photon_map* photon_map,
               take::Photon_settings const& photon_settings_, Lighttracer_pool const* lighttracers,
               uint32_t num_particles_per_chunk, AOV_pool const& aovs,
-              Particle_importance* particle_importance);
+              Particle_importance* particle_importance, sensor::Variance* variance);
 
-    void render(uint32_t frame, uint32_t view, uint32_t iteration, int4_p tile,
-                uint32_t num_samples);
+    // Returns the sum of the errors of the pixels inside the crop, if the variance is tracked
+    float render(uint32_t frame, uint32_t view, uint32_t iteration, int4_p tile,
+                 uint32_t num_samples);
 
     void particles(uint32_t frame, uint64_t offset, ulong2 const& range);
 
@@ -94,12 +100,24 @@ class alignas(64) Worker : public scene::Worker {
 
     uint32_t bake_photons(int32_t begin, int32_t end, uint32_t frame, uint32_t iteration);
 
-    float3 photon_li(Intersection const& isec, Material_sample const& sample) const;
+    float3 photon_li(Intersection const& isec, Material_sample const& sample);
+
+    struct Photon_statistics {
+        uint64_t num_lookups;
+        uint64_t num_photons;
+    };
+
+    // Of the photon_li() calls since the last clear_photon_statistics()
+    Photon_statistics const& photon_statistics() const;
+
+    void clear_photon_statistics();
 
     Particle_importance& particle_importance() const;
 
   private:
-    float4 li(Ray& ray, Interface_stack const& interface_stack, AOV* aov);
+    // The intersection of ray is already known, unless it starts inside a medium
+    float4 li(Ray& ray, Intersection& isec, bool hit, Interface_stack const& interface_stack,
+              AOV* aov);
 
     bool transmittance(Ray const& ray, Filter filter, float3& transmittance);
 
@@ -118,9 +136,13 @@ class alignas(64) Worker : public scene::Worker {
 
     Photon_map* photon_map_ = nullptr;
 
+    Photon_statistics photon_statistics_ = {0, 0};
+
     integrator::particle::Lighttracer* lighttracer_ = nullptr;
 
     Particle_importance* particle_importance_ = nullptr;
+
+    sensor::Variance* variance_ = nullptr;
 };
 
 }  // namespace rendering
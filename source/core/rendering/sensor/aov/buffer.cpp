@@ -2,6 +2,9 @@
 #include "base/atomic/atomic.hpp"
 #include "base/math/vector4.inl"
 
+#include <istream>
+#include <ostream>
+
 namespace rendering::sensor::aov {
 
 Buffer::Buffer() : buffers_len_(0), buffer_len_(0), buffers_(nullptr) {}
@@ -81,4 +84,16 @@ float4 Buffer::value(int32_t id, uint32_t slot) const {
     return buffers_[slot][id];
 }
 
+void Buffer::write(std::ostream& stream) const {
+    for (uint32_t i = 0, len = buffers_len_; i < len; ++i) {
+        stream.write(reinterpret_cast<char const*>(buffers_[i]), buffer_len_ * sizeof(float4));
+    }
+}
+
+void Buffer::read(std::istream& stream) {
+    for (uint32_t i = 0, len = buffers_len_; i < len; ++i) {
+        stream.read(reinterpret_cast<char*>(buffers_[i]), buffer_len_ * sizeof(float4));
+    }
+}
+
 }  // namespace rendering::sensor::aov
@@ -4,6 +4,8 @@
 #include "base/math/vector4.hpp"
 #include "value.hpp"
 
+#include <iosfwd>
+
 namespace rendering::sensor::aov {
 
 class Buffer {
@@ -24,6 +26,10 @@ class Buffer {
 
     float4 value(int32_t id, uint32_t slot) const;
 
+    void write(std::ostream& stream) const;
+
+    void read(std::istream& stream);
+
   private:
     uint32_t buffers_len_;
     uint32_t buffer_len_;
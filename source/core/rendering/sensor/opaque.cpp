@@ -1,8 +1,12 @@
 #include "opaque.hpp"
 #include "base/atomic/atomic.hpp"
 #include "base/math/vector4.inl"
+#include "base/memory/buffer.hpp"
 #include "image/typed_image.hpp"
 
+#include <istream>
+#include <ostream>
+
 namespace rendering::sensor {
 
 Opaque::Opaque(int32_t filter_radius)
@@ -120,4 +124,28 @@ void Opaque::on_clear(float weight) {
     }
 }
 
+void Opaque::on_write(std::ostream& stream) const {
+    uint32_t const len = uint32_t(dimensions_[0] * dimensions_[1] * num_layers_);
+
+    stream.write(reinterpret_cast<char const*>(layers_), len * sizeof(float4));
+}
+
+void Opaque::on_read(std::istream& stream) {
+    uint32_t const len = uint32_t(dimensions_[0] * dimensions_[1] * num_layers_);
+
+    stream.read(reinterpret_cast<char*>(layers_), len * sizeof(float4));
+}
+
+void Opaque::on_merge(std::istream& stream) {
+    uint32_t const len = uint32_t(dimensions_[0] * dimensions_[1] * num_layers_);
+
+    memory::Buffer<float4> layers(len);
+
+    stream.read(reinterpret_cast<char*>(layers.data()), len * sizeof(float4));
+
+    for (uint32_t i = 0; i < len; ++i) {
+        layers_[i] += layers[i];
+    }
+}
+
 }  // namespace rendering::sensor
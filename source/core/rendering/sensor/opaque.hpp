@@ -35,6 +35,12 @@ class Opaque : public Sensor {
 
     void on_clear(float weight) final;
 
+    void on_write(std::ostream& stream) const final;
+
+    void on_read(std::istream& stream) final;
+
+    void on_merge(std::istream& stream) final;
+
     // weight_sum is saved in pixel.w
     float4* layers_;
     float4* pixels_;
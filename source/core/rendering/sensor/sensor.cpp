@@ -3,6 +3,9 @@
 #include "base/thread/thread_pool.hpp"
 #include "image/typed_image.hpp"
 
+#include <istream>
+#include <ostream>
+
 namespace rendering::sensor {
 
 Sensor::Sensor(int32_t filter_radius, bool transparency)
@@ -65,6 +68,69 @@ void Sensor::clear(float weight, aov::Value_pool const& aovs) {
     aov_.clear(aovs);
 }
 
+void Sensor::write(std::ostream& stream) const {
+    int32_t const header[4] = {dimensions_[0], dimensions_[1], int32_t(num_layers_),
+                               int32_t(transparency_)};
+
+    stream.write(reinterpret_cast<char const*>(header), sizeof(header));
+
+    on_write(stream);
+
+    aov_.write(stream);
+}
+
+bool Sensor::read(std::istream& stream) {
+    if (!read_header(stream)) {
+        return false;
+    }
+
+    on_read(stream);
+
+    aov_.read(stream);
+
+    return bool(stream);
+}
+
+bool Sensor::merge(std::istream& stream) {
+    if (!read_header(stream)) {
+        return false;
+    }
+
+    on_merge(stream);
+
+    return bool(stream);
+}
+
+bool Sensor::read_layout(std::istream& stream, int2& dimensions, int32_t& num_layers,
+                         bool& transparency) {
+    auto const position = stream.tellg();
+
+    int32_t header[4];
+
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    if (!stream) {
+        return false;
+    }
+
+    stream.seekg(position);
+
+    dimensions   = int2(header[0], header[1]);
+    num_layers   = header[2];
+    transparency = 0 != header[3];
+
+    return true;
+}
+
+bool Sensor::read_header(std::istream& stream) const {
+    int32_t header[4];
+
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    return stream && header[0] == dimensions_[0] && header[1] == dimensions_[1] &&
+           header[2] == int32_t(num_layers_) && header[3] == int32_t(transparency_);
+}
+
 void Sensor::add_AOV(int2 pixel, uint32_t slot, float4_p value, float weight) {
     auto const d = dimensions();
 
@@ -5,6 +5,8 @@
 #include "base/math/vector2.hpp"
 #include "image/typed_image_fwd.hpp"
 
+#include <iosfwd>
+
 namespace thread {
 class Pool;
 }
@@ -48,6 +50,20 @@ class Sensor {
 
     void clear(float weight, aov::Value_pool const& aovs);
 
+    // The raw accumulation buffers, e.g. for resuming an interrupted render later
+    void write(std::ostream& stream) const;
+
+    // Fails if the stored dimensions and layers don't match the current ones
+    bool read(std::istream& stream);
+
+    // Adds the stored buffers to the current ones, without the AOVs.
+    // Fails under the same conditions as read().
+    bool merge(std::istream& stream);
+
+    // Reads the beginning of what write() stored, and leaves the stream where it was
+    static bool read_layout(std::istream& stream, int2& dimensions, int32_t& num_layers,
+                            bool& transparency);
+
     virtual void set_weights(float weight) = 0;
 
     virtual void fix_zero_weights() = 0;
@@ -84,6 +100,14 @@ class Sensor {
 
     virtual void on_clear(float weight) = 0;
 
+    virtual void on_write(std::ostream& stream) const = 0;
+
+    virtual void on_read(std::istream& stream) = 0;
+
+    virtual void on_merge(std::istream& stream) = 0;
+
+    bool read_header(std::istream& stream) const;
+
     int2 dimensions_;
 
     int32_t const filter_radius_;
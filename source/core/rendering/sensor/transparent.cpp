@@ -1,8 +1,12 @@
 #include "transparent.hpp"
 #include "base/atomic/atomic.hpp"
 #include "base/math/vector4.inl"
+#include "base/memory/buffer.hpp"
 #include "image/typed_image.hpp"
 
+#include <istream>
+#include <ostream>
+
 namespace rendering::sensor {
 
 Transparent::Transparent(int32_t filter_radius)
@@ -133,4 +137,33 @@ void Transparent::on_clear(float weight) {
     }
 }
 
+void Transparent::on_write(std::ostream& stream) const {
+    uint32_t const len = uint32_t(dimensions_[0] * dimensions_[1] * num_layers_);
+
+    stream.write(reinterpret_cast<char const*>(layer_weights_), len * sizeof(float));
+    stream.write(reinterpret_cast<char const*>(layers_), len * sizeof(float4));
+}
+
+void Transparent::on_read(std::istream& stream) {
+    uint32_t const len = uint32_t(dimensions_[0] * dimensions_[1] * num_layers_);
+
+    stream.read(reinterpret_cast<char*>(layer_weights_), len * sizeof(float));
+    stream.read(reinterpret_cast<char*>(layers_), len * sizeof(float4));
+}
+
+void Transparent::on_merge(std::istream& stream) {
+    uint32_t const len = uint32_t(dimensions_[0] * dimensions_[1] * num_layers_);
+
+    memory::Buffer<float>  weights(len);
+    memory::Buffer<float4> layers(len);
+
+    stream.read(reinterpret_cast<char*>(weights.data()), len * sizeof(float));
+    stream.read(reinterpret_cast<char*>(layers.data()), len * sizeof(float4));
+
+    for (uint32_t i = 0; i < len; ++i) {
+        layer_weights_[i] += weights[i];
+        layers_[i] += layers[i];
+    }
+}
+
 }  // namespace rendering::sensor
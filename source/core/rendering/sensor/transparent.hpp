@@ -36,6 +36,12 @@ class Transparent : public Sensor {
 
     void on_clear(float weight) final;
 
+    void on_write(std::ostream& stream) const final;
+
+    void on_read(std::istream& stream) final;
+
+    void on_merge(std::istream& stream) final;
+
     float* layer_weights_;
     float* pixel_weights_;
 
@@ -0,0 +1,63 @@
+#include "variance.hpp"
+#include "base/math/vector3.inl"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rendering::sensor {
+
+// Keeps very dark pixels from dominating with their large relative errors
+static float constexpr Min_mean = 0.01f;
+
+Variance::Variance() : dimensions_(0), num_views_(0), moments_(nullptr) {}
+
+Variance::~Variance() {
+    delete[] moments_;
+}
+
+void Variance::resize(int2 dimensions, uint32_t num_views) {
+    if (dimensions == dimensions_ && num_views == num_views_) {
+        return;
+    }
+
+    delete[] moments_;
+
+    dimensions_ = dimensions;
+    num_views_  = num_views;
+
+    moments_ = new float3[uint32_t(dimensions[0] * dimensions[1]) * num_views];
+}
+
+void Variance::clear() {
+    std::fill_n(moments_, uint32_t(dimensions_[0] * dimensions_[1]) * num_views_, float3(0.f));
+}
+
+void Variance::add(uint32_t view, int2 pixel, float num_samples, float mean, float m2) {
+    int2 const d = dimensions_;
+
+    float3& m = moments_[uint32_t(d[0] * d[1]) * view + uint32_t(d[0] * pixel[1] + pixel[0])];
+
+    // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+    float const n     = m[0] + num_samples;
+    float const delta = mean - m[1];
+
+    m[1] += delta * (num_samples / n);
+    m[2] += m2 + delta * delta * (m[0] * num_samples / n);
+    m[0] = n;
+}
+
+float Variance::error(uint32_t view, int2 pixel) const {
+    int2 const d = dimensions_;
+
+    float3 const m = moments_[uint32_t(d[0] * d[1]) * view + uint32_t(d[0] * pixel[1] + pixel[0])];
+
+    if (m[0] < 2.f) {
+        return 0.f;
+    }
+
+    float const standard_error = std::sqrt(m[2] / (m[0] * (m[0] - 1.f)));
+
+    return standard_error / std::max(m[1], Min_mean);
+}
+
+}  // namespace rendering::sensor
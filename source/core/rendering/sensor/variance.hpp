@@ -0,0 +1,39 @@
+#ifndef SU_CORE_RENDERING_SENSOR_VARIANCE_HPP
+#define SU_CORE_RENDERING_SENSOR_VARIANCE_HPP
+
+#include "base/math/vector2.hpp"
+#include "base/math/vector3.hpp"
+
+namespace rendering::sensor {
+
+// Running mean and variance of the luminance of the samples of every pixel, before filtering.
+// Used to estimate the remaining error of the pixels for adaptive sampling.
+// Every pixel is only ever updated by the worker that renders its tile.
+class Variance {
+  public:
+    Variance();
+
+    ~Variance();
+
+    void resize(int2 dimensions, uint32_t num_views);
+
+    void clear();
+
+    // Merges the moments of a batch of samples into those of the pixel
+    void add(uint32_t view, int2 pixel, float num_samples, float mean, float m2);
+
+    // Standard error of the pixel mean, relative to the mean
+    float error(uint32_t view, int2 pixel) const;
+
+  private:
+    int2 dimensions_;
+
+    uint32_t num_views_;
+
+    // Number of samples, mean, sum of squared differences from the mean
+    float3* moments_;
+};
+
+}  // namespace rendering::sensor
+
+#endif
@@ -1,55 +1,148 @@
 #include "tile_queue.hpp"
 #include "base/math/vector4.inl"
+#include "base/memory/array.inl"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace rendering {
 
+// Number of tiles per worker at the end of the queue that are split into quarters, per level
+static uint32_t constexpr Tail_tiles_per_worker = 2;
+
+static uint32_t constexpr Max_subdivision_levels = 2;
+
+static int32_t constexpr Min_tile_dimensions = 8;
+
+// https://en.wikipedia.org/wiki/Hilbert_curve
+static uint64_t hilbert_index(uint32_t n, uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t const rx = (x & s) > 0 ? 1 : 0;
+        uint32_t const ry = (y & s) > 0 ? 1 : 0;
+
+        d += uint64_t(s) * uint64_t(s) * uint64_t((3 * rx) ^ ry);
+
+        if (0 == ry) {
+            if (1 == rx) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+
+            std::swap(x, y);
+        }
+    }
+
+    return d;
+}
+
 Tile_queue::~Tile_queue() = default;
 
-void Tile_queue::init(int4_p crop, int32_t tile_dimensions, int32_t filter_radius) {
+void Tile_queue::init(int4_p crop, int32_t tile_dimensions, int32_t filter_radius,
+                      uint32_t num_workers, bool subdivide, bool cost_order) {
     crop_            = crop;
     tile_dimensions_ = tile_dimensions;
     filter_radius_   = filter_radius;
+    num_workers_     = num_workers;
+    subdivide_       = subdivide;
+    cost_order_      = cost_order;
+    has_costs_       = false;
 
     int2 const dimensions = crop.zw() - crop.xy();
 
-    int32_t const tiles_per_row = int32_t(std::ceil(float(dimensions[0]) / float(tile_dimensions)));
+    num_tiles_ = int2(int32_t(std::ceil(float(dimensions[0]) / float(tile_dimensions))),
+                      int32_t(std::ceil(float(dimensions[1]) / float(tile_dimensions))));
+
+    uint32_t const num_tiles = uint32_t(num_tiles_[0] * num_tiles_[1]);
+
+    uint32_t n = 1;
+    while (n < uint32_t(std::max(num_tiles_[0], num_tiles_[1]))) {
+        n *= 2;
+    }
+
+    order_.resize(num_tiles);
+
+    std::vector<uint64_t> keys(num_tiles);
+
+    for (uint32_t i = 0; i < num_tiles; ++i) {
+        uint32_t const y = i / uint32_t(num_tiles_[0]);
+        uint32_t const x = i - y * uint32_t(num_tiles_[0]);
+
+        keys[i] = hilbert_index(n, x, y);
+
+        order_[i] = i;
+    }
 
-    tiles_per_row_ = tiles_per_row;
+    std::sort(order_.begin(), order_.end(),
+              [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
 
-    num_tiles_ = tiles_per_row * int32_t(std::ceil(float(dimensions[1]) / float(tile_dimensions)));
+    costs_.resize(num_tiles);
+
+    for (auto& c : costs_) {
+        c = 0.f;
+    }
+
+    active_.resize(num_tiles);
+
+    for (auto& a : active_) {
+        a = 1;
+    }
+
+    build_items();
 
     current_consume_ = 0;
 }
 
 uint32_t Tile_queue::size() const {
-    return uint32_t(num_tiles_);
+    return uint32_t(items_.size());
 }
 
 void Tile_queue::restart() {
+    float total = 0.f;
+    for (float const d : durations_) {
+        total += d;
+    }
+
+    if (total > 0.f) {
+        for (auto& c : costs_) {
+            c = 0.f;
+        }
+
+        for (uint32_t i = 0, len = uint32_t(items_.size()); i < len; ++i) {
+            costs_[items_[i].tile] += durations_[i];
+        }
+
+        has_costs_ = true;
+
+        if (cost_order_) {
+            build_items();
+        }
+    }
+
+    for (auto& d : durations_) {
+        d = 0.f;
+    }
+
     current_consume_ = 0;
 }
 
-bool Tile_queue::pop(int4& tile) {
-    int32_t const current = current_consume_.fetch_add(1, std::memory_order_relaxed);
+bool Tile_queue::pop(int4& tile, uint32_t& id) {
+    uint32_t const current = current_consume_.fetch_add(1, std::memory_order_relaxed);
 
-    if (current >= num_tiles_) {
+    if (current >= uint32_t(items_.size())) {
         return false;
     }
 
     int4 const crop = crop_;
 
-    int32_t const tile_dimensions = tile_dimensions_;
-
     int32_t const filter_radius = filter_radius_;
 
-    int2 start;
-    start[1] = current / tiles_per_row_;
-    start[0] = current - start[1] * tiles_per_row_;
+    int4 const rect = items_[current].rect;
 
-    start *= tile_dimensions;
-    start += crop.xy();
-
-    int2 end = min(start + tile_dimensions, crop.zw());
+    int2 start = rect.xy();
+    int2 end   = rect.zw();
 
     if (crop[1] == start[1]) {
         start[1] -= filter_radius;
@@ -69,9 +162,172 @@ bool Tile_queue::pop(int4& tile) {
 
     tile = int4(start, end - 1);
 
+    id = current;
+
     return true;
 }
 
+void Tile_queue::record(uint32_t id, float seconds) {
+    durations_[id] = seconds;
+}
+
+void Tile_queue::record_error(uint32_t id, float error) {
+    errors_[id] = error;
+}
+
+uint32_t Tile_queue::refine(float threshold) {
+    uint32_t const num_tiles = order_.size();
+
+    memory::Array<float> tile_errors(num_tiles, 0.f);
+
+    for (uint32_t i = 0, len = uint32_t(items_.size()); i < len; ++i) {
+        tile_errors[items_[i].tile] += errors_[i];
+    }
+
+    uint32_t num_active = 0;
+
+    for (uint32_t t = 0; t < num_tiles; ++t) {
+        if (!active_[t]) {
+            continue;
+        }
+
+        int4 const rect = tile_rect(t);
+        int2 const d    = rect.zw() - rect.xy();
+
+        bool const active = tile_errors[t] / float(d[0] * d[1]) > threshold;
+
+        active_[t] = active ? 1 : 0;
+
+        num_active += active ? 1 : 0;
+    }
+
+    build_items();
+
+    current_consume_ = 0;
+
+    return num_active;
+}
+
+void Tile_queue::activate_all() {
+    bool all = true;
+
+    for (auto& a : active_) {
+        all &= 1 == a;
+        a = 1;
+    }
+
+    if (!all) {
+        build_items();
+    }
+}
+
+uint64_t Tile_queue::num_pixels() const {
+    uint64_t num = 0;
+
+    for (auto const& item : items_) {
+        int2 const d = item.rect.zw() - item.rect.xy();
+
+        num += uint64_t(d[0] * d[1]);
+    }
+
+    return num;
+}
+
+Tile_queue::Statistics Tile_queue::statistics() const {
+    Statistics statistics{uint32_t(items_.size()), std::numeric_limits<float>::max(), 0.f, 0.f};
+
+    for (float const d : durations_) {
+        statistics.min = std::min(statistics.min, d);
+        statistics.max = std::max(statistics.max, d);
+        statistics.total += d;
+    }
+
+    return statistics;
+}
+
+int4 Tile_queue::tile_rect(uint32_t tile) const {
+    int4 const crop = crop_;
+
+    int32_t const tile_dimensions = tile_dimensions_;
+
+    int32_t const y = int32_t(tile) / num_tiles_[0];
+    int32_t const x = int32_t(tile) - y * num_tiles_[0];
+
+    int2 const start = int2(x * tile_dimensions, y * tile_dimensions) + crop.xy();
+    int2 const end   = min(start + tile_dimensions, crop.zw());
+
+    return int4(start, end);
+}
+
+void Tile_queue::build_items() {
+    uint32_t const num_tiles = order_.size();
+
+    memory::Array<uint32_t> tiles(num_tiles);
+
+    for (uint32_t i = 0; i < num_tiles; ++i) {
+        tiles[i] = order_[i];
+    }
+
+    if (cost_order_ && has_costs_) {
+        std::stable_sort(tiles.begin(), tiles.end(),
+                         [this](uint32_t a, uint32_t b) { return costs_[a] > costs_[b]; });
+    }
+
+    items_.clear();
+    items_.reserve(num_tiles);
+
+    for (uint32_t const t : tiles) {
+        if (active_[t]) {
+            items_.push_back({tile_rect(t), t});
+        }
+    }
+
+    // Split the tail of the queue, repeatedly, so that the last pieces of work are small
+    if (subdivide_) {
+        uint32_t const num_tail = num_workers_ * Tail_tiles_per_worker;
+
+        for (uint32_t l = 0; l < Max_subdivision_levels; ++l) {
+            uint32_t const len  = uint32_t(items_.size());
+            uint32_t const head = len - std::min(num_tail, len);
+
+            std::vector<Item> tail(items_.begin() + head, items_.end());
+
+            items_.resize(head);
+
+            for (auto const& item : tail) {
+                int2 const start = item.rect.xy();
+                int2 const end   = item.rect.zw();
+                int2 const d     = end - start;
+
+                if (d[0] < 2 * Min_tile_dimensions || d[1] < 2 * Min_tile_dimensions) {
+                    items_.push_back(item);
+                    continue;
+                }
+
+                int2 const middle = start + d / 2;
+
+                // Quadrants in U shape, to stay close to the curve
+                items_.push_back({int4(start, middle), item.tile});
+                items_.push_back({int4(start[0], middle[1], middle[0], end[1]), item.tile});
+                items_.push_back({int4(middle, end), item.tile});
+                items_.push_back({int4(middle[0], start[1], end[0], middle[1]), item.tile});
+            }
+        }
+    }
+
+    durations_.resize(uint32_t(items_.size()));
+
+    for (auto& d : durations_) {
+        d = 0.f;
+    }
+
+    errors_.resize(uint32_t(items_.size()));
+
+    for (auto& e : errors_) {
+        e = 0.f;
+    }
+}
+
 Range_queue::~Range_queue() = default;
 
 void Range_queue::init(uint64_t total0, uint64_t total1, uint32_t range_size) {
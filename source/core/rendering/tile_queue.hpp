@@ -3,35 +3,96 @@
 
 #include "base/math/vector2.hpp"
 #include "base/math/vector4.hpp"
+#include "base/memory/array.hpp"
 
 #include <atomic>
+#include <vector>
 
 namespace rendering {
 
+// Hands out tiles along a Hilbert curve over the tile grid, so that consecutive tiles touch
+// similar parts of the scene. The last tiles of a pass are split into smaller pieces, so that
+// the threads run out of work at roughly the same time. Optionally the tiles are ordered by the
+// cost measured during the previous pass instead, most expensive first.
+// For adaptive sampling, tiles that are converged can be left out of the following passes.
 class Tile_queue {
   public:
+    struct Statistics {
+        uint32_t num_items;
+
+        float min;
+        float max;
+        float total;
+    };
+
     ~Tile_queue();
 
-    void init(int4_p crop, int32_t tile_dimensions, int32_t filter_radius);
+    void init(int4_p crop, int32_t tile_dimensions, int32_t filter_radius, uint32_t num_workers,
+              bool subdivide, bool cost_order);
 
     uint32_t size() const;
 
     void restart();
 
-    bool pop(int4& tile);
+    bool pop(int4& tile, uint32_t& id);
+
+    // Duration of the tile with the given id, as returned by pop()
+    void record(uint32_t id, float seconds);
+
+    // Sum of the errors of the pixels of the tile with the given id, for adaptive sampling
+    void record_error(uint32_t id, float error);
+
+    // Keeps only the tiles whose average pixel error, as recorded during the last pass,
+    // is above the threshold. Returns the number of remaining tiles.
+    uint32_t refine(float threshold);
+
+    void activate_all();
+
+    // Pixels covered by the current tiles, without the filter borders
+    uint64_t num_pixels() const;
+
+    Statistics statistics() const;
 
   private:
+    struct Item {
+        int4 rect;
+
+        uint32_t tile;
+    };
+
+    int4 tile_rect(uint32_t tile) const;
+
+    void build_items();
+
     int4 crop_;
 
     int32_t tile_dimensions_;
 
     int32_t filter_radius_;
 
-    int32_t tiles_per_row_;
+    int2 num_tiles_;
+
+    uint32_t num_workers_;
+
+    bool subdivide_;
+
+    bool cost_order_;
+
+    bool has_costs_;
+
+    memory::Array<uint32_t> order_;
 
-    int32_t num_tiles_;
+    memory::Array<uint8_t> active_;
 
-    std::atomic<int32_t> current_consume_;
+    std::vector<Item> items_;
+
+    memory::Array<float> durations_;
+
+    memory::Array<float> errors_;
+
+    memory::Array<float> costs_;
+
+    std::atomic<uint32_t> current_consume_;
 };
 
 class Range_queue {
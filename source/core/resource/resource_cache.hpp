@@ -1,8 +1,11 @@
 #ifndef SU_CORE_RESOURCE_CACHE_HPP
 #define SU_CORE_RESOURCE_CACHE_HPP
 
+#include <condition_variable>
 #include <filesystem>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,6 +52,15 @@ class Cache {
     using Key      = std::pair<std::string, Variants>;
 
     std::map<Key, Entry> entries_;
+
+    // Protects entries_ and the resources of the derived cache, so that different threads can
+    // load at the same time. Providers are called without holding it.
+    mutable std::mutex mutex_;
+
+    // Keys that are currently being loaded, concurrent requests for them wait for the result
+    std::set<Key> loading_;
+
+    std::condition_variable loaded_signal_;
 };
 
 template <typename T>
@@ -70,24 +70,40 @@ Resource_ptr<T> Typed_cache<T>::load(std::string const& filename, Variants const
 
     uint32_t id = resource::Null;
 
-    if (auto cached = entries_.find(key); entries_.end() != cached) {
-        auto& entry = cached->second;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
 
-        id = entry.id;
+        loaded_signal_.wait(lock, [this, &key]() { return loading_.end() == loading_.find(key); });
 
-        if (check_up_to_date(entry)) {
-            return {resources_[id], id};
+        if (auto cached = entries_.find(key); entries_.end() != cached) {
+            auto& entry = cached->second;
+
+            id = entry.id;
+
+            if (check_up_to_date(entry)) {
+                return {resources_[id], id};
+            }
         }
+
+        loading_.insert(key);
     }
 
     auto resource = provider_.load(filename, options, resources, resolved_name);
+
+    std::error_code ec;
+    auto const      last_write = resource ? std::filesystem::last_write_time(resolved_name, ec)
+                                          : std::filesystem::file_time_type();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    loading_.erase(key);
+
+    loaded_signal_.notify_all();
+
     if (!resource) {
         return Resource_ptr<T>::Null();
     }
 
-    std::error_code ec;
-    auto const      last_write = std::filesystem::last_write_time(resolved_name, ec);
-
     if (id != resource::Null) {
         delete resources_[id];
 
@@ -118,10 +134,16 @@ Resource_ptr<T> Typed_cache<T>::load(std::string const& name, void const* const
         return Resource_ptr<T>::Null();
     }
 
+    std::error_code ec;
+    auto const      last_write = name.empty() ? std::filesystem::file_time_type()
+                                              : std::filesystem::last_write_time(source_name, ec);
+
     uint32_t id = resource::Null;
 
     auto const key = std::make_pair(name, options);
 
+    std::lock_guard<std::mutex> lock(mutex_);
+
     if (auto cached = entries_.find(key); entries_.end() != cached) {
         auto& entry = cached->second;
 
@@ -139,9 +161,6 @@ Resource_ptr<T> Typed_cache<T>::load(std::string const& name, void const* const
     }
 
     if (!name.empty()) {
-        std::error_code ec;
-        auto const      last_write = std::filesystem::last_write_time(source_name, ec);
-
         entries_.insert_or_assign(key, Entry{id, generation_, source_name, last_write});
     }
 
@@ -152,6 +171,8 @@ template <typename T>
 Resource_ptr<T> Typed_cache<T>::get(std::string const& name, Variants const& options) {
     auto const key = std::make_pair(name, options);
 
+    std::lock_guard<std::mutex> lock(mutex_);
+
     if (auto cached = entries_.find(key); entries_.end() != cached) {
         auto& entry = cached->second;
 
@@ -169,6 +190,8 @@ Resource_ptr<T> Typed_cache<T>::get(std::string const& name, Variants const& opt
 
 template <typename T>
 T* Typed_cache<T>::get(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
     if (id >= uint32_t(resources_.size())) {
         return nullptr;
     }
@@ -178,6 +201,8 @@ T* Typed_cache<T>::get(uint32_t id) const {
 
 template <typename T>
 uint32_t Typed_cache<T>::store(T* resource) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
     resources_.push_back(resource);
 
     uint32_t const id = uint32_t(resources_.size()) - 1;
@@ -189,6 +214,8 @@ template <typename T>
 uint32_t Typed_cache<T>::store(std::string const& name, Variants const& options, T* resource) {
     auto const key = std::make_pair(name, options);
 
+    std::lock_guard<std::mutex> lock(mutex_);
+
     resources_.push_back(resource);
 
     uint32_t const id = uint32_t(resources_.size()) - 1;
@@ -85,7 +85,7 @@ Resource_ptr<T> Manager::get(std::string const& filename, Variants const& option
     }
 
     if (Typed_cache<T>* cache = typed_cache<T>(); cache) {
-        cache->get(filename, options);
+        return cache->get(filename, options);
     }
 
     return Resource_ptr<T>::Null();
@@ -27,12 +27,14 @@ void Builder::build(Tree& tree, std::vector<uint32_t> const& indices, std::vecto
         tree.alllocate_indices(0);
         tree.allocate_nodes(0);
 
+        tree.build_sah_ = 0.f;
+
         return;
     }
     {
         References references(num_primitives);
 
-        memory::Array<Simd_AABB> taabbs(threads.num_threads() /*, Empty_AABB*/);
+        memory::Array<Simd_AABB> taabbs(threads.num_threads(), Simd_AABB(Empty_AABB));
 
         threads.run_range(
             [&indices, &aabbs, &references, &taabbs](uint32_t id, int32_t begin,
@@ -49,8 +51,7 @@ void Builder::build(Tree& tree, std::vector<uint32_t> const& indices, std::vecto
                     aabb.merge_assign(b);
                 }
 
-                taabbs[id] = aabb;
-                // taabbs[id].merge_assign(aabb);
+                taabbs[id].merge_assign(aabb);
             },
             0, int32_t(indices.size()));
 
@@ -68,6 +69,96 @@ void Builder::build(Tree& tree, std::vector<uint32_t> const& indices, std::vecto
     uint32_t current_prop = 0;
     new_node();
     serialize(0, 0, tree, current_prop);
+
+    tree.build_sah_ = sah(tree);
+}
+
+bool Builder::refit(Tree& tree, std::vector<uint32_t> const& indices,
+                    std::vector<AABB> const& aabbs) const {
+    if (0 == tree.num_nodes_) {
+        return false;
+    }
+
+    // Spatial splits can reference the same prop from several leaves,
+    // so compare the sets instead of the sizes
+    uint32_t const num_aabbs = uint32_t(aabbs.size());
+
+    memory::Array<uint8_t> used(num_aabbs, 0);
+
+    for (auto const i : indices) {
+        used[i] = 1;
+    }
+
+    uint32_t num_used = 0;
+
+    for (uint32_t i = 0, len = tree.num_nodes_; i < len; ++i) {
+        Node const& n = tree.nodes_[i];
+
+        for (uint32_t p = n.indices_start(), end = n.indices_end(); p < end; ++p) {
+            uint32_t const prop = tree.indices_[p];
+
+            if (prop >= num_aabbs || 0 == used[prop]) {
+                return false;
+            }
+
+            if (1 == used[prop]) {
+                used[prop] = 2;
+                ++num_used;
+            }
+        }
+    }
+
+    if (num_used != uint32_t(indices.size())) {
+        return false;
+    }
+
+    // Children are always serialized after their parent,
+    // so a single backwards pass visits them in the correct order
+    Node* nodes = tree.nodes_;
+
+    for (uint32_t i = tree.num_nodes_; i > 0; --i) {
+        Node& n = nodes[i - 1];
+
+        if (0 == n.num_indices()) {
+            uint32_t const c = n.children();
+
+            n.set_aabb(nodes[c].aabb().merge(nodes[c + 1].aabb()));
+        } else {
+            AABB box = Empty_AABB;
+
+            for (uint32_t p = n.indices_start(), len = n.indices_end(); p < len; ++p) {
+                box.merge_assign(aabbs[tree.indices_[p]]);
+            }
+
+            n.set_aabb(box);
+        }
+    }
+
+    return true;
+}
+
+float Builder::sah(Tree const& tree) {
+    if (0 == tree.num_nodes_) {
+        return 0.f;
+    }
+
+    float const root_area = tree.nodes_[0].aabb().surface_area();
+
+    if (root_area <= 0.f) {
+        return 0.f;
+    }
+
+    float cost = 0.f;
+
+    for (uint32_t i = 0, len = tree.num_nodes_; i < len; ++i) {
+        Node const& n = tree.nodes_[i];
+
+        uint32_t const num_indices = n.num_indices();
+
+        cost += n.aabb().surface_area() * float(0 == num_indices ? 1 : num_indices);
+    }
+
+    return cost / root_area;
 }
 
 void Builder::serialize(uint32_t source_node, uint32_t dest_node, Tree& tree,
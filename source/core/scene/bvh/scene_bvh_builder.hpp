@@ -25,6 +25,14 @@ class Builder final : private Builder_base {
     void build(Tree& tree, std::vector<uint32_t> const& indices, std::vector<AABB> const& aabbs,
                Threads& threads);
 
+    // Recomputes the node bounds of a tree that was built from the same set of indices, while
+    // keeping its topology. Returns false without touching the tree if the sets differ.
+    bool refit(Tree& tree, std::vector<uint32_t> const& indices,
+               std::vector<AABB> const& aabbs) const;
+
+    // Surface area heuristic of the whole tree, relative to the surface area of the root
+    static float sah(Tree const& tree);
+
   private:
     void serialize(uint32_t source_node, uint32_t dest_node, Tree& tree, uint32_t& current_prop);
 };
@@ -10,6 +10,17 @@ namespace scene::bvh {
 
 static uint32_t constexpr Parallelize_threshold = 1024;
 
+Primitive_clipper::~Primitive_clipper() = default;
+
+// Share of the budget for a child, proportional to its number of references
+static uint32_t child_budget(uint32_t budget, uint32_t num_references, uint32_t num_total) {
+    if (Kernel::Unlimited == budget) {
+        return Kernel::Unlimited;
+    }
+
+    return uint32_t((uint64_t(budget) * uint64_t(num_references)) / uint64_t(num_total));
+}
+
 Kernel::Kernel() = default;
 
 Kernel::Kernel(uint32_t num_slices, uint32_t sweep_threshold) {
@@ -23,8 +34,9 @@ Kernel::~Kernel() = default;
 Kernel::Settings::Settings(uint32_t num_slices, uint32_t sweep_threshold, uint32_t max_primitives)
     : num_slices_(num_slices), sweep_threshold_(sweep_threshold), max_primitives_(max_primitives) {}
 
-void Kernel::split(uint32_t node_id, References& references, AABB const& aabb, uint32_t depth,
-                   Settings const& settings, Threads& threads, Tasks& tasks) {
+uint32_t Kernel::split(uint32_t node_id, References& references, AABB const& aabb,
+                       uint32_t depth, uint32_t budget, Settings const& settings, Threads& threads,
+                       Tasks& tasks) {
     Node& node = build_nodes_[node_id];
 
     node.set_aabb(aabb);
@@ -37,14 +49,14 @@ void Kernel::split(uint32_t node_id, References& references, AABB const& aabb, u
         if (!threads.is_running_parallel() && tasks.capacity() > 0 &&
             (num_primitives < Parallelize_threshold || depth == settings.parallel_build_depth_)) {
             tasks.emplace_back(Task(Kernel(settings.num_slices_, settings.sweep_threshold_),
-                                    node_id, depth, aabb, std::move(references)));
+                                    node_id, depth, budget, aabb, std::move(references)));
 
-            return;
+            return 0;
         }
 
         bool                  exhausted;
-        Split_candidate const sp = splitting_plane(references, aabb, depth, settings, exhausted,
-                                                   threads);
+        Split_candidate const sp = splitting_plane(references, aabb, depth, budget, settings,
+                                                   exhausted, threads);
 
         if (num_primitives <= 0xFF && (float(num_primitives) <= sp.cost() || exhausted)) {
             assign(node, references);
@@ -54,12 +66,12 @@ void Kernel::split(uint32_t node_id, References& references, AABB const& aabb, u
                 // Implement a fallback solution that arbitrarily distributes the primitives
                 // to sub-nodes without needing a meaningful splitting plane.
                 logging::warning("Cannot split node further");
-                return;
+                return budget;
             }
 
             References references0;
             References references1;
-            sp.distribute(references, references0, references1);
+            sp.distribute(references, references0, references1, settings.clipper_);
 
             if (num_primitives <= 0xFF && (references0.empty() || references1.empty())) {
                 // This can happen if we didn't find a good splitting plane.
@@ -70,6 +82,16 @@ void Kernel::split(uint32_t node_id, References& references, AABB const& aabb, u
 
                 references.release();
 
+                uint32_t const num_references0 = uint32_t(references0.size());
+                uint32_t const num_references1 = uint32_t(references1.size());
+
+                if (Unlimited != budget) {
+                    budget -= sp.num_duplicates(num_primitives);
+                }
+
+                uint32_t const budget0 = child_budget(budget, num_references0,
+                                                      num_references0 + num_references1);
+
                 uint32_t const child0 = uint32_t(build_nodes_.size());
 
                 build_nodes_[node_id].set_split_node(child0, sp.axis());
@@ -77,19 +99,26 @@ void Kernel::split(uint32_t node_id, References& references, AABB const& aabb, u
                 build_nodes_.emplace_back();
                 build_nodes_.emplace_back();
 
-                split(child0, references0, sp.aabb_0(), depth, settings, threads, tasks);
+                uint32_t const rest0 = split(child0, references0, sp.aabb_0(), depth, budget0,
+                                             settings, threads, tasks);
 
                 references0.release();
 
-                split(child0 + 1, references1, sp.aabb_1(), depth, settings, threads, tasks);
+                uint32_t const budget1 = Unlimited == budget ? Unlimited
+                                                             : budget - budget0 + rest0;
+
+                return split(child0 + 1, references1, sp.aabb_1(), depth, budget1, settings,
+                             threads, tasks);
             }
         }
     }
+
+    return budget;
 }
 
 Split_candidate Kernel::splitting_plane(References const& references, AABB const& aabb,
-                                        uint32_t depth, Settings const& settings, bool& exhausted,
-                                        Threads& threads) {
+                                        uint32_t depth, uint32_t budget, Settings const& settings,
+                                        bool& exhausted, Threads& threads) {
     static uint8_t constexpr X = 0;
     static uint8_t constexpr Y = 1;
     static uint8_t constexpr Z = 2;
@@ -100,9 +129,12 @@ Split_candidate Kernel::splitting_plane(References const& references, AABB const
 
     float3 const position = aabb.position();
 
-    split_candidates_.emplace_back(X, position, true);
-    split_candidates_.emplace_back(Y, position, true);
-    split_candidates_.emplace_back(Z, position, true);
+    // Without budget the (costly) spatial candidates could never be used
+    bool const spatial = budget > 0;
+
+    split_candidates_.emplace_back(X, position, spatial);
+    split_candidates_.emplace_back(Y, position, spatial);
+    split_candidates_.emplace_back(Z, position, spatial);
 
     if (num_references <= settings.sweep_threshold_) {
         for (auto const& r : references) {
@@ -133,7 +165,7 @@ Split_candidate Kernel::splitting_plane(References const& references, AABB const
                 slice[a]     = min[a] + fi * step_a;
                 split_candidates_.emplace_back(a, slice, false);
 
-                if (depth < settings.spatial_split_threshold_) {
+                if (spatial && depth < settings.spatial_split_threshold_) {
                     split_candidates_.emplace_back(a, slice, true);
                 }
             }
@@ -142,17 +174,19 @@ Split_candidate Kernel::splitting_plane(References const& references, AABB const
 
     float const aabb_surface_area = aabb.surface_area();
 
+    Primitive_clipper const* clipper = settings.clipper_;
+
     // Arbitrary heuristic for starting the thread pool
     if (threads.is_running_parallel() || num_references < Parallelize_threshold) {
         for (auto& sc : split_candidates_) {
-            sc.evaluate(references, aabb_surface_area);
+            sc.evaluate(references, aabb_surface_area, clipper);
         }
     } else {
         threads.run_range(
-            [&scs = split_candidates_, &references, aabb_surface_area](
+            [&scs = split_candidates_, &references, aabb_surface_area, clipper](
                 uint32_t /*id*/, int32_t sc_begin, int32_t sc_end) noexcept {
                 for (int32_t i = sc_begin; i < sc_end; ++i) {
-                    scs[uint32_t(i)].evaluate(references, aabb_surface_area);
+                    scs[uint32_t(i)].evaluate(references, aabb_surface_area, clipper);
                 }
             },
             0, int32_t(split_candidates_.size()));
@@ -170,6 +204,30 @@ Split_candidate Kernel::splitting_plane(References const& references, AABB const
         }
     }
 
+    if (split_candidates_[sc].num_duplicates(num_references) > budget) {
+        // Out of budget, so the best split that doesn't duplicate references has to do
+        size_t object_sc = split_candidates_.size();
+
+        min_cost = std::numeric_limits<float>::max();
+
+        for (size_t i = 0, len = split_candidates_.size(); i < len; ++i) {
+            auto const& c = split_candidates_[i];
+
+            if (float const cost = c.cost(); !c.spatial() && cost < min_cost) {
+                object_sc = i;
+
+                min_cost = cost;
+            }
+        }
+
+        if (split_candidates_.size() == object_sc) {
+            split_candidates_.emplace_back(split_candidates_[sc].axis(), position, false);
+            split_candidates_.back().evaluate(references, aabb_surface_area, nullptr);
+        }
+
+        sc = object_sc;
+    }
+
     auto const& sp = split_candidates_[sc];
 
     exhausted = (sp.aabb_0().covers(aabb) && num_references == sp.num_side_0()) ||
@@ -217,7 +275,8 @@ void Builder_base::work_on_tasks(Threads& threads, Tasks& tasks) {
                 Task& t = tasks[current];
 
                 t.kernel.reserve(t.references.size(), settings_);
-                t.kernel.split(0, t.references, t.aabb, t.depth, settings_, threads, tasks);
+                t.kernel.split(0, t.references, t.aabb, t.depth, t.budget, settings_, threads,
+                               tasks);
                 t.references.release();
             }
         },
@@ -253,13 +312,20 @@ void Builder_base::work_on_tasks(Threads& threads, Tasks& tasks) {
 
 Task::Task() = default;
 
-Task::Task(Kernel&& kernel, uint32_t rt, uint32_t d, AABB const& box, References&& refs)
-    : kernel(std::move(kernel)), root(rt), depth(d), aabb(box), references(std::move(refs)) {}
+Task::Task(Kernel&& kernel, uint32_t rt, uint32_t d, uint32_t b, AABB const& box,
+           References&& refs)
+    : kernel(std::move(kernel)),
+      root(rt),
+      depth(d),
+      budget(b),
+      aabb(box),
+      references(std::move(refs)) {}
 
 Task::Task(Task&& other)
     : kernel(std::move(other.kernel)),
       root(other.root),
       depth(other.depth),
+      budget(other.budget),
       aabb(other.aabb),
       references(std::move(other.references)) {}
 
@@ -275,6 +341,11 @@ void Builder_base::split(References& references, AABB const& aabb, Threads& thre
 
     settings_.parallel_build_depth_ = std::min(settings_.spatial_split_threshold_, 6u);
 
+    // The budget limits the duplication instead, so clipped spatial splits are allowed at any depth
+    if (settings_.clipper_) {
+        settings_.spatial_split_threshold_ = 0xFFFFFFFF;
+    }
+
     uint32_t const num_tasks = std::min(math::exp2(settings_.parallel_build_depth_),
                                         references.size() / Parallelize_threshold);
 
@@ -284,7 +355,7 @@ void Builder_base::split(References& references, AABB const& aabb, Threads& thre
         tasks.reserve(num_tasks);
     }
 
-    Kernel::split(0, references, aabb, 0, settings_, threads, tasks);
+    Kernel::split(0, references, aabb, 0, settings_.max_duplicates_, settings_, threads, tasks);
 
     work_on_tasks(threads, tasks);
 }
@@ -17,6 +17,7 @@ namespace scene::bvh {
 
 class Node;
 struct Reference;
+class Primitive_clipper;
 class Split_candidate;
 
 using References = memory::Array<Reference>;
@@ -42,15 +43,26 @@ class Kernel {
 
         uint32_t spatial_split_threshold_;
         uint32_t parallel_build_depth_;
+
+        // Clips the primitives at spatial splits, if set
+        Primitive_clipper const* clipper_ = nullptr;
+
+        // Spatial splits stop once they added this many references
+        uint32_t max_duplicates_ = Unlimited;
     };
 
+    static uint32_t constexpr Unlimited = 0xFFFFFFFF;
+
     using Tasks = std::vector<Task>;
 
-    void split(uint32_t node_id, References& references, AABB const& aabb, uint32_t depth,
-               Settings const& settings, Threads& threads, Tasks& tasks);
+    // budget is the number of references that spatial splits may still add below this node.
+    // Returns the part of it that was not used, nor handed over to a task.
+    uint32_t split(uint32_t node_id, References& references, AABB const& aabb, uint32_t depth,
+                   uint32_t budget, Settings const& settings, Threads& threads, Tasks& tasks);
 
     Split_candidate splitting_plane(References const& references, AABB const& aabb, uint32_t depth,
-                                    Settings const& settings, bool& exhausted, Threads& threads);
+                                    uint32_t budget, Settings const& settings, bool& exhausted,
+                                    Threads& threads);
 
     void assign(Node& node, References const& references);
 
@@ -66,7 +78,7 @@ class Kernel {
 struct Task {
     Task();
 
-    Task(Kernel&& kernel, uint32_t rt, uint32_t d, AABB const& box, References&& refs);
+    Task(Kernel&& kernel, uint32_t rt, uint32_t d, uint32_t b, AABB const& box, References&& refs);
 
     Task(Task&& other);
 
@@ -75,6 +87,9 @@ struct Task {
     uint32_t root;
     uint32_t depth;
 
+    // Fixed before the tasks run in parallel, so that the tree doesn't depend on their timing
+    uint32_t budget;
+
     AABB aabb;
 
     References references;
@@ -11,6 +11,8 @@ struct AABB;
 
 namespace scene::bvh {
 
+struct Ray_packet;
+
 class alignas(32) Node {
   public:
     Node();
@@ -45,6 +47,9 @@ class alignas(32) Node {
 
     bool intersect_p(Simdf_p origin, Simdf_p inv_direction, scalar_p min_t, scalar_p max_t) const;
 
+    // Returns the mask of the rays that hit the node, out of the ones in mask
+    uint32_t intersect_p(Ray_packet const& rays, uint32_t mask) const;
+
   private:
     struct alignas(16) Min {
         float    v[3];
@@ -0,0 +1,63 @@
+#ifndef SU_CORE_SCENE_BVH_NODE4_HPP
+#define SU_CORE_SCENE_BVH_NODE4_HPP
+
+#include "base/math/simd.hpp"
+#include "base/math/vector3.hpp"
+
+namespace math {
+struct AABB;
+}
+
+namespace scene::bvh {
+
+// Node with up to four children, whose bounds are stored in SoA layout,
+// so that one slab test intersects all of them at once.
+// A child is either another Node4 (num_indices() == 0), or a leaf with a range of primitives.
+class alignas(64) Node4 {
+  public:
+    Node4();
+
+    uint32_t num_children() const;
+
+    AABB aabb(uint32_t slot) const;
+
+    uint32_t children(uint32_t slot) const;
+
+    uint8_t num_indices(uint32_t slot) const;
+
+    uint32_t indices_start(uint32_t slot) const;
+
+    uint32_t indices_end(uint32_t slot) const;
+
+    void clear();
+
+    void set_split_child(uint32_t slot, AABB const& aabb, uint32_t node);
+
+    void set_leaf_child(uint32_t slot, AABB const& aabb, uint32_t start_primitive,
+                        uint8_t num_primitives);
+
+    // ray_origin and ray_inv_direction hold one splatted Simdf per axis.
+    // Returns a bit mask of the children hit by the ray, and their entry distances.
+    uint32_t intersect_p(Simdf const* ray_origin, Simdf const* ray_inv_direction,
+                         scalar_p ray_min_t, scalar_p ray_max_t, float* distances) const;
+
+  private:
+    void set_aabb(uint32_t slot, AABB const& aabb);
+
+    float min_x_[4];
+    float min_y_[4];
+    float min_z_[4];
+    float max_x_[4];
+    float max_y_[4];
+    float max_z_[4];
+
+    uint32_t children_or_data_[4];
+
+    uint8_t num_indices_[4];
+
+    uint32_t num_children_;
+};
+
+}  // namespace scene::bvh
+
+#endif
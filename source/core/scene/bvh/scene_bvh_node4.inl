@@ -0,0 +1,129 @@
+#ifndef SU_CORE_SCENE_BVH_NODE4_INL
+#define SU_CORE_SCENE_BVH_NODE4_INL
+
+#include "base/math/aabb.inl"
+#include "base/math/simd.inl"
+#include "base/math/simd_const.hpp"
+#include "scene_bvh_node4.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace scene::bvh {
+
+inline Node4::Node4() = default;
+
+inline uint32_t Node4::num_children() const {
+    return num_children_;
+}
+
+inline AABB Node4::aabb(uint32_t slot) const {
+    return {float3(min_x_[slot], min_y_[slot], min_z_[slot]),
+            float3(max_x_[slot], max_y_[slot], max_z_[slot])};
+}
+
+inline uint32_t Node4::children(uint32_t slot) const {
+    return children_or_data_[slot];
+}
+
+inline uint8_t Node4::num_indices(uint32_t slot) const {
+    return num_indices_[slot];
+}
+
+inline uint32_t Node4::indices_start(uint32_t slot) const {
+    return children_or_data_[slot];
+}
+
+inline uint32_t Node4::indices_end(uint32_t slot) const {
+    return children_or_data_[slot] + uint32_t(num_indices_[slot]);
+}
+
+inline void Node4::clear() {
+    float const max = std::numeric_limits<float>::max();
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        min_x_[i] = max;
+        min_y_[i] = max;
+        min_z_[i] = max;
+        max_x_[i] = -max;
+        max_y_[i] = -max;
+        max_z_[i] = -max;
+
+        children_or_data_[i] = 0;
+
+        num_indices_[i] = 0;
+    }
+
+    num_children_ = 0;
+}
+
+inline void Node4::set_split_child(uint32_t slot, AABB const& aabb, uint32_t node) {
+    set_aabb(slot, aabb);
+
+    children_or_data_[slot] = node;
+    num_indices_[slot]      = 0;
+}
+
+inline void Node4::set_leaf_child(uint32_t slot, AABB const& aabb, uint32_t start_primitive,
+                                  uint8_t num_primitives) {
+    set_aabb(slot, aabb);
+
+    children_or_data_[slot] = start_primitive;
+    num_indices_[slot]      = num_primitives;
+}
+
+inline void Node4::set_aabb(uint32_t slot, AABB const& aabb) {
+    min_x_[slot] = aabb.bounds[0][0];
+    min_y_[slot] = aabb.bounds[0][1];
+    min_z_[slot] = aabb.bounds[0][2];
+
+    max_x_[slot] = aabb.bounds[1][0];
+    max_y_[slot] = aabb.bounds[1][1];
+    max_z_[slot] = aabb.bounds[1][2];
+
+    num_children_ = std::max(num_children_, slot + 1);
+}
+
+// Same test as Node::intersect_p(), including the NaN filtering,
+// only with the four children in the lanes instead of the three axes
+inline uint32_t Node4::intersect_p(Simdf const* ray_origin, Simdf const* ray_inv_direction,
+                                   scalar_p ray_min_t, scalar_p ray_max_t,
+                                   float* distances) const {
+    Simdf const infinity(simd::Infinity);
+    Simdf const neg_infinity(simd::Neg_infinity);
+
+    Simdf const l1x = (Simdf(min_x_) - ray_origin[0]) * ray_inv_direction[0];
+    Simdf const l2x = (Simdf(max_x_) - ray_origin[0]) * ray_inv_direction[0];
+
+    Simdf const l1y = (Simdf(min_y_) - ray_origin[1]) * ray_inv_direction[1];
+    Simdf const l2y = (Simdf(max_y_) - ray_origin[1]) * ray_inv_direction[1];
+
+    Simdf const l1z = (Simdf(min_z_) - ray_origin[2]) * ray_inv_direction[2];
+    Simdf const l2z = (Simdf(max_z_) - ray_origin[2]) * ray_inv_direction[2];
+
+    Simdf const far_x = math::max(math::min(l1x, infinity), math::min(l2x, infinity));
+    Simdf const far_y = math::max(math::min(l1y, infinity), math::min(l2y, infinity));
+    Simdf const far_z = math::max(math::min(l1z, infinity), math::min(l2z, infinity));
+
+    Simdf const near_x = math::min(math::max(l1x, neg_infinity), math::max(l2x, neg_infinity));
+    Simdf const near_y = math::min(math::max(l1y, neg_infinity), math::max(l2y, neg_infinity));
+    Simdf const near_z = math::min(math::max(l1z, neg_infinity), math::max(l2z, neg_infinity));
+
+    Simdf const max_t = math::min(math::min(far_x, far_y), far_z);
+    Simdf const min_t = math::max(math::max(near_x, near_y), near_z);
+
+    Simdf const ray_min(ray_min_t);
+    Simdf const ray_max(ray_max_t);
+
+    __m128 const hit = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(max_t.v, ray_min.v),
+                                             _mm_cmpge_ps(ray_max.v, min_t.v)),
+                                  _mm_cmpge_ps(max_t.v, min_t.v));
+
+    _mm_store_ps(distances, math::max(min_t, ray_min).v);
+
+    return uint32_t(_mm_movemask_ps(hit)) & ((1u << num_children_) - 1u);
+}
+
+}  // namespace scene::bvh
+
+#endif
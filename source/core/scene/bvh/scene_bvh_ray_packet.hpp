@@ -0,0 +1,35 @@
+#ifndef SU_CORE_SCENE_BVH_RAY_PACKET_HPP
+#define SU_CORE_SCENE_BVH_RAY_PACKET_HPP
+
+#include "base/math/simd.hpp"
+#include "scene/scene_constants.hpp"
+
+namespace scene::bvh {
+
+// Coherent rays, which traverse a BVH together: every node is fetched once for all of them,
+// and tested against four rays at a time. Lanes are only valid if they are set in the mask
+// that accompanies the packet.
+struct alignas(16) Ray_packet {
+    static uint32_t constexpr Size = Packet_size;
+
+    void set(uint32_t i, Simdf_p origin, Simdf_p direction, Simdf_p inv_direction, float min_t,
+             float max_t);
+
+    // The order in which the children of a node are visited follows the ray in lane i
+    void signs(uint32_t i, uint32_t s[4]) const;
+
+    // For the primitive tests of the individual rays
+    Simdf origins[Size];
+    Simdf directions[Size];
+
+    // SoA for the node tests
+    float origin[3][Size];
+    float inv_direction[3][Size];
+
+    float min_t[Size];
+    float max_t[Size];
+};
+
+}  // namespace scene::bvh
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SU_CORE_SCENE_BVH_RAY_PACKET_INL
+#define SU_CORE_SCENE_BVH_RAY_PACKET_INL
+
+#include "base/math/simd.inl"
+#include "scene_bvh_ray_packet.hpp"
+
+namespace scene::bvh {
+
+inline void Ray_packet::set(uint32_t i, Simdf_p origin, Simdf_p direction, Simdf_p inv_direction,
+                            float min_t, float max_t) {
+    origins[i]    = origin;
+    directions[i] = direction;
+
+    alignas(16) float o[4];
+    _mm_store_ps(o, origin.v);
+
+    alignas(16) float id[4];
+    _mm_store_ps(id, inv_direction.v);
+
+    for (uint32_t a = 0; a < 3; ++a) {
+        this->origin[a][i]        = o[a];
+        this->inv_direction[a][i] = id[a];
+    }
+
+    this->min_t[i] = min_t;
+    this->max_t[i] = max_t;
+}
+
+inline void Ray_packet::signs(uint32_t i, uint32_t s[4]) const {
+    s[0] = inv_direction[0][i] < 0.f ? 1 : 0;
+    s[1] = inv_direction[1][i] < 0.f ? 1 : 0;
+    s[2] = inv_direction[2][i] < 0.f ? 1 : 0;
+}
+
+}  // namespace scene::bvh
+
+#endif
@@ -26,14 +26,27 @@ struct Reference {
 
 using References = memory::Array<Reference>;
 
+// Spatial splits clip the boxes of the references that straddle the plane, unless the builder
+// can clip the primitives themselves. That gives much tighter boxes for long diagonal triangles.
+class Primitive_clipper {
+  public:
+    virtual ~Primitive_clipper();
+
+    // Bounds of the parts of the primitive behind and in front of the plane,
+    // empty if there is no such part
+    virtual void split(uint32_t primitive, uint8_t axis, float d, AABB& aabb0,
+                       AABB& aabb1) const = 0;
+};
+
 class Split_candidate {
   public:
     Split_candidate(uint8_t split_axis, float3_p p, bool spatial);
 
-    void evaluate(References const& references, float aabb_surface_area);
+    void evaluate(References const& references, float aabb_surface_area,
+                  Primitive_clipper const* clipper);
 
     void distribute(References const& __restrict references, References& __restrict references0,
-                    References& __restrict references1) const;
+                    References& __restrict references1, Primitive_clipper const* clipper) const;
 
     float cost() const;
 
@@ -49,7 +62,14 @@ class Split_candidate {
     uint32_t num_side_0() const;
     uint32_t num_side_1() const;
 
+    // References that a spatial split adds
+    uint32_t num_duplicates(uint32_t num_references) const;
+
   private:
+    // Returns a mask of the sides that hold part of the primitive
+    uint32_t clip(Reference const& reference, Primitive_clipper const& clipper,
+                  Reference& reference0, Reference& reference1) const;
+
     AABB aabb_0_;
     AABB aabb_1_;
 
@@ -46,7 +46,8 @@ inline Split_candidate::Split_candidate(uint8_t split_axis, float3_p p, bool spa
       axis_(split_axis),
       spatial_(spatial) {}
 
-inline void Split_candidate::evaluate(References const& references, float aabb_surface_area) {
+inline void Split_candidate::evaluate(References const& references, float aabb_surface_area,
+                                      Primitive_clipper const* clipper) {
     uint32_t num_side_0 = 0;
     uint32_t num_side_1 = 0;
 
@@ -67,6 +68,25 @@ inline void Split_candidate::evaluate(References const& references, float aabb_s
                 ++num_side_1;
 
                 box_1.merge_assign(b);
+            } else if (clipper) {
+                Reference r0;
+                Reference r1;
+
+                uint32_t const sides = clip(r, *clipper, r0, r1);
+
+                if (0 != (sides & 1)) {
+                    ++num_side_0;
+
+                    box_0.merge_assign(Simd_AABB(r0.bounds[0].v, r0.bounds[1].v));
+                }
+
+                if (0 != (sides & 2)) {
+                    ++num_side_1;
+
+                    box_1.merge_assign(Simd_AABB(r1.bounds[0].v, r1.bounds[1].v));
+                }
+
+                used_spatial = true;
             } else {
                 ++num_side_0;
                 ++num_side_1;
@@ -124,7 +144,8 @@ inline void Split_candidate::evaluate(References const& references, float aabb_s
 
 inline void Split_candidate::distribute(References const& __restrict references,
                                         References& __restrict references0,
-                                        References& __restrict references1) const {
+                                        References& __restrict references1,
+                                        Primitive_clipper const* clipper) const {
     references0.reserve(num_side_0_);
     references1.reserve(num_side_1_);
 
@@ -134,6 +155,19 @@ inline void Split_candidate::distribute(References const& __restrict references,
                 references0.push_back(r);
             } else if (!behind(r.bounds[0].v)) {
                 references1.push_back(r);
+            } else if (clipper) {
+                Reference r0;
+                Reference r1;
+
+                uint32_t const sides = clip(r, *clipper, r0, r1);
+
+                if (0 != (sides & 1)) {
+                    references0.push_back(r0);
+                }
+
+                if (0 != (sides & 2)) {
+                    references1.push_back(r1);
+                }
             } else {
                 references0.push_back(r.clipped_max(d_, axis_));
                 references1.push_back(r.clipped_min(d_, axis_));
@@ -182,6 +216,53 @@ inline uint32_t Split_candidate::num_side_1() const {
     return num_side_1_;
 }
 
+inline uint32_t Split_candidate::num_duplicates(uint32_t num_references) const {
+    return spatial_ ? num_side_0_ + num_side_1_ - num_references : 0;
+}
+
+static inline bool empty(AABB const& box) {
+    float3 const min = box.min();
+    float3 const max = box.max();
+
+    return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+}
+
+inline uint32_t Split_candidate::clip(Reference const& reference, Primitive_clipper const& clipper,
+                                      Reference& reference0, Reference& reference1) const {
+    uint32_t const primitive = reference.primitive();
+
+    AABB aabb0;
+    AABB aabb1;
+    clipper.split(primitive, axis_, d_, aabb0, aabb1);
+
+    // The reference might already be clipped by an earlier split
+    AABB const box(float3(reference.bounds[0].v), float3(reference.bounds[1].v));
+
+    aabb0 = box.intersection(aabb0);
+    aabb1 = box.intersection(aabb1);
+
+    uint32_t sides = 0;
+
+    if (!empty(aabb0)) {
+        reference0.set(Simdf(aabb0.min()), Simdf(aabb0.max()), primitive);
+        sides |= 1;
+    }
+
+    if (!empty(aabb1)) {
+        reference1.set(Simdf(aabb1.min()), Simdf(aabb1.max()), primitive);
+        sides |= 2;
+    }
+
+    if (0 == sides) {
+        // Can only be caused by numerical trouble, so fall back to clipping the box
+        reference0 = reference.clipped_max(d_, axis_);
+        reference1 = reference.clipped_min(d_, axis_);
+        sides      = 3;
+    }
+
+    return sides;
+}
+
 }  // namespace scene::bvh
 
 #endif
@@ -22,6 +22,9 @@ struct Tree {
     Node* nodes_ = nullptr;
 
     uint32_t* indices_ = nullptr;
+
+    // SAH cost of the tree right after the last full build
+    float build_sah_ = 0.f;
 };
 
 }  // namespace scene::bvh
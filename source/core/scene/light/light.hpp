@@ -6,7 +6,12 @@
 
 namespace math {
 struct AABB;
-class Distribution_2D;
+class Distribution_1D;
+
+template <typename T>
+class Distribution_t_2D;
+
+using Distribution_2D = Distribution_t_2D<Distribution_1D>;
 }  // namespace math
 
 namespace image::texture {
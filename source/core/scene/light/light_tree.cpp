@@ -343,7 +343,8 @@ void Tree::set_splitting_threshold(float st) {
 }
 
 Tree::Tree()
-    : num_lights_(0),
+    : build_cost_(0.f),
+      num_lights_(0),
       num_infinite_lights_(0),
       num_nodes_(0),
       nodes_(nullptr),
@@ -102,6 +102,9 @@ class Tree {
     float infinite_weight_;
     float infinite_guard_;
 
+    // Cost of the finite nodes right after the last full build
+    float build_cost_;
+
     uint32_t infinite_end_;
     uint32_t infinite_depth_bias_;
     uint32_t num_lights_;
@@ -102,6 +102,38 @@ static float variance(uint32_t* const lights, uint32_t begin, uint32_t end, Set
     return std::abs(aps - ap * ap);
 }
 
+// Power weighted orientation and surface area of a node, the same measure as in the split cost
+static float node_cost(AABB const& bounds, float4_p cone, bool two_sided, float power) {
+    if (0.f == power) {
+        return 0.f;
+    }
+
+    return power * cone_cost(cone[3]) * (two_sided ? 2.f : 1.f) * bounds.surface_area();
+}
+
+static float normalized_cost(float cost, AABB const& bounds, float4_p cone, bool two_sided,
+                             float power) {
+    float const root_cost = node_cost(bounds, cone, two_sided, power);
+
+    return root_cost > 0.f ? cost / root_cost : 0.f;
+}
+
+static void set_infinite_weight(Tree& tree, float infinite_power, float finite_power,
+                                uint32_t num_finite_lights) {
+    uint32_t const num_infinite_lights = tree.num_infinite_lights_;
+
+    float const p0 = infinite_power;
+    float const pt = p0 + finite_power;
+
+    float const infinite_weight = 0 == tree.num_lights_ ? 0.f : p0 / pt;
+
+    tree.infinite_weight_ = infinite_weight;
+
+    // This is because I'm afraid of the 1.f == random case
+    tree.infinite_guard_ = 0 == num_finite_lights ? (0 == num_infinite_lights ? 0.f : 1.1f)
+                                                  : infinite_weight;
+}
+
 struct Split_candidate {
     using Part = shape::triangle::Part;
 
@@ -524,17 +556,130 @@ void Tree_builder::build(Tree& tree, Scene const& scene, Threads& threads) {
 
     tree.infinite_depth_bias_ = infinite_depth_bias;
 
-    float const p0 = infinite_total_power;
     float const p1 = 0 == num_finite_lights ? 0.f : build_nodes_[0].power;
-    float const pt = p0 + p1;
 
-    float const infinite_weight = 0 == num_lights ? 0.f : p0 / pt;
+    set_infinite_weight(tree, infinite_total_power, p1, num_finite_lights);
 
-    tree.infinite_weight_ = infinite_weight;
+    float build_cost = 0.f;
 
-    // This is because I'm afraid of the 1.f == random case
-    tree.infinite_guard_ = 0 == num_finite_lights ? (0 == num_infinite_lights ? 0.f : 1.1f)
-                                                  : infinite_weight;
+    if (num_finite_lights > 0) {
+        for (uint32_t i = 0, len = current_node_; i < len; ++i) {
+            Build_node const& n = build_nodes_[i];
+
+            build_cost += node_cost(n.bounds, n.cone, n.two_sided, n.power);
+        }
+
+        Build_node const& root = build_nodes_[0];
+
+        build_cost = normalized_cost(build_cost, root.bounds, root.cone, root.two_sided,
+                                     root.power);
+    }
+
+    tree.build_cost_ = build_cost;
+}
+
+bool Tree_builder::refit(Tree& tree, Scene const& scene, float& cost) const {
+    uint32_t const num_lights = scene.num_lights();
+
+    uint32_t const num_nodes = tree.num_nodes_;
+
+    if (0 == num_nodes || num_lights != tree.num_lights_) {
+        return false;
+    }
+
+    uint32_t* const lights = tree.light_mapping_;
+
+    uint32_t const num_infinite_lights = tree.num_infinite_lights_;
+
+    for (uint32_t i = 0; i < num_lights; ++i) {
+        if (scene.light(lights[i]).is_finite(scene) != (i >= num_infinite_lights)) {
+            return false;
+        }
+    }
+
+    float infinite_total_power = 0.f;
+
+    for (uint32_t i = 0; i < num_infinite_lights; ++i) {
+        float const power = scene.light_power(0, lights[i]);
+
+        tree.infinite_light_powers_[i] = power;
+
+        infinite_total_power += power;
+    }
+
+    tree.infinite_light_distribution_.init(tree.infinite_light_powers_, num_infinite_lights);
+
+    memory::Array<AABB> bounds(num_nodes);
+
+    Node* const nodes = tree.nodes_;
+
+    float total_cost = 0.f;
+
+    // Children are always serialized after their parent,
+    // so a single backwards pass visits them in the correct order
+    for (uint32_t i = num_nodes; i > 0; --i) {
+        uint32_t const n = i - 1;
+
+        Node& node = nodes[n];
+
+        uint32_t begin;
+
+        if (node.has_children) {
+            uint32_t const c0 = node.children_or_light;
+
+            Node const& a = nodes[c0];
+            Node const& b = nodes[c0 + 1];
+
+            bounds[n] = bounds[c0].merge(bounds[c0 + 1]);
+
+            node.cone      = 0.f == b.power ? a.cone : cone::merge(a.cone, b.cone);
+            node.power     = a.power + b.power;
+            node.two_sided = a.two_sided | b.two_sided;
+
+            begin = tree.node_middles_[n] - a.num_lights;
+        } else {
+            begin = node.children_or_light;
+
+            Simd_AABB box(Empty_AABB);
+            float4    cone(1.f);
+            bool      two_sided = false;
+            float     power     = 0.f;
+
+            for (uint32_t j = begin, len = begin + node.num_lights; j < len; ++j) {
+                uint32_t const l = lights[j];
+
+                two_sided |= scene.light_two_sided(0, l);
+
+                // Like the split candidates, which determine the bounds of the leaves during build
+                if (float const p = scene.light_power(0, l); p > 0.f) {
+                    box.merge_assign(scene.light_aabb(l));
+                    cone = cone::merge(cone, scene.light_cone(l));
+                    power += p;
+                }
+            }
+
+            bounds[n] = AABB(box);
+
+            node.cone      = cone;
+            node.power     = power;
+            node.two_sided = two_sided ? 1 : 0;
+        }
+
+        AABB const& nb = bounds[n];
+
+        node.center   = float4(nb.position(), 0.5f * length(nb.extent()));
+        node.variance = variance(lights, begin, begin + node.num_lights, scene, 0);
+
+        total_cost += node_cost(nb, node.cone, node.two_sided, node.power);
+    }
+
+    Node const& root = nodes[0];
+
+    set_infinite_weight(tree, infinite_total_power, root.power, num_lights - num_infinite_lights);
+
+    cost = normalized_cost(total_cost, bounds[0], root.cone, root.two_sided, root.power);
+
+    return true;
 }
 
 void Tree_builder::build(Primitive_tree& tree, Part const& part, uint32_t variant,
@@ -43,6 +43,10 @@ class Tree_builder {
 
     void build(Tree& tree, Scene const& scene, Threads& threads);
 
+    // Recomputes bounds, cones and powers of a tree that was built from the same set of lights,
+    // while keeping its topology. Returns false without touching the tree if the sets differ.
+    bool refit(Tree& tree, Scene const& scene, float& cost) const;
+
     void build(Primitive_tree& tree, Part const& part, uint32_t variant, Threads& threads);
 
   private:
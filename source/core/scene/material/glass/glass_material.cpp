@@ -21,7 +21,9 @@ material::Sample const& Glass::sample(float3_p wo, Renderstate const& rs, Sample
     if (normal_map_.is_valid()) {
         auto& sampler = worker.sampler_2D(sampler_key(), rs.filter);
 
-        float3 const n = sample_normal(wo, rs, normal_map_, sampler, worker.scene());
+        float4 const uv_dif = uv_differential(rs, sampler, worker);
+
+        float3 const n = sample_normal(wo, rs, uv_dif, normal_map_, sampler, worker.scene());
         sample.layer_.set_tangent_frame(n);
     } else {
         sample.layer_.set_tangent_frame(rs.t, rs.b, rs.n);
@@ -24,8 +24,10 @@ material::Sample const& Glass_rough::sample(float3_p wo, Renderstate const& rs,
 
     auto& sampler = worker.sampler_2D(sampler_key(), rs.filter);
 
+    float4 const uv_dif = uv_differential(rs, sampler, worker);
+
     if (normal_map_.is_valid()) {
-        float3 const n = sample_normal(wo, rs, normal_map_, sampler, worker.scene());
+        float3 const n = sample_normal(wo, rs, uv_dif, normal_map_, sampler, worker.scene());
         sample.layer_.set_tangent_frame(n);
     } else {
         sample.layer_.set_tangent_frame(rs.t, rs.b, rs.n);
@@ -33,7 +35,8 @@ material::Sample const& Glass_rough::sample(float3_p wo, Renderstate const& rs,
 
     float alpha;
     if (roughness_map_.is_valid()) {
-        float const r = ggx::map_roughness(sampler.sample_1(roughness_map_, rs.uv, worker.scene()));
+        float const r = ggx::map_roughness(
+            sampler.sample_1(roughness_map_, rs.uv, uv_dif, worker.scene()));
 
         alpha = r * r;
     } else {
@@ -6,6 +6,7 @@
 #include "image/texture/texture_sampler.hpp"
 #include "material_sample_helper.hpp"
 #include "scene/scene_renderstate.hpp"
+#include "scene/scene_worker.hpp"
 
 #ifdef SU_DEBUG
 #include "scene/material/material_test.hpp"
@@ -17,10 +18,20 @@ namespace scene::material {
 using Texture            = image::texture::Texture;
 using Texture_sampler_2D = image::texture::Sampler_2D;
 
+// Footprint of the shading point in texture space, only computed if the sampler filters with it
+static inline float4 uv_differential(Renderstate const& rs, Texture_sampler_2D const& sampler,
+                                     Worker const& worker) {
+    if (!sampler.uses_differentials()) {
+        return float4(0.f);
+    }
+
+    return worker.screenspace_differential(rs, rs.time);
+}
+
 static inline float3 sample_normal(float3_p wo, Renderstate const& rs, float2 const uv,
-                                   Texture const& map, Texture_sampler_2D const& sampler,
-                                   Scene const& scene) {
-    float2 const nm  = sampler.sample_2(map, uv, scene);
+                                   float4_p uv_dif, Texture const& map,
+                                   Texture_sampler_2D const& sampler, Scene const& scene) {
+    float2 const nm  = sampler.sample_2(map, uv, uv_dif, scene);
     float const  nmz = math::sqrt(std::max(1.f - dot(nm, nm), Dot_min));
     float3 const n   = normalize(rs.tangent_to_world(float3(nm, nmz)));
 
@@ -37,9 +48,10 @@ static inline float3 sample_normal(float3_p wo, Renderstate const& rs, float2 co
     return n;
 }
 
-static inline float3 sample_normal(float3_p wo, Renderstate const& rs, Texture const& map,
-                                   Texture_sampler_2D const& sampler, Scene const& scene) {
-    return sample_normal(wo, rs, rs.uv, map, sampler, scene);
+static inline float3 sample_normal(float3_p wo, Renderstate const& rs, float4_p uv_dif,
+                                   Texture const& map, Texture_sampler_2D const& sampler,
+                                   Scene const& scene) {
+    return sample_normal(wo, rs, rs.uv, uv_dif, map, sampler, scene);
 }
 
 static inline float non_symmetry_compensation(float3_p wi, float3_p wo, float3_p geo_n,
@@ -76,25 +76,34 @@ struct Coating_description {
     bool in_nm = false;
 };
 
+// How the textures of one material are loaded
+struct Tex_settings {
+    Provider::Tex tex;
+
+    bool mip_maps;
+};
+
+static Tex_settings read_tex_settings(json::Value const& value, Provider::Tex tex);
+
 static Texture_description read_texture_description(json::Value const& value);
 
-static void read_coating_description(json::Value const&, Provider::Tex tex,
+static void read_coating_description(json::Value const&, Tex_settings tex,
                                      Resources& resources, Coating_description& description);
 
 static void read_sampler_settings(json::Value const& value, Sampler_settings& settings);
 
-static Texture create_texture(Texture_description const& desc, Tex_usage usage, Provider::Tex tex,
+static Texture create_texture(Texture_description const& desc, Tex_usage usage, Tex_settings tex,
                               Resources& resources);
 
 static float3 read_color(json::Value const& value);
 
-static Texture read_texture(json::Value const& value, Provider::Tex tex, Tex_usage usage,
+static Texture read_texture(json::Value const& value, Tex_settings tex, Tex_usage usage,
                             Resources& resources);
 
-static void read_mapped_value(json::Value const& value, Provider::Tex tex, Tex_usage usage,
+static void read_mapped_value(json::Value const& value, Tex_settings tex, Tex_usage usage,
                               Resources& resources, Mapped_value<float>& result);
 
-static void read_mapped_value(json::Value const& value, Provider::Tex tex, Tex_usage usage,
+static void read_mapped_value(json::Value const& value, Tex_settings tex, Tex_usage usage,
                               Resources& resources, Mapped_value<float3>& result);
 
 Provider::Provider(bool no_tex, bool no_tex_dwim, bool force_debug_material)
@@ -200,13 +209,15 @@ Material* Provider::load(json::Value const& value, std::string_view mount_folder
 }
 
 Material* Provider::load_debug(json::Value const& debug_value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(debug_value, tex_);
+
     Sampler_settings sampler_settings;
 
     Texture mask;
 
     for (auto const& n : debug_value.GetObject()) {
         if ("mask" == n.name) {
-            mask = read_texture(n.value, tex_, Tex_usage::Mask, resources);
+            mask = read_texture(n.value, tex, Tex_usage::Mask, resources);
         } else if ("textures" == n.name) {
             for (auto const& tn : n.value.GetArray()) {
                 Texture_description const desc = read_texture_description(tn);
@@ -216,7 +227,7 @@ Material* Provider::load_debug(json::Value const& debug_value, Resources& resour
                 }
 
                 if ("Mask" == desc.usage) {
-                    mask = create_texture(desc, Tex_usage::Mask, tex_, resources);
+                    mask = create_texture(desc, Tex_usage::Mask, tex, resources);
                 }
             }
         } else if ("sampler" == n.name) {
@@ -232,6 +243,8 @@ Material* Provider::load_debug(json::Value const& debug_value, Resources& resour
 }
 
 Material* Provider::load_glass(json::Value const& glass_value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(glass_value, tex_);
+
     Sampler_settings sampler_settings;
 
     Mapped_value<float> roughness(0.f);
@@ -248,9 +261,9 @@ Material* Provider::load_glass(json::Value const& glass_value, Resources& resour
 
     for (auto const& n : glass_value.GetObject()) {
         if ("mask" == n.name) {
-            mask = read_texture(n.value, tex_, Tex_usage::Mask, resources);
+            mask = read_texture(n.value, tex, Tex_usage::Mask, resources);
         } else if ("normal" == n.name) {
-            normal_map = read_texture(n.value, tex_, Tex_usage::Normal, resources);
+            normal_map = read_texture(n.value, tex, Tex_usage::Normal, resources);
         } else if ("color" == n.name || "attenuation_color" == n.name) {
             attenuation_color = read_color(n.value);
         } else if ("attenuation_distance" == n.name) {
@@ -260,7 +273,7 @@ Material* Provider::load_glass(json::Value const& glass_value, Resources& resour
         } else if ("abbe" == n.name) {
             abbe = json::read_float(n.value);
         } else if ("roughness" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Roughness, resources, roughness);
+            read_mapped_value(n.value, tex, Tex_usage::Roughness, resources, roughness);
         } else if ("thickness" == n.name) {
             thickness = json::read_float(n.value);
         } else if ("sampler" == n.name) {
@@ -297,6 +310,8 @@ Material* Provider::load_glass(json::Value const& glass_value, Resources& resour
 }
 
 Material* Provider::load_light(json::Value const& light_value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(light_value, tex_);
+
     Sampler_settings sampler_settings;
 
     std::string quantity;
@@ -314,9 +329,9 @@ Material* Provider::load_light(json::Value const& light_value, Resources& resour
 
     for (auto const& n : light_value.GetObject()) {
         if ("mask" == n.name) {
-            mask = read_texture(n.value, tex_, Tex_usage::Mask, resources);
+            mask = read_texture(n.value, tex, Tex_usage::Mask, resources);
         } else if ("emission" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Emission, resources, emission);
+            read_mapped_value(n.value, tex, Tex_usage::Emission, resources, emission);
         } else if ("emittance" == n.name) {
             quantity = json::read_string(n.value, "quantity");
 
@@ -364,6 +379,8 @@ Material* Provider::load_light(json::Value const& light_value, Resources& resour
 }
 
 Material* Provider::load_metal(json::Value const& metal_value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(metal_value, tex_);
+
     Sampler_settings sampler_settings;
 
     Mapped_value<float> rotation(0.f);
@@ -382,9 +399,9 @@ Material* Provider::load_metal(json::Value const& metal_value, Resources& resour
 
     for (auto const& n : metal_value.GetObject()) {
         if ("mask" == n.name) {
-            mask = read_texture(n.value, tex_, Tex_usage::Mask, resources);
+            mask = read_texture(n.value, tex, Tex_usage::Mask, resources);
         } else if ("normal" == n.name) {
-            normal_map = read_texture(n.value, tex_, Tex_usage::Normal, resources);
+            normal_map = read_texture(n.value, tex, Tex_usage::Normal, resources);
         } else if ("ior" == n.name) {
             ior = read_color(n.value);
         } else if ("absorption" == n.name) {
@@ -396,7 +413,7 @@ Material* Provider::load_metal(json::Value const& metal_value, Resources& resour
         } else if ("anisotropy" == n.name) {
             anisotropy = json::read_float(n.value);
         } else if ("anisotropy_rotation" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Roughness, resources, rotation);
+            read_mapped_value(n.value, tex, Tex_usage::Roughness, resources, rotation);
         } else if ("two_sided" == n.name) {
             two_sided = json::read_bool(n.value);
         } else if ("sampler" == n.name) {
@@ -419,6 +436,8 @@ Material* Provider::load_metal(json::Value const& metal_value, Resources& resour
 }
 
 Material* Provider::load_mix(json::Value const& mix_value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(mix_value, tex_);
+
     Sampler_settings sampler_settings;
 
     Texture mask;
@@ -430,7 +449,7 @@ Material* Provider::load_mix(json::Value const& mix_value, Resources& resources)
 
     for (auto const& n : mix_value.GetObject()) {
         if ("mask" == n.name) {
-            mask = read_texture(n.value, tex_, Tex_usage::Mask, resources);
+            mask = read_texture(n.value, tex, Tex_usage::Mask, resources);
         } else if ("materials" == n.name) {
             for (auto& m : n.value.GetArray()) {
                 if (materials.full()) {
@@ -454,7 +473,7 @@ Material* Provider::load_mix(json::Value const& mix_value, Resources& resources)
                 }
 
                 if ("Mask" == desc.usage) {
-                    mask = create_texture(desc, Tex_usage::Mask, tex_, resources);
+                    mask = create_texture(desc, Tex_usage::Mask, tex, resources);
                 }
             }
         } else if ("sampler" == n.name) {
@@ -481,6 +500,8 @@ Material* Provider::load_mix(json::Value const& mix_value, Resources& resources)
 }
 
 Material* Provider::load_substitute(json::Value const& value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(value, tex_);
+
     Sampler_settings sampler_settings;
 
     Mapped_value<float3> color(float3(0.5f));
@@ -512,15 +533,15 @@ Material* Provider::load_substitute(json::Value const& value, Resources& resourc
 
     for (auto const& n : value.GetObject()) {
         if ("mask" == n.name) {
-            mask = read_texture(n.value, tex_, Tex_usage::Mask, resources);
+            mask = read_texture(n.value, tex, Tex_usage::Mask, resources);
         } else if ("normal" == n.name) {
-            normal_map = read_texture(n.value, tex_, Tex_usage::Normal, resources);
+            normal_map = read_texture(n.value, tex, Tex_usage::Normal, resources);
         } else if ("color" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Color, resources, color);
+            read_mapped_value(n.value, tex, Tex_usage::Color, resources, color);
         } else if ("emission" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Emission, resources, emission);
+            read_mapped_value(n.value, tex, Tex_usage::Emission, resources, emission);
         } else if ("surface" == n.name) {
-            roughness.texture = read_texture(n.value, tex_, Tex_usage::Surface, resources);
+            roughness.texture = read_texture(n.value, tex, Tex_usage::Surface, resources);
         } else if ("checkers" == n.name) {
             for (auto const& cn : n.value.GetObject()) {
                 if ("scale" == cn.name) {
@@ -547,9 +568,9 @@ Material* Provider::load_substitute(json::Value const& value, Resources& resourc
         } else if ("ior" == n.name) {
             ior = json::read_float(n.value);
         } else if ("roughness" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Roughness, resources, roughness);
+            read_mapped_value(n.value, tex, Tex_usage::Roughness, resources, roughness);
         } else if ("anisotropy_rotation" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Roughness, resources, rotation);
+            read_mapped_value(n.value, tex, Tex_usage::Roughness, resources, rotation);
         } else if ("anisotropy" == n.name) {
             anisotropy = json::read_float(n.value);
         } else if ("metallic" == n.name) {
@@ -565,7 +586,7 @@ Material* Provider::load_substitute(json::Value const& value, Resources& resourc
         } else if ("two_sided" == n.name) {
             two_sided = json::read_bool(n.value);
         } else if ("coating" == n.name) {
-            read_coating_description(n.value, tex_, resources, coating);
+            read_coating_description(n.value, tex, resources, coating);
         } else if ("textures" == n.name) {
             for (auto& tn : n.value.GetArray()) {
                 Texture_description const desc = read_texture_description(tn);
@@ -575,19 +596,19 @@ Material* Provider::load_substitute(json::Value const& value, Resources& resourc
                 }
 
                 if ("Color" == desc.usage) {
-                    color.texture = create_texture(desc, Tex_usage::Color, tex_, resources);
+                    color.texture = create_texture(desc, Tex_usage::Color, tex, resources);
                 } else if ("Normal" == desc.usage) {
-                    normal_map = create_texture(desc, Tex_usage::Normal, tex_, resources);
+                    normal_map = create_texture(desc, Tex_usage::Normal, tex, resources);
                 } else if ("Surface" == desc.usage) {
-                    roughness.texture = create_texture(desc, Tex_usage::Surface, tex_, resources);
+                    roughness.texture = create_texture(desc, Tex_usage::Surface, tex, resources);
                 } else if ("Roughness" == desc.usage) {
-                    roughness.texture = create_texture(desc, Tex_usage::Roughness, tex_, resources);
+                    roughness.texture = create_texture(desc, Tex_usage::Roughness, tex, resources);
                 } else if ("Emission" == desc.usage) {
-                    emission.texture = create_texture(desc, Tex_usage::Emission, tex_, resources);
+                    emission.texture = create_texture(desc, Tex_usage::Emission, tex, resources);
                 } else if ("Mask" == desc.usage) {
-                    mask = create_texture(desc, Tex_usage::Mask, tex_, resources);
+                    mask = create_texture(desc, Tex_usage::Mask, tex, resources);
                 } else if ("Density" == desc.usage) {
-                    density_map = create_texture(desc, Tex_usage::Mask, tex_, resources);
+                    density_map = create_texture(desc, Tex_usage::Mask, tex, resources);
                 }
             }
         } else if ("sampler" == n.name) {
@@ -766,6 +787,8 @@ Material* Provider::load_substitute(json::Value const& value, Resources& resourc
 }
 
 Material* Provider::load_volumetric(json::Value const& value, Resources& resources) const {
+    Tex_settings const tex = read_tex_settings(value, tex_);
+
     Sampler_settings sampler_settings(Sampler_settings::Filter::Linear,
                                       Sampler_settings::Address::Clamp,
                                       Sampler_settings::Address::Clamp);
@@ -789,11 +812,11 @@ Material* Provider::load_volumetric(json::Value const& value, Resources& resourc
 
     for (auto& n : value.GetObject()) {
         if ("density" == n.name) {
-            density_map = read_texture(n.value, tex_, Tex_usage::Roughness, resources);
+            density_map = read_texture(n.value, tex, Tex_usage::Roughness, resources);
         } else if ("color" == n.name) {
-            read_mapped_value(n.value, tex_, Tex_usage::Color, resources, color);
+            read_mapped_value(n.value, tex, Tex_usage::Color, resources, color);
         } else if ("temperature" == n.name) {
-            temperature_map = read_texture(n.value, tex_, Tex_usage::Roughness, resources);
+            temperature_map = read_texture(n.value, tex, Tex_usage::Roughness, resources);
         } else if ("attenuation_color" == n.name) {
             use_attenuation_color = true;
             attenuation_color     = read_color(n.value);
@@ -874,6 +897,10 @@ void read_sampler_settings(json::Value const& value, Sampler_settings& settings)
                 settings.filter = Sampler_settings::Filter::Nearest;
             } else if ("Linear" == filter) {
                 settings.filter = Sampler_settings::Filter::Linear;
+            } else if ("Trilinear" == filter) {
+                settings.filter = Sampler_settings::Filter::Trilinear;
+            } else if ("Anisotropic" == filter) {
+                settings.filter = Sampler_settings::Filter::Anisotropic;
             }
         } else if ("address" == n.name) {
             if (n.value.IsArray()) {
@@ -892,6 +919,16 @@ void read_sampler_settings(json::Value const& value, Sampler_settings& settings)
     }
 }
 
+Tex_settings read_tex_settings(json::Value const& value, Provider::Tex tex) {
+    Sampler_settings sampler_settings;
+
+    if (auto const n = value.FindMember("sampler"); value.MemberEnd() != n) {
+        read_sampler_settings(n->value, sampler_settings);
+    }
+
+    return {tex, sampler_settings.mip_maps()};
+}
+
 Texture_description read_texture_description(json::Value const& value) {
     using image::Swizzle;
 
@@ -945,8 +982,9 @@ Texture_description read_texture_description(json::Value const& value) {
     return desc;
 }
 
-Texture create_texture(Texture_description const& desc, Tex_usage usage, Provider::Tex tex, Resources& resources) {
-    if (Provider::Tex::No == tex || (Provider::Tex::DWIM == tex && Tex_usage::Emission != usage)) {
+Texture create_texture(Texture_description const& desc, Tex_usage usage, Tex_settings tex, Resources& resources) {
+    if (Provider::Tex::No == tex.tex ||
+        (Provider::Tex::DWIM == tex.tex && Tex_usage::Emission != usage)) {
         return Texture();
     }
 
@@ -961,10 +999,15 @@ Texture create_texture(Texture_description const& desc, Tex_usage usage, Provide
         options.set("invert", desc.invert);
     }
 
+    // Masks are only ever looked up at full resolution
+    if (tex.mip_maps && Tex_usage::Mask != usage) {
+        options.set("mip_maps", true);
+    }
+
     return image::texture::Provider::load(desc.filename, options, desc.scale, resources);
 }
 
-void read_coating_description(json::Value const& value, Provider::Tex tex, Resources& resources,
+void read_coating_description(json::Value const& value, Tex_settings tex, Resources& resources,
                               Coating_description& coating) {
     if (!value.IsObject()) {
         return;
@@ -1068,7 +1111,7 @@ float3 read_color(json::Value const& value) {
     return map_color(read_hex_RGB(hex_string));
 }
 
-Texture read_texture(json::Value const& value, Provider::Tex tex, Tex_usage usage,
+Texture read_texture(json::Value const& value, Tex_settings tex, Tex_usage usage,
                      Resources& resources) {
     Texture_description const desc = read_texture_description(value);
 
@@ -1079,7 +1122,7 @@ Texture read_texture(json::Value const& value, Provider::Tex tex, Tex_usage usag
     return Texture();
 }
 
-void read_mapped_value(json::Value const& value, Provider::Tex tex, Tex_usage usage,
+void read_mapped_value(json::Value const& value, Tex_settings tex, Tex_usage usage,
                        Resources& resources, Mapped_value<float>& result) {
     if (value.IsObject()) {
         Texture_description const desc = read_texture_description(value);
@@ -1094,7 +1137,7 @@ void read_mapped_value(json::Value const& value, Provider::Tex tex, Tex_usage us
     }
 }
 
-void read_mapped_value(json::Value const& value, Provider::Tex tex, Tex_usage usage,
+void read_mapped_value(json::Value const& value, Tex_settings tex, Tex_usage usage,
                        Resources& resources, Mapped_value<float3>& result) {
     if (value.IsObject()) {
         Texture_description const desc = read_texture_description(value);
@@ -23,8 +23,10 @@ material::Sample const& Material::sample(float3_p wo, Renderstate const& rs, Sam
 
     auto const& sampler = worker.sampler_2D(sampler_key(), rs.filter);
 
+    float4 const uv_dif = uv_differential(rs, sampler, worker);
+
     if (normal_map_.is_valid()) {
-        float3 const n = sample_normal(wo, rs, normal_map_, sampler, worker.scene());
+        float3 const n = sample_normal(wo, rs, uv_dif, normal_map_, sampler, worker.scene());
         sample.layer_.set_tangent_frame(n);
     } else {
         sample.layer_.set_tangent_frame(rs.t, rs.b, rs.n);
@@ -32,7 +34,7 @@ material::Sample const& Material::sample(float3_p wo, Renderstate const& rs, Sam
 
     float rotation;
     if (rotation_map_.is_valid()) {
-        rotation = (2.f * Pi) * sampler.sample_1(rotation_map_, rs.uv, worker.scene());
+        rotation = (2.f * Pi) * sampler.sample_1(rotation_map_, rs.uv, uv_dif, worker.scene());
     } else {
         rotation = rotation_;
     }
@@ -11,14 +11,22 @@ using Texture_sampler_3D = image::texture::Sampler_3D;
 Sampler_cache::Sampler_cache() {
     using namespace image::texture;
 
-    samplers_2D_[0] = new Nearest_2D<Address_mode_clamp, Address_mode_clamp>;
-    samplers_2D_[1] = new Nearest_2D<Address_mode_clamp, Address_mode_repeat>;
-    samplers_2D_[2] = new Nearest_2D<Address_mode_repeat, Address_mode_clamp>;
-    samplers_2D_[3] = new Nearest_2D<Address_mode_repeat, Address_mode_repeat>;
-    samplers_2D_[4] = new Linear_2D<Address_mode_clamp, Address_mode_clamp>;
-    samplers_2D_[5] = new Linear_2D<Address_mode_clamp, Address_mode_repeat>;
-    samplers_2D_[6] = new Linear_2D<Address_mode_repeat, Address_mode_clamp>;
-    samplers_2D_[7] = new Linear_2D<Address_mode_repeat, Address_mode_repeat>;
+    samplers_2D_[0]  = new Nearest_2D<Address_mode_clamp, Address_mode_clamp>;
+    samplers_2D_[1]  = new Nearest_2D<Address_mode_clamp, Address_mode_repeat>;
+    samplers_2D_[2]  = new Nearest_2D<Address_mode_repeat, Address_mode_clamp>;
+    samplers_2D_[3]  = new Nearest_2D<Address_mode_repeat, Address_mode_repeat>;
+    samplers_2D_[4]  = new Linear_2D<Address_mode_clamp, Address_mode_clamp>;
+    samplers_2D_[5]  = new Linear_2D<Address_mode_clamp, Address_mode_repeat>;
+    samplers_2D_[6]  = new Linear_2D<Address_mode_repeat, Address_mode_clamp>;
+    samplers_2D_[7]  = new Linear_2D<Address_mode_repeat, Address_mode_repeat>;
+    samplers_2D_[8]  = new Mipmap_2D<Address_mode_clamp, Address_mode_clamp, false>;
+    samplers_2D_[9]  = new Mipmap_2D<Address_mode_clamp, Address_mode_repeat, false>;
+    samplers_2D_[10] = new Mipmap_2D<Address_mode_repeat, Address_mode_clamp, false>;
+    samplers_2D_[11] = new Mipmap_2D<Address_mode_repeat, Address_mode_repeat, false>;
+    samplers_2D_[12] = new Mipmap_2D<Address_mode_clamp, Address_mode_clamp, true>;
+    samplers_2D_[13] = new Mipmap_2D<Address_mode_clamp, Address_mode_repeat, true>;
+    samplers_2D_[14] = new Mipmap_2D<Address_mode_repeat, Address_mode_clamp, true>;
+    samplers_2D_[15] = new Mipmap_2D<Address_mode_repeat, Address_mode_repeat, true>;
 
     samplers_3D_[0] = new Nearest_3D<Address_mode_clamp>;
     samplers_3D_[1] = samplers_3D_[0];
@@ -28,6 +36,11 @@ Sampler_cache::Sampler_cache() {
     samplers_3D_[5] = samplers_3D_[4];
     samplers_3D_[6] = new Linear_3D<Address_mode_repeat>;
     samplers_3D_[7] = samplers_3D_[6];
+
+    // Volumes have no mip maps, so the trilinear and anisotropic filters fall back to linear
+    for (uint32_t i = 8; i < Num_samplers; ++i) {
+        samplers_3D_[i] = samplers_3D_[4 + (i & 3)];
+    }
 }
 
 Sampler_cache::~Sampler_cache() {
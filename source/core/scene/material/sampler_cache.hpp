@@ -27,7 +27,7 @@ class Sampler_cache {
     Texture_sampler_3D const& sampler_3D(uint32_t key, Filter filter) const;
 
   private:
-    static uint32_t constexpr Num_samplers = 8;
+    static uint32_t constexpr Num_samplers = 16;
 
     Texture_sampler_2D* samplers_2D_[Num_samplers];
     Texture_sampler_3D* samplers_3D_[Num_samplers];
@@ -13,4 +13,8 @@ uint32_t Sampler_settings::key() const {
     return key;
 }
 
+bool Sampler_settings::mip_maps() const {
+    return Filter::Trilinear == filter || Filter::Anisotropic == filter;
+}
+
 }  // namespace scene::material
@@ -13,13 +13,22 @@ struct Sampler_settings {
         Undefined = 0xFF
     };
 
-    enum class Filter : uint8_t { Nearest = 0 << 2, Linear = 1 << 2, Undefined = 0xFF };
+    enum class Filter : uint8_t {
+        Nearest     = 0 << 2,
+        Linear      = 1 << 2,
+        Trilinear   = 2 << 2,
+        Anisotropic = 3 << 2,
+        Undefined   = 0xFF
+    };
 
     Sampler_settings(Filter filter = Filter::Linear, Address address_u = Address::Repeat,
                      Address address_v = Address::Repeat);
 
     uint32_t key() const;
 
+    // Trilinear and Anisotropic filtering needs textures with mip maps
+    bool mip_maps() const;
+
     Filter filter;
 
     Address address_u;
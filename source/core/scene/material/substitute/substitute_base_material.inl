@@ -37,8 +37,10 @@ template <typename Sample>
 void Material_base::set_sample(float3_p wo, Renderstate const& rs, float ior_outside,
                                Texture_sampler_2D const& sampler, Worker const& worker,
                                Sample& sample) const {
+    float4 const uv_dif = uv_differential(rs, sampler, worker);
+
     if (normal_map_.is_valid()) {
-        float3 const n = sample_normal(wo, rs, normal_map_, sampler, worker.scene());
+        float3 const n = sample_normal(wo, rs, uv_dif, normal_map_, sampler, worker.scene());
         sample.layer_.set_tangent_frame(n);
     } else {
         sample.layer_.set_tangent_frame(rs.t, rs.b, rs.n);
@@ -46,7 +48,7 @@ void Material_base::set_sample(float3_p wo, Renderstate const& rs, float ior_out
 
     float rotation;
     if (rotation_map_.is_valid()) {
-        rotation = (2.f * Pi) * sampler.sample_1(rotation_map_, rs.uv, worker.scene());
+        rotation = (2.f * Pi) * sampler.sample_1(rotation_map_, rs.uv, uv_dif, worker.scene());
     } else {
         rotation = rotation_;
     }
@@ -57,7 +59,7 @@ void Material_base::set_sample(float3_p wo, Renderstate const& rs, float ior_out
 
     float3 color;
     if (color_map_.is_valid()) {
-        color = sampler.sample_3(color_map_, rs.uv, worker.scene());
+        color = sampler.sample_3(color_map_, rs.uv, uv_dif, worker.scene());
     } else {
         color = color_;
     }
@@ -67,14 +69,15 @@ void Material_base::set_sample(float3_p wo, Renderstate const& rs, float ior_out
 
     uint32_t const nc = surface_map_.num_channels();
     if (nc >= 2) {
-        float2 const surface = sampler.sample_2(surface_map_, rs.uv, worker.scene());
+        float2 const surface = sampler.sample_2(surface_map_, rs.uv, uv_dif, worker.scene());
 
         float const r = ggx::map_roughness(surface[0]);
 
         alpha    = anisotropic_alpha(r, anisotropy_);
         metallic = surface[1];
     } else if (1 == nc) {
-        float const r = ggx::map_roughness(sampler.sample_1(surface_map_, rs.uv, worker.scene()));
+        float const r = ggx::map_roughness(
+            sampler.sample_1(surface_map_, rs.uv, uv_dif, worker.scene()));
 
         alpha    = anisotropic_alpha(r, anisotropy_);
         metallic = metallic_;
@@ -85,7 +88,7 @@ void Material_base::set_sample(float3_p wo, Renderstate const& rs, float ior_out
 
     float3 radiance;
     if (emission_map_.is_valid()) {
-        radiance = emission_factor_ * sampler.sample_3(emission_map_, rs.uv, worker.scene());
+        radiance = emission_factor_ * sampler.sample_3(emission_map_, rs.uv, uv_dif, worker.scene());
     } else {
         radiance = emission_factor_ * emission_;
     }
@@ -35,7 +35,10 @@ void Material_coating<Coating>::set_coating_basis(float3_p wo, Renderstate const
     if (Material_base::normal_map_ == coating_normal_map_) {
         sample.coating_.set_tangent_frame(sample.layer_.t_, sample.layer_.b_, sample.layer_.n_);
     } else if (coating_normal_map_.is_valid()) {
-        float3 const n = sample_normal(wo, rs, coating_normal_map_, sampler, worker.scene());
+        float4 const uv_dif = uv_differential(rs, sampler, worker);
+
+        float3 const n = sample_normal(wo, rs, uv_dif, coating_normal_map_, sampler,
+                                       worker.scene());
         sample.coating_.set_tangent_frame(n);
     } else {
         sample.coating_.set_tangent_frame(rs.t, rs.b, rs.n);
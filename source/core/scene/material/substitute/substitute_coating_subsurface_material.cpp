@@ -53,7 +53,9 @@ material::Sample const& Material_coating_subsurface::sample(float3_p wo, Renders
     float thickness;
     float weight;
     if (coating_thickness_map_.is_valid()) {
-        float const relative_thickness = sampler.sample_1(coating_thickness_map_, rs.uv,
+        float4 const uv_dif = uv_differential(rs, sampler, worker);
+
+        float const relative_thickness = sampler.sample_1(coating_thickness_map_, rs.uv, uv_dif,
                                                           worker.scene());
 
         thickness = coating_.thickness * relative_thickness;
@@ -64,8 +64,10 @@ material::Sample const& Checkers::sample(float3_p wo, Renderstate const& rs, Sam
 
     auto const& sampler = worker.sampler_2D(sampler_key(), rs.filter);
 
+    float4 const uv_dif = uv_differential(rs, sampler, worker);
+
     if (normal_map_.is_valid()) {
-        float3 const n = sample_normal(wo, rs, normal_map_, sampler, worker.scene());
+        float3 const n = sample_normal(wo, rs, uv_dif, normal_map_, sampler, worker.scene());
         sample.layer_.set_tangent_frame(n);
     } else {
         sample.layer_.set_tangent_frame(rs.t, rs.b, rs.n);
@@ -80,7 +82,7 @@ material::Sample const& Checkers::sample(float3_p wo, Renderstate const& rs, Sam
     float2 alpha;
     float  metallic;
     if (surface_map_.is_valid()) {
-        float2 const surface = sampler.sample_2(surface_map_, rs.uv, worker.scene());
+        float2 const surface = sampler.sample_2(surface_map_, rs.uv, uv_dif, worker.scene());
 
         float const r = ggx::map_roughness(surface[0]);
 
@@ -100,7 +102,7 @@ material::Sample const& Checkers::sample(float3_p wo, Renderstate const& rs, Sam
 
     float3 radiance;
     if (emission_map_.is_valid()) {
-        radiance = emission_factor_ * sampler.sample_3(emission_map_, rs.uv, worker.scene());
+        radiance = emission_factor_ * sampler.sample_3(emission_map_, rs.uv, uv_dif, worker.scene());
     } else {
         radiance = float3(0.f);
     }
@@ -193,7 +193,7 @@ float3 Grid_emission::prepare_sampling(Shape const& /*shape*/, uint32_t /*part*/
 
     Distribution_2D* conditional_2d = distribution_.allocate(uint32_t(d[2]));
 
-    memory::Array<float3> ars(threads.num_threads());
+    memory::Array<float3> ars(threads.num_threads(), float3(0.f));
 
     memory::Buffer<float> luminance(d[0] * d[1] * d[2]);
 
@@ -246,7 +246,7 @@ float3 Grid_emission::prepare_sampling(Shape const& /*shape*/, uint32_t /*part*/
                     }
                 }
 
-                ars[id] = ar;
+                ars[id] += ar;
             },
             0, d[2]);
 
@@ -275,7 +275,7 @@ float3 Grid_emission::prepare_sampling(Shape const& /*shape*/, uint32_t /*part*/
                     }
                 }
 
-                ars[id] = ar;
+                ars[id] += ar;
             },
             0, d[2]);
     }
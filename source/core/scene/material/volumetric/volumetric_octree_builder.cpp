@@ -1,6 +1,7 @@
 #include "volumetric_octree_builder.hpp"
 #include "base/math/vector4.inl"
 #include "base/thread/thread_pool.hpp"
+#include "image/image.hpp"
 #include "image/texture/texture.inl"
 #include "scene/material/collision_coefficients.inl"
 
@@ -155,13 +156,20 @@ void Octree_builder::Splitter::split(Build_node* node, Box const& box, Texture c
         float min_density = 1.f;
         float max_density = 0.f;
 
-        for (int32_t z = minb[2]; z < maxb[2]; ++z) {
-            for (int32_t y = minb[1]; y < maxb[1]; ++y) {
-                for (int32_t x = minb[0]; x < maxb[0]; ++x) {
-                    float const density = texture.at_1(x, y, z, scene);
-
-                    min_density = std::min(density, min_density);
-                    max_density = std::max(density, max_density);
+        if (image::Image const* image = texture.image(scene);
+            image::Image::Type::Float1_sparse == image->type()) {
+            // Uniform tiles and cells, as well as the cached ranges of the completely covered
+            // active cells, don't require looking at individual voxels
+            image->float1_sparse().min_max(minb, maxb, min_density, max_density);
+        } else {
+            for (int32_t z = minb[2]; z < maxb[2]; ++z) {
+                for (int32_t y = minb[1]; y < maxb[1]; ++y) {
+                    for (int32_t x = minb[0]; x < maxb[0]; ++x) {
+                        float const density = texture.at_1(x, y, z, scene);
+
+                        min_density = std::min(density, min_density);
+                        max_density = std::max(density, max_density);
+                    }
                 }
             }
         }
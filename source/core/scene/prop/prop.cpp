@@ -15,6 +15,8 @@
 #include "scene/shape/shape.inl"
 #include "scene/shape/shape_intersection.hpp"
 
+#include <bit>
+
 namespace scene::prop {
 
 using Transformation = Composed_transformation;
@@ -125,6 +127,98 @@ bool Prop::intersect_p(uint32_t self, Ray const& ray, Worker& worker) const {
     return scene.prop_shape(self)->intersect_p(ray, trafo, worker);
 }
 
+uint32_t Prop::intersect(uint32_t self, Ray* rays, uint32_t mask, Worker& worker,
+                        shape::Interpolation ipo, shape::Intersection* isecs) const {
+    auto const& scene = worker.scene();
+
+    bool const test_aabb = properties_.is(Property::Test_AABB);
+
+    uint32_t active = 0;
+
+    for (; 0 != mask; mask &= mask - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(mask));
+
+        Ray const& ray = rays[i];
+
+        if (visible(ray.depth) && (!test_aabb || scene.prop_aabb_intersect_p(self, ray))) {
+            active |= 1u << i;
+        }
+    }
+
+    if (0 == active) {
+        return 0;
+    }
+
+    shape::Shape const* shape = scene.prop_shape(self);
+
+    if (properties_.is(Property::Static)) {
+        auto const& trafo = scene.prop_world_transformation(self);
+
+        return shape->intersect_packet(rays, active, trafo, worker, ipo, isecs);
+    }
+
+    // The transformation depends on the time of every ray
+    uint32_t hits = 0;
+
+    for (; 0 != active; active &= active - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(active));
+
+        Transformation temp;
+        auto const&    trafo = scene.prop_transformation_at(self, rays[i].time, false, temp);
+
+        if (shape->intersect(rays[i], trafo, worker, ipo, isecs[i])) {
+            hits |= 1u << i;
+        }
+    }
+
+    return hits;
+}
+
+uint32_t Prop::intersect_p(uint32_t self, Ray const* rays, uint32_t mask, Worker& worker) const {
+    if (!visible_in_shadow()) {
+        return 0;
+    }
+
+    auto const& scene = worker.scene();
+
+    if (properties_.is(Property::Test_AABB)) {
+        for (uint32_t m = mask; 0 != m; m &= m - 1) {
+            uint32_t const i = uint32_t(std::countr_zero(m));
+
+            if (!scene.prop_aabb_intersect_p(self, rays[i])) {
+                mask &= ~(1u << i);
+            }
+        }
+
+        if (0 == mask) {
+            return 0;
+        }
+    }
+
+    shape::Shape const* shape = scene.prop_shape(self);
+
+    if (properties_.is(Property::Static)) {
+        auto const& trafo = scene.prop_world_transformation(self);
+
+        return shape->intersect_p_packet(rays, mask, trafo, worker);
+    }
+
+    uint32_t hits = 0;
+
+    for (; 0 != mask; mask &= mask - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(mask));
+
+        Transformation temp;
+        auto const&    trafo = scene.prop_transformation_at(self, rays[i].time, false, temp);
+
+        if (shape->intersect_p(rays[i], trafo, worker)) {
+            hits |= 1u << i;
+        }
+    }
+
+    return hits;
+}
+
 bool Prop::visibility(uint32_t self, Ray const& ray, Filter filter, Worker& worker,
                       float3& v) const {
     if (!has_tinted_shadow()) {
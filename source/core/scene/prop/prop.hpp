@@ -77,6 +77,12 @@ class Prop {
 
     bool visibility(uint32_t self, Ray const& ray, Filter filter, Worker& worker, float3& v) const;
 
+    // Packets of the rays selected by the bits of mask, returning the mask of the rays that hit
+    uint32_t intersect(uint32_t self, Ray* rays, uint32_t mask, Worker& worker,
+                       shape::Interpolation ipo, shape::Intersection* isecs) const;
+
+    uint32_t intersect_p(uint32_t self, Ray const* rays, uint32_t mask, Worker& worker) const;
+
   private:
     bool visible(uint32_t ray_depth) const;
 
@@ -2,11 +2,14 @@
 #include "prop.hpp"
 #include "prop_intersection.hpp"
 #include "scene/bvh/scene_bvh_node.inl"
+#include "scene/bvh/scene_bvh_ray_packet.inl"
 #include "scene/bvh/scene_bvh_tree.inl"
 #include "scene/scene_ray.inl"
 #include "scene/scene_worker.inl"
 #include "scene/shape/node_stack.inl"
 
+#include <bit>
+
 namespace scene::prop {
 
 bvh::Tree& BVH_wrapper::tree() {
@@ -323,4 +326,198 @@ bool BVH_wrapper::visibility(Ray const& ray, Filter filter, Worker& worker, floa
     return true;
 }
 
+uint32_t BVH_wrapper::intersect(Ray* rays, uint32_t mask, Worker& worker, Interpolation ipo,
+                                Intersection* isecs) const {
+    if (0 == mask) {
+        return 0;
+    }
+
+    auto& stack = worker.node_stack();
+
+    uint32_t hits = 0;
+
+    uint32_t hit_props[Packet_size];
+
+    shape::Intersection geos[Packet_size];
+
+    stack.clear();
+    if (0 != tree_.num_nodes_) {
+        stack.push(0);
+    }
+
+    uint32_t n = 0;
+
+    bvh::Ray_packet packet;
+
+    for (uint32_t m = mask; 0 != m; m &= m - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(m));
+
+        Ray const& ray = rays[i];
+
+        packet.set(i, Simdf(ray.origin.v), Simdf(ray.direction.v), Simdf(ray.inv_direction.v),
+                   ray.min_t(), ray.max_t());
+
+        hit_props[i] = prop::Null;
+    }
+
+    alignas(16) uint32_t ray_signs[4];
+    packet.signs(uint32_t(std::countr_zero(mask)), ray_signs);
+
+    bvh::Node* nodes = tree_.nodes_;
+
+    Prop const* props = props_;
+
+    uint32_t const* finite_props = tree_.indices_;
+
+    while (!stack.empty()) {
+        auto const& node = nodes[n];
+
+        if (uint32_t const active = node.intersect_p(packet, mask); 0 != active) {
+            if (0 == node.num_indices()) {
+                uint32_t const a = node.children();
+                uint32_t const b = a + 1;
+
+                if (0 == ray_signs[node.axis()]) {
+                    stack.push(b);
+                    n = a;
+                } else {
+                    stack.push(a);
+                    n = b;
+                }
+
+                continue;
+            }
+
+            for (uint32_t i = node.indices_start(), len = node.indices_end(); i < len; ++i) {
+                uint32_t const p = finite_props[i];
+
+                uint32_t const prop_hits = props[p].intersect(p, rays, active, worker, ipo, geos);
+
+                for (uint32_t m = prop_hits; 0 != m; m &= m - 1) {
+                    uint32_t const r = uint32_t(std::countr_zero(m));
+
+                    hit_props[r] = p;
+
+                    packet.max_t[r] = rays[r].max_t();
+                }
+
+                hits |= prop_hits;
+            }
+        }
+
+        n = stack.pop();
+    }
+
+    uint32_t const* infinite_props = infinite_props_;
+
+    for (uint32_t i = 0, len = num_infinite_props_; i < len; ++i) {
+        uint32_t const p = infinite_props[i];
+
+        uint32_t const prop_hits = props[p].intersect(p, rays, mask, worker, ipo, geos);
+
+        for (uint32_t m = prop_hits; 0 != m; m &= m - 1) {
+            hit_props[uint32_t(std::countr_zero(m))] = p;
+        }
+
+        hits |= prop_hits;
+    }
+
+    for (uint32_t m = mask; 0 != m; m &= m - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(m));
+
+        if (0 != (hits & (1u << i))) {
+            isecs[i].geo = geos[i];
+        }
+
+        isecs[i].prop       = hit_props[i];
+        isecs[i].subsurface = false;
+    }
+
+    return hits;
+}
+
+uint32_t BVH_wrapper::intersect_p(Ray const* rays, uint32_t mask, Worker& worker) const {
+    if (0 == mask) {
+        return 0;
+    }
+
+    auto& stack = worker.node_stack();
+
+    uint32_t hits = 0;
+
+    stack.clear();
+    if (0 != tree_.num_nodes_) {
+        stack.push(0);
+    }
+
+    uint32_t n = 0;
+
+    bvh::Ray_packet packet;
+
+    for (uint32_t m = mask; 0 != m; m &= m - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(m));
+
+        Ray const& ray = rays[i];
+
+        packet.set(i, Simdf(ray.origin.v), Simdf(ray.direction.v), Simdf(ray.inv_direction.v),
+                   ray.min_t(), ray.max_t());
+    }
+
+    alignas(16) uint32_t ray_signs[4];
+    packet.signs(uint32_t(std::countr_zero(mask)), ray_signs);
+
+    bvh::Node* nodes = tree_.nodes_;
+
+    Prop const* props = props_;
+
+    uint32_t const* finite_props = tree_.indices_;
+
+    while (!stack.empty()) {
+        auto const& node = nodes[n];
+
+        if (uint32_t const active = node.intersect_p(packet, mask & ~hits); 0 != active) {
+            if (0 == node.num_indices()) {
+                uint32_t const a = node.children();
+                uint32_t const b = a + 1;
+
+                if (0 == ray_signs[node.axis()]) {
+                    stack.push(b);
+                    n = a;
+                } else {
+                    stack.push(a);
+                    n = b;
+                }
+
+                continue;
+            }
+
+            for (uint32_t i = node.indices_start(), len = node.indices_end(); i < len; ++i) {
+                uint32_t const p = finite_props[i];
+
+                hits |= props[p].intersect_p(p, rays, active & ~hits, worker);
+
+                if (mask == hits) {
+                    return hits;
+                }
+            }
+        }
+
+        n = stack.pop();
+    }
+
+    uint32_t const* infinite_props = infinite_props_;
+
+    for (uint32_t i = 0, len = num_infinite_props_; i < len; ++i) {
+        uint32_t const p = infinite_props[i];
+
+        hits |= props[p].intersect_p(p, rays, mask & ~hits, worker);
+
+        if (mask == hits) {
+            return hits;
+        }
+    }
+
+    return hits;
+}
+
 }  // namespace scene::prop
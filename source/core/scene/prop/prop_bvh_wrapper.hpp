@@ -40,6 +40,12 @@ class BVH_wrapper {
 
     bool visibility(Ray const& ray, Filter filter, Worker& worker, float3& vis) const;
 
+    // Packets of the rays selected by the bits of mask, returning the mask of the rays that hit
+    uint32_t intersect(Ray* rays, uint32_t mask, Worker& worker, Interpolation ipo,
+                       Intersection* isecs) const;
+
+    uint32_t intersect_p(Ray const* rays, uint32_t mask, Worker& worker) const;
+
   private:
     bvh::Tree tree_;
 
@@ -2,7 +2,7 @@
 #include "animation/animation.hpp"
 #include "base/math/aabb.inl"
 #include "base/math/cone.inl"
-#include "base/math/distribution_1d.inl"
+#include "base/math/distribution_alias_1d.inl"
 #include "base/math/matrix3x3.inl"
 #include "base/math/quaternion.inl"
 #include "base/math/vector3.inl"
@@ -13,6 +13,7 @@
 #include "extension.hpp"
 #include "light/light.inl"
 #include "light/light_tree_builder.hpp"
+#include "logging/logging.hpp"
 #include "material/material.inl"
 #include "prop/prop.inl"
 #include "scene_ray.hpp"
@@ -31,6 +32,12 @@ static uint32_t constexpr Num_steps = 4;
 
 static float constexpr Interval = 1.f / float(Num_steps);
 
+// A refitted BVH is rebuilt once its SAH cost exceeds that of the last build by this factor
+static float constexpr BVH_refit_threshold = 1.25f;
+
+// Same for the light tree, with the cost of its nodes as estimated by the builder
+static float constexpr Light_tree_refit_threshold = 1.25f;
+
 static uint32_t count_frames(uint64_t frame_step, uint64_t frame_duration);
 
 Scene::Scene(std::vector<Image*> const&    image_resources,
@@ -70,6 +77,7 @@ void Scene::clear() {
     prop_world_transformations_.clear();
 
     lights_.clear();
+    light_states_.clear();
 
     keyframes_.clear();
     light_ids_.clear();
@@ -231,12 +239,10 @@ void Scene::compile(float3_p camera_pos, uint64_t time, Worker& worker, Threads&
         props_[v].set_visible_in_shadow(false);
     }
 
-    // rebuild prop BVH
-    bvh_builder_.build(prop_bvh_.tree(), finite_props_, prop_aabbs_, threads);
+    update_bvh(prop_bvh_, finite_props_, "Prop", threads);
     prop_bvh_.set_props(infinite_props_, props_);
 
-    // rebuild volume BVH
-    bvh_builder_.build(volume_bvh_.tree(), volumes_, prop_aabbs_, threads);
+    update_bvh(volume_bvh_, volumes_, "Volume", threads);
     volume_bvh_.set_props(infinite_volumes_, props_);
 
     // re-sort lights PDF
@@ -251,7 +257,7 @@ void Scene::compile(float3_p camera_pos, uint64_t time, Worker& worker, Threads&
 
     light_distribution_.init(light_temp_powers_.data(), light_temp_powers_.size());
 
-    light_tree_builder_.build(light_tree_, *this, threads);
+    update_light_tree(threads);
 
     has_volumes_ = !volumes_.empty() || !infinite_volumes_.empty();
 
@@ -266,6 +272,48 @@ void Scene::compile(float3_p camera_pos, uint64_t time, Worker& worker, Threads&
     caustic_aabb_ = caustic_aabb;
 }
 
+void Scene::update_bvh(prop::BVH_wrapper& bvh, std::vector<uint32_t> const& props,
+                       std::string const& name, Threads& threads) {
+    bvh::Tree& tree = bvh.tree();
+
+    if (props.empty()) {
+        bvh_builder_.build(tree, props, prop_aabbs_, threads);
+        return;
+    }
+
+    // As long as the set of props is unchanged, updating the bounds is much cheaper than a rebuild
+    if (bvh_builder_.refit(tree, props, prop_aabbs_)) {
+        float const sah = bvh::Builder::sah(tree);
+
+        if (sah <= BVH_refit_threshold * tree.build_sah_) {
+            logging::info(name + " BVH refit with SAH %f", sah);
+            return;
+        }
+
+        logging::info(name + " BVH refit degraded to SAH %f, rebuilding", sah);
+    }
+
+    bvh_builder_.build(tree, props, prop_aabbs_, threads);
+
+    logging::info(name + " BVH build with SAH %f", tree.build_sah_);
+}
+
+void Scene::update_light_tree(Threads& threads) {
+    // As long as the set of lights is unchanged, the topology of the last build can be kept
+    if (float cost; light_tree_builder_.refit(light_tree_, *this, cost)) {
+        if (cost <= Light_tree_refit_threshold * light_tree_.build_cost_) {
+            logging::info("Light tree refit with cost %f", cost);
+            return;
+        }
+
+        logging::info("Light tree refit degraded to cost %f, rebuilding", cost);
+    }
+
+    light_tree_builder_.build(light_tree_, *this, threads);
+
+    logging::info("Light tree build with cost %f", light_tree_.build_cost_);
+}
+
 void Scene::commit_materials(Threads& threads) const {
     for (auto m : material_resources_) {
         m->commit(threads, *this);
@@ -431,6 +479,41 @@ void Scene::prop_prepare_sampling(uint32_t entity, uint32_t part, uint32_t light
 
     uint32_t const m = materials_[p];
 
+    uint32_t const f = prop_frames_[entity];
+
+    Light_state& state = light_states_[light];
+
+    if (prop::Null == f && shape->is_finite()) {
+        auto const& trafo = prop_world_transformations_[entity];
+
+        float3 const world_position = prop_world_positions_[entity];
+
+        if (state.prepared && m == state.material && world_position == state.world_position &&
+            trafo.rotation.r[0] == state.rotation.r[0] &&
+            trafo.rotation.r[1] == state.rotation.r[1] &&
+            trafo.rotation.r[2] == state.rotation.r[2] && trafo.scale() == state.scale) {
+            // Only the camera moved, which shifts the camera relative bounds
+            AABB& bb = light_aabbs_[light];
+
+            float3 const shift = trafo.position - state.position;
+
+            bb.bounds[0] = float3(bb.bounds[0] + shift, bb.bounds[0][3]);
+            bb.bounds[1] = float3(bb.bounds[1] + shift, bb.bounds[1][3]);
+
+            state.position = trafo.position;
+            return;
+        }
+
+        state.rotation       = trafo.rotation;
+        state.scale          = trafo.scale();
+        state.world_position = world_position;
+        state.position       = trafo.position;
+        state.material       = m;
+        state.prepared       = true;
+    } else {
+        state.prepared = false;
+    }
+
     uint32_t const variant = shape->prepare_sampling(part, m, light_tree_builder_, worker, threads);
 
     lights_[light].set_variant(variant);
@@ -451,8 +534,6 @@ void Scene::prop_prepare_sampling(uint32_t entity, uint32_t part, uint32_t light
 
     lights_[light].set_extent(extent);
 
-    uint32_t const f = prop_frames_[entity];
-
     AABB const part_aabb = shape->part_aabb(part, variant);
 
     if (prop::Null == f) {
@@ -650,6 +731,7 @@ void Scene::allocate_light(light::Light::Type type, bool two_sided, uint32_t ent
 
     light_aabbs_.emplace_back(AABB(float3(0.f), float3(0.f)));
     light_cones_.emplace_back(float4(0.f, 0.f, 1.f, -1.f));
+    light_states_.emplace_back();
 }
 
 bool Scene::prop_is_instance(uint32_t shape, uint32_t const* materials, uint32_t num_parts) const {
@@ -1,7 +1,8 @@
 #ifndef SU_CORE_SCENE_SCENE_HPP
 #define SU_CORE_SCENE_SCENE_HPP
 
-#include "base/math/distribution_1d.hpp"
+#include "base/math/distribution_alias_1d.hpp"
+#include "base/math/matrix3x3.hpp"
 #include "base/memory/array.hpp"
 #include "bvh/scene_bvh_builder.hpp"
 #include "light/light.hpp"
@@ -9,6 +10,7 @@
 #include "light/light_tree_builder.hpp"
 #include "prop/prop_bvh_wrapper.hpp"
 
+#include <string>
 #include <vector>
 
 namespace math {
@@ -104,6 +106,14 @@ class Scene {
 
     bool visibility(Ray const& ray, Filter filter, Worker& worker, float3& v) const;
 
+    // Packets of up to Packet_size coherent rays, selected by the bits of mask.
+    // Return the mask of the rays that hit something, or that are visible, respectively.
+    uint32_t intersect(Ray* rays, uint32_t mask, Worker& worker, Interpolation ipo,
+                       Intersection* isecs) const;
+
+    uint32_t visibility(Ray const* rays, uint32_t mask, Filter filter, Worker& worker,
+                        float3* vs) const;
+
     uint32_t num_props() const;
 
     Prop const* prop(uint32_t index) const;
@@ -247,6 +257,11 @@ class Scene {
 
     bool prop_has_caustic_material(uint32_t entity) const;
 
+    void update_bvh(prop::BVH_wrapper& bvh, std::vector<uint32_t> const& props,
+                    std::string const& name, Threads& threads);
+
+    void update_light_tree(Threads& threads);
+
     std::vector<Image*> const&    image_resources_;
     std::vector<Material*> const& material_resources_;
     std::vector<Shape*> const&    shape_resources_;
@@ -283,6 +298,19 @@ class Scene {
     std::vector<AABB>         light_aabbs_;
     std::vector<float4>       light_cones_;
 
+    // Transformation and material of a light at the time its sampling was last prepared.
+    // Finite lights of static props that didn't change since then are not prepared again.
+    struct Light_state {
+        float3x3 rotation;
+        float3   scale;
+        float3   world_position;
+        float3   position;
+        uint32_t material;
+        bool     prepared;
+    };
+
+    std::vector<Light_state> light_states_;
+
     std::vector<uint32_t> materials_;
     std::vector<uint32_t> light_ids_;
 
@@ -292,7 +320,8 @@ class Scene {
 
     memory::Array<float> light_temp_powers_;
 
-    Distribution_1D light_distribution_;
+    // Only used for discrete picks, so the alias method serves it in constant time
+    Distribution_alias_1D light_distribution_;
 
     light::Tree light_tree_;
 
@@ -12,6 +12,8 @@
 
 #include "base/debug/assert.hpp"
 
+#include <bit>
+
 namespace scene {
 
 static uint64_t constexpr Tick_duration = Units_per_second / 60;
@@ -56,6 +58,44 @@ inline bool Scene::visibility(Ray const& ray, Filter filter, Worker& worker, flo
     return !ip;
 }
 
+inline uint32_t Scene::intersect(Ray* rays, uint32_t mask, Worker& worker, Interpolation ipo,
+                                 Intersection* isecs) const {
+    return prop_bvh_.intersect(rays, mask, worker, ipo, isecs);
+}
+
+inline uint32_t Scene::visibility(Ray const* rays, uint32_t mask, Filter filter, Worker& worker,
+                                  float3* vs) const {
+    uint32_t visible = 0;
+
+    if (has_tinted_shadow_) {
+        for (; 0 != mask; mask &= mask - 1) {
+            uint32_t const i = uint32_t(std::countr_zero(mask));
+
+            if (prop_bvh_.visibility(rays[i], filter, worker, vs[i])) {
+                visible |= 1u << i;
+            }
+        }
+
+        return visible;
+    }
+
+    uint32_t const ip = prop_bvh_.intersect_p(rays, mask, worker);
+
+    for (; 0 != mask; mask &= mask - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(mask));
+
+        bool const hit = 0 != (ip & (1u << i));
+
+        vs[i] = float3(hit ? 0.f : 1.f);
+
+        if (!hit) {
+            visible |= 1u << i;
+        }
+    }
+
+    return visible;
+}
+
 inline uint32_t Scene::num_interpolation_frames() const {
     return num_interpolation_frames_;
 }
@@ -12,6 +12,10 @@ inline float constexpr Ray_max_t = 3.4027715434167032e+38f;
 // std::nextafter(Ray_max_t, 0.f);
 inline float constexpr Almost_ray_max_t = 3.4027713405926072e+38f;
 
+// Rays that are intersected together as one packet at most,
+// the bits of the masks that select them have the same order
+inline uint32_t constexpr Packet_size = 8;
+
 inline uint64_t constexpr Units_per_second = 705600000;
 
 static inline uint64_t time(double dtime) {
@@ -166,6 +166,8 @@ bool Loader::load(std::string const& filename, std::string_view take_mount_folde
 
     for (auto const& n : root.GetObject()) {
         if ("entities" == n.name) {
+            prefetch(n.value, local_materials, scene);
+
             load_entities(n.value, parent_id, parent_transformation, local_materials, scene,
                           camera);
         }
@@ -196,6 +198,108 @@ void Loader::read_materials(json::Value const& materials_value, std::string cons
     }
 }
 
+void Loader::prefetch(json::Value const& entities_value, Local_materials const& local_materials,
+                      Scene& scene) const {
+    auto& threads = resource_manager_.threads();
+
+    if (threads.num_threads() < 2) {
+        return;
+    }
+
+    Resource_names names;
+    collect_resources(entities_value, names);
+
+    std::vector<std::string> shapes(names.shapes.begin(), names.shapes.end());
+    std::vector<std::string> materials;
+
+    for (auto const& m : names.materials) {
+        if (!resource_manager_.get<Material>(m).ptr) {
+            materials.push_back(m);
+        }
+    }
+
+    int32_t const num_shapes    = int32_t(shapes.size());
+    int32_t const num_resources = num_shapes + int32_t(materials.size());
+
+    if (num_resources < 2) {
+        return;
+    }
+
+    std::vector<Material*> loaded_materials(materials.size(), nullptr);
+
+    threads.run_range(
+        [this, &local_materials, &shapes, &materials, &loaded_materials, num_shapes](
+            uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+            for (int32_t i = begin; i < end; ++i) {
+                if (i < num_shapes) {
+                    resource_manager_.load<Shape>(shapes[uint32_t(i)]);
+                    continue;
+                }
+
+                uint32_t const m = uint32_t(i - num_shapes);
+
+                std::string const& name = materials[m];
+
+                if (auto const material_node = local_materials.materials.find(name);
+                    local_materials.materials.end() != material_node) {
+                    void const* data = reinterpret_cast<void const*>(material_node->second);
+
+                    loaded_materials[m] = resource_manager_
+                                              .load<Material>(name, data,
+                                                              local_materials.source_name)
+                                              .ptr;
+                } else {
+                    loaded_materials[m] = resource_manager_.load<Material>(name).ptr;
+                }
+            }
+        },
+        0, num_resources, 1);
+
+    // load_material() finds them in the cache, so they are committed here
+    for (auto m : loaded_materials) {
+        if (m) {
+            m->commit(threads, scene);
+        }
+    }
+}
+
+void Loader::collect_resources(json::Value const& entities_value, Resource_names& names) {
+    if (!entities_value.IsArray()) {
+        return;
+    }
+
+    for (auto const& e : entities_value.GetArray()) {
+        // Nested scenes are prefetched when they are loaded
+        if (e.MemberEnd() != e.FindMember("file")) {
+            continue;
+        }
+
+        if (std::string const type = json::read_string(e, "type");
+            "Prop" != type && "Light" != type) {
+            continue;
+        }
+
+        for (auto const& n : e.GetObject()) {
+            if ("shape" == n.name) {
+                // Shapes with a type take precedence in load_shape()
+                if (n.value.MemberEnd() != n.value.FindMember("type")) {
+                    continue;
+                }
+
+                if (std::string const file = json::read_string(n.value, "file"); !file.empty()) {
+                    names.shapes.insert(file);
+                }
+            } else if ("materials" == n.name && n.value.IsArray()) {
+                for (auto const& m : n.value.GetArray()) {
+                    names.materials.insert(m.GetString());
+                }
+            } else if ("entities" == n.name) {
+                collect_resources(n.value, names);
+            }
+        }
+    }
+}
+
 void Loader::load_entities(json::Value const& entities_value, uint32_t parent_id,
                            math::Transformation const& parent_transformation,
                            Local_materials const& local_materials, Scene& scene, Camera* camera) {
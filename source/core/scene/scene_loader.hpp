@@ -5,6 +5,7 @@
 #include "base/memory/array.hpp"
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -87,6 +88,18 @@ class Loader {
     void read_materials(json::Value const& materials_value, std::string const& source_name,
                         Local_materials& local_materials) const;
 
+    struct Resource_names {
+        std::set<std::string> shapes;
+        std::set<std::string> materials;
+    };
+
+    // Loads the shape files and materials used by the entities concurrently, so that the
+    // following sequential pass finds them in the resource caches
+    void prefetch(json::Value const& entities_value, Local_materials const& local_materials,
+                  Scene& scene) const;
+
+    static void collect_resources(json::Value const& entities_value, Resource_names& names);
+
     void load_entities(json::Value const& entities_value, uint32_t parent_id,
                        math::Transformation const& parent_transformation,
                        Local_materials const& local_materials, Scene& scene, Camera* camera);
@@ -77,6 +77,11 @@ class Worker {
 
     bool visibility(Ray const& ray, Filter filter, float3& v);
 
+    // Packets of up to Packet_size coherent rays, see Scene
+    uint32_t intersect(Ray* rays, uint32_t mask, Interpolation ipo, Intersection* isecs);
+
+    uint32_t visibility(Ray const* rays, uint32_t mask, Filter filter, float3* vs);
+
     Scene const& scene() const;
 
     Camera const& camera() const;
@@ -37,6 +37,15 @@ inline bool Worker::visibility(const Ray& ray, Filter filter, float3& v) {
     return scene_->visibility(ray, filter, *this, v);
 }
 
+inline uint32_t Worker::intersect(Ray* rays, uint32_t mask, Interpolation ipo,
+                                  Intersection* isecs) {
+    return scene_->intersect(rays, mask, *this, ipo, isecs);
+}
+
+inline uint32_t Worker::visibility(Ray const* rays, uint32_t mask, Filter filter, float3* vs) {
+    return scene_->visibility(rays, mask, filter, *this, vs);
+}
+
 inline Scene const& Worker::scene() const {
     return *scene_;
 }
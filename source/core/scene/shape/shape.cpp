@@ -2,6 +2,10 @@
 #include "base/math/aabb.inl"
 #include "base/math/matrix3x3.inl"
 #include "base/math/vector3.inl"
+#include "scene/scene_ray.hpp"
+#include "shape_intersection.hpp"
+
+#include <bit>
 
 namespace scene::shape {
 
@@ -29,6 +33,36 @@ uint32_t Shape::part_id_to_material_id(uint32_t part) const {
     return part;
 }
 
+uint32_t Shape::intersect_packet(Ray* rays, uint32_t mask, Transformation const& trafo,
+                                 Worker& worker, Interpolation ipo, Intersection* isecs) const {
+    uint32_t hits = 0;
+
+    for (; 0 != mask; mask &= mask - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(mask));
+
+        if (intersect(rays[i], trafo, worker, ipo, isecs[i])) {
+            hits |= 1u << i;
+        }
+    }
+
+    return hits;
+}
+
+uint32_t Shape::intersect_p_packet(Ray const* rays, uint32_t mask, Transformation const& trafo,
+                                   Worker& worker) const {
+    uint32_t hits = 0;
+
+    for (; 0 != mask; mask &= mask - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(mask));
+
+        if (intersect_p(rays[i], trafo, worker)) {
+            hits |= 1u << i;
+        }
+    }
+
+    return hits;
+}
+
 bool Shape::sample_volume(uint32_t /*part*/, float3_p /*p*/, Transformation const& /*trafo*/,
                           float /*volume*/, Sampler& /*sampler*/, RNG& /*rng*/,
                           uint32_t /*sampler_d*/, Sample_to& /*sample*/) const {
@@ -84,6 +84,16 @@ class Shape {
     virtual bool visibility(Ray const& ray, Transformation const& trafo, uint32_t entity,
                             Filter filter, Worker& worker, float3& v) const = 0;
 
+    // Packets of the rays selected by the bits of mask, which all share trafo.
+    // Return the mask of the rays that hit the shape.
+    // By default the rays are intersected one after another.
+    virtual uint32_t intersect_packet(Ray* rays, uint32_t mask, Transformation const& trafo,
+                                      Worker& worker, Interpolation ipo,
+                                      Intersection* isecs) const;
+
+    virtual uint32_t intersect_p_packet(Ray const* rays, uint32_t mask,
+                                        Transformation const& trafo, Worker& worker) const;
+
     virtual bool sample(uint32_t part, uint32_t variant, float3_p p, float3_p n,
                         Transformation const& trafo, float area, bool two_sided, bool total_sphere,
                         Sampler& sampler, RNG& rng, uint32_t sampler_d,
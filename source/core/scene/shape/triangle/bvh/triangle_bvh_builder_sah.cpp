@@ -13,8 +13,56 @@
 
 namespace scene::shape::triangle::bvh {
 
-Builder_SAH::Builder_SAH(uint32_t num_slices, uint32_t sweep_threshold, uint32_t max_primitives)
-    : Builder_base(num_slices, sweep_threshold, max_primitives) {}
+class Triangle_clipper final : public scene::bvh::Primitive_clipper {
+  public:
+    Triangle_clipper(Index_triangle const* triangles, Vertex_stream const& vertices)
+        : triangles_(triangles), vertices_(vertices) {}
+
+    // Every vertex goes to the side it lies on, and every edge that crosses the plane adds the
+    // crossing point to both sides
+    void split(uint32_t primitive, uint8_t axis, float d, AABB& aabb0, AABB& aabb1) const final {
+        auto const& t = triangles_[primitive];
+
+        float3 const v[3] = {vertices_.p(t.i[0]), vertices_.p(t.i[1]), vertices_.p(t.i[2])};
+
+        aabb0 = Empty_AABB;
+        aabb1 = Empty_AABB;
+
+        for (uint32_t i = 0; i < 3; ++i) {
+            float3 const p = v[i];
+            float3 const q = v[2 == i ? 0 : i + 1];
+
+            float const pa = p[axis];
+            float const qa = q[axis];
+
+            if (pa <= d) {
+                aabb0.insert(p);
+            }
+
+            if (pa >= d) {
+                aabb1.insert(p);
+            }
+
+            if ((pa < d && qa > d) || (pa > d && qa < d)) {
+                float3 x = lerp(p, q, (d - pa) / (qa - pa));
+                x[axis]  = d;
+
+                aabb0.insert(x);
+                aabb1.insert(x);
+            }
+        }
+    }
+
+  private:
+    Index_triangle const* triangles_;
+
+    Vertex_stream const& vertices_;
+};
+
+Builder_SAH::Builder_SAH(uint32_t num_slices, uint32_t sweep_threshold, uint32_t max_primitives,
+                         float spatial_split_budget)
+    : Builder_base(num_slices, sweep_threshold, max_primitives),
+      spatial_split_budget_(spatial_split_budget) {}
 
 Builder_SAH::~Builder_SAH() = default;
 
@@ -25,7 +73,7 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
     {
         References references(num_triangles);
 
-        memory::Array<Simd_AABB> aabbs(threads.num_threads());
+        memory::Array<Simd_AABB> aabbs(threads.num_threads(), Simd_AABB(Empty_AABB));
 
         threads.run_range(
             [&triangles, &vertices, &references, &aabbs](uint32_t id, int32_t begin,
@@ -46,7 +94,7 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
                     aabb.merge_assign(min, max);
                 }
 
-                aabbs[id] = aabb;
+                aabbs[id].merge_assign(aabb);
             },
             0, int32_t(num_triangles));
 
@@ -55,7 +103,19 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
             aabb.merge_assign(b);
         }
 
+        Triangle_clipper const clipper(triangles, vertices);
+
+        if (spatial_split_budget_ > 0.f) {
+            settings_.clipper_ = &clipper;
+
+            settings_.max_duplicates_ = uint32_t(spatial_split_budget_ * float(num_triangles));
+        }
+
         split(references, AABB(aabb), threads);
+
+        settings_.clipper_ = nullptr;
+
+        settings_.max_duplicates_ = 0xFFFFFFFF;
     }
 
     tree.allocate_triangles(uint32_t(reference_ids_.size()), 1, vertices);
@@ -64,6 +124,10 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
     uint32_t current_triangle = 0;
     new_node();
     serialize(0, 0, triangles, vertices, tree, current_triangle);
+
+    tree.collapse();
+
+    tree.build_sah_ = sah(tree);
 }
 
 void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles, Vertices vertices,
@@ -73,7 +137,7 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
     {
         References references(num_triangles);
 
-        memory::Array<Simd_AABB> aabbs(threads.num_threads());
+        memory::Array<Simd_AABB> aabbs(threads.num_threads(), Simd_AABB(Empty_AABB));
 
         threads.run_range(
             [&triangles, &vertices, num_frames, &references, &aabbs](uint32_t id, int32_t begin,
@@ -106,7 +170,7 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
                     aabb.merge_assign(min, max);
                 }
 
-                aabbs[id] = aabb;
+                aabbs[id].merge_assign(aabb);
             },
             0, int32_t(num_triangles));
 
@@ -124,6 +188,100 @@ void Builder_SAH::build(Tree& tree, uint32_t num_triangles, Triangles triangles,
     uint32_t current_triangle = 0;
     new_node();
     serialize(0, 0, triangles, vertices, tree, current_triangle);
+
+    tree.collapse();
+
+    tree.build_sah_ = sah(tree);
+}
+
+bool Builder_SAH::refit(Tree& tree, Vertices vertices, uint32_t num_frames,
+                        Threads& threads) const {
+    Indexed_data& data = tree.data_;
+
+    if (0 == tree.num_nodes_ || vertices.num_vertices() != data.num_vertices_ ||
+        num_frames != data.num_frames_) {
+        return false;
+    }
+
+    // Same sizes, so this only copies the moved vertices into the existing arrays
+    data.allocate_triangles(data.num_triangles_, num_frames, vertices);
+
+    uint32_t const num_vertices = data.num_vertices_;
+
+    Node* nodes = tree.nodes_;
+
+    threads.run_range(
+        [nodes, &data, num_vertices, num_frames](uint32_t /*id*/, int32_t begin,
+                                                 int32_t end) noexcept {
+            for (int32_t i = begin; i < end; ++i) {
+                Node& n = nodes[i];
+
+                if (0 == n.num_indices()) {
+                    continue;
+                }
+
+                Simdf min = Simdf(float3(std::numeric_limits<float>::max()));
+                Simdf max = Simdf(float3(-std::numeric_limits<float>::max()));
+
+                for (uint32_t p = n.indices_start(), len = n.indices_end(); p < len; ++p) {
+                    auto const& t = data.triangles_[p];
+
+                    for (uint32_t j = 0; j < num_frames; ++j) {
+                        uint32_t const offset = j * num_vertices;
+
+                        auto const a = Simdf(data.positions_[t.a + offset]);
+                        auto const b = Simdf(data.positions_[t.b + offset]);
+                        auto const c = Simdf(data.positions_[t.c + offset]);
+
+                        min = math::min(min, triangle_min(a, b, c));
+                        max = math::max(max, triangle_max(a, b, c));
+                    }
+                }
+
+                n.set_aabb(AABB(min, max));
+            }
+        },
+        0, int32_t(tree.num_nodes_));
+
+    // Children are always serialized after their parent,
+    // so a single backwards pass visits them in the correct order
+    for (uint32_t i = tree.num_nodes_; i > 0; --i) {
+        Node& n = nodes[i - 1];
+
+        if (0 == n.num_indices()) {
+            uint32_t const c = n.children();
+
+            n.set_aabb(nodes[c].aabb().merge(nodes[c + 1].aabb()));
+        }
+    }
+
+    tree.collapse();
+
+    return true;
+}
+
+float Builder_SAH::sah(Tree const& tree) {
+    if (0 == tree.num_nodes_) {
+        return 0.f;
+    }
+
+    float const root_area = tree.nodes_[0].aabb().surface_area();
+
+    if (root_area <= 0.f) {
+        return 0.f;
+    }
+
+    float cost = 0.f;
+
+    for (uint32_t i = 0, len = tree.num_nodes_; i < len; ++i) {
+        Node const& n = tree.nodes_[i];
+
+        uint32_t const num_indices = n.num_indices();
+
+        cost += n.aabb().surface_area() * float(0 == num_indices ? 1 : num_indices);
+    }
+
+    return cost / root_area;
 }
 
 void Builder_SAH::serialize(uint32_t source_node, uint32_t dest_node, Triangles triangles,
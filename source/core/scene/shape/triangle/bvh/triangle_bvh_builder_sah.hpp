@@ -30,7 +30,10 @@ namespace bvh {
 
 class Builder_SAH final : private scene::bvh::Builder_base {
   public:
-    Builder_SAH(uint32_t num_slices, uint32_t sweep_threshold, uint32_t max_primitives);
+    // A spatial_split_budget above 0 lets spatial splits clip the triangles themselves.
+    // They may then add at most this fraction of the number of triangles as extra references.
+    Builder_SAH(uint32_t num_slices, uint32_t sweep_threshold, uint32_t max_primitives,
+                float spatial_split_budget);
 
     ~Builder_SAH();
 
@@ -43,6 +46,14 @@ class Builder_SAH final : private scene::bvh::Builder_base {
     void build(Tree& tree, uint32_t num_triangles, Triangles triangles, Vertices vertices,
                uint32_t num_frames, Threads& threads);
 
+    // Recomputes the node bounds of a tree that was built from the same triangles, from moved
+    // vertices, while keeping its topology. Returns false without touching the tree if the
+    // number of vertices differs.
+    bool refit(Tree& tree, Vertices vertices, uint32_t num_frames, Threads& threads) const;
+
+    // Surface area heuristic of the whole tree, relative to the surface area of the root
+    static float sah(Tree const& tree);
+
   private:
     using Node       = scene::bvh::Node;
     using Reference  = scene::bvh::Reference;
@@ -50,6 +61,8 @@ class Builder_SAH final : private scene::bvh::Builder_base {
 
     void serialize(uint32_t source_node, uint32_t dest_node, Triangles triangles, Vertices vertices,
                    Tree& tree, uint32_t& current_triangle);
+
+    float const spatial_split_budget_;
 };
 
 }  // namespace bvh
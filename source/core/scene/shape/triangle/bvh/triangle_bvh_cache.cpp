@@ -0,0 +1,199 @@
+#include "triangle_bvh_cache.hpp"
+#include "base/math/vector3.inl"
+#include "file/file_mapping.hpp"
+#include "scene/bvh/scene_bvh_node.hpp"
+#include "triangle_bvh_indexed_data.inl"
+#include "triangle_bvh_tree.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace scene::shape::triangle::bvh {
+
+static uint32_t constexpr Version = 1;
+
+static uint64_t constexpr Section_alignment = 64;
+
+struct Header {
+    char     magic[4];
+    uint32_t version;
+
+    uint64_t key;
+
+    int64_t source_last_write;
+
+    uint32_t num_nodes;
+    uint32_t num_parts;
+    uint32_t num_triangles;
+    uint32_t num_vertices;
+
+    uint64_t nodes_offset;
+    uint64_t triangles_offset;
+    uint64_t positions_offset;
+    uint64_t frames_offset;
+    uint64_t uvs_offset;
+    uint64_t file_size;
+};
+
+static char const Magic[4] = {'S', 'U', 'B', 'V'};
+
+using Node           = scene::bvh::Node;
+using Index_triangle = Indexed_data::Index_triangle;
+
+static uint64_t align(uint64_t offset) {
+    return (offset + Section_alignment - 1) & ~(Section_alignment - 1);
+}
+
+static void layout(Header& header) {
+    uint64_t const nv = header.num_vertices;
+
+    header.nodes_offset     = align(sizeof(Header));
+    header.triangles_offset = align(header.nodes_offset + header.num_nodes * sizeof(Node));
+    header.positions_offset = align(header.triangles_offset +
+                                    header.num_triangles * sizeof(Index_triangle));
+    header.frames_offset    = align(header.positions_offset + nv * sizeof(float3));
+    header.uvs_offset       = align(header.frames_offset + nv * sizeof(float4));
+    header.file_size        = header.uvs_offset + nv * sizeof(float2);
+}
+
+bool Cache::read(std::string const& name, uint64_t key, int64_t source_last_write, Tree& tree) {
+    file::Mapping mapping;
+    if (!mapping.open(name) || mapping.size() < sizeof(Header)) {
+        return false;
+    }
+
+    char* const data = mapping.data();
+
+    Header const& header = *reinterpret_cast<Header const*>(data);
+
+    if (0 != std::memcmp(header.magic, Magic, sizeof(Magic)) || Version != header.version ||
+        key != header.key || source_last_write != header.source_last_write) {
+        return false;
+    }
+
+    // Guard against truncated files and foreign layouts
+    Header expected = header;
+    layout(expected);
+
+    if (expected.file_size != header.file_size || mapping.size() < header.file_size ||
+        0 != std::memcmp(&expected, &header, sizeof(Header)) || 0 == header.num_nodes) {
+        return false;
+    }
+
+    tree.unmap();
+
+    delete[] tree.nodes_;
+
+    tree.num_nodes_ = header.num_nodes;
+    tree.num_parts_ = header.num_parts;
+    tree.nodes_     = reinterpret_cast<Node*>(data + header.nodes_offset);
+
+    Indexed_data& d = tree.data_;
+
+    d.release();
+
+    d.num_triangles_ = header.num_triangles;
+    d.num_vertices_  = header.num_vertices;
+    d.num_frames_    = 1;
+    d.triangles_     = reinterpret_cast<Index_triangle*>(data + header.triangles_offset);
+    d.positions_     = reinterpret_cast<float3*>(data + header.positions_offset);
+    d.frames_        = reinterpret_cast<float4*>(data + header.frames_offset);
+    d.uvs_           = reinterpret_cast<float2*>(data + header.uvs_offset);
+    d.external_      = true;
+
+    tree.mapping_ = std::move(mapping);
+
+    tree.collapse();
+
+    return true;
+}
+
+bool Cache::write(std::string const& name, uint64_t key, int64_t source_last_write,
+                  Tree const& tree) {
+    Indexed_data const& d = tree.data_;
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+
+    header.version           = Version;
+    header.key               = key;
+    header.source_last_write = source_last_write;
+    header.num_nodes         = tree.num_nodes_;
+    header.num_parts         = tree.num_parts_;
+    header.num_triangles     = d.num_triangles_;
+    header.num_vertices      = d.num_vertices_;
+
+    layout(header);
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(name).parent_path(), ec);
+
+    // Write to a temporary file first, so that a concurrent reader never sees a partial entry.
+    // Its name is unique, because several processes can share one cache directory.
+    std::random_device random;
+
+    uint64_t const suffix = (uint64_t(random()) << 32) | uint64_t(random());
+
+    std::string const temp_name = name + "." + std::to_string(suffix) + ".tmp";
+
+    {
+        std::ofstream stream(temp_name, std::ios::binary);
+        if (!stream) {
+            return false;
+        }
+
+        auto write_section = [&stream](uint64_t offset, void const* section, uint64_t size) {
+            static char const zeros[Section_alignment] = {};
+
+            uint64_t const current = uint64_t(stream.tellp());
+            stream.write(zeros, std::streamsize(offset - current));
+            stream.write(static_cast<char const*>(section), std::streamsize(size));
+        };
+
+        uint64_t const nv = header.num_vertices;
+
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(Header));
+
+        write_section(header.nodes_offset, tree.nodes_, header.num_nodes * sizeof(Node));
+        write_section(header.triangles_offset, d.triangles_,
+                      header.num_triangles * sizeof(Index_triangle));
+        write_section(header.positions_offset, d.positions_, nv * sizeof(float3));
+        write_section(header.frames_offset, d.frames_, nv * sizeof(float4));
+        write_section(header.uvs_offset, d.uvs_, nv * sizeof(float2));
+
+        if (!stream) {
+            stream.close();
+            std::filesystem::remove(temp_name, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_name, name, ec);
+
+    if (ec) {
+        std::filesystem::remove(temp_name, ec);
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t Cache::hash(void const* data, uint64_t size, uint64_t seed) {
+    // FNV-1a
+    uint8_t const* bytes = static_cast<uint8_t const*>(data);
+
+    uint64_t h = seed;
+
+    for (uint64_t i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 0x100000001b3ull;
+    }
+
+    return h;
+}
+
+}  // namespace scene::shape::triangle::bvh
@@ -0,0 +1,29 @@
+#ifndef SU_CORE_SCENE_SHAPE_TRIANGLE_BVH_CACHE_HPP
+#define SU_CORE_SCENE_SHAPE_TRIANGLE_BVH_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace scene::shape::triangle::bvh {
+
+class Tree;
+
+// Stores finished trees on disk, so that later runs can map them instead of building them again.
+// An entry is only used if the key (source header, builder parameters, vertex layout)
+// and the last write time of the source file both match.
+class Cache {
+  public:
+    static bool read(std::string const& name, uint64_t key, int64_t source_last_write,
+                     Tree& tree);
+
+    static bool write(std::string const& name, uint64_t key, int64_t source_last_write,
+                      Tree const& tree);
+
+    static uint64_t hash(void const* data, uint64_t size, uint64_t seed = Hash_seed);
+
+    static uint64_t constexpr Hash_seed = 0xcbf29ce484222325ull;
+};
+
+}  // namespace scene::shape::triangle::bvh
+
+#endif
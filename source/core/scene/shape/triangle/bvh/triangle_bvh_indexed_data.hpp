@@ -79,8 +79,13 @@ class Indexed_data {
     };
 
   private:
+    void release();
+
     uint32_t num_triangles_;
+
+    // Per frame
     uint32_t num_vertices_;
+    uint32_t num_frames_;
 
     Index_triangle* triangles_;
 
@@ -89,6 +94,13 @@ class Indexed_data {
     float4* frames_;
 
     float2* uvs_;
+
+    // The arrays are owned by someone else, e.g. a mapped cache file
+    bool external_;
+
+    friend class Builder_SAH;
+    friend class Cache;
+    friend class Tree;
 };
 
 }  // namespace triangle::bvh
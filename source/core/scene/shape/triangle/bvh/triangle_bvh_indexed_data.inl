@@ -14,16 +14,15 @@ namespace scene::shape::triangle::bvh {
 inline Indexed_data::Indexed_data()
     : num_triangles_(0),
       num_vertices_(0),
+      num_frames_(0),
       triangles_(nullptr),
       positions_(nullptr),
       frames_(nullptr),
-      uvs_(nullptr) {}
+      uvs_(nullptr),
+      external_(false) {}
 
 inline Indexed_data::~Indexed_data() {
-    delete[] uvs_;
-    delete[] frames_;
-    delete[] positions_;
-    delete[] triangles_;
+    release();
 }
 
 inline uint32_t Indexed_data::num_triangles() const {
@@ -376,14 +375,13 @@ inline void Indexed_data::allocate_triangles(uint32_t num_triangles, uint32_t nu
     uint32_t const num_vertices       = vertices.num_vertices();
     uint32_t const num_total_vertices = num_frames * num_vertices;
 
-    if (num_triangles != num_triangles_ || num_vertices != num_vertices_) {
+    if (num_triangles != num_triangles_ || num_vertices != num_vertices_ ||
+        num_frames != num_frames_) {
+        release();
+
         num_triangles_ = num_triangles;
         num_vertices_  = num_vertices;
-
-        delete[] uvs_;
-        delete[] frames_;
-        delete[] positions_;
-        delete[] triangles_;
+        num_frames_    = num_frames;
 
         triangles_ = new Index_triangle[num_triangles];
         positions_ = new float3[num_total_vertices];
@@ -400,6 +398,26 @@ inline void Indexed_data::allocate_triangles(uint32_t num_triangles, uint32_t nu
     }
 }
 
+inline void Indexed_data::release() {
+    if (!external_) {
+        delete[] uvs_;
+        delete[] frames_;
+        delete[] positions_;
+        delete[] triangles_;
+    }
+
+    num_triangles_ = 0;
+    num_vertices_  = 0;
+    num_frames_    = 0;
+
+    triangles_ = nullptr;
+    positions_ = nullptr;
+    frames_    = nullptr;
+    uvs_       = nullptr;
+
+    external_ = false;
+}
+
 inline void Indexed_data::set_triangle(uint32_t a, uint32_t b, uint32_t c, uint32_t part,
                                        Vertex_stream const& vertices, uint32_t triangle_id) {
     bool const abts = vertices.bitangent_sign(a);
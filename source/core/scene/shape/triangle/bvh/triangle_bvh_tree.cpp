@@ -3,6 +3,8 @@
 #include "base/math/ray.inl"
 #include "base/math/vector3.inl"
 #include "scene/bvh/scene_bvh_node.inl"
+#include "scene/bvh/scene_bvh_node4.inl"
+#include "scene/bvh/scene_bvh_ray_packet.inl"
 #include "scene/material/material.hpp"
 #include "scene/material/material.inl"
 #include "scene/scene.inl"
@@ -11,15 +13,38 @@
 #include "scene/shape/shape_intersection.hpp"
 #include "triangle_bvh_indexed_data.inl"
 
+#ifdef SU_SIMD_LEAVES
+#include "scene/shape/triangle/triangle_primitive_mt.inl"
+#endif
+
+#include <bit>
+
+#ifdef SU_WIDE_BVH
+#include <vector>
+#endif
+
 namespace scene::shape::triangle::bvh {
 
 Tree::Tree() : num_nodes_(0), num_parts_(0), nodes_(nullptr) {}
 
 Tree::~Tree() {
+    unmap();
+
+#ifdef SU_SIMD_LEAVES
+    delete[] leaf_indices_;
+    delete[] leaf_triangles_;
+#endif
+
+#ifdef SU_WIDE_BVH
+    delete[] wide_nodes_;
+#endif
+
     delete[] nodes_;
 }
 
 scene::bvh::Node* Tree::allocate_nodes(uint32_t num_nodes) {
+    unmap();
+
     if (num_nodes != num_nodes_) {
         num_nodes_ = num_nodes;
 
@@ -30,6 +55,277 @@ scene::bvh::Node* Tree::allocate_nodes(uint32_t num_nodes) {
     return nodes_;
 }
 
+void Tree::unmap() {
+    if (!mapping_.is_open()) {
+        return;
+    }
+
+    num_nodes_ = 0;
+    nodes_     = nullptr;
+
+    data_.release();
+
+    mapping_.close();
+}
+
+#ifdef SU_WIDE_BVH
+
+// Opens the interior child with the largest surface area, until the four slots are used up
+static uint32_t collapse_node(scene::bvh::Node const* nodes, uint32_t source,
+                              std::vector<scene::bvh::Node4>& wide_nodes) {
+    uint32_t const id = uint32_t(wide_nodes.size());
+
+    wide_nodes.emplace_back();
+    wide_nodes[id].clear();
+
+    uint32_t children[4];
+    uint32_t num_children;
+
+    if (0 == nodes[source].num_indices()) {
+        children[0] = nodes[source].children();
+        children[1] = children[0] + 1;
+
+        num_children = 2;
+
+        while (num_children < 4) {
+            uint32_t best = 4;
+
+            float best_area = -1.f;
+
+            for (uint32_t i = 0; i < num_children; ++i) {
+                auto const& n = nodes[children[i]];
+
+                if (0 == n.num_indices()) {
+                    if (float const area = n.aabb().surface_area(); area > best_area) {
+                        best      = i;
+                        best_area = area;
+                    }
+                }
+            }
+
+            if (4 == best) {
+                break;
+            }
+
+            uint32_t const c = nodes[children[best]].children();
+
+            children[best]           = c;
+            children[num_children++] = c + 1;
+        }
+    } else {
+        children[0] = source;
+
+        num_children = 1;
+    }
+
+    for (uint32_t i = 0; i < num_children; ++i) {
+        auto const& n = nodes[children[i]];
+
+        if (0 == n.num_indices()) {
+            uint32_t const child = collapse_node(nodes, children[i], wide_nodes);
+
+            wide_nodes[id].set_split_child(i, n.aabb(), child);
+        } else {
+            wide_nodes[id].set_leaf_child(i, n.aabb(), n.indices_start(), n.num_indices());
+        }
+    }
+
+    return id;
+}
+
+void Tree::collapse() {
+    std::vector<scene::bvh::Node4> wide_nodes;
+
+    if (num_nodes_ > 0) {
+        wide_nodes.reserve(num_nodes_ / 3 + 1);
+
+        collapse_node(nodes_, 0, wide_nodes);
+    }
+
+    uint32_t const num_wide_nodes = uint32_t(wide_nodes.size());
+
+    if (num_wide_nodes != num_wide_nodes_) {
+        num_wide_nodes_ = num_wide_nodes;
+
+        delete[] wide_nodes_;
+        wide_nodes_ = new scene::bvh::Node4[num_wide_nodes];
+    }
+
+    std::copy(wide_nodes.begin(), wide_nodes.end(), wide_nodes_);
+
+#ifdef SU_SIMD_LEAVES
+    gather_leaves();
+#endif
+}
+
+#ifdef SU_SIMD_LEAVES
+
+void Tree::gather_leaves() {
+    uint32_t num_blocks = 0;
+
+    for (uint32_t n = 0, len = num_wide_nodes_; n < len; ++n) {
+        auto const& node = wide_nodes_[n];
+
+        for (uint32_t s = 0, num_children = node.num_children(); s < num_children; ++s) {
+            num_blocks += (uint32_t(node.num_indices(s)) + 3) / 4;
+        }
+    }
+
+    if (num_blocks != num_leaf_blocks_) {
+        num_leaf_blocks_ = num_blocks;
+
+        delete[] leaf_indices_;
+        delete[] leaf_triangles_;
+
+        leaf_triangles_ = new Triangle_MT4[num_blocks];
+        leaf_indices_   = new uint32_t[4 * num_blocks];
+    }
+
+    uint32_t current = 0;
+
+    for (uint32_t n = 0, len = num_wide_nodes_; n < len; ++n) {
+        auto& node = wide_nodes_[n];
+
+        for (uint32_t s = 0, num_children = node.num_children(); s < num_children; ++s) {
+            if (0 == node.num_indices(s)) {
+                continue;
+            }
+
+            uint32_t const begin_block = current;
+
+            for (uint32_t i = node.indices_start(s), end = node.indices_end(s); i < end;
+                 i += 4, ++current) {
+                auto& block = leaf_triangles_[current];
+
+                block.clear();
+
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    uint32_t const t = i + lane;
+
+                    if (t < end) {
+                        float3 a;
+                        float3 b;
+                        float3 c;
+                        data_.triangle(t, a, b, c);
+
+                        block.set(lane, a, b, c);
+
+                        leaf_indices_[4 * current + lane] = t;
+                    } else {
+                        leaf_indices_[4 * current + lane] = 0xFFFFFFFF;
+                    }
+                }
+            }
+
+            node.set_leaf_child(s, node.aabb(s), begin_block, uint8_t(current - begin_block));
+        }
+    }
+}
+
+void Tree::triangle_range(uint32_t begin_block, uint32_t end_block, uint32_t& begin,
+                          uint32_t& end) const {
+    uint32_t const* last = leaf_indices_ + 4 * (end_block - 1);
+
+    uint32_t lane = 3;
+    for (; 0xFFFFFFFF == last[lane]; --lane) {
+    }
+
+    begin = leaf_indices_[4 * begin_block];
+    end   = last[lane] + 1;
+}
+
+#endif
+
+template <typename Leaf>
+bool Tree::traverse(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
+                    scalar const& ray_max_t, Node_stack& nodes, Leaf leaf) const {
+    if (0 == num_wide_nodes_) {
+        return false;
+    }
+
+    Simdf const ray_inv_direction = reciprocal3(ray_direction);
+
+    Simdf const origin[3] = {ray_origin.splat_x(), ray_origin.splat_y(), ray_origin.splat_z()};
+
+    Simdf const inv_direction[3] = {ray_inv_direction.splat_x(), ray_inv_direction.splat_y(),
+                                    ray_inv_direction.splat_z()};
+
+    nodes.push(0xFFFFFFFF);
+    uint32_t n = 0;
+
+    while (0xFFFFFFFF != n) {
+        auto const& node = wide_nodes_[n];
+
+        alignas(16) float distances[4];
+
+        uint32_t const hits = node.intersect_p(origin, inv_direction, ray_min_t, ray_max_t,
+                                               distances);
+
+        // Interior children sorted from far to near
+        uint32_t interior[4];
+        float    interior_distances[4];
+        uint32_t num_interior = 0;
+
+        for (uint32_t mask = hits; 0 != mask; mask &= mask - 1) {
+            uint32_t const slot = uint32_t(std::countr_zero(mask));
+
+            if (0 == node.num_indices(slot)) {
+                float const d = distances[slot];
+
+                uint32_t j = num_interior;
+                for (; j > 0 && interior_distances[j - 1] < d; --j) {
+                    interior[j]           = interior[j - 1];
+                    interior_distances[j] = interior_distances[j - 1];
+                }
+
+                interior[j]           = node.children(slot);
+                interior_distances[j] = d;
+
+                ++num_interior;
+            } else if (leaf(node.indices_start(slot), node.indices_end(slot))) {
+                // The stack is shared with the traversal of the scene
+                while (0xFFFFFFFF != nodes.pop()) {
+                }
+
+                return true;
+            }
+        }
+
+        if (0 == num_interior) {
+            n = nodes.pop();
+            continue;
+        }
+
+        for (uint32_t i = 0, len = num_interior - 1; i < len; ++i) {
+            nodes.push(interior[i]);
+        }
+
+        n = interior[num_interior - 1];
+    }
+
+    return false;
+}
+
+#else
+
+void Tree::collapse() {}
+
+#endif
+
+size_t Tree::num_bytes() const {
+    size_t num_bytes = size_t(num_nodes_) * sizeof(Node);
+
+#ifdef SU_WIDE_BVH
+    num_bytes += size_t(num_wide_nodes_) * sizeof(scene::bvh::Node4);
+#endif
+
+#ifdef SU_SIMD_LEAVES
+    num_bytes += size_t(num_leaf_blocks_) * (sizeof(Triangle_MT4) + 4 * sizeof(uint32_t));
+#endif
+
+    return num_bytes;
+}
+
 AABB Tree::aabb() const {
     if (nodes_) {
         return AABB(float3(nodes_[0].min()), float3(nodes_[0].max()));
@@ -40,6 +336,50 @@ AABB Tree::aabb() const {
 
 bool Tree::intersect(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                      scalar& ray_max_t, Node_stack& nodes, Intersection& isec) const {
+#ifdef SU_WIDE_BVH
+    uint32_t index = 0xFFFFFFFF;
+
+    scalar u;
+    scalar v;
+
+#ifdef SU_SIMD_LEAVES
+    Simdf const origin[3] = {ray_origin.splat_x(), ray_origin.splat_y(), ray_origin.splat_z()};
+
+    Simdf const direction[3] = {ray_direction.splat_x(), ray_direction.splat_y(),
+                                ray_direction.splat_z()};
+
+    traverse(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes,
+             [&](uint32_t begin, uint32_t end) {
+                 for (uint32_t b = begin; b < end; ++b) {
+                     if (uint32_t lane; triangle::intersect(origin, direction, ray_min_t,
+                                                            ray_max_t, leaf_triangles_[b], u, v,
+                                                            lane)) {
+                         index = leaf_indices_[4 * b + lane];
+                     }
+                 }
+
+                 return false;
+             });
+#else
+    traverse(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes,
+             [&](uint32_t begin, uint32_t end) {
+                 for (uint32_t i = begin; i < end; ++i) {
+                     if (data_.intersect(ray_origin, ray_direction, ray_min_t, ray_max_t, i, u,
+                                         v)) {
+                         index = i;
+                     }
+                 }
+
+                 return false;
+             });
+#endif
+
+    isec.u     = Simdf(u);
+    isec.v     = Simdf(v);
+    isec.index = index;
+
+    return index != 0xFFFFFFFF;
+#else
     Simdf const ray_inv_direction = reciprocal3(ray_direction);
 
     alignas(16) uint32_t ray_signs[4];
@@ -87,11 +427,39 @@ bool Tree::intersect(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min
     isec.index = index;
 
     return index != 0xFFFFFFFF;
+#endif
 }
 
 bool Tree::intersect(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                      scalar& ray_max_t, uint32_t frame, Simdf_p weight, Node_stack& nodes,
                      Intersection& isec) const {
+#ifdef SU_WIDE_BVH
+    uint32_t index = 0xFFFFFFFF;
+
+    scalar u;
+    scalar v;
+
+    traverse(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes,
+             [&](uint32_t begin, uint32_t end) {
+#ifdef SU_SIMD_LEAVES
+                 triangle_range(begin, end, begin, end);
+#endif
+                 for (uint32_t i = begin; i < end; ++i) {
+                     if (data_.intersect(ray_origin, ray_direction, ray_min_t, ray_max_t, i,
+                                         frame, weight, u, v)) {
+                         index = i;
+                     }
+                 }
+
+                 return false;
+             });
+
+    isec.u     = Simdf(u);
+    isec.v     = Simdf(v);
+    isec.index = index;
+
+    return index != 0xFFFFFFFF;
+#else
     Simdf const ray_inv_direction = reciprocal3(ray_direction);
 
     alignas(16) uint32_t ray_signs[4];
@@ -140,10 +508,41 @@ bool Tree::intersect(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min
     isec.index = index;
 
     return index != 0xFFFFFFFF;
+#endif
 }
 
 bool Tree::intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                        scalar_p ray_max_t, Node_stack& nodes) const {
+#ifdef SU_SIMD_LEAVES
+    Simdf const origin[3] = {ray_origin.splat_x(), ray_origin.splat_y(), ray_origin.splat_z()};
+
+    Simdf const direction[3] = {ray_direction.splat_x(), ray_direction.splat_y(),
+                                ray_direction.splat_z()};
+
+    return traverse(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes,
+                    [&](uint32_t begin, uint32_t end) {
+                        for (uint32_t b = begin; b < end; ++b) {
+                            if (triangle::intersect_p(origin, direction, ray_min_t, ray_max_t,
+                                                      leaf_triangles_[b])) {
+                                return true;
+                            }
+                        }
+
+                        return false;
+                    });
+#elif defined(SU_WIDE_BVH)
+    return traverse(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes,
+                    [&](uint32_t begin, uint32_t end) {
+                        for (uint32_t i = begin; i < end; ++i) {
+                            if (data_.intersect_p(ray_origin, ray_direction, ray_min_t,
+                                                  ray_max_t, i)) {
+                                return true;
+                            }
+                        }
+
+                        return false;
+                    });
+#else
     Simdf const ray_inv_direction = reciprocal3(ray_direction);
 
     alignas(16) uint32_t ray_signs[4];
@@ -173,6 +572,10 @@ bool Tree::intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_m
 
             for (uint32_t i = node.indices_start(), len = node.indices_end(); i < len; ++i) {
                 if (data_.intersect_p(ray_origin, ray_direction, ray_min_t, ray_max_t, i)) {
+                    // The stack is shared with the traversal of the scene
+                    while (0xFFFFFFFF != nodes.pop()) {
+                    }
+
                     return true;
                 }
             }
@@ -182,11 +585,28 @@ bool Tree::intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_m
     }
 
     return false;
+#endif
 }
 
 bool Tree::intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                        scalar_p ray_max_t, uint32_t frame, Simdf_p weight,
                        Node_stack& nodes) const {
+#ifdef SU_WIDE_BVH
+    return traverse(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes,
+                    [&](uint32_t begin, uint32_t end) {
+#ifdef SU_SIMD_LEAVES
+                        triangle_range(begin, end, begin, end);
+#endif
+                        for (uint32_t i = begin; i < end; ++i) {
+                            if (data_.intersect_p(ray_origin, ray_direction, ray_min_t,
+                                                  ray_max_t, i, frame, weight)) {
+                                return true;
+                            }
+                        }
+
+                        return false;
+                    });
+#else
     Simdf const ray_inv_direction = reciprocal3(ray_direction);
 
     alignas(16) uint32_t ray_signs[4];
@@ -217,6 +637,10 @@ bool Tree::intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_m
             for (uint32_t i = node.indices_start(), len = node.indices_end(); i < len; ++i) {
                 if (data_.intersect_p(ray_origin, ray_direction, ray_min_t, ray_max_t, i, frame,
                                       weight)) {
+                    // The stack is shared with the traversal of the scene
+                    while (0xFFFFFFFF != nodes.pop()) {
+                    }
+
                     return true;
                 }
             }
@@ -226,11 +650,233 @@ bool Tree::intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_m
     }
 
     return false;
+#endif
+}
+
+// Packets always traverse the binary nodes, whose leaves refer directly to the triangles.
+// A node is visited if any ray of the packet hits it, in the order given by the first ray.
+
+uint32_t Tree::intersect(Ray_packet& rays, uint32_t mask, Node_stack& nodes,
+                         Intersection* isecs) const {
+    if (0 == num_nodes_ || 0 == mask) {
+        return 0;
+    }
+
+    alignas(16) uint32_t ray_signs[4];
+    rays.signs(uint32_t(std::countr_zero(mask)), ray_signs);
+
+    nodes.push(0xFFFFFFFF);
+    uint32_t n = 0;
+
+    uint32_t hits = 0;
+
+    while (0xFFFFFFFF != n) {
+        auto const& node = nodes_[n];
+
+        if (uint32_t const active = node.intersect_p(rays, mask); 0 != active) {
+            if (0 == node.num_indices()) {
+                uint32_t const a = node.children();
+                uint32_t const b = a + 1;
+
+                if (0 == ray_signs[node.axis()]) {
+                    nodes.push(b);
+                    n = a;
+                } else {
+                    nodes.push(a);
+                    n = b;
+                }
+
+                continue;
+            }
+
+            for (uint32_t i = node.indices_start(), len = node.indices_end(); i < len; ++i) {
+                for (uint32_t m = active; 0 != m; m &= m - 1) {
+                    uint32_t const r = uint32_t(std::countr_zero(m));
+
+                    scalar const ray_min_t(rays.min_t[r]);
+                    scalar       ray_max_t(rays.max_t[r]);
+
+                    scalar u;
+                    scalar v;
+
+                    if (data_.intersect(rays.origins[r], rays.directions[r], ray_min_t, ray_max_t,
+                                        i, u, v)) {
+                        rays.max_t[r] = ray_max_t.x();
+
+                        isecs[r].u     = Simdf(u);
+                        isecs[r].v     = Simdf(v);
+                        isecs[r].index = i;
+
+                        hits |= 1u << r;
+                    }
+                }
+            }
+        }
+
+        n = nodes.pop();
+    }
+
+    return hits;
+}
+
+uint32_t Tree::intersect_p(Ray_packet const& rays, uint32_t mask, Node_stack& nodes) const {
+    if (0 == num_nodes_ || 0 == mask) {
+        return 0;
+    }
+
+    alignas(16) uint32_t ray_signs[4];
+    rays.signs(uint32_t(std::countr_zero(mask)), ray_signs);
+
+    nodes.push(0xFFFFFFFF);
+    uint32_t n = 0;
+
+    uint32_t hits = 0;
+
+    while (0xFFFFFFFF != n) {
+        auto const& node = nodes_[n];
+
+        if (uint32_t const active = node.intersect_p(rays, mask & ~hits); 0 != active) {
+            if (0 == node.num_indices()) {
+                uint32_t const a = node.children();
+                uint32_t const b = a + 1;
+
+                if (0 == ray_signs[node.axis()]) {
+                    nodes.push(b);
+                    n = a;
+                } else {
+                    nodes.push(a);
+                    n = b;
+                }
+
+                continue;
+            }
+
+            for (uint32_t m = active; 0 != m; m &= m - 1) {
+                uint32_t const r = uint32_t(std::countr_zero(m));
+
+                scalar const ray_min_t(rays.min_t[r]);
+                scalar const ray_max_t(rays.max_t[r]);
+
+                for (uint32_t i = node.indices_start(), len = node.indices_end(); i < len; ++i) {
+                    if (data_.intersect_p(rays.origins[r], rays.directions[r], ray_min_t,
+                                          ray_max_t, i)) {
+                        hits |= 1u << r;
+                        break;
+                    }
+                }
+            }
+
+            if (mask == hits) {
+                // The stack is shared with the traversal of the scene
+                while (0xFFFFFFFF != nodes.pop()) {
+                }
+
+                return hits;
+            }
+        }
+
+        n = nodes.pop();
+    }
+
+    return hits;
 }
 
 bool Tree::visibility(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                       scalar_p ray_max_t, uint32_t entity, Filter filter, Worker& worker,
                       float3& vis) const {
+#ifdef SU_SIMD_LEAVES
+    Simdf const origin[3] = {ray_origin.splat_x(), ray_origin.splat_y(), ray_origin.splat_z()};
+
+    Simdf const direction[3] = {ray_direction.splat_x(), ray_direction.splat_y(),
+                                ray_direction.splat_z()};
+
+    float3 const ray_dir(ray_direction);
+
+    float3 local_vis(1.f);
+
+    bool const blocked = traverse(
+        ray_origin, ray_direction, ray_min_t, ray_max_t, worker.node_stack(),
+        [&](uint32_t begin, uint32_t end) {
+            for (uint32_t b = begin; b < end; ++b) {
+                alignas(16) float u[4];
+                alignas(16) float v[4];
+                alignas(16) float t[4];
+
+                uint32_t const hits = triangle::intersect(origin, direction, ray_min_t, ray_max_t,
+                                                          leaf_triangles_[b], u, v, t);
+
+                for (uint32_t mask = hits; 0 != mask; mask &= mask - 1) {
+                    uint32_t const lane = uint32_t(std::countr_zero(mask));
+
+                    uint32_t const i = leaf_indices_[4 * b + lane];
+
+                    float2 const uv = data_.interpolate_uv(Simdf(u[lane]), Simdf(v[lane]), i);
+
+                    float3 const normal = float3(data_.normal(i));
+
+                    auto const material = worker.scene().prop_material(entity, data_.part(i));
+
+                    float3 tv;
+                    if (!material->visibility(ray_dir, normal, uv, filter, worker, tv)) {
+                        return true;
+                    }
+
+                    local_vis *= tv;
+                }
+            }
+
+            return false;
+        });
+
+    if (blocked) {
+        return false;
+    }
+
+    vis = local_vis;
+    return true;
+#elif defined(SU_WIDE_BVH)
+    float3 const ray_dir(ray_direction);
+
+    float3 local_vis(1.f);
+
+    scalar const max_t = ray_max_t;
+
+    scalar u;
+    scalar v;
+
+    bool const blocked = traverse(
+        ray_origin, ray_direction, ray_min_t, ray_max_t, worker.node_stack(),
+        [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                if (data_.intersect(ray_origin, ray_direction, ray_min_t, ray_max_t, i, u, v)) {
+                    float2 const uv = data_.interpolate_uv(Simdf(u), Simdf(v), i);
+
+                    float3 const normal = float3(data_.normal(i));
+
+                    auto const material = worker.scene().prop_material(entity, data_.part(i));
+
+                    float3 tv;
+                    if (!material->visibility(ray_dir, normal, uv, filter, worker, tv)) {
+                        return true;
+                    }
+
+                    local_vis *= tv;
+
+                    // ray_max_t has changed if intersect() returns true!
+                    ray_max_t = max_t;
+                }
+            }
+
+            return false;
+        });
+
+    if (blocked) {
+        return false;
+    }
+
+    vis = local_vis;
+    return true;
+#else
     Simdf const ray_inv_direction = reciprocal3(ray_direction);
 
     alignas(16) uint32_t ray_signs[4];
@@ -295,11 +941,59 @@ bool Tree::visibility(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_mi
 
     vis = local_vis;
     return true;
+#endif
 }
 
 bool Tree::visibility(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                       scalar_p ray_max_t, uint32_t entity, uint32_t frame, Simdf_p weight,
                       Filter filter, Worker& worker, float3& vis) const {
+#ifdef SU_WIDE_BVH
+    float3 const ray_dir(ray_direction);
+
+    float3 local_vis(1.f);
+
+    scalar const max_t = ray_max_t;
+
+    scalar u;
+    scalar v;
+
+    bool const blocked = traverse(
+        ray_origin, ray_direction, ray_min_t, ray_max_t, worker.node_stack(),
+        [&](uint32_t begin, uint32_t end) {
+#ifdef SU_SIMD_LEAVES
+            triangle_range(begin, end, begin, end);
+#endif
+            for (uint32_t i = begin; i < end; ++i) {
+                if (data_.intersect(ray_origin, ray_direction, ray_min_t, ray_max_t, i, frame,
+                                    weight, u, v)) {
+                    float2 const uv = data_.interpolate_uv(Simdf(u), Simdf(v), i, frame, weight);
+
+                    float3 const normal = float3(data_.normal(i, frame, weight));
+
+                    auto const material = worker.scene().prop_material(entity, data_.part(i));
+
+                    float3 tv;
+                    if (!material->visibility(ray_dir, normal, uv, filter, worker, tv)) {
+                        return true;
+                    }
+
+                    local_vis *= tv;
+
+                    // ray_max_t has changed if intersect() returns true!
+                    ray_max_t = max_t;
+                }
+            }
+
+            return false;
+        });
+
+    if (blocked) {
+        return false;
+    }
+
+    vis = local_vis;
+    return true;
+#else
     Simdf const ray_inv_direction = reciprocal3(ray_direction);
 
     alignas(16) uint32_t ray_signs[4];
@@ -365,6 +1059,7 @@ bool Tree::visibility(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_mi
 
     vis = local_vis;
     return true;
+#endif
 }
 
 }  // namespace scene::shape::triangle::bvh
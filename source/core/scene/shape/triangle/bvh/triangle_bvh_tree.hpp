@@ -3,6 +3,7 @@
 
 #include "base/math/aabb.hpp"
 #include "base/math/vector3.hpp"
+#include "file/file_mapping.hpp"
 #include "scene/material/sampler_settings.hpp"
 #include "triangle_bvh_indexed_data.hpp"
 
@@ -18,7 +19,9 @@ class Material;
 
 namespace bvh {
 class Node;
-}
+class Node4;
+struct Ray_packet;
+}  // namespace bvh
 
 class Worker;
 
@@ -29,6 +32,8 @@ class Vertex_stream;
 
 namespace triangle {
 
+struct Triangle_MT4;
+
 struct Intersection {
     Simdf u;
     Simdf v;
@@ -44,19 +49,31 @@ class Tree {
 
     ~Tree();
 
-    using Node      = scene::bvh::Node;
-    using Filter    = material::Sampler_settings::Filter;
-    using Material  = material::Material;
-    using Materials = Material const* const*;
+    using Node       = scene::bvh::Node;
+    using Ray_packet = scene::bvh::Ray_packet;
+    using Filter     = material::Sampler_settings::Filter;
+    using Material   = material::Material;
+    using Materials  = Material const* const*;
 
     Node* allocate_nodes(uint32_t num_nodes);
 
+    // Derives the 4-wide traversal nodes from the binary nodes, if built with SU_WIDE_BVH
+    void collapse();
+
+    // Memory used by the nodes and the pre-gathered leaf triangles, without the triangle data
+    size_t num_bytes() const;
+
     AABB aabb() const;
 
+    uint32_t num_nodes() const;
+
     uint32_t num_parts() const;
 
     uint32_t num_triangles() const;
 
+    // SAH cost of the tree right after the last full build
+    float build_sah() const;
+
     bool intersect(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t, scalar& ray_max_t,
                    Node_stack& nodes, Intersection& isec) const;
     bool intersect(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t, scalar& ray_max_t,
@@ -67,6 +84,13 @@ class Tree {
     bool intersect_p(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                      scalar_p ray_max_t, uint32_t frame, Simdf_p weight, Node_stack& nodes) const;
 
+    // Return the mask of the rays that hit a triangle, out of the ones in mask.
+    // intersect() also shortens their max_t to the hit.
+    uint32_t intersect(Ray_packet& rays, uint32_t mask, Node_stack& nodes,
+                       Intersection* isecs) const;
+
+    uint32_t intersect_p(Ray_packet const& rays, uint32_t mask, Node_stack& nodes) const;
+
     bool visibility(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
                     scalar_p ray_max_t, uint32_t entity, Filter filter, Worker& worker,
                     float3& ta) const;
@@ -115,12 +139,55 @@ class Tree {
                       Vertex_stream const& vertices, uint32_t triangle_id);
 
   private:
+    // Drops the storage of a tree that was mapped by Cache
+    void unmap();
+
+#ifdef SU_WIDE_BVH
+    // Calls leaf(begin, end) for the leaves hit by the ray, nearer children first.
+    // Stops and returns true as soon as leaf() does.
+    template <typename Leaf>
+    bool traverse(Simdf_p ray_origin, Simdf_p ray_direction, scalar_p ray_min_t,
+                  scalar const& ray_max_t, Node_stack& nodes, Leaf leaf) const;
+#endif
+
+#ifdef SU_SIMD_LEAVES
+    // Replaces the triangle ranges in the leaves of the wide nodes by ranges of blocks,
+    // that hold the triangles in the layout of Triangle_MT4
+    void gather_leaves();
+
+    // Triangles that were gathered into the given blocks
+    void triangle_range(uint32_t begin_block, uint32_t end_block, uint32_t& begin,
+                        uint32_t& end) const;
+#endif
+
     uint32_t num_nodes_;
     uint32_t num_parts_;
 
     Node* nodes_;
 
     Indexed_data data_;
+
+    file::Mapping mapping_;
+
+    float build_sah_ = 0.f;
+
+#ifdef SU_WIDE_BVH
+    uint32_t num_wide_nodes_ = 0;
+
+    scene::bvh::Node4* wide_nodes_ = nullptr;
+#endif
+
+#ifdef SU_SIMD_LEAVES
+    uint32_t num_leaf_blocks_ = 0;
+
+    Triangle_MT4* leaf_triangles_ = nullptr;
+
+    // Triangle index of every lane, 0xFFFFFFFF for unused lanes
+    uint32_t* leaf_indices_ = nullptr;
+#endif
+
+    friend class Builder_SAH;
+    friend class Cache;
 };
 
 }  // namespace bvh
@@ -6,6 +6,10 @@
 
 namespace scene::shape::triangle::bvh {
 
+inline uint32_t Tree::num_nodes() const {
+    return num_nodes_;
+}
+
 inline uint32_t Tree::num_parts() const {
     return num_parts_;
 }
@@ -14,6 +18,10 @@ inline uint32_t Tree::num_triangles() const {
     return data_.num_triangles();
 }
 
+inline float Tree::build_sah() const {
+    return build_sah_;
+}
+
 inline Simdf Tree::interpolate_p(Simdf_p u, Simdf_p v, uint32_t index) const {
     return data_.interpolate_p(u, v, index);
 }
@@ -90,6 +98,8 @@ inline void Tree::allocate_parts(uint32_t num_parts) {
 
 inline void Tree::allocate_triangles(uint32_t num_triangles, uint32_t num_frames,
                                      Vertex_stream const& vertices) {
+    unmap();
+
     data_.allocate_triangles(num_triangles, num_frames, vertices);
 }
 
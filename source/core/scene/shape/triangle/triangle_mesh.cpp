@@ -1,6 +1,6 @@
 #include "triangle_mesh.hpp"
 #include "base/math/aabb.inl"
-#include "base/math/distribution_1d.inl"
+#include "base/math/distribution_alias_1d.inl"
 #include "base/math/matrix3x3.inl"
 #include "base/math/matrix4x4.inl"
 #include "base/math/sample_distribution.inl"
@@ -11,6 +11,7 @@
 #include "base/thread/thread_pool.hpp"
 #include "bvh/triangle_bvh_tree.inl"
 #include "sampler/sampler.hpp"
+#include "scene/bvh/scene_bvh_ray_packet.inl"
 #include "scene/composed_transformation.inl"
 #include "scene/light/light.hpp"
 #include "scene/light/light_tree_builder.hpp"
@@ -26,6 +27,8 @@
 #endif
 #include "base/debug/assert.hpp"
 
+#include <bit>
+
 namespace scene::shape::triangle {
 
 Part::Variant::Variant() = default;
@@ -211,7 +214,11 @@ uint32_t Part::init(uint32_t part, uint32_t material, bvh::Tree const& tree,
                 }
             }
 
-            temps[id] = temp;
+            Temp& t = temps[id];
+
+            t.bb.merge_assign(temp.bb);
+            t.dominant_axis += temp.dominant_axis;
+            t.total_power += temp.total_power;
         },
         0, int32_t(num));
 
@@ -363,65 +370,72 @@ uint32_t Mesh::part_id_to_material_id(uint32_t part) const {
     return parts_[part].material_;
 }
 
-bool Mesh::intersect(Ray& ray, Transformation const& trafo, Worker& worker, Interpolation ipo,
-                     shape::Intersection& isec) const {
-    Node_stack& nodes = worker.node_stack();
+// Completes the intersection of a ray with the triangle pi in world space
+static void set_intersection(bvh::Tree const& tree, Intersection const& pi,
+                             Composed_transformation const& trafo, Interpolation ipo,
+                             shape::Intersection& isec) {
+    Simdf const p = tree.interpolate_p(pi.u, pi.v, pi.index);
 
-    Simd4x4f const world_to_object(trafo.world_to_object);
+    Simd4x4f const object_to_world(trafo.object_to_world());
 
-    Simdf const ray_origin    = transform_point(world_to_object, Simdf(ray.origin));
-    Simdf const ray_direction = transform_vector(world_to_object, Simdf(ray.direction));
+    Simdf const p_w = transform_point(object_to_world, p);
 
-    scalar const ray_min_t(ray.min_t());
-    scalar       ray_max_t(ray.max_t());
+    Simdf const geo_n = tree.triangle_normal(pi.index);
 
-    if (Intersection pi;
-        tree_.intersect(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes, pi)) {
-        ray.max_t() = ray_max_t.x();
+    Simd3x3f const rotation(trafo.rotation);
 
-        Simdf const p = tree_.interpolate_p(pi.u, pi.v, pi.index);
+    Simdf const geo_n_w = transform_vector(rotation, geo_n);
 
-        Simd4x4f const object_to_world(trafo.object_to_world());
+    isec.p         = float3(p_w);
+    isec.geo_n     = float3(geo_n_w);
+    isec.part      = tree.triangle_part(pi.index);
+    isec.primitive = pi.index;
 
-        Simdf const p_w = transform_point(object_to_world, p);
+    if (Interpolation::All == ipo) {
+        Simdf  n;
+        Simdf  t;
+        float2 uv;
+        tree.interpolate_triangle_data(pi.u, pi.v, pi.index, n, t, uv);
 
-        Simdf const geo_n = tree_.triangle_normal(pi.index);
+        Simdf const bitangent_sign(tree.triangle_bitangent_sign(pi.index));
 
-        Simd3x3f const rotation(trafo.rotation);
+        Simdf const n_w = transform_vector(rotation, n);
+        Simdf const t_w = transform_vector(rotation, t);
+        Simdf const b_w = bitangent_sign * cross3(n_w, t_w);
 
-        Simdf const geo_n_w = transform_vector(rotation, geo_n);
+        isec.t  = float3(t_w);
+        isec.b  = float3(b_w);
+        isec.n  = float3(n_w);
+        isec.uv = uv;
+    } else if (Interpolation::No_tangent_space == ipo) {
+        float2 const uv = tree.interpolate_triangle_uv(pi.u, pi.v, pi.index);
 
-        isec.p         = float3(p_w);
-        isec.geo_n     = float3(geo_n_w);
-        isec.part      = tree_.triangle_part(pi.index);
-        isec.primitive = pi.index;
+        isec.uv = uv;
+    } else {
+        Simdf const n   = tree.interpolate_shading_normal(pi.u, pi.v, pi.index);
+        Simdf const n_w = transform_vector(rotation, n);
 
-        if (Interpolation::All == ipo) {
-            Simdf  n;
-            Simdf  t;
-            float2 uv;
-            tree_.interpolate_triangle_data(pi.u, pi.v, pi.index, n, t, uv);
+        isec.n = float3(n_w);
+    }
+}
 
-            Simdf const bitangent_sign(tree_.triangle_bitangent_sign(pi.index));
+bool Mesh::intersect(Ray& ray, Transformation const& trafo, Worker& worker, Interpolation ipo,
+                     shape::Intersection& isec) const {
+    Node_stack& nodes = worker.node_stack();
 
-            Simdf const n_w = transform_vector(rotation, n);
-            Simdf const t_w = transform_vector(rotation, t);
-            Simdf const b_w = bitangent_sign * cross3(n_w, t_w);
+    Simd4x4f const world_to_object(trafo.world_to_object);
 
-            isec.t  = float3(t_w);
-            isec.b  = float3(b_w);
-            isec.n  = float3(n_w);
-            isec.uv = uv;
-        } else if (Interpolation::No_tangent_space == ipo) {
-            float2 const uv = tree_.interpolate_triangle_uv(pi.u, pi.v, pi.index);
+    Simdf const ray_origin    = transform_point(world_to_object, Simdf(ray.origin));
+    Simdf const ray_direction = transform_vector(world_to_object, Simdf(ray.direction));
 
-            isec.uv = uv;
-        } else {
-            Simdf const n   = tree_.interpolate_shading_normal(pi.u, pi.v, pi.index);
-            Simdf const n_w = transform_vector(rotation, n);
+    scalar const ray_min_t(ray.min_t());
+    scalar       ray_max_t(ray.max_t());
 
-            isec.n = float3(n_w);
-        }
+    if (Intersection pi;
+        tree_.intersect(ray_origin, ray_direction, ray_min_t, ray_max_t, nodes, pi)) {
+        ray.max_t() = ray_max_t.x();
+
+        set_intersection(tree_, pi, trafo, ipo, isec);
 
         SOFT_ASSERT(testing::check(isec, trafo, ray));
 
@@ -459,6 +473,61 @@ bool Mesh::visibility(Ray const& ray, Transformation const& trafo, uint32_t enti
                             v);
 }
 
+uint32_t Mesh::intersect_packet(Ray* rays, uint32_t mask, Transformation const& trafo,
+                                Worker& worker, Interpolation ipo,
+                                shape::Intersection* isecs) const {
+    Simd4x4f const world_to_object(trafo.world_to_object);
+
+    bvh::Tree::Ray_packet packet;
+
+    for (uint32_t m = mask; 0 != m; m &= m - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(m));
+
+        Ray const& ray = rays[i];
+
+        Simdf const ray_direction = transform_vector(world_to_object, Simdf(ray.direction));
+
+        packet.set(i, transform_point(world_to_object, Simdf(ray.origin)), ray_direction,
+                   reciprocal3(ray_direction), ray.min_t(), ray.max_t());
+    }
+
+    Intersection pis[Packet_size];
+
+    uint32_t const hits = tree_.intersect(packet, mask, worker.node_stack(), pis);
+
+    for (uint32_t m = hits; 0 != m; m &= m - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(m));
+
+        rays[i].max_t() = packet.max_t[i];
+
+        set_intersection(tree_, pis[i], trafo, ipo, isecs[i]);
+
+        SOFT_ASSERT(testing::check(isecs[i], trafo, rays[i]));
+    }
+
+    return hits;
+}
+
+uint32_t Mesh::intersect_p_packet(Ray const* rays, uint32_t mask, Transformation const& trafo,
+                                  Worker& worker) const {
+    Simd4x4f const world_to_object(trafo.world_to_object);
+
+    bvh::Tree::Ray_packet packet;
+
+    for (uint32_t m = mask; 0 != m; m &= m - 1) {
+        uint32_t const i = uint32_t(std::countr_zero(m));
+
+        Ray const& ray = rays[i];
+
+        Simdf const ray_direction = transform_vector(world_to_object, Simdf(ray.direction));
+
+        packet.set(i, transform_point(world_to_object, Simdf(ray.origin)), ray_direction,
+                   reciprocal3(ray_direction), ray.min_t(), ray.max_t());
+    }
+
+    return tree_.intersect_p(packet, mask, worker.node_stack());
+}
+
 bool Mesh::sample(uint32_t part, uint32_t variant, float3_p p, float3_p n,
                   Transformation const& trafo, float area, bool two_sided, bool total_sphere,
                   Sampler& sampler, RNG& rng, uint32_t sampler_d, Sample_to& sample) const {
@@ -1,7 +1,7 @@
 #ifndef SU_CORE_SCENE_SHAPE_TRIANGLE_MESH_HPP
 #define SU_CORE_SCENE_SHAPE_TRIANGLE_MESH_HPP
 
-#include "base/math/distribution_1d.hpp"
+#include "base/math/distribution_alias_1d.hpp"
 #include "bvh/triangle_bvh_tree.hpp"
 #include "scene/light/light_tree.hpp"
 #include "scene/shape/shape.hpp"
@@ -11,8 +11,8 @@
 namespace scene::shape::triangle {
 
 struct Part {
-    using Distribution_1D = math::Distribution_1D;
-    using Material        = material::Material;
+    using Distribution = math::Distribution_alias_1D;
+    using Material     = material::Material;
 
     struct Variant {
         Variant();
@@ -21,7 +21,8 @@ struct Part {
 
         bool matches(uint32_t m, bool emission_map, bool two_sided, Scene const& scene) const;
 
-        Distribution_1D distribution;
+        // Only used for discrete picks
+        Distribution distribution;
 
         light::Primitive_tree light_tree;
 
@@ -110,6 +111,13 @@ class alignas(64) Mesh final : public Shape {
     bool visibility(Ray const& ray, Transformation const& trafo, uint32_t entity, Filter filter,
                     Worker& worker, float3& ta) const final;
 
+    uint32_t intersect_packet(Ray* rays, uint32_t mask, Transformation const& trafo,
+                              Worker& worker, Interpolation ipo,
+                              shape::Intersection* isecs) const final;
+
+    uint32_t intersect_p_packet(Ray const* rays, uint32_t mask, Transformation const& trafo,
+                                Worker& worker) const final;
+
     bool sample(uint32_t part, uint32_t variant, float3_p p, float3_p n,
                 Transformation const& trafo, float area, bool two_sided, bool total_sphere,
                 Sampler& sampler, RNG& rng, uint32_t sampler_d, Sample_to& sample) const final;
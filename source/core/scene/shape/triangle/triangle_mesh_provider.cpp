@@ -4,14 +4,19 @@
 #include "base/math/vector3.inl"
 #include "base/memory/align.hpp"
 #include "base/memory/buffer.hpp"
+#include "base/string/string.hpp"
 #include "base/thread/thread_pool.hpp"
 #include "bvh/triangle_bvh_builder_sah.hpp"
+#include "bvh/triangle_bvh_cache.hpp"
+#include "bvh/triangle_bvh_tree.inl"
 #include "file/file.hpp"
+#include "file/file_mapping.hpp"
 #include "file/file_system.hpp"
 #include "logging/logging.hpp"
 #include "rapidjson/istreamwrapper.h"
 #include "resource/resource_manager.hpp"
 #include "resource/resource_provider.inl"
+#include "scene/bvh/scene_bvh_node.hpp"
 #include "triangle_json_handler.hpp"
 #include "triangle_mesh.hpp"
 #include "triangle_mesh_exporter.hpp"
@@ -19,6 +24,10 @@
 #include "triangle_morphable_mesh.hpp"
 #include "triangle_primitive.hpp"
 
+#include <bit>
+#include <cstdio>
+#include <filesystem>
+
 #include "base/debug/assert.hpp"
 #ifdef SU_DEBUG
 #include "base/chrono/chrono.hpp"
@@ -40,6 +49,14 @@ Provider::Provider() = default;
 
 Provider::~Provider() = default;
 
+void Provider::set_bvh_cache(std::string const& directory) {
+    bvh_cache_ = directory;
+}
+
+void Provider::set_spatial_split_budget(float budget) {
+    spatial_split_budget_ = budget;
+}
+
 Shape* Provider::load(std::string const& filename, Variants const& /*options*/,
                       Resources& resources, std::string& resolved_name) {
     auto stream = resources.filesystem().read_stream(filename, resolved_name);
@@ -49,7 +66,9 @@ Shape* Provider::load(std::string const& filename, Variants const& /*options*/,
     }
 
     if (file::Type::SUB == file::query_type(*stream)) {
-        Shape* mesh = load_binary(*stream, resources.threads());
+        bool const mappable = file::System::Stream_ptr::Type::Uncompressed == stream.type();
+
+        Shape* mesh = load_binary(*stream, resolved_name, mappable, resources.threads());
         if (!mesh) {
             logging::error("Loading mesh %S: ", filename);
         }
@@ -144,6 +163,7 @@ Shape* Provider::load(std::string const& filename, Variants const& /*options*/,
     LOGGING_VERBOSE("Parsing mesh %f s", chrono::seconds_since(loading_start));
 
     resources.threads().run_async([mesh, handler{std::move(handler)},
+                                   spatial_split_budget = spatial_split_budget_,
                                    &resources]() mutable noexcept {
         LOGGING_VERBOSE("Started asynchronously building triangle mesh BVH.");
 
@@ -166,7 +186,7 @@ Shape* Provider::load(std::string const& filename, Variants const& /*options*/,
         Vertex_stream_interleaved const vertex_stream(uint32_t(vertices.size()), vertices.data());
 
         build_bvh(*mesh, uint32_t(triangles.size()), triangles.data(), vertex_stream,
-                  resources.threads());
+                  spatial_split_budget, resources.threads());
 
         LOGGING_VERBOSE("Finished asynchronously building triangle mesh BVH.");
     });
@@ -197,7 +217,8 @@ Shape* Provider::load(void const* data, std::string const& /*source_name*/,
         mesh->set_material_for_part(0, 0);
     }
 
-    resources.threads().run_async([mesh, desc, &resources]() noexcept {
+    resources.threads().run_async([mesh, desc, spatial_split_budget = spatial_split_budget_,
+                                   &resources]() noexcept {
         LOGGING_VERBOSE("Started asynchronously building triangle mesh BVH.");
 
         uint32_t const num_triangles = desc.num_triangles;
@@ -254,7 +275,8 @@ Shape* Provider::load(void const* data, std::string const& /*source_name*/,
             desc.normals, tangents ? tangents[0].v : desc.tangents,
             desc.uvs ? desc.uvs : empty_uv.v);
 
-        build_bvh(*mesh, num_triangles, triangles, vertex_stream, resources.threads());
+        build_bvh(*mesh, num_triangles, triangles, vertex_stream, spatial_split_budget,
+                  resources.threads());
 
         LOGGING_VERBOSE("Finished asynchronously building triangle mesh BVH.");
     });
@@ -366,16 +388,66 @@ Shape* Provider::create_mesh(Triangles& triangles, Vertices& vertices, uint32_t
                        &threads]() noexcept {
         Vertex_stream_interleaved vertex_stream(uint32_t(vertices.size()), vertices.data());
 
-        build_bvh(*mesh, uint32_t(triangles.size()), triangles.data(), vertex_stream, threads);
+        build_bvh(*mesh, uint32_t(triangles.size()), triangles.data(), vertex_stream, 0.f,
+                  threads);
     });
 
     return mesh;
 }
 
+// Parameters of the builder used by build_bvh(), part of the BVH cache key
+static uint32_t constexpr BVH_num_slices      = 16;
+static uint32_t constexpr BVH_sweep_threshold = 64;
+static uint32_t constexpr BVH_max_primitives  = 4;
+
 void Provider::build_bvh(Mesh& mesh, uint32_t num_triangles, Index_triangle const* const triangles,
-                         Vertex_stream const& vertices, Threads& threads) {
-    bvh::Builder_SAH builder(16, 64, 4);
+                         Vertex_stream const& vertices, float spatial_split_budget,
+                         Threads& threads) {
+    bvh::Builder_SAH builder(BVH_num_slices, BVH_sweep_threshold, BVH_max_primitives,
+                             spatial_split_budget);
+
     builder.build(mesh.tree(), num_triangles, triangles, vertices, threads);
+
+    if (spatial_split_budget > 0.f) {
+        bvh::Tree const& tree = mesh.tree();
+
+        logging::info("Mesh BVH with spatial splits: " + string::to_string(tree.num_nodes()) +
+                          " nodes, " + string::to_string(tree.num_triangles()) + " references for " +
+                          string::to_string(num_triangles) + " triangles, SAH %f",
+                      bvh::Builder_SAH::sah(tree));
+    }
+}
+
+// Returns the next array of the binary payload, either in place if the file is mapped,
+// or copied from the stream
+template <typename T>
+static T* read_array(std::istream& stream, char* mapped, uint64_t& offset, uint32_t count) {
+    uint64_t const size = count * sizeof(T);
+
+    if (mapped) {
+        T* array = reinterpret_cast<T*>(mapped + offset);
+
+        offset += size;
+
+        return array;
+    }
+
+    T* array = new T[count];
+
+    stream.read(reinterpret_cast<char*>(array), std::streamsize(size));
+
+    return array;
+}
+
+static void release(Vertex_stream* vertex_stream, file::Mapping* mapping) {
+    // Mapped vertex arrays are owned by the mapping
+    if (mapping) {
+        delete mapping;
+    } else {
+        vertex_stream->release();
+    }
+
+    delete vertex_stream;
 }
 
 template <typename Index>
@@ -432,7 +504,8 @@ void fill_triangles(uint32_t num_parts, serialize::Part const* const parts,
     }
 }
 
-Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
+Shape* Provider::load_binary(std::istream& stream, std::string const& resolved_name,
+                             bool mappable, Threads& threads) {
 #ifdef SU_DEBUG
     auto const loading_start = std::chrono::high_resolution_clock::now();
 #endif
@@ -446,6 +519,48 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
     stream.read(json_string.data(), std::streamsize(json_size * sizeof(char)));
     json_string[json_size] = 0;
 
+    std::string cache_name;
+
+    uint64_t cache_key = 0;
+
+    int64_t source_last_write = 0;
+
+    if (!bvh_cache_.empty()) {
+        // The header describes the vertex layout and the size of every binary section, so together
+        // with the file size it identifies the source without reading the payload.
+        // Modifications that keep all sizes intact are caught by the last write time.
+        std::error_code ec;
+
+        uint64_t const source_size = std::filesystem::file_size(resolved_name, ec);
+
+        auto const last_write = std::filesystem::last_write_time(resolved_name, ec);
+
+        if (!ec) {
+            uint32_t const params[] = {BVH_num_slices,
+                                       BVH_sweep_threshold,
+                                       BVH_max_primitives,
+                                       std::bit_cast<uint32_t>(spatial_split_budget_),
+                                       uint32_t(sizeof(scene::bvh::Node)),
+                                       uint32_t(sizeof(bvh::Indexed_data::Index_triangle)),
+                                       uint32_t(sizeof(float3))};
+
+            cache_key = bvh::Cache::hash(json_string.data(), json_size);
+            cache_key = bvh::Cache::hash(&source_size, sizeof(uint64_t), cache_key);
+            cache_key = bvh::Cache::hash(params, sizeof(params), cache_key);
+
+            source_last_write = int64_t(last_write.time_since_epoch().count());
+
+            uint64_t const name_hash = bvh::Cache::hash(resolved_name.data(),
+                                                        resolved_name.size());
+
+            char name_buffer[32];
+            std::snprintf(name_buffer, sizeof(name_buffer), "%016llx.bvh",
+                          static_cast<unsigned long long>(name_hash));
+
+            cache_name = (std::filesystem::path(bvh_cache_) / name_buffer).string();
+        }
+    }
+
     rapidjson::Document root;
     root.ParseInsitu(json_string.data());
     if (root.HasParseError()) {
@@ -557,6 +672,26 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
 
     json_string.release();
 
+    if (!cache_name.empty()) {
+        auto mesh = new Mesh;
+
+        mesh->allocate_parts(num_parts);
+
+        if (bvh::Cache::read(cache_name, cache_key, source_last_write, mesh->tree()) &&
+            num_parts == mesh->tree().num_parts()) {
+            for (uint32_t p = 0; p < num_parts; ++p) {
+                mesh->set_material_for_part(p, parts[p].material_index);
+            }
+
+            LOGGING_VERBOSE("Mapped cached triangle mesh BVH %f s",
+                            chrono::seconds_since(loading_start));
+
+            return mesh;
+        }
+
+        delete mesh;
+    }
+
     bool const has_uvs_and_tangents = has_uvs && has_tangents;
 
     uint64_t const binary_start = json_size + 4u + sizeof(uint64_t);
@@ -571,42 +706,82 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
         }
     }
 
-    stream.seekg(std::streamoff(binary_start + vertices_offset));
+    uint64_t const vertices_start = binary_start + vertices_offset;
+    uint64_t const indices_start  = binary_start + indices_offset;
+
+    if (0 == num_indices && index_bytes > 0) {
+        num_indices = uint32_t(indices_size / index_bytes);
+    }
+
+    file::Mapping* mapping = nullptr;
+
+    if (mappable && index_bytes > 0) {
+        uint64_t const positions_size = num_vertices * sizeof(packed_float3);
+
+        uint64_t vertices_end = vertices_start;
+
+        if (interleaved_vertex_stream) {
+            vertices_end += vertices_size;
+        } else if (tangent_space_as_quaternion) {
+            vertices_end += positions_size + num_vertices * (sizeof(Quaternion) + sizeof(float2));
+        } else if (has_uvs_and_tangents) {
+            vertices_end += num_vertices * (3 * sizeof(packed_float3) + sizeof(float2) + 1);
+        } else {
+            vertices_end += 2 * positions_size;
+        }
+
+        // The mapping is page aligned, so the arrays are aligned if their file offsets are
+        bool const aligned = 0 == vertices_start % alignof(float) &&
+                             0 == indices_start % index_bytes &&
+                             (interleaved_vertex_stream || !tangent_space_as_quaternion ||
+                              0 == (vertices_start + positions_size) % alignof(Quaternion));
+
+        mapping = new file::Mapping;
+
+        if (!aligned || !mapping->open(resolved_name) ||
+            mapping->size() < std::max(vertices_end, indices_start + indices_size)) {
+            delete mapping;
+            mapping = nullptr;
+        }
+    }
+
+    char* const mapped = mapping ? mapping->data() : nullptr;
+
+    stream.seekg(std::streamoff(vertices_start));
+
+    uint64_t offset = vertices_start;
 
     Vertex_stream* vertex_stream = nullptr;
 
     if (interleaved_vertex_stream) {
-        Vertex* vertices = new Vertex[num_vertices];
+        Vertex* vertices;
+
+        if (mapped) {
+            vertices = reinterpret_cast<Vertex*>(mapped + offset);
+        } else {
+            vertices = new Vertex[num_vertices];
 
-        stream.read(reinterpret_cast<char*>(vertices), std::streamsize(vertices_size));
+            stream.read(reinterpret_cast<char*>(vertices), std::streamsize(vertices_size));
+        }
 
         vertex_stream = new Vertex_stream_interleaved(num_vertices, vertices);
     } else {
-        packed_float3* p = new packed_float3[num_vertices];
-        stream.read(reinterpret_cast<char*>(p), num_vertices * sizeof(packed_float3));
+        packed_float3* p = read_array<packed_float3>(stream, mapped, offset, num_vertices);
 
         if (tangent_space_as_quaternion) {
-            Quaternion* ts = new Quaternion[num_vertices];
-            float2*     uv = new float2[num_vertices];
-
-            stream.read(reinterpret_cast<char*>(ts), num_vertices * sizeof(Quaternion));
-
-            stream.read(reinterpret_cast<char*>(uv), num_vertices * sizeof(float2));
+            Quaternion* ts = read_array<Quaternion>(stream, mapped, offset, num_vertices);
+            float2*     uv = read_array<float2>(stream, mapped, offset, num_vertices);
 
             vertex_stream = new Vertex_stream_separate_ts(num_vertices, p, ts, uv);
         } else {
-            packed_float3* n = new packed_float3[num_vertices];
-            stream.read(reinterpret_cast<char*>(n), num_vertices * sizeof(packed_float3));
+            packed_float3* n = read_array<packed_float3>(stream, mapped, offset, num_vertices);
 
             if (has_uvs_and_tangents) {
-                packed_float3* t   = new packed_float3[num_vertices];
-                float2*        uv  = new float2[num_vertices];
-                uint8_t*       bts = new uint8_t[num_vertices];
-
-                stream.read(reinterpret_cast<char*>(t), num_vertices * sizeof(packed_float3));
-                stream.read(reinterpret_cast<char*>(uv), num_vertices * sizeof(float2));
-                stream.read(reinterpret_cast<char*>(bts), num_vertices * sizeof(uint8_t));
+                packed_float3* t   = read_array<packed_float3>(stream, mapped, offset, num_vertices);
+                float2*        uv  = read_array<float2>(stream, mapped, offset, num_vertices);
+                uint8_t*       bts = read_array<uint8_t>(stream, mapped, offset, num_vertices);
 
+                // Writing to the mapping only touches private copies of the affected pages
                 for (uint32_t i = 0; i < num_vertices; ++i) {
                     packed_float3& ti = t[i];
 
@@ -622,23 +797,27 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
         }
     }
 
-    if (0 == num_indices) {
-        num_indices = uint32_t(indices_size / index_bytes);
-    }
+    memory::Buffer<char> indices;
 
-    memory::Buffer<char> indices(indices_size);
+    char const* index_data = nullptr;
 
-    stream.seekg(std::streamoff(binary_start + indices_offset));
-    stream.read(indices, std::streamsize(indices_size));
+    if (mapped) {
+        index_data = mapped + indices_start;
+    } else {
+        indices.resize(indices_size);
 
-    if (stream.gcount() < std::streamsize(indices_size)) {
-        logging::push_error("Could not read all index data.");
+        stream.seekg(std::streamoff(indices_start));
+        stream.read(indices, std::streamsize(indices_size));
 
-        vertex_stream->release();
+        if (stream.gcount() < std::streamsize(indices_size)) {
+            logging::push_error("Could not read all index data.");
 
-        delete vertex_stream;
+            release(vertex_stream, mapping);
 
-        return nullptr;
+            return nullptr;
+        }
+
+        index_data = indices.data();
     }
 
     auto mesh = new Mesh;
@@ -653,9 +832,7 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
 
             delete mesh;
 
-            vertex_stream->release();
-
-            delete vertex_stream;
+            release(vertex_stream, mapping);
 
             return nullptr;
         }
@@ -666,7 +843,9 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
     LOGGING_VERBOSE("Parsing mesh %f s", chrono::seconds_since(loading_start));
 
     threads.run_async([mesh, num_parts, parts{std::move(parts)}, num_indices,
-                       indices{std::move(indices)}, vertex_stream, index_bytes, delta_indices,
+                       indices{std::move(indices)}, index_data, vertex_stream, mapping,
+                       index_bytes, delta_indices, cache_name{std::move(cache_name)}, cache_key,
+                       source_last_write, spatial_split_budget = spatial_split_budget_,
                        &threads]() noexcept {
         LOGGING_VERBOSE("Started asynchronously building triangle mesh BVH.");
 
@@ -676,29 +855,33 @@ Shape* Provider::load_binary(std::istream& stream, Threads& threads) {
 
         if (4 == index_bytes) {
             if (delta_indices) {
-                int32_t const* indices32 = reinterpret_cast<int32_t const*>(indices.data());
+                int32_t const* indices32 = reinterpret_cast<int32_t const*>(index_data);
                 fill_triangles_delta(num_parts, parts, indices32, triangles.data());
             } else {
-                uint32_t const* indices32 = reinterpret_cast<uint32_t const*>(indices.data());
+                uint32_t const* indices32 = reinterpret_cast<uint32_t const*>(index_data);
                 fill_triangles(num_parts, parts, indices32, triangles.data());
             }
         } else {
             if (delta_indices) {
-                int16_t const* indices16 = reinterpret_cast<int16_t const*>(indices.data());
+                int16_t const* indices16 = reinterpret_cast<int16_t const*>(index_data);
                 fill_triangles_delta(num_parts, parts, indices16, triangles.data());
             } else {
-                uint16_t const* indices16 = reinterpret_cast<uint16_t const*>(indices.data());
+                uint16_t const* indices16 = reinterpret_cast<uint16_t const*>(index_data);
                 fill_triangles(num_parts, parts, indices16, triangles.data());
             }
         }
 
-        build_bvh(*mesh, num_triangles, triangles.data(), *vertex_stream, threads);
-
-        vertex_stream->release();
+        build_bvh(*mesh, num_triangles, triangles.data(), *vertex_stream, spatial_split_budget,
+                  threads);
 
-        delete vertex_stream;
+        release(vertex_stream, mapping);
 
         LOGGING_VERBOSE("Finished asynchronously building triangle mesh BVH.");
+
+        if (!cache_name.empty() &&
+            !bvh::Cache::write(cache_name, cache_key, source_last_write, mesh->tree())) {
+            logging::warning("Could not write BVH cache %S.", cache_name);
+        }
     });
 
     return mesh;
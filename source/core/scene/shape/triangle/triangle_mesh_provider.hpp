@@ -36,6 +36,14 @@ class Provider : public resource::Provider<Shape> {
     Shape* load(std::string const& filename, Variants const& options, Resources& resources,
                 std::string& resolved_name) final;
 
+    // Finished BVHs of binary meshes are stored in this directory and reused by later runs.
+    // An empty string disables the cache.
+    void set_bvh_cache(std::string const& directory);
+
+    // Lets the BVH builder clip triangles at spatial splits, and add up to this fraction of
+    // the number of triangles as extra references. 0 disables it.
+    void set_spatial_split_budget(float budget);
+
     struct Description {
         uint32_t num_triangles;
         uint32_t num_vertices;
@@ -65,12 +73,19 @@ class Provider : public resource::Provider<Shape> {
                               Threads& threads);
 
     static void build_bvh(Mesh& mesh, uint32_t num_triangles, Index_triangle const* const triangles,
-                          Vertex_stream const& vertices, Threads& threads);
+                          Vertex_stream const& vertices, float spatial_split_budget,
+                          Threads& threads);
 
     //	static void build_bvh(Mesh& mesh, Triangles const& triangles, Vertices const& vertices,
     //						  BVH_preset bvh_preset, Threads& threads);
 
-    static Shape* load_binary(std::istream& stream, Threads& threads);
+    // If mappable, the stream reads an uncompressed file and the payload is used in place
+    Shape* load_binary(std::istream& stream, std::string const& resolved_name, bool mappable,
+                       Threads& threads);
+
+    std::string bvh_cache_;
+
+    float spatial_split_budget_ = 0.f;
 };
 
 }  // namespace triangle
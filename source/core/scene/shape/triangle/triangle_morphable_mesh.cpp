@@ -1,4 +1,5 @@
 #include "triangle_morphable_mesh.hpp"
+#include "base/chrono/chrono.hpp"
 #include "base/math/aabb.inl"
 #include "base/math/distribution_1d.inl"
 #include "base/math/matrix3x3.inl"
@@ -6,6 +7,7 @@
 #include "base/math/vector3.inl"
 #include "bvh/triangle_bvh_builder_sah.hpp"
 #include "bvh/triangle_bvh_tree.inl"
+#include "logging/logging.hpp"
 #include "sampler/sampler.hpp"
 #include "scene/composed_transformation.inl"
 #include "scene/scene_ray.inl"
@@ -22,10 +24,18 @@
 
 namespace scene::shape::triangle {
 
+// A refitted tree is rebuilt once its SAH cost exceeds that of the last build by this factor
+static float constexpr BVH_refit_threshold = 1.25f;
+
+// Refitting can't recover from a bad topology, so the tree is rebuilt this often regardless
+static uint32_t constexpr BVH_max_refits = 32;
+
 Morphable_mesh::Morphable_mesh(Morph_target_collection&& collection, uint32_t num_parts)
     : Shape(Properties(Property::Complex, Property::Finite)),
       collection_(std::move(collection)),
-      vertices_(nullptr) {
+      vertices_(nullptr),
+      num_frames_(0),
+      num_refits_(0) {
     tree_.allocate_parts(num_parts);
 }
 
@@ -223,17 +233,44 @@ Morphable* Morphable_mesh::morphable_shape() {
 }
 
 void Morphable_mesh::morph(Morphing const* morphings, uint32_t num_frames, Threads& threads) {
-    if (!vertices_) {
+    auto const start = std::chrono::high_resolution_clock::now();
+
+    if (num_frames != num_frames_) {
+        delete[] vertices_;
         vertices_ = new Vertex[collection_.num_vertices() * num_frames];
+
+        num_frames_ = num_frames;
+        num_refits_ = BVH_max_refits;
     }
 
     collection_.morph(morphings, num_frames, threads, vertices_);
 
     Vertex_stream_interleaved vertices(collection_.num_vertices(), vertices_);
 
-    bvh::Builder_SAH builder(16, 64, 4);
+    bvh::Builder_SAH builder(16, 64, 4, 0.f);
+
+    // The triangles never change, so updating the bounds is usually much cheaper than a rebuild
+    if (num_refits_ < BVH_max_refits && builder.refit(tree_, vertices, num_frames, threads)) {
+        float const sah = bvh::Builder_SAH::sah(tree_);
+
+        if (sah <= BVH_refit_threshold * tree_.build_sah()) {
+            ++num_refits_;
+
+            logging::info("Morphable mesh BVH refit with SAH %f", sah);
+            logging::info("Morph time %f s", chrono::seconds_since(start));
+            return;
+        }
+
+        logging::info("Morphable mesh BVH refit degraded to SAH %f, rebuilding", sah);
+    }
+
     builder.build(tree_, uint32_t(collection_.triangles().size()), collection_.triangles().data(),
                   vertices, num_frames, threads);
+
+    num_refits_ = 0;
+
+    logging::info("Morphable mesh BVH build with SAH %f", tree_.build_sah());
+    logging::info("Morph time %f s", chrono::seconds_since(start));
 }
 
 }  // namespace scene::shape::triangle
@@ -78,6 +78,11 @@ class alignas(64) Morphable_mesh final : public Shape, public Morphable {
 
     Vertex* vertices_;
 
+    uint32_t num_frames_;
+
+    // Since the last full build of the tree
+    uint32_t num_refits_;
+
     friend class Provider;
 };
 
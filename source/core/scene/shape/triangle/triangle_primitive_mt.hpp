@@ -14,6 +14,26 @@ struct Shading_vertex_MTC {
     float4 t_v;
 };
 
+// Four triangles in SoA layout, with the first vertex and both edges precomputed for the
+// Möller–Trumbore test. Unused lanes hold degenerate triangles, which are never hit.
+struct alignas(16) Triangle_MT4 {
+    void clear();
+
+    void set(uint32_t lane, float3_p a, float3_p b, float3_p c);
+
+    float ax[4];
+    float ay[4];
+    float az[4];
+
+    float e1x[4];
+    float e1y[4];
+    float e1z[4];
+
+    float e2x[4];
+    float e2y[4];
+    float e2z[4];
+};
+
 }  // namespace scene::shape::triangle
 
 #endif
@@ -217,6 +217,157 @@ static inline bool intersect_p(Simdf_p origin, Simdf_p direction, scalar_p min_t
                  _mm_ucomige_ss(hit_t.v, min_t.v) & _mm_ucomige_ss(max_t.v, hit_t.v));
 }
 
+inline void Triangle_MT4::clear() {
+    for (uint32_t i = 0; i < 4; ++i) {
+        ax[i]  = 0.f;
+        ay[i]  = 0.f;
+        az[i]  = 0.f;
+        e1x[i] = 0.f;
+        e1y[i] = 0.f;
+        e1z[i] = 0.f;
+        e2x[i] = 0.f;
+        e2y[i] = 0.f;
+        e2z[i] = 0.f;
+    }
+}
+
+inline void Triangle_MT4::set(uint32_t lane, float3_p a, float3_p b, float3_p c) {
+    float3 const e1 = b - a;
+    float3 const e2 = c - a;
+
+    ax[lane] = a[0];
+    ay[lane] = a[1];
+    az[lane] = a[2];
+
+    e1x[lane] = e1[0];
+    e1y[lane] = e1[1];
+    e1z[lane] = e1[2];
+
+    e2x[lane] = e2[0];
+    e2y[lane] = e2[1];
+    e2z[lane] = e2[2];
+}
+
+// Helpers for the four triangle test, that work on one Simdf per axis.
+// They fuse the multiply-adds where available, so the results can differ from the single
+// triangle test in the last bits.
+
+static inline Simdf fmadd(Simdf_p a, Simdf_p b, Simdf_p c) {
+#if defined(__AVX2__)
+    return _mm_fmadd_ps(a.v, b.v, c.v);
+#else
+    return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v);
+#endif
+}
+
+static inline Simdf fmsub(Simdf_p a, Simdf_p b, Simdf_p c) {
+#if defined(__AVX2__)
+    return _mm_fmsub_ps(a.v, b.v, c.v);
+#else
+    return _mm_sub_ps(_mm_mul_ps(a.v, b.v), c.v);
+#endif
+}
+
+static inline void cross3(Simdf const* a, Simdf const* b, Simdf* c) {
+    c[0] = fmsub(b[2], a[1], a[2] * b[1]);
+    c[1] = fmsub(b[0], a[2], a[0] * b[2]);
+    c[2] = fmsub(b[1], a[0], a[1] * b[0]);
+}
+
+static inline Simdf dot3(Simdf const* a, Simdf const* b) {
+    return fmadd(a[2], b[2], fmadd(a[1], b[1], a[0] * b[0]));
+}
+
+// origin and direction hold one splatted Simdf per axis.
+// Returns a bit mask of the triangles hit, with their barycentrics and distances.
+static inline uint32_t intersect(Simdf const* origin, Simdf const* direction, scalar_p min_t,
+                                 scalar_p max_t, Triangle_MT4 const& tri, float* u_out,
+                                 float* v_out, float* t_out) {
+    Simdf const e1[3] = {Simdf(tri.e1x), Simdf(tri.e1y), Simdf(tri.e1z)};
+    Simdf const e2[3] = {Simdf(tri.e2x), Simdf(tri.e2y), Simdf(tri.e2z)};
+
+    Simdf const tvec[3] = {origin[0] - Simdf(tri.ax), origin[1] - Simdf(tri.ay),
+                           origin[2] - Simdf(tri.az)};
+
+    Simdf pvec[3];
+    cross3(direction, e2, pvec);
+
+    Simdf qvec[3];
+    cross3(tvec, e1, qvec);
+
+    Simdf const e1_d_pv = dot3(e1, pvec);
+    Simdf const tv_d_pv = dot3(tvec, pvec);
+    Simdf const di_d_qv = dot3(direction, qvec);
+    Simdf const e2_d_qv = dot3(e2, qvec);
+
+    __m128 const rcp  = _mm_rcp_ps(e1_d_pv.v);
+    __m128 const muls = _mm_mul_ps(_mm_mul_ps(rcp, rcp), e1_d_pv.v);
+
+    Simdf const inv_det = _mm_sub_ps(_mm_add_ps(rcp, rcp), muls);
+
+    Simdf const u     = tv_d_pv * inv_det;
+    Simdf const v     = di_d_qv * inv_det;
+    Simdf const hit_t = e2_d_qv * inv_det;
+
+    Simdf const uv = u + v;
+
+    __m128 const zero = simd::Zero;
+    __m128 const one  = simd::One;
+
+    __m128 const min = Simdf(min_t).v;
+    __m128 const max = Simdf(max_t).v;
+
+    __m128 const hit = _mm_and_ps(
+        _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(u.v, zero), _mm_cmpge_ps(one, u.v)),
+                   _mm_and_ps(_mm_cmpge_ps(v.v, zero), _mm_cmpge_ps(one, uv.v))),
+        _mm_and_ps(_mm_cmpge_ps(hit_t.v, min), _mm_cmpge_ps(max, hit_t.v)));
+
+    _mm_store_ps(u_out, u.v);
+    _mm_store_ps(v_out, v.v);
+    _mm_store_ps(t_out, hit_t.v);
+
+    return uint32_t(_mm_movemask_ps(hit));
+}
+
+// Closest hit among the four triangles, ties go to the later lane like in a sequential loop
+static inline bool intersect(Simdf const* origin, Simdf const* direction, scalar_p min_t,
+                             scalar& max_t, Triangle_MT4 const& tri, scalar& u_out,
+                             scalar& v_out, uint32_t& lane) {
+    alignas(16) float u[4];
+    alignas(16) float v[4];
+    alignas(16) float t[4];
+
+    uint32_t const hits = intersect(origin, direction, min_t, max_t, tri, u, v, t);
+
+    if (0 == hits) {
+        return false;
+    }
+
+    uint32_t closest = 4;
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        if ((hits & (1u << i)) && (4 == closest || t[i] <= t[closest])) {
+            closest = i;
+        }
+    }
+
+    max_t = scalar(t[closest]);
+    u_out = scalar(u[closest]);
+    v_out = scalar(v[closest]);
+    lane  = closest;
+
+    return true;
+}
+
+static inline bool intersect_p(Simdf const* origin, Simdf const* direction, scalar_p min_t,
+                               scalar_p max_t, Triangle_MT4 const& tri) {
+    alignas(16) float u[4];
+    alignas(16) float v[4];
+    alignas(16) float t[4];
+
+    return 0 != intersect(origin, direction, min_t, max_t, tri, u, v, t);
+}
+
 static inline Simdf interpolate_p(Simdf_p a, Simdf_p b, Simdf_p c, Simdf_p u, Simdf_p v) {
     Simdf const w = simd::One - u - v;
 
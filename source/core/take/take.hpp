@@ -56,6 +56,22 @@ struct Photon_settings {
     bool full_light_path = false;
 };
 
+struct Adaptive_settings {
+    // 0 disables adaptive sampling
+    uint32_t num_base_samples = 0;
+    uint32_t num_step_samples = 0;
+
+    // Average relative standard error of the pixels of a tile, below which it is done
+    float threshold = 0.01f;
+};
+
+struct Tile_settings {
+    uint32_t dimensions = 32;
+
+    bool subdivide  = true;
+    bool cost_order = false;
+};
+
 struct View {
     View();
 
@@ -86,7 +102,11 @@ struct View {
     uint32_t num_samples_per_pixel   = 1;
     uint32_t num_particles_per_pixel = 0;
 
+    Adaptive_settings adaptive_settings;
+
     Photon_settings photon_settings;
+
+    Tile_settings tile_settings;
 };
 
 struct Take {
@@ -72,7 +72,11 @@ using Light_sampling = rendering::integrator::Light_sampling;
 static Sensor* load_sensor(json::Value const& value);
 
 static sampler::Pool* load_sampler_pool(json::Value const& value, uint32_t num_workers,
-                                        bool progressive, uint32_t& num_samples_per_pixel);
+                                        bool progressive, uint32_t& num_samples_per_pixel,
+                                        Adaptive_settings& adaptive_settings);
+
+static void load_adaptive_settings(json::Value const& value, uint32_t num_samples_per_pixel,
+                                   Adaptive_settings& settings);
 
 static Surface_pool* load_surface_integrator(json::Value const& value, uint32_t num_workers,
                                              bool progressive, bool lighttracer);
@@ -86,6 +90,8 @@ static Particle_pool* load_particle_integrator(json::Value const& value, uint32_
 
 static void load_photon_settings(json::Value const& value, Photon_settings& settings);
 
+static void load_tile_settings(json::Value const& value, Tile_settings& settings);
+
 static Postprocessor* load_tonemapper(json::Value const& value);
 
 static bool peek_stereoscopic(json::Value const& value);
@@ -128,6 +134,8 @@ bool Loader::load(Take& take, std::istream& stream, bool progressive, Scene& sce
             sampler_value = &n.value;
         } else if ("scene" == n.name) {
             take.scene_filename = n.value.GetString();
+        } else if ("tiles" == n.name) {
+            load_tile_settings(n.value, take.view.tile_settings);
         }
     }
 
@@ -151,7 +159,8 @@ bool Loader::load(Take& take, std::istream& stream, bool progressive, Scene& sce
 
         if (potential_surface_integrator) {
             take.view.samplers = load_sampler_pool(*sampler_value, num_threads, progressive,
-                                                   take.view.num_samples_per_pixel);
+                                                   take.view.num_samples_per_pixel,
+                                                   take.view.adaptive_settings);
         } else {
             take.view.samplers = new sampler::Random_pool(num_threads);
         }
@@ -529,7 +538,8 @@ Sensor* load_sensor(json::Value const& value) {
 }
 
 sampler::Pool* load_sampler_pool(json::Value const& value, uint32_t num_workers, bool progressive,
-                                 uint32_t& num_samples_per_pixel) {
+                                 uint32_t& num_samples_per_pixel,
+                                 Adaptive_settings& adaptive_settings) {
     if (progressive) {
         num_samples_per_pixel = 1;
         return new sampler::Random_pool(num_workers);
@@ -538,6 +548,12 @@ sampler::Pool* load_sampler_pool(json::Value const& value, uint32_t num_workers,
     for (auto& n : value.GetObject()) {
         num_samples_per_pixel = json::read_uint(n.value, "samples_per_pixel");
 
+        if (auto const adaptive_node = n.value.FindMember("adaptive");
+            n.value.MemberEnd() != adaptive_node) {
+            load_adaptive_settings(adaptive_node->value, num_samples_per_pixel,
+                                   adaptive_settings);
+        }
+
         if ("Random" == n.name) {
             return new sampler::Random_pool(num_workers);
         }
@@ -814,6 +830,37 @@ static void load_photon_settings(json::Value const& value, Photon_settings& sett
     settings.full_light_path     = json::read_bool(value, "full_light_path", false);
 }
 
+static void load_adaptive_settings(json::Value const& value, uint32_t num_samples_per_pixel,
+                                   Adaptive_settings& settings) {
+    // At least two samples are needed to estimate the variance
+    uint32_t const num_base_samples = std::max(
+        json::read_uint(value, "base_samples", num_samples_per_pixel / 8), 2u);
+
+    if (num_base_samples >= num_samples_per_pixel) {
+        return;
+    }
+
+    settings.num_base_samples = num_base_samples;
+    settings.num_step_samples = std::max(json::read_uint(value, "step_samples", num_base_samples),
+                                         1u);
+    settings.threshold        = json::read_float(value, "threshold", 0.01f);
+}
+
+static void load_tile_settings(json::Value const& value, Tile_settings& settings) {
+    settings.dimensions = std::max(json::read_uint(value, "dimensions", 32), 1u);
+    settings.subdivide  = json::read_bool(value, "subdivide", true);
+
+    std::string const order = json::read_string(value, "order", "Hilbert");
+
+    if ("Cost" == order) {
+        settings.cost_order = true;
+    } else if ("Hilbert" == order) {
+        settings.cost_order = false;
+    } else {
+        logging::warning("Unknown tile order \"" + order + "\". Using Hilbert.");
+    }
+}
+
 void Loader::load_postprocessors(json::Value const& pp_value, Resources& resources,
                                  Pipeline& pipeline) {
     if (!pp_value.IsArray()) {
@@ -0,0 +1,302 @@
+#include "testing_bvh.hpp"
+#include "base/math/math.hpp"
+#include "base/math/simd.inl"
+#include "base/math/vector3.inl"
+#include "base/random/generator.inl"
+#include "base/thread/thread_pool.hpp"
+#include "scene/shape/node_stack.inl"
+#include "scene/shape/shape_vertex.hpp"
+#include "scene/shape/triangle/bvh/triangle_bvh_builder_sah.hpp"
+#include "scene/shape/triangle/bvh/triangle_bvh_tree.inl"
+#include "scene/shape/triangle/triangle_primitive.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Compares the traversal speed of the binary and the 4-wide triangle BVH,
+// by running it once in a regular build and once in a build with SU_WIDE_BVH.
+// The checksums must be identical between the two.
+// spatial_splits() compares trees built with different spatial split budgets the same way.
+
+namespace testing::bvh {
+
+using namespace scene::shape;
+
+using Clock = std::chrono::high_resolution_clock;
+
+static float seconds_since(Clock::time_point start) {
+    auto const duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                                                 start);
+    return float(duration.count()) / 1000000.f;
+}
+
+// Bumpy sphere without the poles, so that the nodes overlap and rays traverse more than one path.
+// The poles would produce thousands of triangles with identical bounds, that the builder cannot
+// split.
+static void create_mesh(uint32_t width, uint32_t height, std::vector<Vertex>& vertices,
+                        std::vector<triangle::Index_triangle>& triangles) {
+    vertices.resize((width + 1) * (height + 1));
+
+    for (uint32_t y = 0; y <= height; ++y) {
+        float const theta = Pi * (0.05f + 0.9f * float(y) / float(height));
+
+        for (uint32_t x = 0; x <= width; ++x) {
+            float const phi = (2.f * Pi) * float(x) / float(width);
+
+            float const r = 1.f + 0.05f * std::sin(37.f * theta) * std::sin(23.f * phi);
+
+            float3 const n(std::sin(theta) * std::cos(phi), std::cos(theta),
+                           std::sin(theta) * std::sin(phi));
+
+            Vertex& v = vertices[y * (width + 1) + x];
+
+            v.p  = packed_float3(r * n);
+            v.n  = packed_float3(n);
+            v.t  = packed_float3(1.f, 0.f, 0.f);
+            v.uv = float2(float(x) / float(width), float(y) / float(height));
+
+            v.bitangent_sign = 0;
+        }
+    }
+
+    triangles.clear();
+    triangles.reserve(2 * width * height);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t const a = y * (width + 1) + x;
+            uint32_t const b = a + 1;
+            uint32_t const c = a + width + 1;
+            uint32_t const d = c + 1;
+
+            triangles.emplace_back(a, c, b, 0);
+            triangles.emplace_back(b, c, d, 0);
+        }
+    }
+}
+
+static float3 random_direction(rnd::Generator& rng) {
+    float const z   = 1.f - 2.f * rng.random_float();
+    float const r   = std::sqrt(std::max(1.f - z * z, 0.f));
+    float const phi = (2.f * Pi) * rng.random_float();
+
+    return float3(r * std::cos(phi), r * std::sin(phi), z);
+}
+
+void traversal() {
+    std::cout << "testing::bvh::traversal()" << std::endl;
+
+#ifdef SU_WIDE_BVH
+    std::cout << "4-wide BVH" << std::endl;
+#else
+    std::cout << "binary BVH" << std::endl;
+#endif
+
+    Threads threads(Threads::num_threads(0));
+
+    std::vector<Vertex>                   vertices;
+    std::vector<triangle::Index_triangle> triangles;
+
+    create_mesh(1024, 512, vertices, triangles);
+
+    Vertex_stream_interleaved const vertex_stream(uint32_t(vertices.size()), vertices.data());
+
+    triangle::bvh::Tree tree;
+
+    {
+        auto const start = Clock::now();
+
+        triangle::bvh::Builder_SAH builder(16, 64, 4, 0.f);
+        builder.build(tree, uint32_t(triangles.size()), triangles.data(), vertex_stream,
+                      threads);
+
+        std::cout << triangles.size() << " triangles, build " << seconds_since(start) << " s, "
+                  << float(tree.num_bytes()) / (1024.f * 1024.f) << " MiB" << std::endl;
+    }
+
+    uint32_t constexpr Num_rays = 1 << 21;
+
+    std::vector<float3> origins(Num_rays);
+    std::vector<float3> directions(Num_rays);
+
+    rnd::Generator rng(0, 0);
+
+    // Half of the rays start inside, the other half outside and aim at the sphere
+    for (uint32_t i = 0; i < Num_rays; ++i) {
+        if (0 == (i & 1)) {
+            origins[i]    = 0.5f * rng.random_float() * random_direction(rng);
+            directions[i] = random_direction(rng);
+        } else {
+            origins[i]    = 3.f * random_direction(rng);
+            directions[i] = normalize(0.8f * random_direction(rng) - origins[i]);
+        }
+    }
+
+    Node_stack nodes;
+
+    {
+        uint64_t checksum = 0;
+
+        auto const start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_rays; ++i) {
+            scalar max_t(8.f);
+
+            triangle::Intersection isec;
+
+            nodes.clear();
+
+            if (tree.intersect(Simdf(origins[i]), Simdf(directions[i]), scalar(0.f), max_t, nodes,
+                               isec)) {
+                checksum += isec.index;
+            }
+        }
+
+        float const duration = seconds_since(start);
+
+        std::cout << "intersect:   " << float(Num_rays) / (1000000.f * duration)
+                  << " Mrays/s (checksum " << checksum << ")" << std::endl;
+    }
+
+    {
+        uint64_t checksum = 0;
+
+        auto const start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_rays; ++i) {
+            nodes.clear();
+
+            // Short rays, so that a good part of them miss
+            if (tree.intersect_p(Simdf(origins[i]), Simdf(directions[i]), scalar(0.f),
+                                 scalar(0 == (i & 1) ? 0.6f : 2.f), nodes)) {
+                ++checksum;
+            }
+        }
+
+        float const duration = seconds_since(start);
+
+        std::cout << "intersect_p: " << float(Num_rays) / (1000000.f * duration)
+                  << " Mrays/s (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+// Long thin diagonal triangles, like railings and wires, between two large floor quads.
+// Their bounds overlap a lot, which is the worst case for splitting the references only.
+static void create_slivers(uint32_t num_slivers, std::vector<Vertex>& vertices,
+                           std::vector<triangle::Index_triangle>& triangles) {
+    rnd::Generator rng(0, 1);
+
+    vertices.clear();
+    triangles.clear();
+
+    auto const add_vertex = [&vertices](float3_p p) {
+        Vertex v;
+
+        v.p  = packed_float3(p);
+        v.n  = packed_float3(0.f, 1.f, 0.f);
+        v.t  = packed_float3(1.f, 0.f, 0.f);
+        v.uv = float2(0.f);
+
+        v.bitangent_sign = 0;
+
+        vertices.push_back(v);
+    };
+
+    for (uint32_t i = 0; i < num_slivers; ++i) {
+        float3 const a = 4.f * float3(rng.random_float(), rng.random_float(), rng.random_float()) -
+                         2.f;
+
+        float3 const b = a + 0.5f * random_direction(rng);
+
+        float3 const c = b + 0.002f * random_direction(rng);
+
+        uint32_t const o = uint32_t(vertices.size());
+
+        add_vertex(a);
+        add_vertex(b);
+        add_vertex(c);
+
+        triangles.emplace_back(o, o + 1, o + 2, 0);
+    }
+
+    for (float const y : {-2.5f, 2.5f}) {
+        uint32_t const o = uint32_t(vertices.size());
+
+        add_vertex(float3(-3.f, y, -3.f));
+        add_vertex(float3(3.f, y, -3.f));
+        add_vertex(float3(-3.f, y, 3.f));
+        add_vertex(float3(3.f, y, 3.f));
+
+        triangles.emplace_back(o, o + 2, o + 1, 0);
+        triangles.emplace_back(o + 1, o + 2, o + 3, 0);
+    }
+}
+
+void spatial_splits() {
+    std::cout << "testing::bvh::spatial_splits()" << std::endl;
+
+    Threads threads(Threads::num_threads(0));
+
+    std::vector<Vertex>                   vertices;
+    std::vector<triangle::Index_triangle> triangles;
+
+    create_slivers(1 << 16, vertices, triangles);
+
+    Vertex_stream_interleaved const vertex_stream(uint32_t(vertices.size()), vertices.data());
+
+    uint32_t constexpr Num_rays = 1 << 18;
+
+    std::vector<float3> origins(Num_rays);
+    std::vector<float3> directions(Num_rays);
+
+    rnd::Generator rng(0, 0);
+
+    for (uint32_t i = 0; i < Num_rays; ++i) {
+        origins[i]    = 1.8f * float3(rng.random_float(), rng.random_float(), rng.random_float());
+        directions[i] = random_direction(rng);
+    }
+
+    Node_stack nodes;
+
+    for (float const budget : {0.f, 0.1f, 0.3f, 1.f}) {
+        triangle::bvh::Tree tree;
+
+        auto const start = Clock::now();
+
+        triangle::bvh::Builder_SAH builder(16, 64, 4, budget);
+        builder.build(tree, uint32_t(triangles.size()), triangles.data(), vertex_stream,
+                      threads);
+
+        std::cout << "budget " << budget << ": build " << seconds_since(start) << " s, SAH "
+                  << triangle::bvh::Builder_SAH::sah(tree) << ", " << tree.num_nodes()
+                  << " nodes, " << tree.num_triangles() << " references for "
+                  << triangles.size() << " triangles" << std::endl;
+
+        // The sum of the hit distances doesn't depend on the order of the triangles in the tree
+        double checksum = 0.;
+
+        auto const trace_start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_rays; ++i) {
+            scalar max_t(8.f);
+
+            triangle::Intersection isec;
+
+            nodes.clear();
+
+            if (tree.intersect(Simdf(origins[i]), Simdf(directions[i]), scalar(0.f), max_t, nodes,
+                               isec)) {
+                checksum += double(max_t.x());
+            }
+        }
+
+        float const duration = seconds_since(trace_start);
+
+        std::cout << "intersect:   " << float(Num_rays) / (1000000.f * duration)
+                  << " Mrays/s (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+}  // namespace testing::bvh
@@ -0,0 +1,12 @@
+#ifndef SU_CORE_TESTING_BVH_HPP
+#define SU_CORE_TESTING_BVH_HPP
+
+namespace testing::bvh {
+
+void traversal();
+
+void spatial_splits();
+
+}  // namespace testing::bvh
+
+#endif
@@ -1,281 +1,196 @@
-/*
 #include "testing_cdf.hpp"
-#include <fstream>
-#include <iostream>
-#include <vector>
-#include "base/chrono/chrono.hpp"
 #include "base/math/distribution_1d.inl"
+#include "base/math/distribution_2d.hpp"
+#include "base/math/distribution_alias_1d.inl"
+#include "base/math/vector2.inl"
+#include "base/memory/array.inl"
 #include "base/random/generator.inl"
-#include "base/spectrum/rgb.hpp"
-#include "base/string/string.hpp"
-#include "file/file_system.hpp"
-#include "image/encoding/rgbe/rgbe_reader.hpp"
-#include "image/texture/texture_float_3.hpp"
-
-namespace testing {
-namespace cdf {
-
-template <typename T, typename U>
-void compare_distributions(T const& a, const U& b, float r);
-
-template <typename T, typename U>
-void assert_distributions(T const& a, const U& b, float2 r);
-
-template <typename T>
-void test_distribution(T const& d, const std::vector<float>& samples);
-
-template <typename T>
-void test_distribution(T const& d, const std::vector<float2>& samples);
-
-template <typename T, typename U>
-void assert_distributions(T const& a, const U& b, const std::vector<float2>& samples);
-
-template <typename T>
-void init(T& distribution, const image::texture::Float3& texture);
-
-void test_1D() {
-    std::cout << "testing::cdf::test_1D()" << std::endl;
-
-    rnd::Generator rng(0, 0);
-
-    //	size_t const num_values = 1024 * 10;
-
-    //	std::vector<float> values(num_values);
 
-    //	for (size_t i = 0, len = values.size(); i < len; ++i) {
-    //		values[i] = 8.f * rng.random_float();
-    //	}
-
-    std::vector<float> values = {0.0f, 3.f, 0.0f, 0.f};
-
-    //	size_t const num_samples = 1024 * 1024 * 32;
-
-    //	std::vector<float> samples(num_samples);
-
-    //	for (size_t i = 0, len = samples.size(); i < len; ++i) {
-    //		samples[i] = rng.random_float();
-    //	}
-
-    math::Distribution_1D a;
-    a.init(values.data(), uint32_t(values.size()));
-
-    math::Distribution_lut_1D b;
-    b.init(values.data(), uint32_t(values.size()));
-
-    math::Distribution_implicit_pdf_lut_1D c;
-    c.init(values.data(), uint32_t(values.size()));
-
-    //	math::Distribution_implicit_pdf_lut_1D d;
-    //	d.init(values.data(), uint32_t(values.size()), 8);
+#include <chrono>
+#include <cmath>
+#include <iostream>
 
-    math::Distribution_1D e;
-    e.init(values.data(), uint32_t(values.size()));
+// Search based distributions compared to the alias method
 
-    //	math::Distribution_1D f;
-    //	f.init(values.data(), uint32_t(values.size()), 8);
+namespace testing::cdf {
 
-    //	std::cout << "Distribution_1D" << std::endl;
-    //	test_distribution(a, samples);
+using Clock = std::chrono::high_resolution_clock;
 
-    //	std::cout << "Distribution_lut_1D" << std::endl;
-    //	test_distribution(b, samples);
+static float nanoseconds_since(Clock::time_point start) {
+    auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                                start);
+    return float(duration.count());
+}
 
-    //	std::cout << "Distribution_implicit_pdf_lut_1D(" << c.lut_size() << ")" << std::endl;
-    //	test_distribution(c, samples);
+static uint32_t constexpr Num_samples = 1 << 22;
 
-    //	std::cout << "Distribution_implicit_pdf_lut_1D(" << d.lut_size() << ")" << std::endl;
-    //	test_distribution(d, samples);
+// Mostly small values with a few bright spots, similar to the powers of lights or triangles
+static void fill(memory::Array<float>& data, rnd::Generator& rng) {
+    for (auto& d : data) {
+        float const r = rng.random_float();
 
-    //	std::cout << "Distribution_1D(" << e.lut_size() << ")" << std::endl;
-    //	test_distribution(e, samples);
+        d = r * r * r * r;
+    }
+}
 
-    //	std::cout << "Distribution_1D(" << f.lut_size() << ")" << std::endl;
-    //	test_distribution(f, samples);
+template <typename T>
+static void time_discrete(T const& distribution, memory::Array<float> const& samples,
+                          char const* name) {
+    auto const start = Clock::now();
 
-    compare_distributions(a, e, 0.3f);
+    uint32_t sum = 0;
+    for (float const r : samples) {
+        sum += distribution.sample_discrete(r).offset;
+    }
 
-    //	float pdf;
-    //	float const result = e.sample_discrete(0.5f, pdf);
-    //	std::cout << result << " " << pdf << std::endl;
+    std::cout << "  " << name << " discrete: "
+              << nanoseconds_since(start) / float(samples.size()) << " ns (" << sum << ")"
+              << std::endl;
 }
 
-void test_2D() {
-    std::cout << "testing::cdf::test_2D()" << std::endl;
-
-    image::encoding::rgbe::Reader reader;
-
-    std::string const name = "../data/textures/uffizi_spherical.hdr";
-    //	std::string const name = "../data/textures/river_road_spherical.hdr";
-    //	std::string const name = "../data/textures/city_night_lights_spherical.hdr";
-    //	std::string const name = "../data/textures/ennis_spherical.hdr";
+template <typename T>
+static void time_continuous(T const& distribution, memory::Array<float> const& samples,
+                            char const* name) {
+    auto const start = Clock::now();
 
-    std::ifstream stream(name, std::ios::binary);
-    if (!stream) {
-        std::cout << "Could not read image" << std::endl;
-        return;
+    float sum = 0.f;
+    for (float const r : samples) {
+        sum += distribution.sample_continuous(r).offset;
     }
 
-    rnd::Generator rng(0, 0);
-
-    size_t const num_samples = 1024 * 1024 * 16;
-
-    std::vector<float2> samples(num_samples);
+    std::cout << "  " << name << " continuous: "
+              << nanoseconds_since(start) / float(samples.size()) << " ns (" << sum << ")"
+              << std::endl;
+}
 
-    samples[0] = float2(0.f, 0.f);
-    samples[1] = float2(0.f, 1.f);
-    samples[2] = float2(1.f, 0.f);
-    samples[3] = float2(1.f, 1.f);
+// Largest difference between the frequency of every offset and its pdf
+template <typename T>
+static float max_error(T const& distribution, uint32_t len, memory::Array<float> const& samples) {
+    memory::Array<uint32_t> counts(len, 0u);
 
-    for (size_t i = 4, len = samples.size(); i < len; ++i) {
-        samples[i] = float2(rng.random_float(), rng.random_float());
+    for (float const r : samples) {
+        ++counts[distribution.sample_discrete(r).offset];
     }
 
-    auto image = reader.read(stream);
+    float error = 0.f;
 
-    const image::texture::Float3 texture(image);
+    for (uint32_t i = 0; i < len; ++i) {
+        float const frequency = float(counts[i]) / float(samples.size());
 
-    math::Distribution_t_2D<math::Distribution_1D> a;
-    init(a, texture);
+        error = std::max(error, std::abs(frequency - distribution.pdf(i)));
+    }
 
-    math::Distribution_t_2D<math::Distribution_lut_1D> b;
-    init(b, texture);
+    return error;
+}
 
-    math::Distribution_t_2D<math::Distribution_implicit_pdf_lut_1D> c;
-    init(c, texture);
+void test_1D() {
+    std::cout << "testing::cdf::test_1D()" << std::endl;
 
-    math::Distribution_t_2D<math::Distribution_1D> d;
-    init(d, texture);
+    rnd::Generator rng(0, 0);
 
-    std::cout << "Distribution_2D" << std::endl;
-    test_distribution(a, samples);
+    memory::Array<float> samples(Num_samples);
 
-    std::cout << "Distribution_lut_2D" << std::endl;
-    test_distribution(b, samples);
+    for (auto& s : samples) {
+        s = rng.random_float();
+    }
 
-    std::cout << "Distribution_implicit_pdf_lut_2D" << std::endl;
-    test_distribution(c, samples);
+    uint32_t const sizes[] = {16, 256, 4096, 65536, 1 << 20};
 
-    std::cout << "Distribution_implicit_pdf_lut_lin_2D" << std::endl;
-    test_distribution(d, samples);
+    for (uint32_t const len : sizes) {
+        memory::Array<float> data(len);
 
-    //	assert_distributions(a, d, samples);
+        fill(data, rng);
 
-    std::cout << "Done" << std::endl;
-}
+        Distribution_1D search;
 
-template <typename T, typename U>
-void compare_distributions(T const& a, const U& b, float r) {
-    auto const a_d = a.sample_discrete(r);
+        auto start = Clock::now();
 
-    auto const a_r = a.sample_continuous(r);
+        search.init(data.data(), len);
 
-    float const a_pdf_2 = a.pdf(r);
+        float const search_init = nanoseconds_since(start) / 1000.f;
 
-    auto const b_d = b.sample_discrete(r);
+        Distribution_alias_1D alias;
 
-    auto const b_r = b.sample_continuous(r);
+        start = Clock::now();
 
-    float const b_pdf_2 = b.pdf(r);
+        alias.init(data.data(), len);
 
-    std::cout << "a(" << r << "): " << a_d.offset << ", " << a_r.offset << ", " << a_d.pdf << ", "
-              << a_r.pdf << ", " << a_pdf_2 << std::endl;
+        float const alias_init = nanoseconds_since(start) / 1000.f;
 
-    std::cout << "b(" << r << "): " << b_d.offset << ", " << b_r.offset << ", " << b_d.pdf << ", "
-              << b_r.pdf << ", " << b_pdf_2 << std::endl;
-}
+        std::cout << len << " entries" << std::endl;
 
-template <typename T, typename U>
-void assert_distributions(T const& a, const U& b, float2 r) {
-    float        a_pdf;
-    float2 const a_r = a.sample_continuous(r, a_pdf);
+        std::cout << "  init: " << search_init << " us search, " << alias_init << " us alias"
+                  << std::endl;
 
-    float        b_pdf;
-    float2 const b_r = b.sample_continuous(r, b_pdf);
+        time_discrete(search, samples, "search");
+        time_discrete(alias, samples, "alias");
 
-    if (a_r != b_r || std::abs(a_pdf - b_pdf) > 0.000001f) {
-        std::cout << "a(" << r << "): " << a_r << ", " << a_pdf << std::endl;
+        time_continuous(search, samples, "search");
+        time_continuous(alias, samples, "alias");
 
-        std::cout << "b(" << r << "): " << b_r << ", " << b_pdf << std::endl;
+        if (len <= 4096) {
+            std::cout << "  max error: " << max_error(search, len, samples) << " search, "
+                      << max_error(alias, len, samples) << " alias" << std::endl;
+        }
     }
 }
 
 template <typename T>
-void test_distribution(T const& d, const std::vector<float>& samples) {
-    auto const start = std::chrono::high_resolution_clock::now();
-
-    float accumulated_r   = 0.f;
-    float accumulated_pdf = 0.f;
-
-    float const inv_num_samples = 1.f / float(samples.size());
+static void init(T& distribution, memory::Array<float> const& data, uint32_t width,
+                 uint32_t height) {
+    auto* conditional = distribution.allocate(height);
 
-    for (size_t i = 0, len = samples.size(); i < len; ++i) {
-        float       pdf;
-        float const r = d.sample_continuous(samples[i], pdf);
-
-        accumulated_r += inv_num_samples * r;
-        accumulated_pdf += inv_num_samples * pdf;
+    for (uint32_t y = 0; y < height; ++y) {
+        conditional[y].init(data.data() + y * width, width);
     }
 
-    auto const duration = chrono::seconds_since(start);
-
-    std::cout << "accumulated r: " << accumulated_r << std::endl;
-    std::cout << "accumulated pdf: " << accumulated_pdf << std::endl;
-
-    std::cout << "in " << string::to_string(duration) << " s" << std::endl;
+    distribution.init();
 }
 
 template <typename T>
-void test_distribution(T const& d, const std::vector<float2>& samples) {
-    auto const start = std::chrono::high_resolution_clock::now();
-
-    float2 accumulated_r   = 0.f;
-    float  accumulated_pdf = 0.f;
-
-    float const inv_num_samples = 1.f / float(samples.size());
+static void time_2D(T const& distribution, memory::Array<float> const& samples,
+                    char const* name) {
+    auto const start = Clock::now();
 
-    for (size_t i = 0, len = samples.size(); i < len; ++i) {
-        auto const r = d.sample_continuous(samples[i]);
-
-        accumulated_r += inv_num_samples * r.uv;
-        accumulated_pdf += inv_num_samples * r.pdf;
+    float2 sum(0.f);
+    for (uint32_t i = 0, len = samples.size() - 1; i < len; i += 2) {
+        sum += distribution.sample_continuous(float2(samples[i], samples[i + 1])).uv;
     }
 
-    auto const duration = chrono::seconds_since(start);
+    std::cout << "  " << name << ": " << nanoseconds_since(start) / float(samples.size() / 2)
+              << " ns (" << sum[0] << ", " << sum[1] << ")" << std::endl;
+}
 
-    std::cout << "accumulated r: " << accumulated_r << std::endl;
-    std::cout << "accumulated pdf: " << accumulated_pdf << std::endl;
+void test_2D() {
+    std::cout << "testing::cdf::test_2D()" << std::endl;
 
-    std::cout << "in " << string::to_string(duration) << " s" << std::endl;
-}
+    rnd::Generator rng(0, 0);
 
-template <typename T, typename U>
-void assert_distributions(T const& a, const U& b, const std::vector<float2>& samples) {
-    for (size_t i = 0, len = samples.size(); i < len; ++i) {
-        assert_distributions(a, b, samples[i]);
+    memory::Array<float> samples(Num_samples);
+
+    for (auto& s : samples) {
+        s = rng.random_float();
     }
-}
 
-template <typename T>
-void init(T& distribution, const image::texture::Float3& texture) {
-    auto const d = texture.dimensions_2();
+    // Typical environment map resolutions
+    uint2 const dimensions[] = {uint2(512, 256), uint2(2048, 1024), uint2(8192, 4096)};
 
-    std::vector<typename T::Distribution_impl> conditional(d[1]);
+    for (uint2 const d : dimensions) {
+        memory::Array<float> data(d[0] * d[1]);
 
-    std::vector<float> luminance(d[0]);
+        fill(data, rng);
 
-    for (int32_t y = 0; y < d[1]; ++y) {
-        for (int32_t x = 0; x < d[0]; ++x) {
-            float3 const radiance = texture.at_3(x, y);
+        Distribution_2D search;
+        init(search, data, d[0], d[1]);
 
-            luminance[x] = spectrum::luminance(radiance);
-        }
+        Distribution_alias_2D alias;
+        init(alias, data, d[0], d[1]);
 
-        conditional[y].init(luminance.data(), d[0]);
-    }
+        std::cout << d[0] << " x " << d[1] << std::endl;
 
-    distribution.init(conditional);
+        time_2D(search, samples, "search");
+        time_2D(alias, samples, "alias");
+    }
 }
 
-}  // namespace cdf
-}  // namespace testing
-*/
+}  // namespace testing::cdf
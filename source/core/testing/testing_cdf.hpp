@@ -1,11 +1,12 @@
-#pragma once
+#ifndef SU_CORE_TESTING_CDF_HPP
+#define SU_CORE_TESTING_CDF_HPP
 
-namespace testing {
-namespace cdf {
+namespace testing::cdf {
 
 void test_1D();
 
 void test_2D();
 
-}  // namespace cdf
-}  // namespace testing
+}  // namespace testing::cdf
+
+#endif
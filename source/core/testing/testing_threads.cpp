@@ -0,0 +1,144 @@
+#include "testing_threads.hpp"
+#include "base/memory/array.inl"
+#include "base/string/string.hpp"
+#include "base/thread/thread_pool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace testing::threads {
+
+using Clock = std::chrono::high_resolution_clock;
+
+static float microseconds_since(Clock::time_point start) {
+    auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                                start);
+    return float(duration.count()) / 1000.f;
+}
+
+// Work that gets more expensive towards the end of the range,
+// similar to a few expensive cells in an otherwise cheap light tree or photon map
+static float uneven_work(int32_t i, int32_t num_items) {
+    int32_t const num_iterations = i > (num_items * 7) / 8 ? 4096 : 64;
+
+    float result = float(i);
+    for (int32_t j = 0; j < num_iterations; ++j) {
+        result = std::sqrt(result + float(j));
+    }
+
+    return result;
+}
+
+void dispatch() {
+    std::cout << "testing::threads::dispatch()" << std::endl;
+
+    uint32_t const num_threads = Threads::num_threads(0);
+
+    Threads pool(num_threads);
+
+    uint32_t constexpr Num_iterations = 10000;
+
+    memory::Array<uint32_t> counters(num_threads, 0u);
+
+    {
+        auto const start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_iterations; ++i) {
+            pool.run_parallel([&counters](uint32_t id) noexcept { ++counters[id]; });
+        }
+
+        std::cout << "run_parallel: " << microseconds_since(start) / float(Num_iterations)
+                  << " us" << std::endl;
+    }
+
+    {
+        auto const start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_iterations; ++i) {
+            pool.run_range([&counters](uint32_t id, int32_t begin,
+                                       int32_t end) noexcept { counters[id] += end - begin; },
+                           0, int32_t(num_threads));
+        }
+
+        std::cout << "run_range:    " << microseconds_since(start) / float(Num_iterations)
+                  << " us" << std::endl;
+    }
+
+    {
+        auto const start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_iterations; ++i) {
+            pool.run_async([]() noexcept {});
+        }
+
+        pool.wait_async();
+
+        std::cout << "run_async:    " << microseconds_since(start) / float(Num_iterations)
+                  << " us" << std::endl;
+    }
+
+    {
+        // Nested fork-join
+        auto const start = Clock::now();
+
+        for (uint32_t i = 0; i < Num_iterations / 100; ++i) {
+            pool.run_range(
+                [&pool](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+                    for (int32_t j = begin; j < end; ++j) {
+                        // The inner ids are shared by all outer ids, so they can't own counters
+                        pool.run_range(
+                            [](uint32_t /*id*/, int32_t /*b*/, int32_t /*e*/) noexcept {}, 0, 64);
+                    }
+                },
+                0, int32_t(num_threads));
+        }
+
+        std::cout << "nested:       "
+                  << microseconds_since(start) / float(Num_iterations / 100) << " us" << std::endl;
+    }
+}
+
+void scaling() {
+    std::cout << "testing::threads::scaling()" << std::endl;
+
+    int32_t constexpr Num_items = 1 << 16;
+
+    float reference = 0.f;
+
+    for (uint32_t num_threads = 1, max_threads = Threads::num_threads(0);;) {
+        Threads pool(num_threads);
+
+        memory::Array<float> results(num_threads, 0.f);
+
+        auto const start = Clock::now();
+
+        pool.run_range(
+            [&results](uint32_t id, int32_t begin, int32_t end) noexcept {
+                float result = 0.f;
+                for (int32_t i = begin; i < end; ++i) {
+                    result += uneven_work(i, Num_items);
+                }
+
+                results[id] += result;
+            },
+            0, Num_items);
+
+        float const duration = microseconds_since(start);
+
+        if (1 == num_threads) {
+            reference = duration;
+        }
+
+        std::cout << num_threads << " threads: " << duration / 1000.f << " ms (speedup "
+                  << reference / duration << ")" << std::endl;
+
+        if (num_threads == max_threads) {
+            break;
+        }
+
+        num_threads = std::min(num_threads * 2, max_threads);
+    }
+}
+
+}  // namespace testing::threads
@@ -0,0 +1,12 @@
+#ifndef SU_CORE_TESTING_THREADS_HPP
+#define SU_CORE_TESTING_THREADS_HPP
+
+namespace testing::threads {
+
+void dispatch();
+
+void scaling();
+
+}  // namespace testing::threads
+
+#endif
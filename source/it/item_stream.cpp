@@ -0,0 +1,193 @@
+#include "item_stream.hpp"
+#include "base/memory/variant_map.inl"
+#include "base/thread/thread_pool.hpp"
+#include "core/image/channels.hpp"
+#include "core/image/image.hpp"
+#include "core/image/image_provider.hpp"
+#include "core/image/texture/texture.inl"
+#include "core/image/texture/texture_provider.hpp"
+#include "core/logging/logging.hpp"
+#include "core/resource/resource_manager.hpp"
+
+using Texture_provider = texture::Provider;
+
+Item_stream::Item_stream(Strings const& names, Strings const& outputs, uint32_t first_output,
+                         uint32_t look_ahead, image::Provider& provider, Resources& resources)
+    : names_(names),
+      outputs_(outputs),
+      first_output_(first_output),
+      provider_(provider),
+      resources_(resources),
+      slots_(look_ahead + 2, Slot{State::Free, 0, Texture()}),
+      images_(look_ahead + 2, nullptr),
+      scene_(images_, materials_, shapes_, 0xFFFFFFFF) {
+    // Same as texture::Provider does for Usage::Color_with_alpha
+    options_.set("swizzle", Swizzle::XYZW);
+    options_.set("color", true);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    fill();
+}
+
+Item_stream::~Item_stream() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        loaded_signal_.wait(lock, [this]() {
+            for (auto const& s : slots_) {
+                if (State::Loading == s.state) {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    for (auto i : images_) {
+        delete i;
+    }
+}
+
+Scene const& Item_stream::scene() const {
+    return scene_;
+}
+
+uint32_t Item_stream::num_images() const {
+    return uint32_t(names_.size());
+}
+
+uint32_t Item_stream::current() const {
+    return current_;
+}
+
+bool Item_stream::next(Item& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!pending_.empty()) {
+        uint32_t const s = pending_.front();
+
+        Slot& slot = slots_[s];
+
+        loaded_signal_.wait(lock, [&slot]() { return State::Loading != slot.state; });
+
+        pending_.pop_front();
+
+        uint32_t const index = slot.index;
+
+        if (!slot.texture.is_valid()) {
+            delete images_[s];
+            images_[s] = nullptr;
+
+            slot.state = State::Free;
+
+            fill();
+            continue;
+        }
+
+        slot.state = State::Taken;
+
+        uint32_t const output = index - first_output_;
+
+        std::string const name_out = index >= first_output_ && output < outputs_.size()
+                                         ? outputs_[output]
+                                         : "";
+
+        item = Item{names_[index], name_out, slot.texture};
+
+        current_ = index;
+
+        return true;
+    }
+
+    return false;
+}
+
+void Item_stream::release(Item const& item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (uint32_t s = 0, len = uint32_t(slots_.size()); s < len; ++s) {
+        Slot& slot = slots_[s];
+
+        if (State::Taken == slot.state && item.image == slot.texture) {
+            delete images_[s];
+            images_[s] = nullptr;
+
+            slot.state = State::Free;
+            break;
+        }
+    }
+
+    fill();
+}
+
+void Item_stream::restart(uint32_t begin) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (uint32_t const s : pending_) {
+        Slot& slot = slots_[s];
+
+        loaded_signal_.wait(lock, [&slot]() { return State::Loading != slot.state; });
+
+        delete images_[s];
+        images_[s] = nullptr;
+
+        slot.state = State::Free;
+    }
+
+    pending_.clear();
+
+    next_load_ = begin;
+
+    fill();
+}
+
+void Item_stream::load(uint32_t slot) {
+    uint32_t const index = slots_[slot].index;
+
+    std::string resolved_name;
+    image::Image* image = provider_.load(names_[index], options_, resources_, resolved_name);
+
+    if (!image) {
+        // Right away, so that the message isn't mixed up with what is pushed by other loads
+        logging::error("Loading texture %S: ", names_[index]);
+    }
+
+    Texture const texture = image ? Texture_provider::create(
+                                        *image, slot, Texture_provider::Usage::Color_with_alpha,
+                                        float2(1.f))
+                                  : Texture();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    images_[slot] = image;
+
+    slots_[slot].texture = texture;
+    slots_[slot].state   = State::Loaded;
+
+    loaded_signal_.notify_all();
+}
+
+void Item_stream::fill() {
+    for (uint32_t s = 0, len = uint32_t(slots_.size()); s < len; ++s) {
+        if (next_load_ >= uint32_t(names_.size())) {
+            return;
+        }
+
+        Slot& slot = slots_[s];
+
+        if (State::Free != slot.state) {
+            continue;
+        }
+
+        slot.state = State::Loading;
+        slot.index = next_load_;
+
+        ++next_load_;
+
+        pending_.push_back(s);
+
+        resources_.threads().run_async([this, s]() { load(s); });
+    }
+}
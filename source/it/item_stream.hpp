@@ -0,0 +1,104 @@
+#ifndef SU_IT_ITEM_STREAM_HPP
+#define SU_IT_ITEM_STREAM_HPP
+
+#include "base/memory/variant_map.hpp"
+#include "core/scene/scene.hpp"
+#include "item.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace image {
+class Image;
+class Provider;
+}  // namespace image
+
+namespace resource {
+class Manager;
+}
+
+// Decodes the images of a potentially very long list concurrently, a bounded number of them
+// ahead of the consumer, and hands them out in order. The images are not owned by the resource
+// manager, but live in a fixed number of slots that are reused once an item is released.
+// So the memory doesn't depend on the number of images.
+class Item_stream {
+  public:
+    using Strings   = std::vector<std::string>;
+    using Resources = resource::Manager;
+
+    // Output names are assigned starting with the image at first_output
+    Item_stream(Strings const& names, Strings const& outputs, uint32_t first_output,
+                uint32_t look_ahead, image::Provider& provider, Resources& resources);
+
+    ~Item_stream();
+
+    // The scene that the textures of the items refer to
+    Scene const& scene() const;
+
+    uint32_t num_images() const;
+
+    // Index of the image of the item that was returned last by next()
+    uint32_t current() const;
+
+    // Waits for the next image that could be loaded. Returns false after the last one.
+    // The item stays valid until it is released.
+    bool next(Item& item);
+
+    void release(Item const& item);
+
+    // Continues with the image at begin. Items that are not released yet stay valid.
+    void restart(uint32_t begin);
+
+  private:
+    enum class State { Free, Loading, Loaded, Taken };
+
+    struct Slot {
+        State state;
+
+        uint32_t index;
+
+        Texture texture;
+    };
+
+    void load(uint32_t slot);
+
+    // Starts loading images into the free slots. Must be called with the mutex held.
+    void fill();
+
+    Strings const& names_;
+    Strings const& outputs_;
+
+    uint32_t first_output_;
+
+    image::Provider& provider_;
+
+    Resources& resources_;
+
+    memory::Variant_map options_;
+
+    std::vector<Slot> slots_;
+
+    // Never resized, because scene_ refers to it
+    std::vector<image::Image*> images_;
+
+    std::vector<scene::material::Material*> materials_;
+    std::vector<scene::shape::Shape*>       shapes_;
+
+    Scene scene_;
+
+    // Slots in the order of their images
+    std::deque<uint32_t> pending_;
+
+    uint32_t next_load_ = 0;
+
+    uint32_t current_ = 0;
+
+    std::mutex mutex_;
+
+    std::condition_variable loaded_signal_;
+};
+
+#endif
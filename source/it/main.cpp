@@ -13,11 +13,15 @@
 #include "core/scene/scene.hpp"
 #include "core/take/take_loader.hpp"
 #include "item.hpp"
+#include "item_stream.hpp"
 #include "operator/add.hpp"
 #include "operator/average.hpp"
 #include "operator/concatenate.hpp"
 #include "operator/difference.hpp"
+#include "operator/merge.hpp"
+#include "operator/sparse.hpp"
 #include "operator/statistics.hpp"
+#include "operator/tile.hpp"
 #include "options/options.hpp"
 
 namespace scene {
@@ -97,61 +101,117 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    std::vector<Item> items;
-    items.reserve(args.images.size());
+    if (Options::Operator::Merge == args.op) {
+        // The inputs are not images, but the raw results of separate sprout processes
+        if (uint32_t const num = op::merge(args.images, args, threads); num) {
+            logging::info("merge " + string::to_string(num) + " parts in " +
+                          string::to_string(chrono::seconds_since(total_start)) + " s");
+            return 0;
+        }
 
-    memory::Variant_map options;
-    options.set("usage", texture::Provider::Usage::Color_with_alpha);
+        return 1;
+    }
 
-    uint32_t slot = Options::Operator::Diff == args.op ? 0xFFFFFFFF : 0;
-    for (auto& i : args.images) {
-        if (Texture const image = texture::Provider::load(i, options, float2(1.f), resources);
-            image.is_valid()) {
-            std::string const name_out = slot < args.outputs.size() ? args.outputs[slot] : "";
+    bool const statistics = Options::Operator::Undefined == args.op || !args.statistics.empty();
 
-            items.emplace_back(Item{i, name_out, image});
+    // Diff has no output for the reference
+    uint32_t const first_output = Options::Operator::Diff == args.op ? 1 : 0;
+
+    if (Options::Operator::Cat == args.op || Options::Operator::Tile == args.op) {
+        if (statistics) {
+            Item_stream items(args.images, args.outputs, first_output, args.look_ahead,
+                              image_provider, resources);
+
+            op::statistics(items, args, threads);
         }
 
-        ++slot;
-    }
+        // These need all the images at the same time
+        std::vector<Item> items;
+        items.reserve(args.images.size());
 
-    if (items.empty()) {
-        return 1;
+        memory::Variant_map options;
+        options.set("usage", texture::Provider::Usage::Color_with_alpha);
+
+        uint32_t slot = 0;
+        for (auto& i : args.images) {
+            if (Texture const image = texture::Provider::load(i, options, float2(1.f), resources);
+                image.is_valid()) {
+                std::string const name_out = slot < args.outputs.size() ? args.outputs[slot] : "";
+
+                items.emplace_back(Item{i, name_out, image});
+            }
+
+            ++slot;
+        }
+
+        if (items.empty()) {
+            return 1;
+        }
+
+        if (Options::Operator::Cat == args.op) {
+            if (uint32_t const num = op::concatenate(items, args, pipeline, scene, threads); num) {
+                logging::info("cat " + string::to_string(num) + " images in " +
+                              string::to_string(chrono::seconds_since(total_start)) + " s");
+            }
+        } else {
+            if (uint32_t const num = op::tile(items, args, scene); num) {
+                logging::info("tile " + string::to_string(num) + " images in " +
+                              string::to_string(chrono::seconds_since(total_start)) + " s");
+            }
+        }
+
+        return 0;
     }
 
-    if (Options::Operator::Undefined == args.op || !args.statistics.empty()) {
-        op::statistics(items, args, scene, resources.threads());
+    // The remaining operators look at one image after the other,
+    // so they don't have to be in memory at the same time
+    Item_stream items(args.images, args.outputs, first_output, args.look_ahead, image_provider,
+                      resources);
+
+    if (statistics) {
+        if (0 == op::statistics(items, args, threads)) {
+            return 1;
+        }
+
+        if (Options::Operator::Undefined == args.op) {
+            return 0;
+        }
+
+        items.restart(0);
     }
 
+    uint32_t num = 0;
+
     if (Options::Operator::Add == args.op) {
-        if (uint32_t const num = op::add(items, args, scene, resources.threads()); num) {
+        if (num = op::add(items, args, threads); num) {
             logging::info("add " + string::to_string(num) + " images in " +
                           string::to_string(chrono::seconds_since(total_start)) + " s");
         }
     } else if (Options::Operator::Average == args.op) {
-        if (uint32_t const num = op::average(items, args, scene, resources.threads()); num) {
+        if (num = op::average(items, args, threads); num) {
             logging::info("average " + string::to_string(num) + " images in " +
                           string::to_string(chrono::seconds_since(total_start)) + " s");
         }
     } else if (Options::Operator::Diff == args.op) {
-        if (uint32_t const num = op::difference(items, args, scene, resources.threads()); num) {
+        if (num = op::difference(items, args, threads); num) {
             logging::info("diff " + string::to_string(num) + " images in " +
                           string::to_string(chrono::seconds_since(total_start)) + " s");
         }
-    } else if (Options::Operator::Cat == args.op) {
-        if (uint32_t const num = op::concatenate(items, args, pipeline, scene, resources.threads());
-            num) {
-            logging::info("cat " + string::to_string(num) + " images in " +
+    } else if (Options::Operator::Sparse == args.op) {
+        if (num = op::sparse(items, args); num) {
+            logging::info("sparse " + string::to_string(num) + " images in " +
                           string::to_string(chrono::seconds_since(total_start)) + " s");
         }
     } else if (Options::Operator::Sub == args.op) {
-        if (uint32_t const num = op::sub(items, args, scene, resources.threads()); num) {
+        if (num = op::sub(items, args, threads); num) {
             logging::info("subtract " + string::to_string(num) + " images in " +
                           string::to_string(chrono::seconds_since(total_start)) + " s");
         }
+    } else {
+        return 0;
     }
 
-    return 0;
+    return num ? 0 : 1;
 }
 
 void load_pipeline(std::istream& stream, std::string_view take_name, Pipeline& pipeline,
@@ -1,10 +1,12 @@
 #include "add.hpp"
 #include "base/math/print.hpp"
+#include "base/string/string.hpp"
 #include "base/thread/thread_pool.hpp"
 #include "core/image/texture/texture.inl"
 #include "core/logging/logging.hpp"
 #include "core/scene/scene.hpp"
 #include "item.hpp"
+#include "item_stream.hpp"
 #include "operator_helper.hpp"
 
 namespace op {
@@ -12,88 +14,127 @@ namespace op {
 using namespace scene;
 using namespace it::options;
 
-uint32_t add(Items const& items, Options const& /*options*/, Scene const& scene, Threads& threads) {
-    int2 const d = max_dimensions_2(items, scene);
+// Keeps the accumulated values of a smaller target in the top left corner
+static void grow(Float4& target, int2 dimensions) {
+    int2 const d = target.description().dimensions().xy();
 
-    Float4 target = Float4(image::Description(d));
+    if (dimensions[0] <= d[0] && dimensions[1] <= d[1]) {
+        return;
+    }
 
-    threads.run_range(
-        [&items, &target, &scene](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
-            int2 const d = target.description().dimensions().xy();
+    Float4 previous = Float4(target.description());
+    target.copy(previous);
 
-            for (int32_t y = begin; y < end; ++y) {
-                for (int32_t x = 0; x < d[0]; ++x) {
-                    float4 a(0.f);
+    target.resize(image::Description(max(d, dimensions)));
+    target.clear(float4(0.f));
 
-                    for (auto const& i : items) {
-                        int2 const db = i.image.description(scene).dimensions().xy();
+    for (int32_t y = 0; y < d[1]; ++y) {
+        for (int32_t x = 0; x < d[0]; ++x) {
+            target.store(x, y, previous.at(x, y));
+        }
+    }
+}
 
-                        if ((x >= db[0]) | (y >= db[1])) {
-                            continue;
-                        }
+uint32_t add(Item_stream& items, Options const& /*options*/, Threads& threads) {
+    Scene const& scene = items.scene();
 
-                        float4 const b = i.image.at_4(x, y, scene);
+    Float4 target = Float4(image::Description(int2(0)));
 
-                        a += b;
-                    }
+    bool alpha = false;
+
+    std::string name;
+
+    uint32_t num = 0;
 
-                    target.store(x, y, a);
+    for (Item item; items.next(item); ++num) {
+        int2 const d = item.image.description(scene).dimensions().xy();
+
+        grow(target, d);
+
+        threads.run_range(
+            [&item, &target, &scene, d](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+                for (int32_t y = begin; y < end; ++y) {
+                    for (int32_t x = 0; x < d[0]; ++x) {
+                        target.store(x, y, target.at(x, y) + item.image.at_4(x, y, scene));
+                    }
                 }
-            }
-        },
-        0, d[1]);
+            },
+            0, d[1]);
+
+        alpha |= 4 == item.image.num_channels();
 
-    bool const alpha = any_has_alpha_channel(items);
+        if (0 == num) {
+            name = item.name_out.empty() ? "add." + string::copy_suffix(item.name)
+                                         : item.name_out;
+        }
 
-    std::string const name = name_out(items, "add");
+        items.release(item);
+    }
+
+    if (0 == num) {
+        return 0;
+    }
 
     write(target, name, alpha, threads);
 
-    return uint32_t(items.size());
+    return num;
 }
 
-uint32_t sub(Items const& items, Options const& /*options*/, Scene const& scene, Threads& threads) {
-    int2 const d = items[0].image.description(scene).dimensions().xy();
+uint32_t sub(Item_stream& items, Options const& /*options*/, Threads& threads) {
+    Scene const& scene = items.scene();
 
-    Float4 target = Float4(image::Description(d));
+    Item first;
+    if (!items.next(first)) {
+        return 0;
+    }
 
-    threads.run_range(
-        [&items, &scene, &target](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
-            auto const& image0 = items[0].image;
+    int2 const d = first.image.description(scene).dimensions().xy();
 
-            int2 const d = image0.description(scene).dimensions().xy();
+    Float4 target = Float4(image::Description(d));
 
+    threads.run_range(
+        [&first, &target, &scene, d](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
             for (int32_t y = begin; y < end; ++y) {
                 for (int32_t x = 0; x < d[0]; ++x) {
-                    float4 a = image0.at_4(x, y, scene);
+                    target.store(x, y, first.image.at_4(x, y, scene));
+                }
+            }
+        },
+        0, d[1]);
 
-                    for (size_t i = 1, len = items.size(); i < len; ++i) {
-                        auto const& imagei = items[i].image;
+    bool alpha = 4 == first.image.num_channels();
 
-                        int2 const db = imagei.description(scene).dimensions().xy();
+    std::string const name = first.name_out.empty() ? "sub." + string::copy_suffix(first.name)
+                                                    : first.name_out;
 
-                        if ((x >= db[0]) | (y >= db[1])) {
-                            continue;
-                        }
+    items.release(first);
 
-                        float4 const b = imagei.at_4(x, y, scene);
+    uint32_t num = 1;
 
-                        a = float4(max(a.xyz() - b.xyz(), 0.f), a[3]);
-                    }
+    for (Item item; items.next(item); ++num) {
+        int2 const db = min(d, item.image.description(scene).dimensions().xy());
 
-                    target.store(x, y, a);
+        threads.run_range(
+            [&item, &target, &scene, db](uint32_t /*id*/, int32_t begin, int32_t end) noexcept {
+                for (int32_t y = begin; y < end; ++y) {
+                    for (int32_t x = 0; x < db[0]; ++x) {
+                        float4 const a = target.at(x, y);
+                        float4 const b = item.image.at_4(x, y, scene);
+
+                        target.store(x, y, float4(max(a.xyz() - b.xyz(), 0.f), a[3]));
+                    }
                 }
-            }
-        },
-        0, d[1]);
+            },
+            0, db[1]);
 
-    bool const alpha = any_has_alpha_channel(items);
+        alpha |= 4 == item.image.num_channels();
 
-    std::string const name = name_out(items, "sub");
+        items.release(item);
+    }
 
     write(target, name, alpha, threads);
 
-    return uint32_t(items.size());
+    return num;
 }
 
 }  // namespace op
@@ -2,7 +2,6 @@
 #define SU_IT_OPERATOR_ADD_HPP
 
 #include <cstdint>
-#include <vector>
 
 namespace scene {
 class Scene;
@@ -20,16 +19,12 @@ namespace it::options {
 struct Options;
 }
 
-struct Item;
-
-using Items = std::vector<Item>;
+class Item_stream;
 
 namespace op {
-uint32_t add(Items const& items, it::options::Options const& options, Scene const& scene,
-             Threads& threads);
+uint32_t add(Item_stream& items, it::options::Options const& options, Threads& threads);
 
-uint32_t sub(Items const& items, it::options::Options const& options, Scene const& scene,
-             Threads& threads);
+uint32_t sub(Item_stream& items, it::options::Options const& options, Threads& threads);
 }  // namespace op
 
 #endif
@@ -5,6 +5,7 @@
 #include "core/logging/logging.hpp"
 #include "core/scene/scene.hpp"
 #include "item.hpp"
+#include "item_stream.hpp"
 #include "operator_helper.inl"
 
 #include <sstream>
@@ -13,9 +14,13 @@ namespace op {
 
 using namespace scene;
 
-uint32_t average(std::vector<Item> const& items, it::options::Options const& /*options*/,
-                 Scene const&             scene, Threads& /*threads*/) {
-    for (auto const& i : items) {
+uint32_t average(Item_stream& items, it::options::Options const& /*options*/,
+                 Threads& /*threads*/) {
+    Scene const& scene = items.scene();
+
+    uint32_t num = 0;
+
+    for (Item i; items.next(i); ++num) {
         if (1 == i.image.num_channels()) {
             logging::info(string::to_string(round(i.image.average_1(scene), 4)));
         } else {
@@ -26,9 +31,11 @@ uint32_t average(std::vector<Item> const& items, it::options::Options const& /*o
 
             logging::info(stream.str());
         }
+
+        items.release(i);
     }
 
-    return uint32_t(items.size());
+    return num;
 }
 
 }  // namespace op
@@ -9,6 +9,7 @@
 #include "difference_report_html.hpp"
 #include "difference_report_org.hpp"
 #include "item.hpp"
+#include "item_stream.hpp"
 #include "options/options.hpp"
 
 #include <fstream>
@@ -21,46 +22,68 @@ using namespace image;
 
 using Texture = texture::Texture;
 
-uint32_t difference(std::vector<Item> const& items, it::options::Options const& options,
-                    Scene const& scene, Threads& threads) {
-    if (items.size() < 2) {
+uint32_t difference(Item_stream& items, it::options::Options const& options,
+                    Threads& threads) {
+    if (items.num_images() < 2) {
         logging::error("Need at least 2 images for diff.");
         return 0;
     }
 
-    Texture const reference = items[0].image;
+    Scene const& scene = items.scene();
 
-    int2 const dimensions = reference.description(scene).dimensions().xy();
+    Item reference;
+    if (!items.next(reference)) {
+        return 0;
+    }
+
+    uint32_t const reference_index = items.current();
+
+    int2 const dimensions = reference.image.description(scene).dimensions().xy();
+
+    // Only the names are needed for the reports
+    std::vector<Item> names;
+    names.push_back(Item{reference.name, reference.name_out, Texture()});
 
     std::vector<Difference_item> candidates;
-    candidates.reserve(items.size() - 1);
 
-    for (size_t i = 1, len = items.size(); i < len; ++i) {
-        Item const& item = items[i];
+    memory::Array<float> difference(uint32_t(dimensions[0] * dimensions[1]));
+
+    memory::Array<Scratch> scratch(threads.num_threads(), Scratch{0.f, 0.f, 0.f});
+
+    // Without a given max difference, the heatmaps can only be written after all differences are
+    // known. Instead of keeping all of them around, they are calculated a second time.
+    bool const export_now = !options.no_export && options.max_dif > 0.f;
+
+    float max_dif = 0.f;
 
+    for (Item item; items.next(item);) {
         if (item.image.description(scene).dimensions().xy() != dimensions) {
             logging::error("%S does not match reference resolution", item.name);
+            items.release(item);
             continue;
         }
 
-        candidates.emplace_back(item, scene);
-    }
+        names.push_back(Item{item.name, item.name_out, Texture()});
 
-    memory::Array<Scratch> scratch(threads.num_threads(), Scratch{0.f, 0.f, 0.f});
+        auto& c = candidates.emplace_back(item);
 
-    float max_dif = 0.f;
-
-    for (auto& c : candidates) {
-        c.calculate_difference(reference, scratch.data(), options.clamp, options.clip, scene,
-                               threads);
+        c.calculate_difference(item.image, reference.image, difference.data(), scratch.data(),
+                               options.clamp, options.clip, scene, threads);
 
         max_dif = std::max(c.max_dif(), max_dif);
+
+        if (export_now) {
+            encoding::png::Writer::write_heatmap(c.name(), difference.data(), dimensions,
+                                                 options.max_dif, threads);
+        }
+
+        items.release(item);
     }
 
     if ("." == options.report) {
         std::ostringstream stream;
 
-        write_difference_summary_org(items, candidates, max_dif, stream);
+        write_difference_summary_org(names, candidates, max_dif, stream);
 
         logging::info(stream.str());
     } else if (!options.report.empty()) {
@@ -69,23 +92,36 @@ uint32_t difference(std::vector<Item> const& items, it::options::Options const&
         std::string_view const suffix = string::suffix(options.report);
 
         if ("htm" == suffix || "html" == suffix) {
-            write_difference_report_html(items, candidates, max_dif, stream);
+            write_difference_report_html(names, candidates, max_dif, stream);
         } else {
-            write_difference_report_org(items, candidates, max_dif, stream);
+            write_difference_report_org(names, candidates, max_dif, stream);
         }
     }
 
-    if (!options.no_export) {
-        if (options.max_dif > 0.f) {
-            max_dif = options.max_dif;
-        }
+    if (!options.no_export && !export_now) {
+        items.restart(reference_index + 1);
 
-        for (auto const& c : candidates) {
-            encoding::png::Writer::write_heatmap(c.name(), c.difference(), dimensions, max_dif,
-                                                 threads);
+        size_t c = 0;
+
+        for (Item item; items.next(item);) {
+            if (item.image.description(scene).dimensions().xy() == dimensions &&
+                c < candidates.size()) {
+                Difference_item& candidate = candidates[c++];
+
+                candidate.calculate_difference(item.image, reference.image, difference.data(),
+                                               scratch.data(), options.clamp, options.clip, scene,
+                                               threads);
+
+                encoding::png::Writer::write_heatmap(candidate.name(), difference.data(),
+                                                     dimensions, max_dif, threads);
+            }
+
+            items.release(item);
         }
     }
 
+    items.release(reference);
+
     return uint32_t(candidates.size()) + 1;
 }
 
@@ -2,13 +2,6 @@
 #define SU_IT_OPERATOR_DIFFERENCE_HPP
 
 #include <cstdint>
-#include <vector>
-
-namespace scene {
-class Scene;
-}
-
-using Scene = scene::Scene;
 
 namespace thread {
 class Pool;
@@ -20,11 +13,10 @@ namespace it::options {
 struct Options;
 }
 
-struct Item;
+class Item_stream;
 
 namespace op {
-uint32_t difference(std::vector<Item> const& items, it::options::Options const& options,
-                    Scene const& scene, Threads& threads);
+uint32_t difference(Item_stream& items, it::options::Options const& options, Threads& threads);
 }
 
 #endif
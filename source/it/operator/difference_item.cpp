@@ -9,26 +9,14 @@ namespace op {
 
 using namespace scene;
 
-Difference_item::Difference_item(Item const& item, Scene const& scene)
+Difference_item::Difference_item(Item const& item)
     : name_(item.name_out.empty() ? item.name.substr(0, item.name.find_last_of('.')) + "_dif.png"
-                                  : item.name_out),
-      image_(item.image) {
-    int2 const d = item.image.description(scene).dimensions().xy();
-    difference_  = new float[d[0] * d[1]];
-}
-
-Difference_item::~Difference_item() {
-    delete[] difference_;
-}
+                                  : item.name_out) {}
 
 std::string Difference_item::name() const {
     return name_;
 }
 
-float const* Difference_item::difference() const {
-    return difference_;
-}
-
 float Difference_item::max_dif() const {
     return round(max_dif_, 4);
 }
@@ -41,9 +29,10 @@ float Difference_item::psnr() const {
     return round(psnr_, 2);
 }
 
-void Difference_item::calculate_difference(Texture const& other, Scratch* scratch, float clamp,
+void Difference_item::calculate_difference(Texture const& image, Texture const& other,
+                                           float* difference, Scratch* scratch, float clamp,
                                            float2 clip, Scene const& scene, Threads& threads) {
-    int2 const d = image_.description(scene).dimensions().xy();
+    int2 const d = image.description(scene).dimensions().xy();
 
     int32_t const num_pixel = d[0] * d[1];
 
@@ -59,7 +48,11 @@ void Difference_item::calculate_difference(Texture const& other, Scratch* scratc
         float2 clip;
     };
 
-    Args args = Args{image_, other, difference_, scratch, clamp, clip};
+    Args args = Args{image, other, difference, scratch, clamp, clip};
+
+    for (uint32_t i = 0, len = threads.num_threads(); i < len; ++i) {
+        scratch[i] = Scratch{0.f, 0.f, 0.f};
+    }
 
     threads.run_range(
         [&args, &scene](uint32_t id, int32_t begin, int32_t end) {
@@ -90,9 +83,11 @@ void Difference_item::calculate_difference(Texture const& other, Scratch* scratc
                 }
             }
 
-            args.scratch[id].max_val = max_val;
-            args.scratch[id].max_dif = max_dif;
-            args.scratch[id].dif_sum = dif_sum;
+            Scratch& s = args.scratch[id];
+
+            s.max_val = std::max(s.max_val, max_val);
+            s.max_dif = std::max(s.max_dif, max_dif);
+            s.dif_sum += dif_sum;
         },
         0, d[1]);
 
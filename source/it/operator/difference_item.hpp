@@ -31,30 +31,24 @@ class Difference_item {
     using Scene   = scene::Scene;
     using Texture = image::texture::Texture;
 
-    Difference_item(Item const& item, Scene const& scene);
-
-    ~Difference_item();
+    Difference_item(Item const& item);
 
     std::string name() const;
 
-    float const* difference() const;
-
     float max_dif() const;
 
     float rmse() const;
 
     float psnr() const;
 
-    void calculate_difference(Texture const& other, Scratch* scratch, float clamp, float2 clip,
-                              Scene const& scene, Threads& threads);
+    // The difference of every pixel is written to difference, which must be as large as image
+    void calculate_difference(Texture const& image, Texture const& other, float* difference,
+                              Scratch* scratch, float clamp, float2 clip, Scene const& scene,
+                              Threads& threads);
 
   private:
     std::string name_;
 
-    Texture image_;
-
-    float* difference_;
-
     float max_dif_;
 
     float psnr_;
@@ -0,0 +1,157 @@
+#include "merge.hpp"
+#include "base/math/vector4.inl"
+#include "base/string/string.hpp"
+#include "core/image/typed_image.hpp"
+#include "core/logging/logging.hpp"
+#include "core/rendering/checkpoint.hpp"
+#include "core/rendering/sensor/aov/value.hpp"
+#include "core/rendering/sensor/clamp.inl"
+#include "core/rendering/sensor/opaque.hpp"
+#include "core/rendering/sensor/transparent.hpp"
+#include "core/rendering/sensor/unfiltered.inl"
+#include "operator_helper.hpp"
+#include "options/options.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace op {
+
+using namespace image;
+
+using Checkpoint = rendering::Checkpoint;
+using Sensor     = rendering::sensor::Sensor;
+using Identity   = rendering::sensor::clamp::Identity;
+
+struct Part {
+    std::string name;
+
+    Checkpoint checkpoint;
+};
+
+static bool read_parts(std::vector<std::string> const& names, std::vector<Part>& parts);
+
+uint32_t merge(std::vector<std::string> const& names, it::options::Options const& options,
+               Threads& threads) {
+    std::vector<Part> parts;
+
+    if (!read_parts(names, parts)) {
+        return 0;
+    }
+
+    std::ifstream stream(parts[0].name, std::ios::binary);
+
+    Checkpoint checkpoint;
+    checkpoint.read(stream);
+
+    int2    dimensions;
+    int32_t num_layers;
+    bool    transparency;
+
+    if (!Sensor::read_layout(stream, dimensions, num_layers, transparency)) {
+        logging::error("Could not read %S.", parts[0].name);
+        return 0;
+    }
+
+    using namespace rendering::sensor;
+
+    // Only used for resolving, so the filter doesn't matter
+    Sensor* sensor = transparency
+                         ? static_cast<Sensor*>(new Unfiltered<Transparent, Identity>(Identity()))
+                         : static_cast<Sensor*>(new Unfiltered<Opaque, Identity>(Identity()));
+
+    // The AOVs are not merged, so the sensor doesn't need any
+    aov::Value_pool const aovs;
+
+    sensor->resize(dimensions, num_layers, aovs);
+
+    bool valid = sensor->read(stream);
+
+    uint32_t num_iterations = parts[0].checkpoint.num_iterations;
+
+    // Always in the order of the split indices, so that the sums don't depend on the order
+    // of the inputs
+    for (size_t i = 1, len = parts.size(); valid && i < len; ++i) {
+        stream = std::ifstream(parts[i].name, std::ios::binary);
+
+        valid = checkpoint.read(stream) && sensor->merge(stream);
+
+        if (!valid) {
+            logging::error("%S does not match the other parts.", parts[i].name);
+        }
+
+        num_iterations += parts[i].checkpoint.num_iterations;
+    }
+
+    if (!valid) {
+        delete sensor;
+        return 0;
+    }
+
+    Float4 target = Float4(image::Description(dimensions));
+
+    // Progressive rendering only uses the second layer for light tracing,
+    // in which case it needs to be resolved as in Driver::postprocess()
+    if (num_layers > 1) {
+        sensor->resolve_accumulate(threads, target);
+    } else {
+        sensor->resolve(threads, target);
+    }
+
+    logging::info("Merged " + string::to_string(num_iterations) + " iterations of frame " +
+                  string::to_string(parts[0].checkpoint.frame));
+
+    std::string const name = options.outputs.empty() ? "merge.exr" : options.outputs[0];
+
+    write(target, name, transparency, threads);
+
+    delete sensor;
+
+    return uint32_t(parts.size());
+}
+
+bool read_parts(std::vector<std::string> const& names, std::vector<Part>& parts) {
+    parts.reserve(names.size());
+
+    for (auto const& n : names) {
+        std::ifstream stream(n, std::ios::binary);
+
+        Checkpoint checkpoint;
+
+        if (!stream || !checkpoint.read(stream)) {
+            logging::error("%S is not a checkpoint.", n);
+            return false;
+        }
+
+        parts.push_back({n, checkpoint});
+    }
+
+    std::sort(parts.begin(), parts.end(), [](Part const& a, Part const& b) {
+        return a.checkpoint.split_index < b.checkpoint.split_index;
+    });
+
+    Checkpoint const& first = parts[0].checkpoint;
+
+    for (size_t i = 1, len = parts.size(); i < len; ++i) {
+        Checkpoint const& c = parts[i].checkpoint;
+
+        if (c.frame != first.frame || c.num_splits != first.num_splits) {
+            logging::error("%S belongs to another frame or split.", parts[i].name);
+            return false;
+        }
+
+        if (c.split_index == parts[i - 1].checkpoint.split_index) {
+            logging::error("%S repeats another part.", parts[i].name);
+            return false;
+        }
+    }
+
+    if (parts.size() < first.num_splits) {
+        logging::warning("Only " + string::to_string(parts.size()) + " of " +
+                         string::to_string(first.num_splits) + " parts are merged.");
+    }
+
+    return true;
+}
+
+}  // namespace op
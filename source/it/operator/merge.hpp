@@ -0,0 +1,27 @@
+#ifndef SU_IT_OPERATOR_MERGE_HPP
+#define SU_IT_OPERATOR_MERGE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace thread {
+class Pool;
+}
+
+using Threads = thread::Pool;
+
+namespace it::options {
+struct Options;
+}
+
+namespace op {
+
+// Combines the checkpoints that sprout --split stored for the parts of a frame,
+// into the resolved image without any postprocessing
+uint32_t merge(std::vector<std::string> const& names, it::options::Options const& options,
+               Threads& threads);
+
+}  // namespace op
+
+#endif
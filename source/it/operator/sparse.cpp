@@ -0,0 +1,43 @@
+#include "sparse.hpp"
+#include "base/string/string.hpp"
+#include "core/image/encoding/sub/sub_image_writer.hpp"
+#include "core/image/image.hpp"
+#include "core/image/texture/texture.inl"
+#include "core/logging/logging.hpp"
+#include "item.hpp"
+#include "item_stream.hpp"
+#include "options/options.hpp"
+
+namespace op {
+
+uint32_t sparse(Item_stream& items, it::options::Options const& /*options*/) {
+    Scene const& scene = items.scene();
+
+    uint32_t num = 0;
+
+    for (Item i; items.next(i);) {
+        Image const* image = i.image.image(scene);
+
+        Image::Type const type = image->type();
+
+        if (Image::Type::Float1_sparse != type && (Image::Type::Float1 != type || !image->data())) {
+            logging::warning("%S is not a Float1 volume.", i.name);
+            items.release(i);
+            continue;
+        }
+
+        // The default must not overwrite the input, which might still be mapped
+        std::string const name = i.name_out.empty() ? string::extract_filename(i.name) + "_sparse"
+                                                    : i.name_out;
+
+        encoding::sub::Writer::write_sparse(name, *image);
+
+        items.release(i);
+
+        ++num;
+    }
+
+    return num;
+}
+
+}  // namespace op
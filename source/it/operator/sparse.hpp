@@ -0,0 +1,16 @@
+#ifndef SU_IT_OPERATOR_SPARSE_HPP
+#define SU_IT_OPERATOR_SPARSE_HPP
+
+#include <cstdint>
+
+namespace it::options {
+struct Options;
+}
+
+class Item_stream;
+
+namespace op {
+uint32_t sparse(Item_stream& items, it::options::Options const& options);
+}
+
+#endif
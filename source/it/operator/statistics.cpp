@@ -4,6 +4,7 @@
 #include "core/logging/logging.hpp"
 #include "core/scene/scene.hpp"
 #include "item.hpp"
+#include "item_stream.hpp"
 #include "options/options.hpp"
 
 #include <fstream>
@@ -81,20 +82,28 @@ class Histogram {
     uint32_t* buckets_;
 };
 
-uint32_t statistics(std::vector<Item> const& items, it::options::Options const& options,
-                    Scene const& scene, Threads& /*threads*/) {
+uint32_t statistics(Item_stream& items, it::options::Options const& options,
+                    Threads& /*threads*/) {
+    Scene const& scene = items.scene();
+
+    bool const multiple = items.num_images() > 1;
+
     std::ostringstream stream;
 
-    for (auto const& i : items) {
-        if (items.size() > 1) {
+    uint32_t num = 0;
+
+    for (Item i; items.next(i); ++num) {
+        if (multiple) {
             stream << i.name << "\n";
         }
 
         write_histogram(i, scene, stream);
 
-        if (items.size() > 1) {
+        if (multiple) {
             stream << "\n";
         }
+
+        items.release(i);
     }
 
     if ("." == options.statistics || options.statistics.empty()) {
@@ -105,7 +114,7 @@ uint32_t statistics(std::vector<Item> const& items, it::options::Options const&
         fstream << stream.str();
     }
 
-    return 1;
+    return num;
 }
 
 Luminance average_and_max_luminance(Texture const& image, Scene const& scene) {
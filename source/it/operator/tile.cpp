@@ -0,0 +1,43 @@
+#include "tile.hpp"
+#include "core/image/encoding/sub/sub_image_writer.hpp"
+#include "core/image/image.hpp"
+#include "core/image/texture/texture.inl"
+#include "core/logging/logging.hpp"
+#include "core/scene/scene.hpp"
+#include "item.hpp"
+#include "options/options.hpp"
+
+#include <bit>
+
+namespace op {
+
+uint32_t tile(std::vector<Item> const& items, it::options::Options const& options,
+              Scene const& scene) {
+    uint32_t const tile_size = options.tile_size;
+
+    if (tile_size < 8 || !std::has_single_bit(tile_size)) {
+        logging::error("Tile size must be a power of two of at least 8.");
+        return 0;
+    }
+
+    uint32_t num = 0;
+
+    for (auto const& i : items) {
+        Image const* image = i.image.image(scene);
+
+        if (!image->data() || image->description().dimensions()[2] > 1) {
+            logging::warning("%S cannot be tiled.", i.name);
+            continue;
+        }
+
+        std::string const& name = i.name_out.empty() ? i.name : i.name_out;
+
+        encoding::sub::Writer::write_tiled(name, *image, tile_size);
+
+        ++num;
+    }
+
+    return num;
+}
+
+}  // namespace op
@@ -0,0 +1,24 @@
+#ifndef SU_IT_OPERATOR_TILE_HPP
+#define SU_IT_OPERATOR_TILE_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace scene {
+class Scene;
+}
+
+using Scene = scene::Scene;
+
+namespace it::options {
+struct Options;
+}
+
+struct Item;
+
+namespace op {
+uint32_t tile(std::vector<Item> const& items, it::options::Options const& options,
+              Scene const& scene);
+}
+
+#endif
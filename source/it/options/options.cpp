@@ -79,8 +79,12 @@ bool handle(std::string const& command, std::string const& parameter, Options& r
         result.clip[0] = std::stof(parameter);
     } else if ("clip-hi" == command) {
         result.clip[1] = std::stof(parameter);
+    } else if ("look-ahead" == command) {
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(), result.look_ahead);
     } else if ("max-dif" == command) {
         result.max_dif = std::stof(parameter);
+    } else if ("merge" == command) {
+        result.op = Options::Operator::Merge;
     } else if ("image" == command || "i" == command) {
         result.images.push_back(parameter);
     } else if ("out" == command || "o" == command) {
@@ -89,10 +93,15 @@ bool handle(std::string const& command, std::string const& parameter, Options& r
         result.no_export = true;
     } else if ("report" == command || "r" == command) {
         result.report = parameter.empty() ? "." : parameter;
+    } else if ("sparse" == command) {
+        result.op = Options::Operator::Sparse;
     } else if ("stats" == command || "s" == command) {
         result.statistics = parameter.empty() ? "." : parameter;
     } else if ("sub" == command) {
         result.op = Options::Operator::Sub;
+    } else if ("tile" == command) {
+        result.op = Options::Operator::Tile;
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(), result.tile_size);
     } else if ("take" == command) {
         result.take = parameter;
     } else if ("threads" == command || "t" == command) {
@@ -143,6 +152,11 @@ Usage:
       --clip-hi  float        Clip above the given value.
   -d, --diff                  Compute the difference between the first
                               and subsequent images.
+      --look-ahead int        Number of images that are decoded ahead of
+                              the one that is processed, for the operators
+                              that stream their inputs (add, average, diff,
+                              stats and sub).
+                              The default value is 4.
       --max-dif  float        Override the calculated max difference
                               for coloring the difference images.
   -i, --image    file+        File name of an image.
@@ -155,16 +169,28 @@ Usage:
                               WARNING:
                               In case of missing file names, it will pick
                               defaults that could overwrite existing files!
+      --merge                 Combine the checkpoints that were stored by
+                              "sprout --split" into the final image,
+                              without postprocessing.
+                              The checkpoints are specified with --image.
+                              The default output is "merge.exr".
   -n, --no-export             Disables export of images.
   -r, --report   file?        Generate report.
                               Optionally the report can be written to a file.
   -s, --stats    file?        Generate image statistics, including histogram.
                               Optionally the stats can be written to a file.
                               If no operator is specified, it defaults to stats.
+      --sparse                Store each Float1 volume as a sparse .sub file
+                              that is loaded without expanding empty space.
       --sub                   Subtract a series of images from the first image
                               and save as a single image.
       --take     file/string  Path of the take file to render,
                               or json-string describing the take.
+      --tile     int?         Store each image in tiles, as a .sub file
+                              that can be loaded on demand while rendering.
+                              Optionally specify the tile size,
+                              a power of two of at least 8.
+                              The default value is 64.
   -t, --threads  int          Specifies the number of threads used by it.
                               0 creates one thread for each logical CPU.
                               -x creates as many threads as the number of
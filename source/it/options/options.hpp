@@ -10,12 +10,17 @@
 namespace it::options {
 
 struct Options {
-    enum class Operator { Add, Average, Cat, Diff, Sub, Undefined };
+    enum class Operator { Add, Average, Cat, Diff, Merge, Sparse, Sub, Tile, Undefined };
 
     Operator op = Operator::Undefined;
 
     uint32_t concat_num_per_row = 0;
 
+    uint32_t tile_size = 64;
+
+    // Number of images that are decoded ahead of the one that is currently processed
+    uint32_t look_ahead = 4;
+
     float clamp = std::numeric_limits<float>::max();
 
     float2 clip = float2(0.f, std::numeric_limits<float>::max());